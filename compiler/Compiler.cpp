@@ -1,3 +1,5 @@
+#include "BackEnd/ELF/Linker.h"
+#include "BackEnd/X86/ObjectEmitter.h"
 #include "FrontEnd/AST/ASTDump.h"
 #include "FrontEnd/Lex/Lexer.h"
 #include "FrontEnd/Parse/Parser.h"
@@ -6,23 +8,43 @@
 #include "FrontEnd/Analysis/TypeAnalysis.h"
 #include "MiddleEnd/CodeGen/CodeGen.h"
 #include "MiddleEnd/Driver/Driver.h"
+#include "MiddleEnd/IR/ASTLowering.h"
+#include "MiddleEnd/IR/Passes.h"
+#include "MiddleEnd/Optimizers/BoundsCheckElimination.h"
+#include "MiddleEnd/Optimizers/ConstantFolding.h"
+#include "MiddleEnd/Optimizers/DeadFunctionElimination.h"
 #include "MiddleEnd/Optimizers/Optimizers.h"
+#include "MiddleEnd/Optimizers/ProfileGuidedOptimization.h"
+#include "MiddleEnd/Optimizers/StructLayout.h"
+#include "Utility/CompilationCache.h"
 #include "Utility/Diagnostic.h"
 #include "Utility/Files.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/CachePruning.h"
 #include "llvm/Support/CommandLine.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/ThreadPool.h"
 #include <iomanip>
 #include <iostream>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
 
-std::vector<weak::Token> DoLexicalAnalysis(std::string_view Path) {
+std::vector<weak::Token> DoLexicalAnalysis(
+  std::string_view  Path,
+  std::ostream     &WarnStream = std::cout
+) {
   std::string Program = weak::FileAsString(Path);
   weak::Lexer Lex(&Program.front(), &Program.back());
-  weak::PrintGeneratedWarns(std::cout);
+  weak::PrintGeneratedWarns(WarnStream);
   return Lex.Analyze();
 }
 
-std::unique_ptr<weak::ASTCompound>
-DoSyntaxAnalysis(std::string_view InputPath) {
-  auto Tokens = DoLexicalAnalysis(InputPath);
+std::unique_ptr<weak::ASTCompound> DoSyntaxAnalysis(
+  std::string_view  InputPath,
+  std::ostream     &WarnStream = std::cout
+) {
+  auto Tokens = DoLexicalAnalysis(InputPath, WarnStream);
   weak::Parser Parser(&Tokens.front(), &Tokens.back());
   auto AST = Parser.Parse();
 
@@ -37,16 +59,110 @@ DoSyntaxAnalysis(std::string_view InputPath) {
     delete A;
   }
 
-  weak::PrintGeneratedWarns(std::cout);
+  weak::PrintGeneratedWarns(WarnStream);
 
   return AST;
 }
 
-std::string DoLLVMCodeGen(std::string_view InputPath, WeakOptimizationLevel OptLvl) {
+/// Code generator for functions, lowered to Weak IR.
+enum class BackEndKind { LLVM, Fast };
+
+/// Options, that affect the whole compilation pipeline.
+struct CompilerOptions {
+  WeakOptimizationLevel OptLvl{O0};
+  bool PrintStats{false};
+  /// Lower functions to Weak IR and optimize them there before LLVM.
+  bool WeakIR{false};
+  /// Compile functions from Weak IR to machine code without LLVM. Implies
+  /// Weak IR.
+  BackEndKind BackEnd{BackEndKind::LLVM};
+  weak::StructLayoutOptions StructLayout;
+  weak::CodeGenOptions CodeGen;
+  weak::DriverOptions Driver;
+  /// Directory of compilation cache. Cache is not used if empty.
+  std::string CacheDir;
+  /// Limit of compilation cache size in bytes.
+  uint64_t CacheMaxSize{0U};
+  /// Instrument code to write execution profile to this file, when
+  /// program exits. Code is not instrumented if empty.
+  std::string ProfileGenerate;
+  /// Profile in indexed format to optimize code by. Not used if empty.
+  std::string ProfileUse;
+};
+
+void DoASTOptimizations(
+  weak::ASTNode         *AST,
+  const CompilerOptions &Opts,
+  std::ostream          &StatsStream = std::cerr
+) {
+  auto FoldingStats = weak::RunConstantFoldingPass(AST);
+  /// Folding removes calls from dead branches, so run it first.
+  auto DFEStats = weak::RunDeadFunctionEliminationPass(AST);
+
+  if (Opts.PrintStats) {
+    FoldingStats.Dump(StatsStream);
+    DFEStats.Dump(StatsStream);
+  }
+
+  if (Opts.StructLayout.ReorderFields || Opts.StructLayout.SplitColdFields) {
+    auto LayoutStats = weak::RunStructLayoutPass(AST, Opts.StructLayout);
+    if (Opts.PrintStats)
+      LayoutStats.Dump(StatsStream);
+  }
+
+  if (Opts.CodeGen.BoundsCheck) {
+    auto BCEStats = weak::RunBoundsCheckEliminationPass(AST);
+    if (Opts.PrintStats)
+      BCEStats.Dump(StatsStream);
+  }
+}
+
+weak::ir::Module DoWeakIRGen(
+  weak::ASTNode         *AST,
+  const CompilerOptions &Opts,
+  std::ostream          &StatsStream = std::cerr
+) {
+  auto Module = weak::LowerToWeakIR(AST, Opts.CodeGen.BoundsCheck);
+
+  if (Opts.OptLvl != O0) {
+    auto Stats = weak::ir::RunDefaultPasses(Module);
+    if (Opts.PrintStats)
+      Stats.Dump(StatsStream);
+  }
+
+  return Module;
+}
+
+/// Instrument LLVM module or attach profile to it. Called before LLVM
+/// optimizations, so instrumented and optimized builds see the same code.
+///
+/// \param Unit  Index of translation unit among linked together.
+/// \param Units Count of translation units, linked together.
+void DoProfileGuidedOptimization(
+  llvm::Module          &M,
+  const CompilerOptions &Opts,
+  unsigned               Unit = 0U,
+  unsigned               Units = 1U
+) {
+  if (!Opts.ProfileGenerate.empty())
+    weak::RunProfileInstrumentationPass(M, Opts.ProfileGenerate, Unit, Units);
+  if (!Opts.ProfileUse.empty())
+    weak::RunProfileUsePass(M, Opts.ProfileUse);
+}
+
+std::string DoLLVMCodeGen(std::string_view InputPath, const CompilerOptions &Opts) {
   auto AST = DoSyntaxAnalysis(InputPath);
-  weak::CodeGen CG(AST.get());
+  DoASTOptimizations(AST.get(), Opts);
+  weak::ir::Module WeakIR;
+  weak::CodeGenOptions CodeGenOpts = Opts.CodeGen;
+  if (Opts.WeakIR) {
+    WeakIR = DoWeakIRGen(AST.get(), Opts);
+    CodeGenOpts.WeakIR = &WeakIR;
+  }
+  weak::CodeGen CG(AST.get(), CodeGenOpts);
   CG.CreateCode();
-  weak::RunBuiltinLLVMOptimizationPass(CG.Module(), OptLvl);
+  DoProfileGuidedOptimization(CG.Module(), Opts);
+  weak::RunBuiltinLLVMOptimizationPass(CG.Module(), Opts.OptLvl);
   weak::PrintGeneratedWarns(std::cout);
   return CG.ToString();
 }
@@ -65,23 +181,235 @@ void DumpAST(std::string_view InputPath) {
   weak::ASTDump(AST.get(), std::cout);
 }
 
-void DumpLLVMIR(std::string_view InputPath, WeakOptimizationLevel OptLvl) {
-  std::string IR = DoLLVMCodeGen(InputPath, OptLvl);
+void DumpWeakIR(std::string_view InputPath, const CompilerOptions &Opts) {
+  auto AST = DoSyntaxAnalysis(InputPath);
+  DoASTOptimizations(AST.get(), Opts);
+  weak::ir::Dump(DoWeakIRGen(AST.get(), Opts), std::cout);
+}
+
+void DumpLLVMIR(std::string_view InputPath, const CompilerOptions &Opts) {
+  std::string IR = DoLLVMCodeGen(InputPath, Opts);
   std::cout << IR << std::endl;
 }
 
-void BuildCode(
-  std::string_view      InputPath,
-  std::string_view      OutputPath,
-  WeakOptimizationLevel OptLvl
+/// \return Exit code of program.
+int RunCode(
+  std::string_view       InputPath,
+  std::string_view       OutputPath,
+  const CompilerOptions &Opts
 ) {
   auto AST = DoSyntaxAnalysis(InputPath);
-  weak::CodeGen CG(AST.get());
+  DoASTOptimizations(AST.get(), Opts);
+  weak::ir::Module WeakIR;
+  weak::CodeGenOptions CodeGenOpts = Opts.CodeGen;
+  weak::DriverOptions DriverOpts = Opts.Driver;
+  if (Opts.WeakIR || Opts.BackEnd == BackEndKind::Fast) {
+    WeakIR = DoWeakIRGen(AST.get(), Opts);
+    CodeGenOpts.WeakIR = &WeakIR;
+  }
+  if (Opts.BackEnd == BackEndKind::Fast) {
+    std::string ObjectPath = std::string(OutputPath) + ".weak.o";
+    weak::x86::EmitObjectFile(WeakIR, ObjectPath);
+    /// The rest of functions is still compiled by LLVM.
+    CodeGenOpts.WeakIRDeclarationsOnly = true;
+    DriverOpts.ExtraObjects.push_back(std::move(ObjectPath));
+  }
+  weak::CodeGen CG(AST.get(), CodeGenOpts);
   CG.CreateCode();
-  weak::RunBuiltinLLVMOptimizationPass(CG.Module(), OptLvl);
-  weak::Driver Driver(CG.Module(), OutputPath);
+  weak::Driver Driver(CG.Module(), OutputPath, DriverOpts);
+  DoProfileGuidedOptimization(CG.Module(), Opts);
+  weak::RunBuiltinLLVMOptimizationPass(CG.Module(), Opts.OptLvl, &Driver.TargetMachine());
   weak::PrintGeneratedWarns(std::cout);
-  Driver.Compile();
+  return Driver.Run();
+}
+
+/// Result of compilation of one input file by worker thread.
+struct CompiledUnit {
+  /// Objects, emitted by LLVM and native back end.
+  std::vector<std::unique_ptr<llvm::MemoryBuffer>> Objects;
+  /// Warnings and statistics are printed in order of input files, when
+  /// all units are compiled.
+  std::ostringstream Warnings;
+  std::ostringstream Stats;
+  /// Error is reported in order of input files as well.
+  std::exception_ptr Error;
+};
+
+/// Key of cache entry of input file. Path is a part of key, since it is
+/// referenced from debug info and diagnostics. Instrumented code depends
+/// on position of unit among linked ones.
+std::string UnitCacheKey(
+  std::string_view       InputPath,
+  const std::string     &Source,
+  const CompilerOptions &Opts,
+  unsigned               Unit,
+  unsigned               Units
+) {
+  std::ostringstream Flags;
+  Flags << Opts.OptLvl << ' ' << Opts.WeakIR << ' '
+        << static_cast<int>(Opts.BackEnd) << ' '
+        << Opts.StructLayout.ReorderFields << ' ' << Opts.StructLayout.SplitColdFields << ' '
+        << Opts.CodeGen.BoundsCheck << ' ' << Opts.CodeGen.DebugInfo << ' '
+        << Opts.Driver.KeepFramePointers << ' ' << Opts.Driver.OptLvl << ' '
+        << static_cast<int>(Opts.Driver.LTO) << ' ' << Opts.Driver.CodeGenThreads;
+  if (!Opts.ProfileGenerate.empty())
+    Flags << ' ' << Opts.ProfileGenerate << ' ' << Unit << ' ' << Units;
+  std::string Profile = Opts.ProfileUse.empty() ? "" : weak::FileAsString(Opts.ProfileUse);
+  std::string Target = weak::TargetDescription(Opts.Driver);
+  return weak::CompilationCache::ComputeKey({InputPath, Source, Target, Flags.str(), Profile});
+}
+
+/// \return True if LLVM module defines anything. With native back end
+///         it may contain only declarations of natively compiled functions.
+bool HasLLVMDefinitions(const llvm::Module &M) {
+  return
+    llvm::any_of(M.functions(), [](const llvm::Function &F) { return !F.isDeclaration(); }) ||
+    llvm::any_of(M.globals(), [](const llvm::GlobalVariable &G) { return !G.isDeclaration(); });
+}
+
+/// Compile input file to relocatable objects. Each unit has its own AST,
+/// Weak IR and LLVM context, so units can be compiled in parallel.
+///
+/// \param Index Position of input file among linked together.
+/// \param Count Count of input files, linked together.
+void CompileUnit(
+  std::string_view       InputPath,
+  const CompilerOptions &Opts,
+  CompiledUnit          &Unit,
+  unsigned               Index,
+  unsigned               Count
+) {
+  auto AST = DoSyntaxAnalysis(InputPath, Unit.Warnings);
+  DoASTOptimizations(AST.get(), Opts, Unit.Stats);
+  weak::ir::Module WeakIR;
+  weak::CodeGenOptions CodeGenOpts = Opts.CodeGen;
+  CodeGenOpts.SourcePath = std::string(InputPath);
+  if (Opts.WeakIR || Opts.BackEnd == BackEndKind::Fast) {
+    WeakIR = DoWeakIRGen(AST.get(), Opts, Unit.Stats);
+    CodeGenOpts.WeakIR = &WeakIR;
+  }
+  if (Opts.BackEnd == BackEndKind::Fast) {
+    std::vector<char> Object = weak::x86::EmitObject(WeakIR);
+    Unit.Objects.push_back(llvm::MemoryBuffer::getMemBufferCopy(
+      llvm::StringRef(Object.data(), Object.size()), std::string(InputPath) + ".weak.o"));
+    /// The rest of functions is still compiled by LLVM.
+    CodeGenOpts.WeakIRDeclarationsOnly = true;
+  }
+  weak::CodeGen CG(AST.get(), CodeGenOpts);
+  CG.CreateCode();
+  /// Every function is compiled natively, so neither target machine nor
+  /// LLVM optimizer and code generator are needed.
+  if (Opts.BackEnd == BackEndKind::Fast && !HasLLVMDefinitions(CG.Module())) {
+    weak::PrintGeneratedWarns(Unit.Warnings);
+    return;
+  }
+  weak::Driver Driver(CG.Module(), InputPath, Opts.Driver);
+  DoProfileGuidedOptimization(CG.Module(), Opts, Index, Count);
+  weak::RunBuiltinLLVMOptimizationPass(CG.Module(), Opts.OptLvl, &Driver.TargetMachine(), Opts.Driver.LTO);
+  weak::PrintGeneratedWarns(Unit.Warnings);
+  if (Opts.Driver.LTO != weak::LTOKind::None)
+    Unit.Objects.push_back(Driver.EmitBitcode());
+  else
+    for (auto &Object : Driver.EmitObjects())
+      Unit.Objects.push_back(std::move(Object));
+}
+
+/// Take objects, warnings and statistics of input file from cache or
+/// compile it and store them there. Entry is warnings, statistics and
+/// then objects.
+void CompileUnitCached(
+  std::string_view        InputPath,
+  const CompilerOptions  &Opts,
+  weak::CompilationCache &Cache,
+  CompiledUnit           &Unit,
+  unsigned                Index,
+  unsigned                Count
+) {
+  std::string Key = UnitCacheKey(InputPath, weak::FileAsString(InputPath), Opts, Index, Count);
+  if (auto Blobs = Cache.Lookup(Key)) {
+    Unit.Warnings << (*Blobs)[0];
+    if (Opts.PrintStats)
+      Unit.Stats << (*Blobs)[1];
+    for (size_t I = 2; I < Blobs->size(); ++I)
+      Unit.Objects.push_back(llvm::MemoryBuffer::getMemBufferCopy((*Blobs)[I], InputPath));
+    return;
+  }
+
+  /// Statistics are always collected, so -print-stats does not change
+  /// key of entry.
+  CompilerOptions StatsOpts = Opts;
+  StatsOpts.PrintStats = true;
+  CompileUnit(InputPath, StatsOpts, Unit, Index, Count);
+  std::string Warnings = Unit.Warnings.str();
+  std::string Stats = Unit.Stats.str();
+  if (!Opts.PrintStats)
+    Unit.Stats.str("");
+  std::vector<std::string_view> Blobs = {Warnings, Stats};
+  for (const auto &Object : Unit.Objects)
+    Blobs.emplace_back(Object->getBufferStart(), Object->getBufferSize());
+  Cache.Store(Key, Blobs);
+}
+
+/// Compile input files on all cores and link them to one executable.
+/// Calls between files are resolved by linker, so functions, called
+/// from other files, should be exported there and declared by prototype
+/// in caller. With LTO units are compiled to bitcode, that is optimized
+/// together before linking.
+void BuildCode(
+  const std::vector<std::string> &InputPaths,
+  std::string_view                OutputPath,
+  const CompilerOptions          &Opts
+) {
+  std::vector<CompiledUnit> Units(InputPaths.size());
+  std::optional<weak::CompilationCache> Cache;
+  if (!Opts.CacheDir.empty())
+    Cache.emplace(Opts.CacheDir, Opts.CacheMaxSize);
+  {
+    llvm::ThreadPool Pool;
+    for (size_t I = 0; I < InputPaths.size(); ++I)
+      Pool.async([&, I] {
+        try {
+          if (Cache)
+            CompileUnitCached(InputPaths[I], Opts, *Cache, Units[I], I, Units.size());
+          else
+            CompileUnit(InputPaths[I], Opts, Units[I], I, Units.size());
+        } catch (...) {
+          Units[I].Error = std::current_exception();
+        }
+      });
+    Pool.wait();
+  }
+
+  weak::elf::Linker Linker;
+  std::vector<std::unique_ptr<llvm::MemoryBuffer>> Bitcode;
+  for (size_t I = 0; I < Units.size(); ++I) {
+    /// Warnings, as well as errors, know only position inside of file.
+    std::istringstream Warnings(Units[I].Warnings.str());
+    for (std::string Line; std::getline(Warnings, Line);)
+      std::cout << InputPaths[I] << ": " << Line << '\n';
+    std::cerr << Units[I].Stats.str();
+    if (Units[I].Error)
+      try {
+        std::rethrow_exception(Units[I].Error);
+      } catch (const std::exception &E) {
+        throw std::runtime_error(InputPaths[I] + ": " + E.what());
+      }
+    for (auto &Object : Units[I].Objects)
+      if (Opts.Driver.LTO != weak::LTOKind::None)
+        Bitcode.push_back(std::move(Object));
+      else
+        Linker.AddObject(std::move(Object), I);
+  }
+  if (!Bitcode.empty())
+    for (auto &Object : weak::LinkTimeOptimize(Bitcode, Opts.Driver))
+      Linker.AddObject(std::move(Object));
+  Linker.Link(OutputPath);
+
+  if (Cache) {
+    Cache->Prune();
+    if (Opts.PrintStats)
+      Cache->Stats().Dump(std::cerr);
+  }
 }
 
 int main(int Argc, char *Argv[]) {
@@ -90,11 +418,11 @@ int main(int Argc, char *Argv[]) {
       "Compiler Options",
       "Options for controlling the compilation process.");
 
-  llvm::cl::opt<std::string>
-    InputFilenameOpt(
+  llvm::cl::list<std::string>
+    InputFilenamesOpt(
       "i",
-      llvm::cl::desc("Specify input program file"),
-      llvm::cl::Required,
+      llvm::cl::desc("Specify input program file, can be given many times"),
+      llvm::cl::OneOrMore,
       llvm::cl::cat(CompilerCategory));
 
   llvm::cl::opt<std::string>
@@ -125,39 +453,275 @@ int main(int Argc, char *Argv[]) {
       llvm::cl::Optional,
       llvm::cl::cat(CompilerCategory));
 
+  llvm::cl::opt<bool>
+    DumpWeakIROpt(
+      "dump-weak-ir",
+      llvm::cl::desc("Show the Weak IR of input file"),
+      llvm::cl::Optional,
+      llvm::cl::cat(CompilerCategory));
+
+  llvm::cl::opt<bool>
+    WeakIROpt(
+      "fweak-ir",
+      llvm::cl::desc("Optimize functions on scalars and arrays in Weak IR before LLVM"),
+      llvm::cl::Optional,
+      llvm::cl::cat(CompilerCategory));
+
+  llvm::cl::opt<BackEndKind>
+    BackEndOpt(
+      "backend",
+      llvm::cl::desc("Code generator for functions on scalars and arrays"),
+      llvm::cl::values(
+        clEnumValN(BackEndKind::LLVM, "llvm", "LLVM code generator"),
+        clEnumValN(BackEndKind::Fast, "fast", "Native x86-64 code generator for fast debug builds")),
+      llvm::cl::init(BackEndKind::LLVM),
+      llvm::cl::cat(CompilerCategory));
+
+  llvm::cl::opt<weak::LTOKind>
+    LTOOpt(
+      "flto",
+      llvm::cl::desc("Optimize all input files together at link time"),
+      llvm::cl::values(
+        clEnumValN(weak::LTOKind::Full, "full", "Merge all files to one module"),
+        clEnumValN(weak::LTOKind::Thin, "thin", "Optimize files in parallel, importing functions by summaries"),
+        clEnumValN(weak::LTOKind::Full, "", "")),
+      llvm::cl::ValueOptional,
+      llvm::cl::init(weak::LTOKind::None),
+      llvm::cl::cat(CompilerCategory));
+
+  llvm::cl::opt<unsigned>
+    CodeGenThreadsOpt(
+      "codegen-threads",
+      llvm::cl::desc("Split each input file to given number of parts, compiled to machine code in parallel"),
+      llvm::cl::value_desc("N"),
+      llvm::cl::init(1U),
+      llvm::cl::cat(CompilerCategory));
+
+  llvm::cl::opt<std::string>
+    CacheDirOpt(
+      "cache-dir",
+      llvm::cl::desc("Take objects of unchanged input files from given directory and store new ones there"),
+      llvm::cl::value_desc("directory"),
+      llvm::cl::Optional,
+      llvm::cl::cat(CompilerCategory));
+
+  llvm::cl::opt<std::string>
+    CacheMaxSizeOpt(
+      "cache-max-size",
+      llvm::cl::desc("Evict least recently used objects, if cache is larger than given size, like 500m or 2g"),
+      llvm::cl::value_desc("size"),
+      llvm::cl::init("1g"),
+      llvm::cl::cat(CompilerCategory));
+
+  llvm::cl::opt<std::string>
+    ProfileGenerateOpt(
+      "fprofile-generate",
+      llvm::cl::desc("Instrument program to write execution profile to given file, default.proftext by default"),
+      llvm::cl::value_desc("file"),
+      llvm::cl::ValueOptional,
+      llvm::cl::cat(CompilerCategory));
+
+  llvm::cl::opt<std::string>
+    ProfileUseOpt(
+      "fprofile-use",
+      llvm::cl::desc("Optimize program by execution profile, written by instrumented program or llvm-profdata"),
+      llvm::cl::value_desc("file"),
+      llvm::cl::Optional,
+      llvm::cl::cat(CompilerCategory));
+
+  llvm::cl::opt<bool>
+    RunOpt(
+      "run",
+      llvm::cl::desc("Run program in memory and exit with its exit code"),
+      llvm::cl::Optional,
+      llvm::cl::cat(CompilerCategory));
+
+  llvm::cl::opt<bool>
+    StatsOpt(
+      "print-stats",
+      llvm::cl::desc("Print statistics of optimization passes"),
+      llvm::cl::Optional,
+      llvm::cl::cat(CompilerCategory));
+
+  llvm::cl::opt<bool>
+    BoundsCheckOpt(
+      "fbounds-check",
+      llvm::cl::desc("Check array indices at runtime, if they cannot be proven to be in bounds"),
+      llvm::cl::Optional,
+      llvm::cl::cat(CompilerCategory));
+
+  llvm::cl::opt<bool>
+    DebugInfoOpt(
+      "g",
+      llvm::cl::desc("Generate source-level debug information and keep frame pointers"),
+      llvm::cl::Optional,
+      llvm::cl::cat(CompilerCategory));
+
+  llvm::cl::opt<bool>
+    ReorderStructFieldsOpt(
+      "freorder-struct-fields",
+      llvm::cl::desc("Reorder structure members to minimize padding"),
+      llvm::cl::Optional,
+      llvm::cl::cat(CompilerCategory));
+
+  llvm::cl::opt<bool>
+    SplitColdStructFieldsOpt(
+      "fsplit-cold-struct-fields",
+      llvm::cl::desc("Move rarely used structure members to the end of structure"),
+      llvm::cl::Optional,
+      llvm::cl::cat(CompilerCategory));
+
+  llvm::cl::opt<std::string>
+    MArchOpt(
+      "march",
+      llvm::cl::desc("Generate code for given processor, \"native\" for host one"),
+      llvm::cl::value_desc("cpu"),
+      llvm::cl::Optional,
+      llvm::cl::cat(CompilerCategory));
+
+  llvm::cl::opt<std::string>
+    MCPUOpt(
+      "mcpu",
+      llvm::cl::desc("Like -march, takes precedence over it"),
+      llvm::cl::value_desc("cpu"),
+      llvm::cl::Optional,
+      llvm::cl::cat(CompilerCategory));
+
+  llvm::cl::opt<std::string>
+    MAttrOpt(
+      "mattr",
+      llvm::cl::desc("Enable or disable target features, like +avx2,-fma"),
+      llvm::cl::value_desc("features"),
+      llvm::cl::Optional,
+      llvm::cl::cat(CompilerCategory));
+
+  llvm::cl::opt<std::string>
+    MTuneOpt(
+      "mtune",
+      llvm::cl::desc("Tune code for given processor without changing instruction set"),
+      llvm::cl::value_desc("cpu"),
+      llvm::cl::Optional,
+      llvm::cl::cat(CompilerCategory));
+
   llvm::cl::opt<WeakOptimizationLevel>
     OptimizationLvlOpt(
-      llvm::cl::desc("Optimization level, from -O0 to -O3"),
+      llvm::cl::desc("Optimization level, from -O0 to -O3, -Os or -Oz"),
       llvm::cl::values(
         clEnumVal(O0, "No optimizations"),
         clEnumVal(O1, "Trivial"),
         clEnumVal(O2, "Default"),
-        clEnumVal(O3, "Most aggressive")),
+        clEnumVal(O3, "Most aggressive"),
+        clEnumVal(Os, "Like -O2 with extra optimizations for size"),
+        clEnumVal(Oz, "Like -Os but reduces code size further")),
       llvm::cl::init(O0));
 
   llvm::cl::HideUnrelatedOptions(CompilerCategory);
   llvm::cl::ParseCommandLineOptions(Argc, Argv);
 
-  std::string InputFilename = InputFilenameOpt;
+  std::vector<std::string> InputFilenames = InputFilenamesOpt;
   std::string OutputFilename =
     OutputFilenameOpt.empty()
-      ? InputFilename.substr(0, InputFilename.find_first_of('.'))
+      ? InputFilenames.front().substr(0, InputFilenames.front().find_first_of('.'))
       : OutputFilenameOpt;
 
-  if (DumpLexemesOpt) {
-    DumpLexemes(InputFilename);
-    return 0;
+  CompilerOptions Opts;
+  Opts.OptLvl = OptimizationLvlOpt;
+  Opts.Driver.OptLvl = OptimizationLvlOpt;
+  if (!MCPUOpt.empty())
+    Opts.Driver.CPU = MCPUOpt;
+  else if (!MArchOpt.empty())
+    Opts.Driver.CPU = MArchOpt;
+  Opts.Driver.TuneCPU = MTuneOpt;
+  Opts.Driver.Features = MAttrOpt;
+  Opts.Driver.LTO = LTOOpt;
+  Opts.Driver.CodeGenThreads = CodeGenThreadsOpt;
+  Opts.PrintStats = StatsOpt;
+  Opts.CacheDir = CacheDirOpt;
+  auto CachePolicy = llvm::parseCachePruningPolicy("cache_size_bytes=" + CacheMaxSizeOpt);
+  if (!CachePolicy) {
+    llvm::errs() << "Invalid cache size: " << llvm::toString(CachePolicy.takeError());
+    return -1;
   }
-
-  if (DumpASTOpt) {
-    DumpAST(InputFilename);
-    return 0;
+  Opts.CacheMaxSize = CachePolicy->MaxSizeBytes;
+  Opts.WeakIR = WeakIROpt;
+  Opts.BackEnd = BackEndOpt;
+  Opts.StructLayout.ReorderFields = ReorderStructFieldsOpt;
+  Opts.StructLayout.SplitColdFields = SplitColdStructFieldsOpt;
+  Opts.CodeGen.BoundsCheck = BoundsCheckOpt;
+  Opts.CodeGen.DebugInfo = DebugInfoOpt;
+  Opts.CodeGen.SourcePath = InputFilenames.front();
+  Opts.Driver.KeepFramePointers = DebugInfoOpt;
+  if (ProfileGenerateOpt.getNumOccurrences() && !ProfileUseOpt.empty()) {
+    llvm::errs() << "-fprofile-generate cannot be used with -fprofile-use";
+    return -1;
   }
+  if (ProfileGenerateOpt.getNumOccurrences())
+    Opts.ProfileGenerate = ProfileGenerateOpt.empty() ? "default.proftext" : ProfileGenerateOpt.getValue();
+  /// Converted profile is removed on exit and on signals.
+  std::optional<weak::IndexedProfile> Profile;
+  if (!ProfileUseOpt.empty()) {
+    Profile.emplace(ProfileUseOpt);
+    Opts.ProfileUse = Profile->Path();
+  }
+
+  /// Exception, not caught by main, terminates without stack unwinding, so
+  /// converted profile is removed here.
+  try {
+    if (DumpLexemesOpt) {
+      for (const std::string &InputFilename : InputFilenames)
+        DumpLexemes(InputFilename);
+      return 0;
+    }
 
-  if (DumpLLVMIROpt) {
-    DumpLLVMIR(InputFilename, OptimizationLvlOpt);
+    if (DumpASTOpt) {
+      for (const std::string &InputFilename : InputFilenames)
+        DumpAST(InputFilename);
+      return 0;
+    }
+
+    if (DumpWeakIROpt) {
+      for (const std::string &InputFilename : InputFilenames)
+        DumpWeakIR(InputFilename, Opts);
+      return 0;
+    }
+
+    if (DumpLLVMIROpt) {
+      for (const std::string &InputFilename : InputFilenames) {
+        Opts.CodeGen.SourcePath = InputFilename;
+        DumpLLVMIR(InputFilename, Opts);
+      }
+      return 0;
+    }
+
+    /// Layout is computed from member accesses of one file, so files would
+    /// disagree about layout of the same structure.
+    if (InputFilenames.size() > 1 && (Opts.StructLayout.ReorderFields || Opts.StructLayout.SplitColdFields)) {
+      llvm::errs() << "-freorder-struct-fields and -fsplit-cold-struct-fields cannot be used with many input files";
+      return -1;
+    }
+
+    if (Opts.Driver.LTO != weak::LTOKind::None && Opts.BackEnd == BackEndKind::Fast) {
+      llvm::errs() << "-flto cannot be used with native back end";
+      return -1;
+    }
+
+    if ((ProfileGenerateOpt.getNumOccurrences() || !ProfileUseOpt.empty()) && Opts.BackEnd == BackEndKind::Fast) {
+      llvm::errs() << "-fprofile-generate and -fprofile-use cannot be used with native back end";
+      return -1;
+    }
+
+    if (RunOpt) {
+      if (InputFilenames.size() != 1) {
+        llvm::errs() << "Only one input file can be run";
+        return -1;
+      }
+      return RunCode(InputFilenames.front(), OutputFilename, Opts);
+    }
+
+    BuildCode(InputFilenames, OutputFilename, Opts);
     return 0;
+  } catch (...) {
+    Profile.reset();
+    throw;
   }
-
-  BuildCode(InputFilename, OutputFilename, OptimizationLvlOpt);
 }
\ No newline at end of file
@@ -0,0 +1,73 @@
+/* FileBuffer.h - Helpers to build ELF files in memory.
+ * Copyright (C) 2022 epoll-reactor <glibcxx.chrono@gmail.com>
+ *
+ * This file is distributed under the MIT license.
+ */
+
+#ifndef WEAK_COMPILER_BACK_END_ELF_FILE_BUFFER_H
+#define WEAK_COMPILER_BACK_END_ELF_FILE_BUFFER_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace weak::elf {
+
+/// Table of null-terminated strings, the first one is empty.
+class StringTable {
+public:
+  StringTable() : mData(1, '\0') {}
+
+  uint32_t Add(std::string_view Str) {
+    uint32_t Offset = mData.size();
+    mData.append(Str);
+    mData.push_back('\0');
+    return Offset;
+  }
+
+  const std::string &Data() const { return mData; }
+
+private:
+  std::string mData;
+};
+
+/// Growing byte buffer of file, that is written at once.
+class FileBuffer {
+public:
+  template <typename T>
+  uint64_t Append(const T &Object) {
+    return Append(&Object, sizeof(T));
+  }
+
+  uint64_t Append(const void *Data, size_t Size) {
+    uint64_t Offset = mData.size();
+    mData.insert(mData.end(), static_cast<const char *>(Data), static_cast<const char *>(Data) + Size);
+    return Offset;
+  }
+
+  void Align(size_t Alignment) {
+    mData.resize((mData.size() + Alignment - 1) / Alignment * Alignment);
+  }
+
+  template <typename T>
+  T *At(uint64_t Offset) {
+    return reinterpret_cast<T *>(mData.data() + Offset);
+  }
+
+  /// Extend buffer with zeros to given size.
+  void Resize(size_t Size) {
+    mData.resize(Size);
+  }
+
+  uint64_t Size() const { return mData.size(); }
+
+  const std::vector<char> &Data() const { return mData; }
+
+private:
+  std::vector<char> mData;
+};
+
+} // namespace weak::elf
+
+#endif // WEAK_COMPILER_BACK_END_ELF_FILE_BUFFER_H
\ No newline at end of file
@@ -0,0 +1,58 @@
+/* Linker.h - Linker of ELF relocatable objects to executable.
+ * Copyright (C) 2022 epoll-reactor <glibcxx.chrono@gmail.com>
+ *
+ * This file is distributed under the MIT license.
+ */
+
+#ifndef WEAK_COMPILER_BACK_END_ELF_LINKER_H
+#define WEAK_COMPILER_BACK_END_ELF_LINKER_H
+
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace llvm {
+class MemoryBuffer;
+} // namespace llvm
+
+namespace weak::elf {
+
+/// \brief Linker of x86-64 ELF relocatable objects to executable.
+///
+/// Supports what LLVM and native back end emit for weak programs.
+/// Allocatable sections are merged to .text, .rodata, .data and .bss,
+/// debug sections are concatenated by name, unwind tables are dropped.
+/// Code of .text.hot sections is placed first and of .text.unlikely
+/// sections last, as profile-guided code generator splits it.
+///
+/// Startup code, that calls main and exits with its result, is generated
+/// by linker itself. Functions, not defined by any object, are imported
+/// from libc.so.6 and libm.so.6 through PLT, bound at load time, if one of
+/// these libraries exports them. Program without imports is linked to
+/// fully static executable.
+///
+/// Objects are grouped to translation units. Symbols with hidden
+/// visibility are resolved only between objects of the same unit, so
+/// functions, not exported by source files, may have same names.
+class Linker {
+public:
+  Linker();
+  ~Linker();
+
+  /// Add relocatable object of given translation unit. Buffer is kept
+  /// until executable is written.
+  void AddObject(std::unique_ptr<llvm::MemoryBuffer> Object, uint32_t Unit = 0U);
+
+  /// Link added objects to executable file. Throw exception on undefined
+  /// or duplicate symbols and unsupported input.
+  void Link(std::string_view OutPath);
+
+private:
+  std::vector<std::unique_ptr<llvm::MemoryBuffer>> mObjects;
+  std::vector<uint32_t> mUnits;
+};
+
+} // namespace weak::elf
+
+#endif // WEAK_COMPILER_BACK_END_ELF_LINKER_H
\ No newline at end of file
@@ -0,0 +1,62 @@
+/* ObjectWriter.h - Writer of ELF relocatable objects.
+ * Copyright (C) 2022 epoll-reactor <glibcxx.chrono@gmail.com>
+ *
+ * This file is distributed under the MIT license.
+ */
+
+#ifndef WEAK_COMPILER_BACK_END_ELF_OBJECT_WRITER_H
+#define WEAK_COMPILER_BACK_END_ELF_OBJECT_WRITER_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace weak::elf {
+
+/// \brief Writer of x86-64 ELF relocatable object with one code section.
+///
+/// All defined functions are global, so object can be linked together
+/// with objects, emitted by LLVM, and call them in both directions.
+class ObjectWriter {
+public:
+  explicit ObjectWriter(std::vector<uint8_t> Text);
+
+  /// Define function at given offset of code. Hidden function is visible
+  /// only to objects of the same translation unit.
+  void AddFunction(std::string Name, uint64_t Offset, uint64_t Size, bool IsHidden = false);
+
+  /// Add relocation of 32-bit PC-relative call operand at given offset
+  /// of code to function, defined elsewhere.
+  void AddCall(uint64_t Offset, const std::string &Symbol);
+
+  /// Emit .text, .rela.text, .symtab and string tables.
+  std::vector<char> Emit() const;
+
+  /// Write emitted object to file.
+  void Write(std::string_view Path) const;
+
+private:
+  struct Symbol {
+    std::string Name;
+    uint64_t Offset;
+    uint64_t Size;
+    bool IsDefined;
+    bool IsHidden;
+  };
+
+  struct Relocation {
+    uint64_t Offset;
+    uint32_t Symbol;
+  };
+
+  uint32_t FindOrAddUndefined(const std::string &Name);
+
+  std::vector<uint8_t> mText;
+  std::vector<Symbol> mSymbols;
+  std::vector<Relocation> mRelocations;
+};
+
+} // namespace weak::elf
+
+#endif // WEAK_COMPILER_BACK_END_ELF_OBJECT_WRITER_H
\ No newline at end of file
@@ -0,0 +1,179 @@
+/* Assembler.h - Encoder of x86-64 machine instructions.
+ * Copyright (C) 2022 epoll-reactor <glibcxx.chrono@gmail.com>
+ *
+ * This file is distributed under the MIT license.
+ */
+
+#ifndef WEAK_COMPILER_BACK_END_X86_ASSEMBLER_H
+#define WEAK_COMPILER_BACK_END_X86_ASSEMBLER_H
+
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+namespace weak::x86 {
+
+/// General purpose registers in order of their encoding.
+enum Reg : uint8_t {
+  RAX, RCX, RDX, RBX, RSP, RBP, RSI, RDI,
+  R8,  R9,  R10, R11, R12, R13, R14, R15,
+  NoReg
+};
+
+/// SSE registers in order of their encoding.
+enum XReg : uint8_t {
+  XMM0,  XMM1,  XMM2,  XMM3,  XMM4,  XMM5,  XMM6,  XMM7,
+  XMM8,  XMM9,  XMM10, XMM11, XMM12, XMM13, XMM14, XMM15
+};
+
+/// Condition codes of Jcc and SETcc.
+enum Cond : uint8_t {
+  CC_B  = 0x2,
+  CC_AE = 0x3,
+  CC_E  = 0x4,
+  CC_NE = 0x5,
+  CC_A  = 0x7,
+  CC_P  = 0xA,
+  CC_NP = 0xB,
+  CC_L  = 0xC,
+  CC_GE = 0xD,
+  CC_LE = 0xE,
+  CC_G  = 0xF
+};
+
+/// Two-operand integer instructions, named by their opcode.
+enum AluOp : uint8_t {
+  ALU_ADD = 0x01,
+  ALU_OR  = 0x09,
+  ALU_AND = 0x21,
+  ALU_SUB = 0x29,
+  ALU_XOR = 0x31,
+  ALU_CMP = 0x39
+};
+
+/// Scalar single precision instructions, named by their opcode.
+enum SSEOp : uint8_t {
+  SSE_MOVSS = 0x10,
+  SSE_ADDSS = 0x58,
+  SSE_MULSS = 0x59,
+  SSE_SUBSS = 0x5C,
+  SSE_DIVSS = 0x5E
+};
+
+/// Width of memory access.
+enum class Width : uint8_t {
+  /// Byte, sign-extended to 32 bits on load.
+  S8,
+  /// Byte, zero-extended to 32 bits on load.
+  U8,
+  W32,
+  W64
+};
+
+/// Memory operand [Base + Index * Scale + Disp].
+struct Mem {
+  Reg Base;
+  int32_t Disp{0};
+  Reg Index{NoReg};
+  uint8_t Scale{1U};
+};
+
+/// Position in code, that jumps can refer to before it is bound.
+struct Label {
+  uint32_t ID;
+};
+
+/// Call, that should be resolved by linker or by caller of assembler.
+struct CallFixup {
+  /// Offset of 32-bit PC-relative displacement in code.
+  uint32_t Offset;
+  std::string Symbol;
+};
+
+/// \brief Encoder of x86-64 machine instructions.
+///
+/// Supports only forms, needed to compile Weak IR. All jumps use 32-bit
+/// displacements, so code is never relaxed. 32-bit operations implicitly
+/// clear upper half of 64-bit register.
+class Assembler {
+public:
+  // Data movement.
+  void Mov(Reg Dst, Reg Src, bool Wide);
+  void MovImm(Reg Dst, int32_t Imm);
+  void Load(Reg Dst, Mem Src, Width);
+  void Store(Mem Dst, Reg Src, Width);
+  void Lea(Reg Dst, Mem Src);
+  void MovSX8(Reg Dst, Reg Src);
+  void MovZX8(Reg Dst, Reg Src);
+  void MovSXD(Reg Dst, Reg Src);
+  void Push(Reg);
+  void Pop(Reg);
+
+  // Integer arithmetic.
+  void Alu(AluOp, Reg Dst, Reg Src, bool Wide);
+  void AluImm(AluOp, Reg Dst, int32_t Imm, bool Wide);
+  void Test(Reg Dst, Reg Src);
+  void IMul(Reg Dst, Reg Src);
+  void Neg(Reg);
+  /// Shift left by CL.
+  void Shl(Reg);
+  /// Arithmetic shift right by CL.
+  void Sar(Reg);
+  /// Sign-extend EAX to EDX:EAX.
+  void Cdq();
+  /// Divide EDX:EAX, quotient is stored to EAX.
+  void IDiv(Reg);
+  void SetCC(Cond, Reg);
+
+  // SSE.
+  void SSE(SSEOp, XReg Dst, XReg Src);
+  void MovssLoad(XReg Dst, Mem Src);
+  void MovssStore(Mem Dst, XReg Src);
+  /// Compare and set ZF, PF and CF like unsigned comparison does.
+  void Ucomiss(XReg LHS, XReg RHS);
+  void MovdToXmm(XReg Dst, Reg Src);
+  void MovdFromXmm(Reg Dst, XReg Src);
+  /// Convert signed 64-bit integer to float.
+  void Cvtsi2ss(XReg Dst, Reg Src);
+
+  // Control flow.
+  Label NewLabel();
+  void Bind(Label);
+  void Jmp(Label);
+  void Jcc(Cond, Label);
+  void Call(std::string Symbol);
+  void Ret();
+  void Ud2();
+  void Syscall();
+
+  /// Pad code with int3 to given alignment.
+  void Align(unsigned Alignment);
+
+  /// Resolve jumps to labels. All used labels must be bound.
+  void Finish();
+
+  const std::vector<uint8_t> &Code() const;
+  const std::vector<CallFixup> &Calls() const;
+
+private:
+  void Emit8(uint8_t);
+  void Emit32(uint32_t);
+  /// Emit REX prefix if any bit is set or 8-bit operand requires it.
+  void EmitRex(bool W, unsigned Reg, unsigned Index, unsigned Base, bool ByteRegs);
+  /// Emit [Prefix] [REX] Opcode ModRM for register operands.
+  void EmitRR(uint8_t Prefix, bool W, std::initializer_list<uint8_t> Opcode, unsigned Reg, unsigned RM, bool ByteRegs = false);
+  /// Emit [Prefix] [REX] Opcode ModRM [SIB] [Disp] for memory operand.
+  void EmitRM(uint8_t Prefix, bool W, std::initializer_list<uint8_t> Opcode, unsigned Reg, Mem, bool ByteRegs = false);
+
+  std::vector<uint8_t> mCode;
+  /// Offsets of labels, UINT32_MAX if not bound.
+  std::vector<uint32_t> mLabels;
+  /// Offsets of 32-bit displacements and labels they refer to.
+  std::vector<std::pair<uint32_t, uint32_t>> mJumps;
+  std::vector<CallFixup> mCalls;
+};
+
+} // namespace weak::x86
+
+#endif // WEAK_COMPILER_BACK_END_X86_ASSEMBLER_H
\ No newline at end of file
@@ -0,0 +1,29 @@
+/* ObjectEmitter.h - Fast x86-64 code generator for Weak IR.
+ * Copyright (C) 2022 epoll-reactor <glibcxx.chrono@gmail.com>
+ *
+ * This file is distributed under the MIT license.
+ */
+
+#ifndef WEAK_COMPILER_BACK_END_X86_OBJECT_EMITTER_H
+#define WEAK_COMPILER_BACK_END_X86_OBJECT_EMITTER_H
+
+#include "MiddleEnd/IR/IR.h"
+#include <string_view>
+
+namespace weak::x86 {
+
+/// \brief Compile all functions of module to x86-64 machine code and
+///        write them to ELF relocatable object.
+///
+/// Code follows System V calling convention, so object can be linked with
+/// ones, emitted by LLVM. Instructions are selected one by one without
+/// any scheduling or peephole optimizations, operands are loaded to
+/// scratch registers from locations, assigned by linear scan.
+void EmitObjectFile(const ir::Module &, std::string_view Path);
+
+/// Same as EmitObjectFile, but object is returned in memory.
+std::vector<char> EmitObject(const ir::Module &);
+
+} // namespace weak::x86
+
+#endif // WEAK_COMPILER_BACK_END_X86_OBJECT_EMITTER_H
\ No newline at end of file
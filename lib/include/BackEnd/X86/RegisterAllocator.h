@@ -0,0 +1,55 @@
+/* RegisterAllocator.h - Linear scan register allocation for Weak IR.
+ * Copyright (C) 2022 epoll-reactor <glibcxx.chrono@gmail.com>
+ *
+ * This file is distributed under the MIT license.
+ */
+
+#ifndef WEAK_COMPILER_BACK_END_X86_REGISTER_ALLOCATOR_H
+#define WEAK_COMPILER_BACK_END_X86_REGISTER_ALLOCATOR_H
+
+#include "BackEnd/X86/Assembler.h"
+#include "MiddleEnd/IR/IR.h"
+
+namespace weak::x86 {
+
+/// Where value lives during whole its lifetime.
+struct Location {
+  enum LocationKind : uint8_t {
+    /// Constants and values, that are never defined.
+    NONE,
+    GPR,
+    XMM,
+    STACK
+  };
+
+  LocationKind Kind{NONE};
+  /// Register number for GPR and XMM.
+  uint8_t Reg{0U};
+  /// Index of 8-byte spill slot for STACK.
+  uint32_t Slot{0U};
+};
+
+struct Allocation {
+  /// Location of each value of function.
+  std::vector<Location> Locations;
+  /// Reachable blocks in order of emission.
+  std::vector<ir::BlockID> Order;
+  unsigned SpillSlots{0U};
+  /// Callee-saved registers, that should be preserved by prologue.
+  std::vector<Reg> UsedCalleeSaved;
+};
+
+/// \brief Assign registers to values of function in SSA form.
+///
+/// Uses linear scan of "Linear Scan Register Allocation" by Poletto and
+/// Sarkar. Each value gets one live interval without holes, that covers
+/// all blocks it is live in, so loops extend intervals to their ends.
+///
+/// RAX, RCX, RDX, R11, XMM14 and XMM15 are never allocated and left for
+/// instruction selection, as well as registers for arguments. Values,
+/// live across calls, get only callee-saved registers or are spilled.
+Allocation AllocateRegisters(const ir::Function &);
+
+} // namespace weak::x86
+
+#endif // WEAK_COMPILER_BACK_END_X86_REGISTER_ALLOCATOR_H
\ No newline at end of file
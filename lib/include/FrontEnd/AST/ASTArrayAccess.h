@@ -28,10 +28,17 @@ public:
 
   const std::string &Name() const;
   const std::vector<ASTNode *> &Indices() const;
+  std::vector<ASTNode *> &Indices();
+
+  /// Whether all indices are proven to be within array bounds, so no
+  /// runtime check is needed.
+  bool InBounds() const;
+  void SetInBounds(bool);
 
 private:
   std::string mName;
   std::vector<ASTNode *> mIndices;
+  bool mInBounds;
 };
 
 } // namespace weak
@@ -8,6 +8,7 @@
 #define WEAK_COMPILER_FRONTEND_AST_AST_ARRAY_DECL_H
 
 #include "FrontEnd/AST/ASTNode.h"
+#include "FrontEnd/AST/ParamMode.h"
 #include "FrontEnd/Lex/DataType.h"
 #include <string>
 #include <vector>
@@ -30,6 +31,10 @@ public:
   const std::string &Name() const;
   const std::vector<unsigned> &ArityList() const;
 
+  /// How array is passed, if it is function parameter.
+  ParamMode Mode() const;
+  void SetMode(ParamMode);
+
 private:
   /// Data type of array.
   weak::DataType mDataType;
@@ -41,6 +46,8 @@ private:
   /// and size for each dimension, e.g.,
   /// for array[1][2][3], ArityList equal to { 1, 2, 3 }.
   std::vector<unsigned> mArityList;
+
+  ParamMode mMode;
 };
 
 } // namespace weak
@@ -30,6 +30,9 @@ public:
   ASTNode *LHS() const;
   ASTNode *RHS() const;
 
+  void SetLHS(ASTNode *);
+  void SetRHS(ASTNode *);
+
 private:
   TokenType mOperation;
   ASTNode *mLHS;
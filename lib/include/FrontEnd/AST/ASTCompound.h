@@ -25,6 +25,7 @@ public:
   void Accept(ASTVisitor *) override;
 
   const std::vector<ASTNode *> &Stmts() const;
+  std::vector<ASTNode *> &Stmts();
 
 private:
   std::vector<ASTNode *> mStmts;
@@ -9,6 +9,7 @@
 
 #include "FrontEnd/AST/ASTCompound.h"
 #include "FrontEnd/AST/ASTNode.h"
+#include "FrontEnd/AST/LoopHints.h"
 
 namespace weak {
 
@@ -28,9 +29,17 @@ public:
   ASTCompound *Body() const;
   ASTNode *Condition() const;
 
+  void SetBody(ASTCompound *);
+  void SetCondition(ASTNode *);
+
+  /// Optimization hints, written before loop.
+  const LoopHints &Hints() const;
+  void SetHints(LoopHints);
+
 private:
   ASTCompound *mBody;
   ASTNode *mCondition;
+  LoopHints mHints;
 };
 
 } // namespace weak
@@ -9,6 +9,7 @@
 
 #include "FrontEnd/AST/ASTCompound.h"
 #include "FrontEnd/AST/ASTNode.h"
+#include "FrontEnd/AST/LoopHints.h"
 
 namespace weak {
 
@@ -32,11 +33,21 @@ public:
   ASTNode *Increment() const;
   ASTCompound *Body() const;
 
+  void SetInit(ASTNode *);
+  void SetCondition(ASTNode *);
+  void SetIncrement(ASTNode *);
+  void SetBody(ASTCompound *);
+
+  /// Optimization hints, written before loop.
+  const LoopHints &Hints() const;
+  void SetHints(LoopHints);
+
 private:
   ASTNode *mInit;
   ASTNode *mCondition;
   ASTNode *mIncrement;
   ASTCompound *mBody;
+  LoopHints mHints;
 };
 
 } // namespace weak
@@ -28,6 +28,7 @@ public:
 
   const std::string &Name() const;
   const std::vector<ASTNode *> &Args() const;
+  std::vector<ASTNode *> &Args();
 
 private:
   std::string mName;
@@ -36,11 +36,17 @@ public:
   const std::vector<ASTNode *> &Args() const;
   ASTCompound *Body() const;
 
+  /// Exported function can be called from other modules. Other functions
+  /// (except `main`) are visible only inside own module.
+  bool IsExported() const;
+  void SetExported(bool);
+
 private:
   DataType mReturnType;
   std::string mName;
   std::vector<ASTNode *> mArgs;
   ASTCompound *mBody;
+  bool mExported;
 };
 
 } // namespace weak
@@ -31,6 +31,10 @@ public:
   ASTCompound *ThenBody() const;
   ASTCompound *ElseBody() const;
 
+  void SetCondition(ASTNode *);
+  void SetThenBody(ASTCompound *);
+  void SetElseBody(ASTCompound *);
+
 private:
   ASTNode *mCondition;
   ASTCompound *mThenBody;
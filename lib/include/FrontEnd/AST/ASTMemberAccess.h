@@ -13,6 +13,7 @@
 
 namespace weak {
 
+class ASTStructDecl;
 class ASTSymbol;
 
 class ASTMemberAccess : public ASTNode {
@@ -30,10 +31,21 @@ public:
 
   ASTSymbol *Name() const;
   ASTNode *MemberDecl() const;
+  void SetMemberDecl(ASTNode *);
+
+  /// Structure, which member is accessed. Resolved by type analysis.
+  ASTStructDecl *StructDecl() const;
+  void SetStructDecl(ASTStructDecl *);
+
+  /// Position of accessed member in declaration of StructDecl().
+  unsigned MemberIndex() const;
+  void SetMemberIndex(unsigned);
 
 private:
   ASTSymbol *mName;
   ASTNode *mMemberDecl;
+  ASTStructDecl *mStructDecl;
+  unsigned mMemberIndex;
 };
 
 } // namespace weak
@@ -21,6 +21,8 @@ public:
 
   ASTNode *Operand() const;
 
+  void SetOperand(ASTNode *);
+
 private:
   ASTNode *mOperand;
 };
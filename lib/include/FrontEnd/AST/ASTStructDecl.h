@@ -27,6 +27,7 @@ public:
   void Accept(ASTVisitor *) override;
 
   const std::vector<ASTNode *> &Decls() const;
+  std::vector<ASTNode *> &Decls();
   const std::string &Name() const;
 
 private:
@@ -8,6 +8,7 @@
 #define WEAK_COMPILER_FRONTEND_AST_AST_VAR_DECL_H
 
 #include "FrontEnd/AST/ASTNode.h"
+#include "FrontEnd/AST/ParamMode.h"
 #include "FrontEnd/Lex/DataType.h"
 #include <string>
 
@@ -41,11 +42,18 @@ public:
   const std::string &TypeName() const;
   ASTNode *Body() const;
 
+  void SetBody(ASTNode *);
+
+  /// How structure is passed, if it is function parameter.
+  ParamMode Mode() const;
+  void SetMode(ParamMode);
+
 private:
   weak::DataType mDataType;
   std::string mTypeName;
   std::string mName;
   ASTNode *mBody;
+  ParamMode mMode;
 };
 
 } // namespace weak
@@ -8,6 +8,7 @@
 #define WEAK_COMPILER_FRONTEND_AST_AST_WHILE_H
 
 #include "FrontEnd/AST/ASTNode.h"
+#include "FrontEnd/AST/LoopHints.h"
 
 namespace weak {
 
@@ -29,9 +30,17 @@ public:
   ASTNode *Condition() const;
   ASTCompound *Body() const;
 
+  void SetCondition(ASTNode *);
+  void SetBody(ASTCompound *);
+
+  /// Optimization hints, written before loop.
+  const LoopHints &Hints() const;
+  void SetHints(LoopHints);
+
 private:
   ASTNode *mCondition;
   ASTCompound *mBody;
+  LoopHints mHints;
 };
 
 } // namespace weak
@@ -0,0 +1,54 @@
+/* LoopHints.h - Loop transformation hints, attached to loop statements.
+ * Copyright (C) 2022 epoll-reactor <glibcxx.chrono@gmail.com>
+ *
+ * This file is distributed under the MIT license.
+ */
+
+#ifndef WEAK_COMPILER_FRONTEND_AST_LOOP_HINTS_H
+#define WEAK_COMPILER_FRONTEND_AST_LOOP_HINTS_H
+
+#include <string>
+
+namespace weak {
+
+/// \brief Hints for optimizer, written before loop.
+///
+/// Supported forms are
+///   #unroll, #unroll(N), #unroll(full), #nounroll,
+///   #vectorize, #vectorize(width=N), #novectorize,
+///   #interleave(N).
+struct LoopHints {
+  enum UnrollMode {
+    UNROLL_DEFAULT,
+    UNROLL_ENABLE,
+    UNROLL_DISABLE,
+    UNROLL_FULL
+  };
+
+  enum VectorizeMode {
+    VECTORIZE_DEFAULT,
+    VECTORIZE_ENABLE,
+    VECTORIZE_DISABLE
+  };
+
+  UnrollMode Unroll{UNROLL_DEFAULT};
+  /// Requested unroll factor, 0 if not given.
+  unsigned UnrollCount{0U};
+
+  VectorizeMode Vectorize{VECTORIZE_DEFAULT};
+  /// Requested vector width, 0 if not given.
+  unsigned VectorizeWidth{0U};
+
+  /// Requested interleave count, 0 if not given.
+  unsigned InterleaveCount{0U};
+
+  /// Whether no hints were given.
+  bool Empty() const;
+
+  /// Get hints in the same form, as they are written in the source.
+  std::string ToString() const;
+};
+
+} // namespace weak
+
+#endif // WEAK_COMPILER_FRONTEND_AST_LOOP_HINTS_H
\ No newline at end of file
@@ -0,0 +1,30 @@
+/* ParamMode.h - How function parameter is passed.
+ * Copyright (C) 2022 epoll-reactor <glibcxx.chrono@gmail.com>
+ *
+ * This file is distributed under the MIT license.
+ */
+
+#ifndef WEAK_COMPILER_FRONTEND_AST_PARAM_MODE_H
+#define WEAK_COMPILER_FRONTEND_AST_PARAM_MODE_H
+
+namespace weak {
+
+/// Mode of array or structure parameter. Scalars are always copied.
+enum ParamMode {
+  /// No explicit mode. Arrays are passed as pointer to first element,
+  /// structures are copied.
+  PARAM_DEFAULT,
+  /// Read-only reference.
+  PARAM_IN,
+  /// Mutable reference.
+  PARAM_INOUT,
+  /// Mutable reference, memory of which is not accessible through
+  /// other parameters.
+  PARAM_RESTRICT
+};
+
+const char *ParamModeToString(ParamMode);
+
+} // namespace weak
+
+#endif // WEAK_COMPILER_FRONTEND_AST_PARAM_MODE_H
\ No newline at end of file
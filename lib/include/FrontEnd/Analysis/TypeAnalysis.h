@@ -11,6 +11,7 @@
 #include "FrontEnd/Analysis/Analysis.h"
 #include "FrontEnd/Lex/DataType.h"
 #include "FrontEnd/Lex/TokenType.h"
+#include <unordered_map>
 
 namespace weak {
 
@@ -45,6 +46,26 @@ namespace weak {
 ///     <th>mem[1] | mem[var]</th>
 ///     <td>Integer as array index.</td>
 ///   </tr>
+///   <tr>
+///     <th>int mem[10][10], mem[10][0]</th>
+///     <td>Literal index is in bounds of its dimension.</td>
+///   </tr>
+///   <tr>
+///     <th>void f(in int mem[10]) { mem[0] = 1; }</th>
+///     <td>Read-only parameter is not modified or passed as mutable.</td>
+///   </tr>
+///   <tr>
+///     <th>void f(restrict int a[10], int b[10]) {}, f(x, x)</th>
+///     <td>Restrict argument is not passed twice.</td>
+///   </tr>
+///   <tr>
+///     <th>void f(inout int mem[10]) {}, f(x)</th>
+///     <td>Reference argument is variable of same or greater size.</td>
+///   </tr>
+///   <tr>
+///     <th>s.a | s.nested.b</th>
+///     <td>Member is declared in structure. Resolves member index.</td>
+///   </tr>
 /// </table>
 class TypeAnalysis : public Analysis {
 public:
@@ -70,6 +91,9 @@ private:
   void Visit(ASTArrayAccess *) override;
   void Visit(ASTSymbol *) override;
 
+  void Visit(ASTStructDecl *) override;
+  void Visit(ASTMemberAccess *) override;
+
   void Visit(ASTFunctionDecl *) override;
   void Visit(ASTFunctionPrototype *) override;
   void Visit(ASTFunctionCall *) override;
@@ -80,11 +104,27 @@ private:
   template <typename ASTFun>
   void CallArgumentsAnalysis(ASTNode *Decl, const std::vector<ASTNode *> &Args);
 
+  /// Check argument, passed to array or structure parameter.
+  void ReferenceArgumentAnalysis(
+    ASTNode                      *DeclArg,
+    ASTNode                      *CallArg,
+    const std::vector<ASTNode *> &CallArgs
+  );
+
+  /// Forbid modification of memory, designated by read-only parameter.
+  void ReadOnlyParamAnalysis(ASTNode *Stmt);
+
+  /// Resolve member index of access to Struct and all nested accesses.
+  void MemberAccessAnalysis(ASTStructDecl *Struct, ASTMemberAccess *Stmt);
+
   /// Analyzed root AST node.
   ASTNode *mRoot;
 
   ASTStorage mStorage;
 
+  /// Global structure declarations.
+  std::unordered_map<std::string, ASTStructDecl *> mStructs;
+
   DataType mLastDataType;
   DataType mLastReturnDataType;
 };
@@ -17,11 +17,15 @@ enum TokenType {
   TOK_CONTINUE,
   TOK_DO,
   TOK_ELSE,
+  TOK_EXPORT,
   TOK_FALSE,
   TOK_FLOAT,
   TOK_FOR,
   TOK_IF,
+  TOK_IN,
+  TOK_INOUT,
   TOK_INT,
+  TOK_RESTRICT,
   TOK_RETURN,
   TOK_STRING,
   TOK_TRUE,
@@ -72,6 +76,7 @@ enum TokenType {
   TOK_COMMA,               // ,
   TOK_SEMICOLON,           // ;
   TOK_NOT,                 // !
+  TOK_HASH,                // #
   TOK_OPEN_BOX_BRACKET,    // [
   TOK_CLOSE_BOX_BRACKET,   // ]
   TOK_OPEN_CURLY_BRACKET,  // {
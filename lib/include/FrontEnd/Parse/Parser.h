@@ -8,6 +8,7 @@
 #define WEAK_COMPILER_FRONTEND_PARSE_PARSER_H
 
 #include "FrontEnd/AST/ASTCompound.h"
+#include "FrontEnd/AST/LoopHints.h"
 #include "FrontEnd/Lex/DataType.h"
 #include "FrontEnd/Lex/Token.h"
 #include <memory>
@@ -73,9 +74,13 @@ private:
   /// < type > < id > | < type > < id > [ < integral-literal > ].
   ASTNode *ParseDeclWithoutInitializer();
 
-  /// ( (< type > < id > ,?)* ).
+  /// ( (< parameter > ,?)* ).
   std::vector<ASTNode *> ParseParameterList();
 
+  /// < mode >? < type > < id > | < mode >? < type > < id > [ < integral-literal > ],
+  /// where mode is `in`, `inout` or `restrict`.
+  ASTNode *ParseParameter();
+
   /// { < iteration-stmt >* }.
   ASTCompound *ParseBlock();
 
@@ -92,6 +97,15 @@ private:
   /// For, while or do-while statement.
   ASTNode *ParseIterationStmt();
 
+  /// Loop, preceded by optimization hints like `#unroll(4)`.
+  ASTNode *ParseHintedIterationStmt();
+
+  /// Sequence of `#hint` or `#hint(argument)`.
+  LoopHints ParseLoopHints();
+
+  /// Positive integer argument of loop hint.
+  unsigned ParseLoopHintCount();
+
   ASTNode *ParseFor();
 
   ASTNode *ParseWhile();
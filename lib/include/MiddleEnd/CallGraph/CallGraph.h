@@ -0,0 +1,60 @@
+/* CallGraph.h - Graph of calls between functions.
+ * Copyright (C) 2022 epoll-reactor <glibcxx.chrono@gmail.com>
+ *
+ * This file is distributed under the MIT license.
+ */
+
+#ifndef WEAK_COMPILER_MIDDLE_END_CALL_GRAPH_H
+#define WEAK_COMPILER_MIDDLE_END_CALL_GRAPH_H
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace weak {
+
+class ASTNode;
+
+/// \brief Graph of direct calls between top-level functions.
+///
+/// Nodes are function declarations and prototypes, placed in root compound
+/// statement. Edge A -> B means that body of A contains call to B.
+class CallGraph {
+public:
+  CallGraph(ASTNode *Root);
+
+  /// All functions and prototypes in declaration order.
+  const std::vector<std::string> &Functions() const;
+
+  /// Get declaration (function or prototype) by name or null, if not found.
+  ASTNode *Decl(std::string_view Name) const;
+
+  /// Get functions, called directly from given one, without duplicates.
+  const std::vector<std::string> &Callees(std::string_view Name) const;
+
+  /// Get all functions, transitively called from any of given roots,
+  /// including roots themselves.
+  std::unordered_set<std::string> Reachable(const std::vector<std::string> &Roots) const;
+
+  /// Get functions, that can be called from outside of module: `main` and
+  /// exported definitions.
+  std::vector<std::string> EntryPoints() const;
+
+  /// Check if function definition can be called from outside of module.
+  static bool IsEntryPoint(ASTNode *Decl);
+
+private:
+  struct Node {
+    ASTNode *Decl{nullptr};
+    std::vector<std::string> Callees;
+  };
+
+  std::vector<std::string> mFunctions;
+  std::unordered_map<std::string, Node> mNodes;
+};
+
+} // namespace weak
+
+#endif // WEAK_COMPILER_MIDDLE_END_CALL_GRAPH_H
\ No newline at end of file
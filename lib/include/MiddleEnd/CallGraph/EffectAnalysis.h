@@ -0,0 +1,74 @@
+/* EffectAnalysis.h - Interprocedural analysis of function side effects.
+ * Copyright (C) 2022 epoll-reactor <glibcxx.chrono@gmail.com>
+ *
+ * This file is distributed under the MIT license.
+ */
+
+#ifndef WEAK_COMPILER_MIDDLE_END_EFFECT_ANALYSIS_H
+#define WEAK_COMPILER_MIDDLE_END_EFFECT_ANALYSIS_H
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace weak {
+
+class ASTNode;
+
+/// What function does with memory, passed by pointer parameter (array,
+/// string or structure). Meaningless for scalar parameters.
+struct ParamEffects {
+  bool Read{false};
+  bool Written{false};
+  /// Pointer may outlive the call, f.e. if passed to external function.
+  bool Captured{false};
+};
+
+/// Summary of observable function behaviour. Memory of local variables
+/// is not observable, so it is not considered.
+struct FunctionEffects {
+  /// Memory, pointed by parameters.
+  bool ReadsArgMem{false};
+  bool WritesArgMem{false};
+  /// Global or unknown memory.
+  bool ReadsOtherMem{false};
+  bool WritesOtherMem{false};
+  /// Calls external function, that can throw.
+  bool MayUnwind{false};
+  /// Contains loops, traps or recursion.
+  bool MayNotReturn{false};
+  /// Can be called again before returning.
+  bool MayRecurse{false};
+  std::vector<ParamEffects> Params;
+
+  /// Does not access any observable memory.
+  bool ReadNone() const;
+  /// Does not write any observable memory.
+  bool ReadOnly() const;
+  /// Accesses only memory, pointed by parameters.
+  bool ArgMemOnly() const;
+};
+
+/// \brief Interprocedural side effect analysis.
+///
+/// Computes local effects of each function body and propagates them over
+/// call graph until fixed point. External functions (prototypes without
+/// definition) are assumed to do anything.
+class EffectAnalysis {
+public:
+  /// \param TrapsOnOutOfRange true if code is generated with bounds checks,
+  ///                          so array accesses not proven to be in bounds
+  ///                          can terminate program.
+  EffectAnalysis(ASTNode *Root, bool TrapsOnOutOfRange);
+
+  /// Get effects of function with given name or null, if not found.
+  const FunctionEffects *Effects(std::string_view Name) const;
+
+private:
+  std::unordered_map<std::string, FunctionEffects> mEffects;
+};
+
+} // namespace weak
+
+#endif // WEAK_COMPILER_MIDDLE_END_EFFECT_ANALYSIS_H
\ No newline at end of file
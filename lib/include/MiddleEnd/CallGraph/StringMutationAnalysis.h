@@ -0,0 +1,37 @@
+/* StringMutationAnalysis.h - Detect string variables, that need own copy.
+ * Copyright (C) 2022 epoll-reactor <glibcxx.chrono@gmail.com>
+ *
+ * This file is distributed under the MIT license.
+ */
+
+#ifndef WEAK_COMPILER_MIDDLE_END_STRING_MUTATION_ANALYSIS_H
+#define WEAK_COMPILER_MIDDLE_END_STRING_MUTATION_ANALYSIS_H
+
+#include <unordered_set>
+
+namespace weak {
+
+class ASTNode;
+class ASTVarDecl;
+class EffectAnalysis;
+
+/// \brief Find local string variables, which contents may be modified.
+///
+/// String variable initialized with literal initially points to constant
+/// data and needs copy on stack only if it is written by index, passed
+/// to function, that writes or captures its parameter, or its pointer
+/// escapes in any other way (assigned to another variable, returned).
+class StringMutationAnalysis {
+public:
+  StringMutationAnalysis(ASTNode *Root, const EffectAnalysis &Effects);
+
+  /// Declarations of string variables, that need copy of literal.
+  const std::unordered_set<const ASTVarDecl *> &Mutated() const;
+
+private:
+  std::unordered_set<const ASTVarDecl *> mMutated;
+};
+
+} // namespace weak
+
+#endif // WEAK_COMPILER_MIDDLE_END_STRING_MUTATION_ANALYSIS_H
\ No newline at end of file
@@ -8,13 +8,44 @@
 #define WEAK_COMPILER_MIDDLE_END_CODEGEN_H
 
 #include "FrontEnd/AST/ASTVisitor.h"
+#include "MiddleEnd/CodeGen/DebugInfoBuilder.h"
+#include "MiddleEnd/CodeGen/SSABuilder.h"
 #include "MiddleEnd/Storage/Storage.h"
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
+#include <unordered_set>
 
 namespace weak {
 
+class ASTArrayDecl;
+class ASTVarDecl;
+class EffectAnalysis;
+struct LoopHints;
+
+namespace ir {
+class Module;
+} // namespace ir
+
+/// Options, that control generated code.
+struct CodeGenOptions {
+  /// Emit runtime check for every array index, not proven to be in bounds.
+  /// Program is aborted with trap instruction if index is out of range.
+  bool BoundsCheck{false};
+  /// Emit DWARF metadata, describing functions, variables and source
+  /// locations.
+  bool DebugInfo{false};
+  /// Path to source file, referenced from debug info and profiles.
+  std::string SourcePath;
+  /// Functions, already lowered to Weak IR and optimized there. Their
+  /// bodies are emitted from Weak IR instead of AST and have no debug info.
+  const ir::Module *WeakIR{nullptr};
+  /// Functions from WeakIR are compiled by native back end to separate
+  /// object, so only declare them. All other functions get external
+  /// linkage and C calling convention to be callable from that object.
+  bool WeakIRDeclarationsOnly{false};
+};
+
 /// \brief LLVM IR generator.
 ///
 /// \note Requires analyzed by weak::Sema AST.
@@ -22,7 +53,7 @@ namespace weak {
 /// Implemented as AST visitor because it still does not operates on CFG.
 class CodeGen : private ASTVisitor {
 public:
-  CodeGen(ASTNode *Root);
+  CodeGen(ASTNode *Root, CodeGenOptions Options = CodeGenOptions());
 
   /// Convert AST to LLVM IR starting from root node (usually CompoundStmt).
   void CreateCode();
@@ -53,8 +84,8 @@ private:
   void Visit(ASTUnary *) override;
 
   // Inside-loop statements.
-  void Visit(ASTBreak *) override {}
-  void Visit(ASTContinue *) override {}
+  void Visit(ASTBreak *) override;
+  void Visit(ASTContinue *) override;
 
   // Loop statements.
   void Visit(ASTFor *) override;
@@ -81,10 +112,86 @@ private:
   void Visit(ASTReturn *) override;
   void Visit(ASTMemberAccess *) override;
 
+  /// Attach memory, unwinding and recursion attributes to generated functions
+  /// and their pointer parameters, using interprocedural effect analysis.
+  void AddFunctionAttributes(const EffectAnalysis &);
+
+  /// Attach location of AST node to instructions, emitted next.
+  void EmitLocation(ASTNode *);
+
+  /// Get pointer to constant with contents of literal. Equal literals
+  /// share one constant.
+  llvm::Constant *EmitStringLiteral(const std::string &Value);
+
+  /// Check if index is less than dimension size and jump to trap block
+  /// otherwise. Negative indices are treated as large unsigned numbers.
+  void EmitBoundsCheck(llvm::Value *Index, unsigned DimensionSize);
+
+  /// Evaluate expression and load array element if it designates one.
+  llvm::Value *EmitValue(ASTNode *);
+
+  /// Compute address of structure member, following nested accesses
+  /// by member indices, resolved during type analysis.
+  llvm::Value *EmitMemberPtr(ASTMemberAccess *);
+
+  /// Create LLVM type for structure and all structures, nested in it.
+  llvm::StructType *EmitStructType(ASTStructDecl *, const std::string &Name);
+
+  /// Get current value of scalar variable or pointer to variable in memory.
+  llvm::Value *ReadVariable(const std::string &Name);
+
+  /// Assign value to variable, either in memory or in SSA register.
+  void WriteVariable(const std::string &Name, llvm::Value *V);
+
+  /// Create stack slot in entry block of current function, so it is
+  /// allocated once per call, and mark beginning of its lifetime at
+  /// current position.
+  llvm::AllocaInst *EmitStackSlot(llvm::Type *Ty);
+
+  /// \return Declaration of array, visible at current point, or null
+  ///         if there is no one, like for strings.
+  ASTArrayDecl *LookupArrayDecl(const std::string &Name) const;
+
+  /// Begin new scope of variables.
+  void StartScope();
+
+  /// Terminate scope and mark end of lifetime of all stack slots
+  /// declared inside, so their memory can be reused by other scopes.
+  void EndScope();
+
+  /// Mark end of lifetime of stack slots of all scopes, deeper than given
+  /// depth of mStorage. Emitted on exits from scopes by break, continue
+  /// and return, before the branch.
+  void EmitLifetimeEnds(unsigned Depth);
+
+  /// Convert scalar to i1 by comparing it with zero.
+  llvm::Value *EmitBoolCast(llvm::Value *);
+
+  /// Emit jump to one of targets, depending on condition. `&&` and `||` are
+  /// lowered to control flow, so right operand is evaluated only if needed.
+  void EmitBranchOnCondition(ASTNode *Cond, llvm::BasicBlock *TrueBB, llvm::BasicBlock *FalseBB);
+
+  /// Emit short-circuit `&&` or `||`, which result is used as value.
+  llvm::Value *EmitLogicalValue(ASTBinary *);
+
+  /// Create distinct `llvm.loop` node, identifying loop, with
+  /// `llvm.loop.unroll.*` and `llvm.loop.vectorize.*` properties for hints.
+  llvm::MDNode *CreateLoopID(const LoopHints &);
+
+  /// Mark all back edges of loop with given `llvm.loop` node.
+  void AttachLoopID(llvm::BasicBlock *HeaderBB, llvm::BasicBlock *PreheaderBB, llvm::MDNode *LoopID);
+
+  /// Emit branch unless current block is already terminated (by return).
+  void EmitBranch(llvm::BasicBlock *Target);
+
   /// Analyzed root AST node.
   ASTNode *mRoot;
-  /// Variables pool.
+  /// What and how to generate.
+  CodeGenOptions mOptions;
+  /// Variables, that live in memory.
   Storage mStorage;
+  /// Scalar variables, that live in SSA registers.
+  SSABuilder mSSA;
   /// Consequence of using visitor pattern, since we cannot return anything from
   /// visit functions.
   llvm::Value *mLastInstr;
@@ -95,9 +202,32 @@ private:
   /// LLVM stuff.
   llvm::IRBuilder<> mIRBuilder;
 
-  using StructVarName = std::string;
-  using TypeName = std::string;
-  std::unordered_map<StructVarName, TypeName> mStructVarsStorage;
+  using ArrayName = std::string;
+  /// Declarations of arrays, giving dimensions for bounds checks, by
+  /// scope. Pushed and popped together with scopes of mStorage, so other
+  /// functions and sibling blocks do not see them.
+  std::vector<std::unordered_map<ArrayName, ASTArrayDecl *>> mArraysStorage;
+  /// Jump targets of loop, being generated.
+  struct LoopContext {
+    /// Where `continue` jumps to. Either header or increment block.
+    llvm::BasicBlock *ContinueBB;
+    /// Where `break` jumps to.
+    llvm::BasicBlock *BreakBB;
+    /// Depth of mStorage outside of loop body. Scopes, deeper than this,
+    /// are left by `break` and `continue`.
+    unsigned Depth;
+  };
+  /// Innermost loop is on top.
+  std::vector<LoopContext> mLoops;
+  /// Block with trap, shared between all bounds checks in current function.
+  llvm::BasicBlock *mBoundsTrapBB;
+  /// Module-level pool of string literals, keyed by contents.
+  std::unordered_map<std::string, llvm::GlobalVariable *> mStringPool;
+  /// String variables, that need own copy of literal on stack. Other
+  /// string variables point directly to pooled constant.
+  std::unordered_set<const ASTVarDecl *> mMutatedStrings;
+  /// Null if debug info is not requested.
+  std::unique_ptr<DebugInfoBuilder> mDebugInfo;
 };
 
 } // namespace weak
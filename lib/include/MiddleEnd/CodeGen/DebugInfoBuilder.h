@@ -0,0 +1,82 @@
+/* DebugInfoBuilder.h - Helper class to emit DWARF metadata for LLVM IR.
+ * Copyright (C) 2022 epoll-reactor <glibcxx.chrono@gmail.com>
+ *
+ * This file is distributed under the MIT license.
+ */
+
+#ifndef WEAK_COMPILER_MIDDLE_END_DEBUG_INFO_BUILDER_H
+#define WEAK_COMPILER_MIDDLE_END_DEBUG_INFO_BUILDER_H
+
+#include "FrontEnd/Lex/DataType.h"
+#include "llvm/IR/DIBuilder.h"
+#include "llvm/IR/DebugLoc.h"
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace weak {
+
+class ASTNode;
+class ASTFunctionDecl;
+class ASTStructDecl;
+
+/// \brief Helper class to emit DWARF metadata for LLVM IR.
+///
+/// Describes compile unit, functions, source locations of AST nodes and
+/// variables. Variables, living in memory, are described with
+/// llvm.dbg.declare, SSA values with llvm.dbg.value on every write.
+class DebugInfoBuilder {
+public:
+  DebugInfoBuilder(llvm::Module &M, std::string_view SourcePath);
+
+  /// Create subprogram for function definition and make it current scope.
+  void StartFunction(llvm::Function *F, ASTFunctionDecl *Decl);
+
+  /// Describe structure type. Must be called before declaration of
+  /// variables of this type.
+  void AddStruct(ASTStructDecl *Decl, llvm::StructType *Type);
+
+  /// Get location of AST node in current function.
+  llvm::DebugLoc Location(ASTNode *) const;
+
+  /// Describe variable or parameter (if ArgNo is not zero) declaration.
+  ///
+  /// \param Storage Stack slot, byval parameter or initial SSA value.
+  void DeclareVariable(
+    ASTNode           *Decl,
+    llvm::Value       *Storage,
+    llvm::BasicBlock  *BB,
+    unsigned           ArgNo = 0
+  );
+
+  /// Describe new SSA value of variable, declared earlier.
+  void UpdateVariable(const std::string &Name, llvm::Value *V, llvm::BasicBlock *BB);
+
+  /// Resolve all temporary metadata. Must be called once after all
+  /// functions are generated.
+  void Finalize();
+
+private:
+  llvm::DIType *ResolveType(ASTNode *Decl);
+  llvm::DIType *ResolveType(DataType T);
+  /// Type of parameter or SSA value. Unlike ResolveType, arrays and
+  /// structures passed by reference are pointers.
+  llvm::DIType *ResolveParamType(ASTNode *Decl);
+  llvm::DICompositeType *ResolveStruct(ASTStructDecl *, llvm::StructType *, const std::string &Name);
+
+  llvm::Module &mIRModule;
+  llvm::DIBuilder mDIBuilder;
+  llvm::DIFile *mFile;
+  llvm::DICompileUnit *mCompileUnit;
+  /// Current function.
+  llvm::DISubprogram *mScope;
+  /// Structure name -> its description.
+  std::unordered_map<std::string, llvm::DICompositeType *> mStructs;
+  /// Variable name -> its description in current function. Names are
+  /// unique at any point of function, so scopes are not tracked.
+  std::unordered_map<std::string, llvm::DILocalVariable *> mVariables;
+};
+
+} // namespace weak
+
+#endif // WEAK_COMPILER_MIDDLE_END_DEBUG_INFO_BUILDER_H
\ No newline at end of file
@@ -0,0 +1,76 @@
+/* SSABuilder.h - On-the-fly construction of SSA form.
+ * Copyright (C) 2022 epoll-reactor <glibcxx.chrono@gmail.com>
+ *
+ * This file is distributed under the MIT license.
+ */
+
+#ifndef WEAK_COMPILER_MIDDLE_END_SSA_BUILDER_H
+#define WEAK_COMPILER_MIDDLE_END_SSA_BUILDER_H
+
+#include "llvm/IR/ValueHandle.h"
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace llvm {
+class BasicBlock;
+class PHINode;
+class Type;
+class Value;
+} // namespace llvm
+
+namespace weak {
+
+/// \brief Builder of SSA values for scalar variables.
+///
+/// Implements algorithm from "Simple and Efficient Construction of Static
+/// Single Assignment Form" by Braun et al. Each assignment records value as
+/// current definition of variable in block, each use looks for definition
+/// through predecessors, placing φ-nodes where control flow joins. Blocks
+/// should be sealed when all their predecessors are emitted; until then
+/// φ-nodes are left incomplete. Trivial φ-nodes are removed immediately.
+///
+/// Variables are identified by name. It is correct, because names cannot be
+/// redeclared in nested scopes and each use is dominated by declaration.
+class SSABuilder {
+public:
+  /// Forget everything about previous function.
+  void Reset();
+
+  /// Start new variable with given type.
+  void Declare(std::string_view Name, llvm::Type *Ty);
+
+  /// Whether variable is declared with Declare().
+  bool IsDeclared(std::string_view Name) const;
+
+  /// Set value of variable at the end of block.
+  void Write(std::string_view Name, llvm::BasicBlock *BB, llvm::Value *V);
+
+  /// Get value of variable at the end of block.
+  llvm::Value *Read(std::string_view Name, llvm::BasicBlock *BB);
+
+  /// Mark that all predecessors of block are known and complete
+  /// φ-nodes, created before.
+  void Seal(llvm::BasicBlock *BB);
+
+private:
+  llvm::Value *ReadRecursive(const std::string &Name, llvm::BasicBlock *BB);
+  llvm::Value *AddPhiOperands(const std::string &Name, llvm::PHINode *Phi);
+  llvm::Value *TryRemoveTrivialPhi(llvm::PHINode *Phi);
+  llvm::PHINode *CreatePhi(const std::string &Name, llvm::BasicBlock *BB);
+
+  using Definitions = std::unordered_map<llvm::BasicBlock *, llvm::WeakTrackingVH>;
+
+  /// Variable -> its value in each block. Handles follow replacement
+  /// of removed φ-nodes.
+  std::unordered_map<std::string, Definitions> mCurrentDef;
+  std::unordered_map<std::string, llvm::Type *> mTypes;
+  std::unordered_map<llvm::BasicBlock *, std::vector<std::pair<std::string, llvm::PHINode *>>> mIncompletePhis;
+  std::unordered_set<llvm::BasicBlock *> mSealedBlocks;
+};
+
+} // namespace weak
+
+#endif // WEAK_COMPILER_MIDDLE_END_SSA_BUILDER_H
\ No newline at end of file
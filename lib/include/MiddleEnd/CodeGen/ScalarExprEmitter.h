@@ -26,6 +26,8 @@ public:
   /// \note
   ///         - Set of supported operations is depend on given L and R types.
   ///         - Requires same LLVM types.
+  ///         - `&&` and `||` are not supported, since they need control
+  ///           flow and are lowered by CodeGen.
   /// \param  T         Operation to be emitted.
   /// \param  L         Left operand.
   /// \param  R         Right operand.
@@ -7,33 +7,112 @@
 #ifndef WEAK_COMPILER_MIDDLE_END_DRIVER_H
 #define WEAK_COMPILER_MIDDLE_END_DRIVER_H
 
+#include "MiddleEnd/Optimizers/Optimizers.h"
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace llvm {
+class MemoryBuffer;
 class Module;
+class TargetMachine;
 } // namespace llvm
 
 namespace weak {
 
+/// Options, that control emitted machine code.
+struct DriverOptions {
+  /// Do not use frame pointer register for other purposes, so profilers
+  /// and debuggers can unwind stack without DWARF call frame information.
+  bool KeepFramePointers{false};
+  /// Optimization level of instruction selection, scheduling and register
+  /// allocation.
+  WeakOptimizationLevel OptLvl{O0};
+  /// Objects, linked into executable together with compiled LLVM module.
+  std::vector<std::string> ExtraObjects;
+  /// Processor to generate code for. "native" means host processor with
+  /// all its features.
+  std::string CPU{"generic"};
+  /// Processor to tune code for without changing instruction set.
+  std::string TuneCPU;
+  /// Comma-separated target features, like "+avx2,-fma".
+  std::string Features;
+  /// Link-time optimization, module is prepared for.
+  LTOKind LTO{LTOKind::None};
+  /// Module is split to this many partitions, which are compiled to
+  /// machine code in parallel.
+  unsigned CodeGenThreads{1U};
+};
+
 /// Builder of executable code from LLVM IR.
 class Driver {
 public:
-  Driver(llvm::Module &M, std::string_view OutPath);
+  /// Get target machine for host and set module data layout, target
+  /// triple and target attributes of functions, so IR optimizations can
+  /// rely on them.
+  Driver(llvm::Module &M, std::string_view OutPath, DriverOptions Options = DriverOptions());
 
-  /// Compile LLVM IR to object code and write it to output file.
-  ///
-  /// \note In debugging purposes this function uses clang to somehow emit
-  ///       executable file.
-  /// \todo Judge how properly do emitting of binaries without bash stubs.
+  ~Driver();
+
+  /// Target, code is generated for.
+  llvm::TargetMachine &TargetMachine();
+
+  /// Compile LLVM IR to object code in memory and link it with extra
+  /// objects to output file by built-in linker. Module without function
+  /// definitions is not compiled.
   void Compile();
 
+  /// Compile LLVM IR to relocatable objects in memory without linking,
+  /// so objects of many translation units can be linked together. Extra
+  /// objects are not touched. With many code generation threads module
+  /// is split to partitions and its local functions become hidden.
+  ///
+  /// \return One object per partition or nothing, if module has no
+  ///         function definitions.
+  std::vector<std::unique_ptr<llvm::MemoryBuffer>> EmitObjects();
+
+  /// Emit LLVM bitcode in memory for link-time optimization. For ThinLTO
+  /// module summary is attached, so functions can be imported by other
+  /// modules. Buffer is named by path, given to constructor, so paths
+  /// of modules, optimized together, should be unique.
+  std::unique_ptr<llvm::MemoryBuffer> EmitBitcode();
+
+  /// Compile LLVM IR together with extra objects in memory by ORC JIT
+  /// and call main. Calls to undefined functions, such as strcmp, are
+  /// resolved against host process.
+  ///
+  /// \return Exit code, as shell reports it: value returned by main
+  ///         or 128 + signal number if program trapped on SIGILL or
+  ///         SIGFPE.
+  int Run();
+
 private:
   /// Reference to global LLVM stuff.
   llvm::Module &mIRModule;
   /// Reference to global LLVM stuff.
   std::string mOutPath;
+  /// How to emit code.
+  DriverOptions mOptions;
+  /// Code generator for host, shared by all drivers of thread with same
+  /// options.
+  llvm::TargetMachine *mTargetMachine;
 };
 
+/// \return Triple, processors and features, code is generated for, with
+///         "native" resolved to host processor.
+std::string TargetDescription(const DriverOptions &Options);
+
+/// \brief Optimize bitcode modules of all translation units together and
+///        compile them to objects in memory.
+///
+/// Only main is kept visible, other functions are internalized and can
+/// be inlined or removed across modules. ThinLTO back end jobs are run
+/// on all cores.
+std::vector<std::unique_ptr<llvm::MemoryBuffer>> LinkTimeOptimize(
+  const std::vector<std::unique_ptr<llvm::MemoryBuffer>> &Modules,
+  const DriverOptions                                    &Options
+);
+
 } // namespace weak
 
 #endif // WEAK_COMPILER_MIDDLE_END_DRIVER_H
\ No newline at end of file
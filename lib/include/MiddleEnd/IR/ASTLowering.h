@@ -0,0 +1,30 @@
+/* ASTLowering.h - Translation of AST to Weak IR.
+ * Copyright (C) 2022 epoll-reactor <glibcxx.chrono@gmail.com>
+ *
+ * This file is distributed under the MIT license.
+ */
+
+#ifndef WEAK_COMPILER_MIDDLE_END_IR_AST_LOWERING_H
+#define WEAK_COMPILER_MIDDLE_END_IR_AST_LOWERING_H
+
+#include "MiddleEnd/IR/IR.h"
+
+namespace weak {
+
+class ASTNode;
+
+/// \brief Translate function definitions from AST to Weak IR in SSA form.
+///
+/// Only functions, that operate on scalars and arrays of scalars, are
+/// lowered. Functions, which use strings, structures or loop hints, are
+/// not present in result and are left to CodeGen.
+///
+/// \param BoundsCheck Whether to emit runtime checks of array indices,
+///                    not proven to be in bounds.
+///
+/// \note Requires analyzed AST.
+ir::Module LowerToWeakIR(ASTNode *Root, bool BoundsCheck);
+
+} // namespace weak
+
+#endif // WEAK_COMPILER_MIDDLE_END_IR_AST_LOWERING_H
\ No newline at end of file
@@ -0,0 +1,49 @@
+/* Dominators.h - Dominator tree of Weak IR function.
+ * Copyright (C) 2022 epoll-reactor <glibcxx.chrono@gmail.com>
+ *
+ * This file is distributed under the MIT license.
+ */
+
+#ifndef WEAK_COMPILER_MIDDLE_END_IR_DOMINATORS_H
+#define WEAK_COMPILER_MIDDLE_END_IR_DOMINATORS_H
+
+#include "MiddleEnd/IR/IR.h"
+
+namespace weak::ir {
+
+/// \brief Dominator tree of reachable blocks.
+///
+/// Built with iterative algorithm from "A Simple, Fast Dominance Algorithm"
+/// by Cooper, Harvey and Kennedy. Dominance queries are answered in constant
+/// time using pre- and post-order numbers of tree nodes.
+class DominatorTree {
+public:
+  explicit DominatorTree(const Function &);
+
+  /// Immediate dominator, NoID for entry and unreachable blocks.
+  BlockID IDom(BlockID) const;
+
+  /// Blocks, immediately dominated by given one.
+  const std::vector<BlockID> &Children(BlockID) const;
+
+  /// Whether every path from entry to B goes through A. Each block
+  /// dominates itself.
+  bool Dominates(BlockID A, BlockID B) const;
+
+  bool IsReachable(BlockID) const;
+
+  /// Reachable blocks in reverse post-order of CFG.
+  const std::vector<BlockID> &Order() const;
+
+private:
+  std::vector<BlockID> mOrder;
+  std::vector<BlockID> mIDoms;
+  std::vector<std::vector<BlockID>> mChildren;
+  /// Numbers of nodes in depth-first walk of tree.
+  std::vector<uint32_t> mEnter;
+  std::vector<uint32_t> mLeave;
+};
+
+} // namespace weak::ir
+
+#endif // WEAK_COMPILER_MIDDLE_END_IR_DOMINATORS_H
\ No newline at end of file
@@ -0,0 +1,228 @@
+/* IR.h - Weak IR, mid-level three-address intermediate representation.
+ * Copyright (C) 2022 epoll-reactor <glibcxx.chrono@gmail.com>
+ *
+ * This file is distributed under the MIT license.
+ */
+
+#ifndef WEAK_COMPILER_MIDDLE_END_IR_IR_H
+#define WEAK_COMPILER_MIDDLE_END_IR_IR_H
+
+#include "llvm/ADT/SmallVector.h"
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace weak::ir {
+
+/// Index of instruction in Function::Instrs. Each instruction defines
+/// at most one value, so it is also identifier of value.
+using ValueID = uint32_t;
+/// Index of block in Function::Blocks.
+using BlockID = uint32_t;
+
+constexpr uint32_t NoID = std::numeric_limits<uint32_t>::max();
+
+enum class Type : uint8_t {
+  Void,
+  I1,
+  I8,
+  I32,
+  F32,
+  /// Address of array element.
+  Ptr
+};
+
+enum class Opcode : uint8_t {
+  /// Removed instruction, kept only to not renumber others.
+  Nop,
+  // Values, that do not belong to any block.
+  Const,
+  Param,
+  Undef,
+  // Integer arithmetic.
+  Add,
+  Sub,
+  Mul,
+  SDiv,
+  Shl,
+  AShr,
+  And,
+  Or,
+  Xor,
+  // Floating point arithmetic.
+  FAdd,
+  FSub,
+  FMul,
+  FDiv,
+  // Comparisons, giving I1.
+  ICmpEQ,
+  ICmpNE,
+  ICmpSLT,
+  ICmpSLE,
+  ICmpSGT,
+  ICmpSGE,
+  ICmpULT,
+  FCmpOEQ,
+  FCmpONE,
+  FCmpOLT,
+  FCmpOLE,
+  FCmpOGT,
+  FCmpOGE,
+  FCmpUNE,
+  // Conversions.
+  ZExt,
+  SExt,
+  UIToFP,
+  // Memory.
+  Alloca,
+  ElemAddr,
+  Load,
+  Store,
+  // The rest.
+  Phi,
+  Call,
+  // Terminators.
+  Br,
+  CondBr,
+  Ret,
+  Trap,
+  Unreachable
+};
+
+/// \brief Single three-address instruction.
+///
+/// Meaning of immediate depends on opcode: value bits for Const, index of
+/// parameter for Param, count of elements for Alloca and index of callee
+/// in Module::Symbols for Call. Operands of Phi correspond to predecessors
+/// of its block in the same order. Targets of terminators are successors
+/// of their block, for CondBr the first one is taken if condition is true.
+struct Instr {
+  Opcode Op{Opcode::Nop};
+  /// Type of defined value, Void if there is no value.
+  Type Ty{Type::Void};
+  /// Type of array element for Alloca and ElemAddr.
+  Type ElemTy{Type::Void};
+  /// Block of instruction, NoID for constants and parameters.
+  BlockID Block{NoID};
+  uint64_t Imm{0U};
+  llvm::SmallVector<ValueID, 2> Ops;
+
+  /// Constant value, sign-extended from its type.
+  int64_t IntValue() const;
+  float FloatValue() const;
+};
+
+struct Block {
+  /// Instructions in execution order. φ-nodes go first, terminator is
+  /// the last one.
+  std::vector<ValueID> Instrs;
+  std::vector<BlockID> Preds;
+  std::vector<BlockID> Succs;
+  /// Removed block is kept only to not renumber others.
+  bool Removed{false};
+};
+
+/// \brief Function in SSA form.
+///
+/// All instructions and blocks are stored in contiguous arrays and refer
+/// to each other by index. Block 0 is the entry block.
+class Function {
+public:
+  Function(std::string Name, Type RetTy, std::vector<Type> ParamTypes);
+
+  const std::string &Name() const;
+  Type ReturnType() const;
+  const std::vector<ValueID> &Params() const;
+
+  std::vector<Instr> Instrs;
+  std::vector<Block> Blocks;
+  /// Function, that is not exported, is called only from its translation
+  /// unit.
+  bool Exported{true};
+
+  BlockID CreateBlock();
+
+  /// Append instruction to the end of block.
+  ValueID Append(BlockID BB, Instr I);
+
+  /// Insert instruction before terminator of block.
+  ValueID InsertBeforeTerminator(BlockID BB, Instr I);
+
+  /// Insert φ-node after other φ-nodes of block.
+  ValueID InsertPhi(BlockID BB, Type Ty);
+
+  /// Get constant of given type, creating it if not exists.
+  ValueID GetConst(Type Ty, int64_t Value);
+  ValueID GetFloatConst(float Value);
+  ValueID GetUndef(Type Ty);
+
+  /// Add CFG edge, also extending φ-nodes of target with undefined values.
+  void AddEdge(BlockID From, BlockID To);
+
+  /// Remove CFG edge together with corresponding φ-node operands.
+  void RemoveEdge(BlockID From, BlockID To);
+
+  /// Detach block from CFG and drop all its instructions.
+  void RemoveBlock(BlockID BB);
+
+  /// Unlink instruction from its block.
+  void Erase(ValueID V);
+
+  /// Move instruction before terminator of another block.
+  void Move(ValueID V, BlockID BB);
+
+  /// Replace every operand V with Replacements[V], if it is not NoID.
+  void ReplaceUses(const std::vector<ValueID> &Replacements);
+
+  ValueID Terminator(BlockID BB) const;
+
+private:
+  std::string mName;
+  Type mRetTy;
+  std::vector<ValueID> mParams;
+  /// (Type, value bits) -> constant.
+  std::map<std::pair<Type, uint64_t>, ValueID> mConsts;
+  std::map<Type, ValueID> mUndefs;
+};
+
+class Module {
+public:
+  /// Get or add name of function, callable from Weak IR.
+  uint32_t Symbol(const std::string &Name);
+
+  const std::string &SymbolName(uint32_t Index) const;
+
+  /// Get function with given name, or null if it is not lowered to Weak IR.
+  const Function *Find(const std::string &Name) const;
+
+  std::vector<Function> Functions;
+
+private:
+  std::vector<std::string> mSymbols;
+};
+
+/// Blocks, reachable from entry, in reverse post-order. Each block goes
+/// after its dominators.
+std::vector<BlockID> ReversePostOrder(const Function &);
+
+bool IsTerminator(Opcode);
+
+/// Whether instruction only computes value from operands and can be
+/// freely removed, duplicated or moved.
+bool IsPure(const Instr &);
+
+bool IsCommutative(Opcode);
+
+const char *OpcodeToString(Opcode);
+const char *TypeToString(Type);
+
+/// Print module in textual form. Values are renumbered in order of
+/// appearance and constants are printed inline.
+void Dump(const Module &, std::ostream &);
+
+} // namespace weak::ir
+
+#endif // WEAK_COMPILER_MIDDLE_END_IR_IR_H
\ No newline at end of file
@@ -0,0 +1,25 @@
+/* LLVMEmitter.h - Translation of Weak IR to LLVM IR.
+ * Copyright (C) 2022 epoll-reactor <glibcxx.chrono@gmail.com>
+ *
+ * This file is distributed under the MIT license.
+ */
+
+#ifndef WEAK_COMPILER_MIDDLE_END_IR_LLVM_EMITTER_H
+#define WEAK_COMPILER_MIDDLE_END_IR_LLVM_EMITTER_H
+
+#include "MiddleEnd/IR/IR.h"
+
+namespace llvm {
+class Function;
+} // namespace llvm
+
+namespace weak::ir {
+
+/// Create body of already declared LLVM function from Weak IR function.
+/// Callees are looked up by name in module of LLVM function, so they
+/// should be declared before.
+void EmitLLVMFunctionBody(const Module &, const Function &, llvm::Function *);
+
+} // namespace weak::ir
+
+#endif // WEAK_COMPILER_MIDDLE_END_IR_LLVM_EMITTER_H
\ No newline at end of file
@@ -0,0 +1,67 @@
+/* Passes.h - Optimization passes over Weak IR.
+ * Copyright (C) 2022 epoll-reactor <glibcxx.chrono@gmail.com>
+ *
+ * This file is distributed under the MIT license.
+ */
+
+#ifndef WEAK_COMPILER_MIDDLE_END_IR_PASSES_H
+#define WEAK_COMPILER_MIDDLE_END_IR_PASSES_H
+
+#include "MiddleEnd/IR/IR.h"
+#include <memory>
+#include <ostream>
+
+namespace weak::ir {
+
+/// Transformation of single function.
+class Pass {
+public:
+  virtual ~Pass() = default;
+
+  virtual const char *Name() const = 0;
+
+  /// Transform function and get count of changes made.
+  virtual unsigned Run(Function &) = 0;
+};
+
+/// Sparse conditional constant propagation (Wegman and Zadeck). Replaces
+/// values, proven to be constant, folds branches on them and removes
+/// blocks, that are never executed.
+std::unique_ptr<Pass> CreateSCCPPass();
+
+/// Dominator-based global value numbering. Removes pure computations and
+/// φ-nodes, which repeat already computed value on every path.
+std::unique_ptr<Pass> CreateGVNPass();
+
+/// Loop-invariant code motion. Hoists pure computations, which operands
+/// are defined outside of loop, to loop preheader.
+std::unique_ptr<Pass> CreateLICMPass();
+
+/// Dead code elimination. Removes instructions, which results do not
+/// contribute to stores, calls or control flow.
+std::unique_ptr<Pass> CreateDCEPass();
+
+/// Counts of changes made by each pass.
+struct PassStats {
+  std::vector<std::pair<const char *, unsigned>> Changes;
+
+  void Dump(std::ostream &) const;
+};
+
+class PassManager {
+public:
+  void Add(std::unique_ptr<Pass>);
+
+  /// Run passes in order of addition on every function of module.
+  PassStats Run(Module &);
+
+private:
+  std::vector<std::unique_ptr<Pass>> mPasses;
+};
+
+/// Run SCCP, GVN, LICM and DCE over module.
+PassStats RunDefaultPasses(Module &);
+
+} // namespace weak::ir
+
+#endif // WEAK_COMPILER_MIDDLE_END_IR_PASSES_H
\ No newline at end of file
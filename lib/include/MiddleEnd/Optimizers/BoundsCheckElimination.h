@@ -0,0 +1,43 @@
+/* BoundsCheckElimination.h - Proving array accesses to be in bounds.
+ * Copyright (C) 2022 epoll-reactor <glibcxx.chrono@gmail.com>
+ *
+ * This file is distributed under the MIT license.
+ */
+
+#ifndef WEAK_COMPILER_MIDDLE_END_BOUNDS_CHECK_ELIMINATION_H
+#define WEAK_COMPILER_MIDDLE_END_BOUNDS_CHECK_ELIMINATION_H
+
+#include <ostream>
+
+namespace weak {
+
+class ASTNode;
+
+/// Counters collected by bounds check elimination pass.
+struct BoundsCheckEliminationStats {
+  /// Array accesses, proven to be in bounds.
+  unsigned EliminatedChecks{0U};
+  /// Array accesses, that still need runtime check.
+  unsigned EmittedChecks{0U};
+
+  void Dump(std::ostream &) const;
+};
+
+/// \brief Mark array accesses, that never go out of declared bounds.
+///
+/// Computes intervals of index expressions, built from integer literals
+/// and induction variables of loops like
+/// \code
+///   for (int i = 0; i < 100; ++i) { ... }
+/// \endcode
+/// where variable is not changed in loop body, and marks accesses with all
+/// indices inside [0, dimension size) with ASTArrayAccess::SetInBounds(), so
+/// code generator does not emit runtime checks for them.
+///
+/// \note Requires analyzed AST. Should be run after constant folding to see
+///       propagated constants as literals.
+BoundsCheckEliminationStats RunBoundsCheckEliminationPass(ASTNode *Root);
+
+} // namespace weak
+
+#endif // WEAK_COMPILER_MIDDLE_END_BOUNDS_CHECK_ELIMINATION_H
\ No newline at end of file
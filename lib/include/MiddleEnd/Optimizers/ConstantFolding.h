@@ -0,0 +1,48 @@
+/* ConstantFolding.h - AST-level constant folding and propagation.
+ * Copyright (C) 2022 epoll-reactor <glibcxx.chrono@gmail.com>
+ *
+ * This file is distributed under the MIT license.
+ */
+
+#ifndef WEAK_COMPILER_MIDDLE_END_CONSTANT_FOLDING_H
+#define WEAK_COMPILER_MIDDLE_END_CONSTANT_FOLDING_H
+
+#include <ostream>
+
+namespace weak {
+
+class ASTNode;
+
+/// Counters collected by constant folding pass.
+struct ConstantFoldingStats {
+  /// Binary operators replaced by literals.
+  unsigned FoldedExprs{0U};
+  /// Variable uses replaced by literals.
+  unsigned PropagatedUses{0U};
+  /// Declarations of constant variables, that became unused after propagation.
+  unsigned RemovedDecls{0U};
+  /// If statements with constant condition.
+  unsigned SimplifiedBranches{0U};
+  /// Loops with constant false condition.
+  unsigned SimplifiedLoops{0U};
+
+  void Dump(std::ostream &) const;
+};
+
+/// \brief Fold constant expressions and propagate constants through AST.
+///
+/// Evaluates binary operators on integer, char, bool and float literals
+/// with the same semantics, as emitted LLVM IR has, replaces uses of
+/// never reassigned variables initialized with literals, removes such
+/// declarations and simplifies if statements and loops with constant
+/// conditions.
+///
+/// Operations with undefined or target-dependent result (like division by
+/// zero or too wide shifts) are left as is.
+///
+/// \note Requires analyzed AST.
+ConstantFoldingStats RunConstantFoldingPass(ASTNode *Root);
+
+} // namespace weak
+
+#endif // WEAK_COMPILER_MIDDLE_END_CONSTANT_FOLDING_H
\ No newline at end of file
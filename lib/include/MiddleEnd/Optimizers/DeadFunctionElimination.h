@@ -0,0 +1,38 @@
+/* DeadFunctionElimination.h - Removal of functions unreachable from main.
+ * Copyright (C) 2022 epoll-reactor <glibcxx.chrono@gmail.com>
+ *
+ * This file is distributed under the MIT license.
+ */
+
+#ifndef WEAK_COMPILER_MIDDLE_END_DEAD_FUNCTION_ELIMINATION_H
+#define WEAK_COMPILER_MIDDLE_END_DEAD_FUNCTION_ELIMINATION_H
+
+#include <ostream>
+
+namespace weak {
+
+class ASTNode;
+
+/// Counters collected by dead function elimination pass.
+struct DeadFunctionEliminationStats {
+  /// Functions kept for code generation.
+  unsigned ReachableFunctions{0U};
+  /// Function definitions and prototypes removed from AST.
+  unsigned RemovedFunctions{0U};
+
+  void Dump(std::ostream &) const;
+};
+
+/// \brief Remove functions, that cannot be called from program entry.
+///
+/// Builds call graph and removes from root compound statement all function
+/// declarations and prototypes, not reachable from `main` or exported
+/// functions. Removed functions are not lowered to LLVM IR at all. If there
+/// is no `main` function, nothing is removed.
+///
+/// \note Requires analyzed AST, so removed functions are still type-checked.
+DeadFunctionEliminationStats RunDeadFunctionEliminationPass(ASTNode *Root);
+
+} // namespace weak
+
+#endif // WEAK_COMPILER_MIDDLE_END_DEAD_FUNCTION_ELIMINATION_H
\ No newline at end of file
@@ -9,17 +9,42 @@
 
 namespace llvm {
 class Module;
+class TargetMachine;
 } // namespace llvm
 
 /// Global due to clEnumVal use.
-enum WeakOptimizationLevel { O0 = 0, O1, O2, O3 };
+enum WeakOptimizationLevel { O0 = 0, O1, O2, O3, Os, Oz };
 
 namespace weak {
 
+/// Kind of link-time optimization.
+enum class LTOKind {
+  /// Each module is optimized and compiled alone.
+  None,
+  /// All modules are merged to one and optimized together.
+  Full,
+  /// Modules are optimized in parallel, importing functions from each
+  /// other by module summaries.
+  Thin
+};
+
 /// Perform built-in LLVM optimizations of given level.
 ///
-/// \todo Implement own optimizations.
-void RunBuiltinLLVMOptimizationPass(llvm::Module &M, WeakOptimizationLevel OptLvl);
+/// Runs the same per-module pipeline, as clang does, including inliner
+/// and other interprocedural passes. If module is going to be optimized
+/// at link time, pre-link pipeline is run instead, that leaves most of
+/// inlining and all of vectorization to link step.
+///
+/// \param TM Target to query costs of instructions from. Generic costs
+///           are used if null.
+///
+/// \note Own optimizations are done on Weak IR, see MiddleEnd/IR/Passes.h.
+void RunBuiltinLLVMOptimizationPass(
+  llvm::Module          &M,
+  WeakOptimizationLevel  OptLvl,
+  llvm::TargetMachine   *TM = nullptr,
+  LTOKind                LTO = LTOKind::None
+);
 
 } // namespace weak
 
@@ -0,0 +1,71 @@
+/* ProfileGuidedOptimization.h - Instrumentation and use of execution profiles.
+ * Copyright (C) 2022 epoll-reactor <glibcxx.chrono@gmail.com>
+ *
+ * This file is distributed under the MIT license.
+ */
+
+#ifndef WEAK_COMPILER_MIDDLE_END_PROFILE_GUIDED_OPTIMIZATION_H
+#define WEAK_COMPILER_MIDDLE_END_PROFILE_GUIDED_OPTIMIZATION_H
+
+#include <string>
+#include <string_view>
+
+namespace llvm {
+class Module;
+} // namespace llvm
+
+namespace weak {
+
+/// \brief Instrument module to count executions of control flow edges.
+///
+/// Counters are placed by LLVM PGO instrumentation, same as clang does
+/// for -fprofile-generate, and lowered to plain global arrays, so no
+/// profile runtime is needed. Each translation unit defines function,
+/// that prints its counters, and unit with main calls these functions
+/// of all units before main returns. Profile is written in LLVM text
+/// format, understood by llvm-profdata and by IndexedProfile.
+///
+/// Must be run before optimizations, at the same point as
+/// RunProfileUsePass, so control flow graphs of both builds match.
+///
+/// \param Unit  Index of translation unit among units, linked together.
+/// \param Units Count of translation units, linked together.
+void RunProfileInstrumentationPass(
+  llvm::Module     &M,
+  std::string_view  ProfilePath,
+  unsigned          Unit = 0U,
+  unsigned          Units = 1U
+);
+
+/// \brief Attach execution counts from profile to module.
+///
+/// Branch weights and function entry counts are attached, rarely
+/// executed functions become cold and profile summary is set, so inliner,
+/// block placement and code layout follow real execution. Functions,
+/// found hot or cold, are placed to .text.hot or .text.unlikely sections,
+/// that linker puts before or after the rest of code.
+///
+/// \param IndexedProfilePath Profile, converted by IndexedProfile.
+void RunProfileUsePass(llvm::Module &M, const std::string &IndexedProfilePath);
+
+/// Profile in LLVM indexed format, written to temporary file, since
+/// LLVM optimizer reads only this format. File is removed together with
+/// object.
+class IndexedProfile {
+public:
+  /// Read profile, written by instrumented program or produced by
+  /// llvm-profdata.
+  explicit IndexedProfile(const std::string &Path);
+  IndexedProfile(const IndexedProfile &) = delete;
+  IndexedProfile &operator=(const IndexedProfile &) = delete;
+  ~IndexedProfile();
+
+  const std::string &Path() const;
+
+private:
+  std::string mPath;
+};
+
+} // namespace weak
+
+#endif // WEAK_COMPILER_MIDDLE_END_PROFILE_GUIDED_OPTIMIZATION_H
\ No newline at end of file
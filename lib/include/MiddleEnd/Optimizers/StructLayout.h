@@ -0,0 +1,66 @@
+/* StructLayout.h - Reordering and splitting of structure members.
+ * Copyright (C) 2022 epoll-reactor <glibcxx.chrono@gmail.com>
+ *
+ * This file is distributed under the MIT license.
+ */
+
+#ifndef WEAK_COMPILER_MIDDLE_END_STRUCT_LAYOUT_H
+#define WEAK_COMPILER_MIDDLE_END_STRUCT_LAYOUT_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace weak {
+
+class ASTNode;
+
+/// Transformations, performed by structure layout pass.
+struct StructLayoutOptions {
+  /// Sort members by decreasing alignment to minimize padding.
+  bool ReorderFields{false};
+  /// Move rarely used members to the side structure at the end.
+  bool SplitColdFields{false};
+};
+
+/// Counters collected by structure layout pass.
+struct StructLayoutStats {
+  struct Layout {
+    std::string Name;
+    /// Size in bytes of structure as declared.
+    unsigned SizeBefore{0U};
+    /// Size in bytes of structure after transformation.
+    unsigned SizeAfter{0U};
+    /// Size in bytes of members before the side structure.
+    unsigned HotSize{0U};
+  };
+
+  /// Top-level and nested structures in order of declaration.
+  std::vector<Layout> Structs;
+  /// Structures, which members were moved.
+  unsigned ChangedStructs{0U};
+  /// Members, moved to side structures.
+  unsigned ColdFields{0U};
+
+  void Dump(std::ostream &) const;
+};
+
+/// \brief Change order of structure members.
+///
+/// Sizes and alignments of members are computed as for x86-64, so
+/// sorting by decreasing alignment leaves padding only at the end.
+///
+/// Cold splitting weights each member access by 8 raised to the loop depth
+/// and moves members, which weight is less than 1/8 of the hottest member,
+/// to the nested side structure `cold$`, placed last. This way frequently
+/// used members are packed together at the beginning of object.
+///
+/// Member indices of all ASTMemberAccess nodes are updated, accesses to
+/// moved members go through the side structure.
+///
+/// \note Requires analyzed AST, since member accesses must be resolved.
+StructLayoutStats RunStructLayoutPass(ASTNode *Root, const StructLayoutOptions &);
+
+} // namespace weak
+
+#endif // WEAK_COMPILER_MIDDLE_END_STRUCT_LAYOUT_H
\ No newline at end of file
@@ -9,14 +9,18 @@
 
 #include <string_view>
 #include <unordered_map>
+#include <vector>
 
 namespace llvm {
-class AllocaInst;
+class Value;
 } // namespace llvm
 
 namespace weak {
 
 /// \brief Storage for LLVM declarations.
+///
+/// Holds only variables, that live in memory (arrays, structures and array
+/// parameters). Scalars are kept in SSA registers by weak::SSABuilder.
 class Storage {
   /// Entity stored inside. Needed to handle
   /// erasure of IR objects with the end of
@@ -24,8 +28,8 @@ class Storage {
   struct DeclRecord {
     /// How much variable is nested.
     unsigned Depth;
-    /// Pointer.
-    llvm::AllocaInst *Value;
+    /// Pointer to memory, occupied by variable.
+    llvm::Value *Value;
   };
 
 public:
@@ -36,12 +40,18 @@ public:
   void EndScope();
 
   /// Add variable at current depth.
-  void Push(std::string_view Name, llvm::AllocaInst *Value);
+  void Push(std::string_view Name, llvm::Value *Value);
 
   /// Try to retrieve variable by name.
   ///
   /// \return Stored value if present, null otherwise.
-  llvm::AllocaInst *Lookup(std::string_view Name) const;
+  llvm::Value *Lookup(std::string_view Name) const;
+
+  /// Get all variables, added at depths greater than given one.
+  std::vector<llvm::Value *> ScopesDeeperThan(unsigned Depth) const;
+
+  /// \return Current scope depth.
+  unsigned Depth() const;
 
 private:
   unsigned mDepth{0U};
@@ -0,0 +1,78 @@
+/* CompilationCache.h - On-disk cache of compilation results.
+ * Copyright (C) 2022 epoll-reactor <glibcxx.chrono@gmail.com>
+ *
+ * This file is distributed under the MIT license.
+ */
+
+#ifndef WEAK_COMPILER_UTILITY_COMPILATION_CACHE_H
+#define WEAK_COMPILER_UTILITY_COMPILATION_CACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace weak {
+
+/// Counters collected by compilation cache.
+struct CompilationCacheStats {
+  /// Source files, whose results were taken from cache.
+  unsigned Hits{0U};
+  /// Source files, compiled and stored to cache.
+  unsigned Misses{0U};
+
+  void Dump(std::ostream &) const;
+};
+
+/// \brief On-disk cache of compilation results, shared by many compiler
+///        processes.
+///
+/// Entry is a list of blobs, such as objects and warnings text, stored
+/// in one file. It is named by SHA-1 of everything, that affects result
+/// of compilation: source text, compiler build, target and options.
+///
+/// Entry is written to temporary file in cache directory and renamed,
+/// so concurrent builds never see partially written one. Entries, used
+/// least recently, are evicted when cache exceeds its size limit.
+class CompilationCache {
+public:
+  /// Create cache directory, if it does not exist.
+  ///
+  /// \param MaxSize Limit of total size of entries in bytes.
+  CompilationCache(std::string_view Dir, uint64_t MaxSize);
+
+  /// \return Key, unique for given parts and build of compiler.
+  static std::string ComputeKey(const std::vector<std::string_view> &Parts);
+
+  /// Find entry and mark it as recently used. Can be called from many
+  /// threads at once.
+  ///
+  /// \return Blobs in order they were stored or nothing, if entry is
+  ///         missing or damaged.
+  std::optional<std::vector<std::string>> Lookup(const std::string &Key);
+
+  /// Write entry atomically. Failure to write is not an error, result
+  /// is just not cached. Can be called from many threads at once.
+  void Store(const std::string &Key, const std::vector<std::string_view> &Blobs);
+
+  /// Remove least recently used entries, until cache fits into its size
+  /// limit.
+  void Prune();
+
+  CompilationCacheStats Stats() const;
+
+private:
+  std::string EntryPath(const std::string &Key) const;
+
+  std::string mDir;
+  uint64_t mMaxSize;
+  std::atomic<unsigned> mHits{0U};
+  std::atomic<unsigned> mMisses{0U};
+};
+
+} // namespace weak
+
+#endif // WEAK_COMPILER_UTILITY_COMPILATION_CACHE_H
\ No newline at end of file
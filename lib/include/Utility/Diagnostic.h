@@ -17,7 +17,8 @@ class ASTNode;
 
 namespace weak {
 
-/// Dump all generated warnings to given stream.
+/// Dump all warnings, generated by current thread, to given stream.
+/// Each warning is terminated with newline.
 ///
 /// All generated previously warnings are erased
 /// before next call of this function.
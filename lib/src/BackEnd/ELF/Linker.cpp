@@ -0,0 +1,885 @@
+/* Linker.cpp - Linker of ELF relocatable objects to executable.
+ * Copyright (C) 2022 epoll-reactor <glibcxx.chrono@gmail.com>
+ *
+ * This file is distributed under the MIT license.
+ */
+
+#include "BackEnd/ELF/Linker.h"
+#include "BackEnd/ELF/FileBuffer.h"
+#include "BackEnd/ELF/ObjectWriter.h"
+#include "BackEnd/X86/Assembler.h"
+#include "llvm/Object/ELF.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <iterator>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace weak::elf {
+namespace {
+
+using namespace llvm::ELF;
+using ELFFile = llvm::object::ELF64LEFile;
+using ELFSection = ELFFile::Elf_Shdr;
+using ELFSymbol = ELFFile::Elf_Sym;
+
+/// Executable is not position independent and is loaded at this address.
+constexpr uint64_t BaseAddress = 0x400000;
+constexpr uint64_t PageSize = 0x1000;
+/// jmp *GOT(%rip), padded with int3.
+constexpr uint64_t PLTEntrySize = 8;
+constexpr const char *DynamicLoader = "/lib64/ld-linux-x86-64.so.2";
+constexpr const char *SharedLibraries[] = {"libc.so.6", "libm.so.6"};
+/// Where shared libraries are looked for to find out, what they export.
+constexpr const char *LibraryPaths[] = {
+  "/lib/x86_64-linux-gnu",
+  "/usr/lib/x86_64-linux-gnu",
+  "/lib64",
+  "/usr/lib64",
+  "/lib",
+  "/usr/lib"
+};
+constexpr uint32_t NoSection = UINT32_MAX;
+
+/// Thrown, so callers can clean up, like compilation errors.
+[[noreturn]] void LinkError(const llvm::Twine &Message) {
+  throw std::runtime_error(("Link error: " + Message).str());
+}
+
+template <typename T>
+T ExitOnLinkError(llvm::Expected<T> Value) {
+  if (!Value)
+    LinkError(llvm::toString(Value.takeError()));
+  return std::move(*Value);
+}
+
+/// \return Names of functions and variables, defined by SharedLibraries.
+///         Read from .dynsym once per process.
+const std::unordered_set<std::string> &SharedLibraryExports() {
+  static const std::unordered_set<std::string> Exports = [] {
+    std::unordered_set<std::string> Names;
+    for (const char *Library : SharedLibraries) {
+      auto Dir = std::find_if(std::begin(LibraryPaths), std::end(LibraryPaths), [&](const char *Path) {
+        return llvm::sys::fs::exists(llvm::Twine(Path) + "/" + Library);
+      });
+      if (Dir == std::end(LibraryPaths))
+        LinkError(llvm::Twine("cannot find ") + Library);
+      auto Buffer = llvm::MemoryBuffer::getFile(llvm::Twine(*Dir) + "/" + Library);
+      if (!Buffer)
+        LinkError(llvm::Twine(Library) + ": " + Buffer.getError().message());
+      ELFFile File = ExitOnLinkError(ELFFile::create((*Buffer)->getBuffer()));
+      auto Sections = ExitOnLinkError(File.sections());
+      for (const ELFSection &S : Sections) {
+        if (S.sh_type != SHT_DYNSYM)
+          continue;
+        llvm::StringRef Strings = ExitOnLinkError(File.getStringTableForSymtab(S, Sections));
+        for (const ELFSymbol &Sym : ExitOnLinkError(File.symbols(&S)))
+          if (!Sym.isUndefined() && Sym.getBinding() != STB_LOCAL)
+            Names.insert(ExitOnLinkError(Sym.getName(Strings)).str());
+      }
+    }
+    return Names;
+  }();
+  return Exports;
+}
+
+/// Memory segment, output section is loaded to.
+enum Segment : uint8_t {
+  SEG_R,
+  SEG_RX,
+  SEG_RW,
+  /// Not loaded, like debug info.
+  SEG_NONE
+};
+
+struct OutputSection {
+  std::string Name;
+  Segment Seg;
+  uint32_t Type;
+  uint64_t Flags;
+  uint64_t Align;
+  uint64_t EntSize;
+  /// Index of related section in section header table.
+  uint32_t Link{0U};
+  uint32_t Info{0U};
+  uint64_t Size;
+  /// Contents, empty for SHT_NOBITS.
+  std::vector<uint8_t> Data;
+  uint64_t Addr{0U};
+  uint64_t Offset{0U};
+};
+
+/// Where input section is placed in output.
+struct Placement {
+  /// NoSection if input section is discarded.
+  uint32_t Out{NoSection};
+  uint64_t Offset{0U};
+};
+
+struct InputObject {
+  InputObject(std::string Name, ELFFile File, uint32_t Unit)
+    : Name(std::move(Name))
+    , File(std::move(File))
+    , Unit(Unit) {}
+
+  std::string Name;
+  ELFFile File;
+  /// Translation unit, object is compiled from.
+  uint32_t Unit;
+  llvm::ArrayRef<ELFSection> Sections;
+  llvm::ArrayRef<ELFSymbol> Symbols;
+  llvm::StringRef Strings;
+  std::vector<Placement> Placements;
+};
+
+/// Input sections, that are concatenated to one output section.
+struct MergedSection {
+  uint32_t Type;
+  uint64_t Flags;
+  uint64_t Align{1U};
+  uint64_t Size{0U};
+  /// Indices of object and its section.
+  std::vector<std::pair<uint32_t, uint32_t>> Inputs;
+};
+
+/// Definition of global symbol.
+struct SymbolRef {
+  uint32_t Object;
+  uint32_t Symbol;
+};
+
+class LinkerImpl {
+public:
+  void Link(
+    const std::vector<std::unique_ptr<llvm::MemoryBuffer>> &Objects,
+    const std::vector<uint32_t>                            &Units,
+    std::string_view                                        OutPath
+  ) {
+    for (size_t I = 0; I < Objects.size(); ++I)
+      AddInput(*Objects[I], Units[I]);
+    for (const InputObject &In : mInputs)
+      CollectUndefined(In);
+    if (!mDefined.count("main"))
+      LinkError("undefined symbol: main");
+    CollectImports();
+    AddStartup();
+    CollectImports();
+
+    MergeSections();
+    CollectGOTSlots();
+    CreateSections();
+    Layout();
+
+    FillMergedSections();
+    ApplyRelocations();
+    FillDynamicSections();
+    FillSymbolTable();
+    Write(OutPath);
+  }
+
+private:
+  bool IsDynamic() const { return !mImports.empty(); }
+
+  void AddInput(const llvm::MemoryBuffer &Buffer, uint32_t Unit) {
+    ELFFile File = ExitOnLinkError(ELFFile::create(Buffer.getBuffer()));
+    std::string Name = Buffer.getBufferIdentifier().str();
+    if (File.getHeader().e_type != ET_REL || File.getHeader().e_machine != EM_X86_64)
+      LinkError(Name + ": not an x86-64 relocatable object");
+
+    uint32_t Index = mInputs.size();
+    InputObject &In = mInputs.emplace_back(std::move(Name), File, Unit);
+    In.Sections = ExitOnLinkError(In.File.sections());
+    In.Placements.resize(In.Sections.size());
+    for (const ELFSection &S : In.Sections)
+      if (S.sh_type == SHT_SYMTAB) {
+        In.Symbols = ExitOnLinkError(In.File.symbols(&S));
+        In.Strings = ExitOnLinkError(In.File.getStringTableForSymtab(S, In.Sections));
+      }
+
+    for (uint32_t I = 1; I < In.Symbols.size(); ++I) {
+      const ELFSymbol &Sym = In.Symbols[I];
+      if (Sym.getBinding() == STB_LOCAL || Sym.isUndefined())
+        continue;
+      std::string SymName = GlobalName(In, Sym);
+      if (Sym.st_shndx == SHN_COMMON)
+        LinkError(In.Name + ": common symbols are not supported: " + SymName);
+      auto [It, Inserted] = mDefined.try_emplace(SymName, SymbolRef{Index, I});
+      if (Inserted || Sym.getBinding() == STB_WEAK)
+        continue;
+      const ELFSymbol &Old = mInputs[It->second.Object].Symbols[It->second.Symbol];
+      if (Old.getBinding() != STB_WEAK)
+        LinkError("duplicate symbol: " + SymName.substr(0, SymName.find('@')));
+      It->second = SymbolRef{Index, I};
+    }
+  }
+
+  /// Called when all definitions are known, so references are resolved
+  /// to hidden symbols of the same unit first.
+  void CollectUndefined(const InputObject &In) {
+    for (const ELFSymbol &Sym : In.Symbols.drop_front())
+      if (Sym.getBinding() != STB_LOCAL && Sym.isUndefined())
+        mUndefined.insert(GlobalName(In, Sym));
+  }
+
+  void CollectImports() {
+    mImports.clear();
+    for (const std::string &Name : mUndefined) {
+      if (mDefined.count(Name))
+        continue;
+      if (IsHiddenName(Name))
+        LinkError("undefined hidden symbol: " + Name.substr(0, Name.find('@')));
+      /// Otherwise program would fail only when loaded.
+      if (!SharedLibraryExports().count(Name))
+        LinkError("undefined symbol: " + Name);
+      mImports.push_back(Name);
+    }
+  }
+
+  /// Generate _start. Without shared libraries process is terminated by
+  /// system call, otherwise exit() is called to flush stdio buffers.
+  void AddStartup() {
+    x86::Assembler Asm;
+    /// Mark the outermost frame for debuggers.
+    Asm.Alu(x86::ALU_XOR, x86::RBP, x86::RBP, /*Wide=*/false);
+    Asm.Call("main");
+    Asm.Mov(x86::RDI, x86::RAX, /*Wide=*/false);
+    if (IsDynamic())
+      Asm.Call("exit");
+    else {
+      /// SYS_exit_group.
+      Asm.MovImm(x86::RAX, 231);
+      Asm.Syscall();
+    }
+    Asm.Ud2();
+    Asm.Finish();
+
+    ObjectWriter Writer(Asm.Code());
+    Writer.AddFunction("_start", 0U, Asm.Code().size());
+    for (const x86::CallFixup &Call : Asm.Calls())
+      Writer.AddCall(Call.Offset, Call.Symbol);
+    std::vector<char> Data = Writer.Emit();
+    mStartup = llvm::MemoryBuffer::getMemBufferCopy(
+      llvm::StringRef(Data.data(), Data.size()), "<startup>");
+    AddInput(*mStartup, /*Unit=*/0U);
+    CollectUndefined(mInputs.back());
+  }
+
+  /// \return Name of output section or empty string if input section
+  ///         is discarded.
+  static std::string OutputName(const ELFSection &S, llvm::StringRef Name) {
+    if (!(S.sh_flags & SHF_ALLOC))
+      return Name.startswith(".debug_") ? Name.str() : "";
+    /// Weak programs do not unwind stack.
+    if (S.sh_type == SHT_X86_64_UNWIND || Name == ".eh_frame")
+      return "";
+    if (S.sh_flags & SHF_TLS)
+      LinkError("thread-local storage is not supported: " + Name);
+    if (S.sh_type == SHT_INIT_ARRAY || S.sh_type == SHT_FINI_ARRAY || S.sh_type == SHT_PREINIT_ARRAY)
+      LinkError("global constructors are not supported: " + Name);
+    if (S.sh_type != SHT_PROGBITS && S.sh_type != SHT_NOBITS)
+      return "";
+    if (S.sh_type == SHT_NOBITS)
+      return ".bss";
+    if (S.sh_flags & SHF_EXECINSTR)
+      return ".text";
+    return S.sh_flags & SHF_WRITE ? ".data" : ".rodata";
+  }
+
+  /// Functions, that profile found hot, are placed before the rest of
+  /// code and never executed ones after it, so hot code shares pages
+  /// and cache lines.
+  static unsigned LayoutRank(const ELFSection &S, llvm::StringRef Name) {
+    if (!(S.sh_flags & SHF_EXECINSTR))
+      return 1U;
+    if (Name.startswith(".text.hot"))
+      return 0U;
+    if (Name.startswith(".text.unlikely"))
+      return 2U;
+    return 1U;
+  }
+
+  void MergeSections() {
+    for (unsigned Rank = 0U; Rank < 3U; ++Rank)
+      for (uint32_t Obj = 0; Obj < mInputs.size(); ++Obj) {
+        InputObject &In = mInputs[Obj];
+        for (uint32_t I = 1; I < In.Sections.size(); ++I) {
+          const ELFSection &S = In.Sections[I];
+          llvm::StringRef InputName = ExitOnLinkError(In.File.getSectionName(S));
+          if (LayoutRank(S, InputName) != Rank)
+            continue;
+          std::string Name = OutputName(S, InputName);
+          if (Name.empty())
+            continue;
+          auto [It, Inserted] = mMerged.try_emplace(Name);
+          MergedSection &M = It->second;
+          if (Inserted) {
+            M.Type = S.sh_type;
+            M.Flags = S.sh_flags & (SHF_ALLOC | SHF_WRITE | SHF_EXECINSTR);
+          }
+          uint64_t Align = std::max<uint64_t>(S.sh_addralign, 1U);
+          M.Align = std::max(M.Align, Align);
+          In.Placements[I].Offset = llvm::alignTo(M.Size, Align);
+          M.Size = In.Placements[I].Offset + S.sh_size;
+          M.Inputs.emplace_back(Obj, I);
+        }
+      }
+  }
+
+  template <typename Callback>
+  void ForEachRelocation(Callback C) {
+    for (InputObject &In : mInputs)
+      for (const ELFSection &S : In.Sections) {
+        if (S.sh_type != SHT_RELA && S.sh_type != SHT_REL)
+          continue;
+        /// Call graph profile, emitted for profile-guided builds, has
+        /// SHT_REL relocations, but is discarded as other unknown sections.
+        if (In.Placements[S.sh_info].Out == NoSection)
+          continue;
+        if (S.sh_type == SHT_REL)
+          LinkError(In.Name + ": SHT_REL relocations are not supported");
+        for (const auto &R : ExitOnLinkError(In.File.relas(S)))
+          C(In, In.Placements[S.sh_info], R);
+      }
+  }
+
+  /// \return Name of global symbol or empty string for local one.
+  /// Hidden symbols are visible only inside of translation unit, so they
+  /// are qualified by it. '@' is not allowed in names of weak functions.
+  static std::string HiddenName(const std::string &Name, uint32_t Unit) {
+    return Name + '@' + std::to_string(Unit);
+  }
+
+  static bool IsHiddenName(const std::string &Name) {
+    return Name.find('@') != std::string::npos;
+  }
+
+  /// \return Name, symbol is resolved by, or empty string for local one.
+  std::string GlobalName(const InputObject &In, const ELFSymbol &Sym) const {
+    if (Sym.getBinding() == STB_LOCAL)
+      return "";
+    std::string Name = ExitOnLinkError(Sym.getName(In.Strings)).str();
+    std::string Hidden = HiddenName(Name, In.Unit);
+    if (Sym.getVisibility() == STV_HIDDEN || (Sym.isUndefined() && mDefined.count(Hidden)))
+      return Hidden;
+    return Name;
+  }
+
+  static bool IsGOTRelocation(uint32_t Type) {
+    return Type == R_X86_64_GOTPCREL || Type == R_X86_64_GOTPCRELX || Type == R_X86_64_REX_GOTPCRELX;
+  }
+
+  /// Imports take the first slots, they are filled by dynamic loader.
+  void CollectGOTSlots() {
+    for (const std::string &Name : mImports)
+      mGOTSlots.try_emplace(Name, mGOTSlots.size());
+
+    /// Placements are not assigned yet, so mark kept sections.
+    for (auto &[Name, M] : mMerged)
+      for (auto [Obj, I] : M.Inputs)
+        mInputs[Obj].Placements[I].Out = 0U;
+
+    ForEachRelocation([&](const InputObject &In, const Placement &, const auto &R) {
+      if (!IsGOTRelocation(R.getType(false)))
+        return;
+      std::string Name = GlobalName(In, In.Symbols[R.getSymbol(false)]);
+      if (Name.empty())
+        LinkError(In.Name + ": GOT reference to local symbol is not supported");
+      mGOTSlots.try_emplace(Name, mGOTSlots.size());
+    });
+  }
+
+  uint32_t AddSection(
+    std::string Name,
+    Segment     Seg,
+    uint32_t    Type,
+    uint64_t    Flags,
+    uint64_t    Align,
+    uint64_t    Size,
+    uint64_t    EntSize = 0U
+  ) {
+    OutputSection S;
+    S.Name = std::move(Name);
+    S.Seg = Seg;
+    S.Type = Type;
+    S.Flags = Flags;
+    S.Align = Align;
+    S.EntSize = EntSize;
+    S.Size = Size;
+    if (Type != SHT_NOBITS)
+      S.Data.resize(Size);
+    mSections.push_back(std::move(S));
+    return mSections.size() - 1;
+  }
+
+  void AddMerged(const std::string &Name, Segment Seg) {
+    auto It = mMerged.find(Name);
+    if (It == mMerged.end())
+      return;
+    const MergedSection &M = It->second;
+    uint32_t Index = AddSection(Name, Seg, M.Type, M.Flags, M.Align, M.Size);
+    for (auto [Obj, I] : M.Inputs)
+      mInputs[Obj].Placements[I].Out = Index;
+  }
+
+  /// Create output sections, grouped by segments in order of loading.
+  void CreateSections() {
+    for (const auto &Name : SharedLibraries)
+      mDynamicNames.Add(Name);
+    std::vector<uint32_t> ImportNames;
+    for (const std::string &Name : mImports)
+      ImportNames.push_back(mDynamicNames.Add(Name));
+    mImportNames = std::move(ImportNames);
+
+    uint64_t DynamicSymbols = mImports.size() + 1;
+    if (IsDynamic()) {
+      mInterp = AddSection(".interp", SEG_R, SHT_PROGBITS, SHF_ALLOC, 1U, std::strlen(DynamicLoader) + 1);
+      mHash = AddSection(".hash", SEG_R, SHT_HASH, SHF_ALLOC, 8U, (3 + DynamicSymbols) * 4, 4U);
+      mDynsym = AddSection(".dynsym", SEG_R, SHT_DYNSYM, SHF_ALLOC, 8U, DynamicSymbols * sizeof(Elf64_Sym), sizeof(Elf64_Sym));
+      mDynstr = AddSection(".dynstr", SEG_R, SHT_STRTAB, SHF_ALLOC, 1U, mDynamicNames.Data().size());
+      mRelaDyn = AddSection(".rela.dyn", SEG_R, SHT_RELA, SHF_ALLOC, 8U, mImports.size() * sizeof(Elf64_Rela), sizeof(Elf64_Rela));
+    }
+    AddMerged(".rodata", SEG_R);
+
+    AddMerged(".text", SEG_RX);
+    if (IsDynamic())
+      mPLT = AddSection(".plt", SEG_RX, SHT_PROGBITS, SHF_ALLOC | SHF_EXECINSTR, 16U, mImports.size() * PLTEntrySize);
+
+    AddMerged(".data", SEG_RW);
+    if (!mGOTSlots.empty())
+      mGOT = AddSection(".got", SEG_RW, SHT_PROGBITS, SHF_ALLOC | SHF_WRITE, 8U, mGOTSlots.size() * 8, 8U);
+    if (IsDynamic())
+      mDynamic = AddSection(".dynamic", SEG_RW, SHT_DYNAMIC, SHF_ALLOC | SHF_WRITE, 8U, DynamicEntryCount * sizeof(Elf64_Dyn), sizeof(Elf64_Dyn));
+    AddMerged(".bss", SEG_RW);
+
+    for (const auto &[Name, M] : mMerged)
+      if (!(M.Flags & SHF_ALLOC))
+        AddMerged(Name, SEG_NONE);
+
+    for (const auto &[Name, Def] : mDefined)
+      mSymbolNames.push_back(Name);
+    /// Hidden symbols become local ones, that precede global ones.
+    std::sort(mSymbolNames.begin(), mSymbolNames.end(), [](const std::string &L, const std::string &R) {
+      bool IsLocalL = IsHiddenName(L);
+      bool IsLocalR = IsHiddenName(R);
+      return IsLocalL != IsLocalR ? IsLocalL : L < R;
+    });
+    for (const std::string &Name : mSymbolNames) {
+      mSymbolNameOffsets.push_back(mStrings.Add(Name.substr(0, Name.find('@'))));
+      mLocalSymbolCount += IsHiddenName(Name);
+    }
+    mSymtab = AddSection(".symtab", SEG_NONE, SHT_SYMTAB, 0U, 8U, (mSymbolNames.size() + 1) * sizeof(Elf64_Sym), sizeof(Elf64_Sym));
+    mStrtab = AddSection(".strtab", SEG_NONE, SHT_STRTAB, 0U, 1U, mStrings.Data().size());
+
+    for (OutputSection &S : mSections)
+      mSectionNameOffsets.push_back(mSectionNames.Add(S.Name));
+    mShstrtabNameOffset = mSectionNames.Add(".shstrtab");
+    mShstrtab = AddSection(".shstrtab", SEG_NONE, SHT_STRTAB, 0U, 1U, mSectionNames.Data().size());
+    mSectionNameOffsets.push_back(mShstrtabNameOffset);
+
+    /// Section header table has null section at index 0.
+    auto HeaderIndex = [](uint32_t I) { return I + 1; };
+    if (IsDynamic()) {
+      mSections[mHash].Link = HeaderIndex(mDynsym);
+      mSections[mDynsym].Link = HeaderIndex(mDynstr);
+      mSections[mDynsym].Info = 1U;
+      mSections[mRelaDyn].Link = HeaderIndex(mDynsym);
+      mSections[mDynamic].Link = HeaderIndex(mDynstr);
+    }
+    mSections[mSymtab].Link = HeaderIndex(mStrtab);
+    /// Index of the first global symbol.
+    mSections[mSymtab].Info = mLocalSymbolCount + 1;
+  }
+
+  unsigned ProgramHeaderCount() const {
+    std::set<Segment> Loaded{SEG_R};
+    for (const OutputSection &S : mSections)
+      if (S.Seg != SEG_NONE)
+        Loaded.insert(S.Seg);
+    /// PT_PHDR, PT_INTERP and PT_DYNAMIC for dynamic loader.
+    return Loaded.size() + 1 + (IsDynamic() ? 3 : 0);
+  }
+
+  /// File offsets of loaded sections are equal to their addresses minus
+  /// base address, segments start at page boundary.
+  void Layout() {
+    uint64_t Offset = sizeof(Elf64_Ehdr) + ProgramHeaderCount() * sizeof(Elf64_Phdr);
+    Segment Current = SEG_R;
+    for (OutputSection &S : mSections) {
+      if (S.Seg != Current && S.Seg != SEG_NONE)
+        Offset = llvm::alignTo(Offset, PageSize);
+      Current = S.Seg;
+      Offset = llvm::alignTo(Offset, S.Align);
+      S.Offset = Offset;
+      S.Addr = S.Seg == SEG_NONE ? 0U : BaseAddress + Offset;
+      if (S.Type != SHT_NOBITS)
+        Offset += S.Size;
+    }
+  }
+
+  void FillMergedSections() {
+    for (const InputObject &In : mInputs)
+      for (uint32_t I = 1; I < In.Sections.size(); ++I) {
+        const Placement &P = In.Placements[I];
+        const ELFSection &S = In.Sections[I];
+        if (P.Out == NoSection || S.sh_type == SHT_NOBITS)
+          continue;
+        auto Contents = ExitOnLinkError(In.File.getSectionContents(S));
+        std::copy(Contents.begin(), Contents.end(), mSections[P.Out].Data.begin() + P.Offset);
+      }
+  }
+
+  uint64_t DefinedAddress(const InputObject &In, const ELFSymbol &Sym) const {
+    if (Sym.st_shndx == SHN_ABS)
+      return Sym.st_value;
+    if (Sym.st_shndx == SHN_UNDEF || Sym.st_shndx >= SHN_LORESERVE)
+      LinkError(In.Name + ": unsupported symbol section index");
+    const Placement &P = In.Placements[Sym.st_shndx];
+    if (P.Out == NoSection)
+      LinkError(In.Name + ": reference to discarded section");
+    return mSections[P.Out].Addr + P.Offset + Sym.st_value;
+  }
+
+  uint64_t GlobalAddress(const std::string &Name) const {
+    const SymbolRef &Def = mDefined.at(Name);
+    const InputObject &In = mInputs[Def.Object];
+    return DefinedAddress(In, In.Symbols[Def.Symbol]);
+  }
+
+  uint64_t GOTSlotAddress(const std::string &Name) const {
+    return mSections[mGOT].Addr + mGOTSlots.at(Name) * 8;
+  }
+
+  uint64_t PLTEntryAddress(const std::string &Name) const {
+    return mSections[mPLT].Addr + mGOTSlots.at(Name) * PLTEntrySize;
+  }
+
+  template <typename T>
+  static void Put(std::vector<uint8_t> &Data, uint64_t Offset, T Value) {
+    if (Offset + sizeof(T) > Data.size())
+      LinkError("relocation is out of section");
+    std::memcpy(Data.data() + Offset, &Value, sizeof(T));
+  }
+
+  static void Put32(std::vector<uint8_t> &Data, uint64_t Offset, int64_t Value, bool IsSigned) {
+    bool Fits = IsSigned ? llvm::isInt<32>(Value) : llvm::isUInt<32>(Value);
+    if (!Fits)
+      LinkError("relocation value does not fit in 32 bits");
+    Put(Data, Offset, static_cast<uint32_t>(Value));
+  }
+
+  void ApplyRelocations() {
+    ForEachRelocation([&](const InputObject &In, const Placement &P, const auto &R) {
+      OutputSection &Out = mSections[P.Out];
+      const ELFSymbol &Sym = In.Symbols[R.getSymbol(false)];
+      std::string Name = GlobalName(In, Sym);
+      bool IsImport = !Name.empty() && !mDefined.count(Name);
+      uint32_t Type = R.getType(false);
+
+      uint64_t Offset = P.Offset + R.r_offset;
+      int64_t Place = Out.Addr + Offset;
+      int64_t Addend = R.r_addend;
+      int64_t Symbol = 0;
+      if (R.getSymbol(false) == 0)
+        Symbol = 0;
+      else if (IsGOTRelocation(Type))
+        Symbol = GOTSlotAddress(Name);
+      else if (IsImport) {
+        if (Type != R_X86_64_PC32 && Type != R_X86_64_PLT32)
+          LinkError(In.Name + ": absolute reference to shared symbol " + Name);
+        Symbol = PLTEntryAddress(Name);
+      } else
+        Symbol = Name.empty() ? DefinedAddress(In, Sym) : GlobalAddress(Name);
+
+      switch (Type) {
+      case R_X86_64_NONE:
+        break;
+      case R_X86_64_64:
+        Put<uint64_t>(Out.Data, Offset, Symbol + Addend);
+        break;
+      case R_X86_64_32:
+        Put32(Out.Data, Offset, Symbol + Addend, /*IsSigned=*/false);
+        break;
+      case R_X86_64_32S:
+        Put32(Out.Data, Offset, Symbol + Addend, /*IsSigned=*/true);
+        break;
+      case R_X86_64_PC32:
+      case R_X86_64_PLT32:
+      case R_X86_64_GOTPCREL:
+      case R_X86_64_GOTPCRELX:
+      case R_X86_64_REX_GOTPCRELX:
+        Put32(Out.Data, Offset, Symbol + Addend - Place, /*IsSigned=*/true);
+        break;
+      case R_X86_64_PC64:
+        Put<uint64_t>(Out.Data, Offset, Symbol + Addend - Place);
+        break;
+      default:
+        LinkError(In.Name + ": unsupported relocation type " + llvm::Twine(Type));
+      }
+    });
+  }
+
+  static constexpr unsigned DynamicEntryCount = std::size(SharedLibraries) + 12;
+
+  void FillDynamicSections() {
+    if (mGOT != NoSection)
+      for (const auto &[Name, Slot] : mGOTSlots)
+        if (mDefined.count(Name))
+          Put<uint64_t>(mSections[mGOT].Data, Slot * 8, GlobalAddress(Name));
+
+    if (!IsDynamic())
+      return;
+
+    std::memcpy(mSections[mInterp].Data.data(), DynamicLoader, std::strlen(DynamicLoader) + 1);
+    const std::string &Names = mDynamicNames.Data();
+    std::copy(Names.begin(), Names.end(), mSections[mDynstr].Data.begin());
+
+    /// One bucket with empty chain, nothing is exported.
+    std::vector<uint8_t> &Hash = mSections[mHash].Data;
+    Put<uint32_t>(Hash, 0, 1U);
+    Put<uint32_t>(Hash, 4, mImports.size() + 1);
+
+    for (uint32_t I = 0; I < mImports.size(); ++I) {
+      Elf64_Sym Sym{};
+      Sym.st_name = mImportNames[I];
+      Sym.setBindingAndType(STB_GLOBAL, STT_FUNC);
+      Sym.st_shndx = SHN_UNDEF;
+      Put(mSections[mDynsym].Data, (I + 1) * sizeof(Elf64_Sym), Sym);
+
+      Elf64_Rela Rela{};
+      Rela.r_offset = GOTSlotAddress(mImports[I]);
+      Rela.setSymbolAndType(I + 1, R_X86_64_GLOB_DAT);
+      Put(mSections[mRelaDyn].Data, I * sizeof(Elf64_Rela), Rela);
+
+      uint64_t Entry = PLTEntryAddress(mImports[I]);
+      uint64_t EntryOffset = Entry - mSections[mPLT].Addr;
+      std::vector<uint8_t> &PLT = mSections[mPLT].Data;
+      PLT[EntryOffset] = 0xFF;
+      PLT[EntryOffset + 1] = 0x25;
+      Put32(PLT, EntryOffset + 2, GOTSlotAddress(mImports[I]) - (Entry + 6), /*IsSigned=*/true);
+      PLT[EntryOffset + 6] = 0xCC;
+      PLT[EntryOffset + 7] = 0xCC;
+    }
+
+    std::vector<Elf64_Dyn> Entries;
+    auto Add = [&](int64_t Tag, uint64_t Value) {
+      Elf64_Dyn Entry{};
+      Entry.d_tag = Tag;
+      Entry.d_un.d_val = Value;
+      Entries.push_back(Entry);
+    };
+    uint32_t LibraryName = 1;
+    for (const auto &Name : SharedLibraries) {
+      Add(DT_NEEDED, LibraryName);
+      LibraryName += std::strlen(Name) + 1;
+    }
+    Add(DT_HASH, mSections[mHash].Addr);
+    Add(DT_STRTAB, mSections[mDynstr].Addr);
+    Add(DT_SYMTAB, mSections[mDynsym].Addr);
+    Add(DT_STRSZ, mSections[mDynstr].Size);
+    Add(DT_SYMENT, sizeof(Elf64_Sym));
+    Add(DT_RELA, mSections[mRelaDyn].Addr);
+    Add(DT_RELASZ, mSections[mRelaDyn].Size);
+    Add(DT_RELAENT, sizeof(Elf64_Rela));
+    /// Functions are resolved at startup, so PLT needs no lazy binding.
+    Add(DT_FLAGS, DF_BIND_NOW);
+    Add(DT_FLAGS_1, DF_1_NOW);
+    Add(DT_DEBUG, 0U);
+    Add(DT_NULL, 0U);
+    assert(Entries.size() == DynamicEntryCount && "Wrong size of .dynamic");
+    std::memcpy(mSections[mDynamic].Data.data(), Entries.data(), mSections[mDynamic].Size);
+  }
+
+  void FillSymbolTable() {
+    const std::string &Names = mStrings.Data();
+    std::copy(Names.begin(), Names.end(), mSections[mStrtab].Data.begin());
+    std::copy(
+      mSectionNames.Data().begin(), mSectionNames.Data().end(),
+      mSections[mShstrtab].Data.begin()
+    );
+
+    for (uint32_t I = 0; I < mSymbolNames.size(); ++I) {
+      const SymbolRef &Def = mDefined.at(mSymbolNames[I]);
+      const InputObject &In = mInputs[Def.Object];
+      const ELFSymbol &Input = In.Symbols[Def.Symbol];
+
+      Elf64_Sym Sym{};
+      Sym.st_name = mSymbolNameOffsets[I];
+      Sym.setBindingAndType(I < mLocalSymbolCount ? static_cast<uint8_t>(STB_LOCAL) : Input.getBinding(), Input.getType());
+      Sym.st_value = DefinedAddress(In, Input);
+      Sym.st_size = Input.st_size;
+      Sym.st_shndx = Input.st_shndx == SHN_ABS
+        ? static_cast<uint16_t>(SHN_ABS)
+        : static_cast<uint16_t>(In.Placements[Input.st_shndx].Out + 1);
+      Put(mSections[mSymtab].Data, (I + 1) * sizeof(Elf64_Sym), Sym);
+    }
+  }
+
+  void AddProgramHeaders(FileBuffer &File) {
+    auto Add = [&](uint32_t Type, uint32_t Flags, uint64_t Offset, uint64_t Addr, uint64_t FileSize, uint64_t MemSize, uint64_t Align) {
+      Elf64_Phdr Header{};
+      Header.p_type = Type;
+      Header.p_flags = Flags;
+      Header.p_offset = Offset;
+      Header.p_vaddr = Addr;
+      Header.p_paddr = Addr;
+      Header.p_filesz = FileSize;
+      Header.p_memsz = MemSize;
+      Header.p_align = Align;
+      File.Append(Header);
+    };
+    auto AddSectionHeader = [&](uint32_t Type, uint32_t Flags, const OutputSection &S) {
+      Add(Type, Flags, S.Offset, S.Addr, S.Size, S.Size, S.Align);
+    };
+
+    if (IsDynamic()) {
+      uint64_t Size = ProgramHeaderCount() * sizeof(Elf64_Phdr);
+      Add(PT_PHDR, PF_R, sizeof(Elf64_Ehdr), BaseAddress + sizeof(Elf64_Ehdr), Size, Size, 8U);
+      AddSectionHeader(PT_INTERP, PF_R, mSections[mInterp]);
+    }
+
+    for (Segment Seg : {SEG_R, SEG_RX, SEG_RW}) {
+      uint64_t Begin = Seg == SEG_R ? 0U : UINT64_MAX;
+      uint64_t FileEnd = Seg == SEG_R ? sizeof(Elf64_Ehdr) + ProgramHeaderCount() * sizeof(Elf64_Phdr) : 0U;
+      uint64_t MemEnd = FileEnd;
+      for (const OutputSection &S : mSections) {
+        if (S.Seg != Seg)
+          continue;
+        Begin = std::min(Begin, S.Offset);
+        if (S.Type != SHT_NOBITS)
+          FileEnd = S.Offset + S.Size;
+        MemEnd = S.Offset + S.Size;
+      }
+      if (Begin == UINT64_MAX)
+        continue;
+      FileEnd = std::max(FileEnd, Begin);
+      uint32_t Flags = Seg == SEG_R ? PF_R : Seg == SEG_RX ? PF_R | PF_X : PF_R | PF_W;
+      Add(PT_LOAD, Flags, Begin, BaseAddress + Begin, FileEnd - Begin, MemEnd - Begin, PageSize);
+    }
+
+    if (IsDynamic())
+      AddSectionHeader(PT_DYNAMIC, PF_R | PF_W, mSections[mDynamic]);
+    Add(PT_GNU_STACK, PF_R | PF_W, 0U, 0U, 0U, 0U, 16U);
+  }
+
+  void Write(std::string_view OutPath) {
+    FileBuffer File;
+    uint64_t HeaderOffset = File.Append(Elf64_Ehdr{});
+    uint64_t ProgramHeadersOffset = File.Size();
+    AddProgramHeaders(File);
+
+    for (const OutputSection &S : mSections) {
+      if (S.Type == SHT_NOBITS)
+        continue;
+      File.Resize(std::max(File.Size(), S.Offset));
+      File.Append(S.Data.data(), S.Data.size());
+    }
+
+    File.Align(8);
+    uint64_t SectionsOffset = File.Append(Elf64_Shdr{});
+    for (uint32_t I = 0; I < mSections.size(); ++I) {
+      const OutputSection &S = mSections[I];
+      Elf64_Shdr Header{};
+      Header.sh_name = mSectionNameOffsets[I];
+      Header.sh_type = S.Type;
+      Header.sh_flags = S.Flags;
+      Header.sh_addr = S.Addr;
+      Header.sh_offset = S.Offset;
+      Header.sh_size = S.Size;
+      Header.sh_link = S.Link;
+      Header.sh_info = S.Info;
+      Header.sh_addralign = S.Align;
+      Header.sh_entsize = S.EntSize;
+      File.Append(Header);
+    }
+
+    auto *Header = File.At<Elf64_Ehdr>(HeaderOffset);
+    std::memcpy(Header->e_ident, ElfMagic, std::strlen(ElfMagic));
+    Header->e_ident[EI_CLASS] = ELFCLASS64;
+    Header->e_ident[EI_DATA] = ELFDATA2LSB;
+    Header->e_ident[EI_VERSION] = EV_CURRENT;
+    Header->e_ident[EI_OSABI] = ELFOSABI_NONE;
+    Header->e_type = ET_EXEC;
+    Header->e_machine = EM_X86_64;
+    Header->e_version = EV_CURRENT;
+    Header->e_entry = GlobalAddress("_start");
+    Header->e_phoff = ProgramHeadersOffset;
+    Header->e_shoff = SectionsOffset;
+    Header->e_ehsize = sizeof(Elf64_Ehdr);
+    Header->e_phentsize = sizeof(Elf64_Phdr);
+    Header->e_phnum = ProgramHeaderCount();
+    Header->e_shentsize = sizeof(Elf64_Shdr);
+    Header->e_shnum = mSections.size() + 1;
+    Header->e_shstrndx = mShstrtab + 1;
+
+    std::error_code Errc;
+    {
+      llvm::raw_fd_ostream OutStream(OutPath, Errc, llvm::sys::fs::OF_None);
+      if (Errc)
+        LinkError("could not open file: " + Errc.message());
+      OutStream.write(File.Data().data(), File.Data().size());
+    }
+
+    namespace fs = llvm::sys::fs;
+    if ((Errc = fs::setPermissions(OutPath, fs::all_read | fs::all_exe | fs::owner_write)))
+      LinkError("could not make file executable: " + Errc.message());
+  }
+
+  std::vector<InputObject> mInputs;
+  std::unique_ptr<llvm::MemoryBuffer> mStartup;
+  std::unordered_map<std::string, SymbolRef> mDefined;
+  /// Sorted, so output does not depend on hashing.
+  std::set<std::string> mUndefined;
+  /// Functions from shared libraries.
+  std::vector<std::string> mImports;
+  std::vector<uint32_t> mImportNames;
+  std::map<std::string, uint32_t> mGOTSlots;
+  std::map<std::string, MergedSection> mMerged;
+
+  std::vector<OutputSection> mSections;
+  std::vector<uint32_t> mSectionNameOffsets;
+  uint32_t mShstrtabNameOffset{0U};
+  StringTable mDynamicNames;
+  StringTable mStrings;
+  StringTable mSectionNames;
+  /// Names of defined symbols, hidden ones go first.
+  std::vector<std::string> mSymbolNames;
+  std::vector<uint32_t> mSymbolNameOffsets;
+  uint32_t mLocalSymbolCount{0U};
+
+  uint32_t mInterp{NoSection};
+  uint32_t mHash{NoSection};
+  uint32_t mDynsym{NoSection};
+  uint32_t mDynstr{NoSection};
+  uint32_t mRelaDyn{NoSection};
+  uint32_t mPLT{NoSection};
+  uint32_t mGOT{NoSection};
+  uint32_t mDynamic{NoSection};
+  uint32_t mSymtab{NoSection};
+  uint32_t mStrtab{NoSection};
+  uint32_t mShstrtab{NoSection};
+};
+
+} // namespace
+
+Linker::Linker() = default;
+
+Linker::~Linker() = default;
+
+void Linker::AddObject(std::unique_ptr<llvm::MemoryBuffer> Object, uint32_t Unit) {
+  mObjects.push_back(std::move(Object));
+  mUnits.push_back(Unit);
+}
+
+void Linker::Link(std::string_view OutPath) {
+  LinkerImpl().Link(mObjects, mUnits, OutPath);
+}
+
+} // namespace weak::elf
\ No newline at end of file
@@ -0,0 +1,166 @@
+/* ObjectWriter.cpp - Writer of ELF relocatable objects.
+ * Copyright (C) 2022 epoll-reactor <glibcxx.chrono@gmail.com>
+ *
+ * This file is distributed under the MIT license.
+ */
+
+#include "BackEnd/ELF/ObjectWriter.h"
+#include "BackEnd/ELF/FileBuffer.h"
+#include "llvm/BinaryFormat/ELF.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/raw_ostream.h"
+#include <cstring>
+
+namespace weak::elf {
+namespace {
+
+enum SectionIndex : uint16_t {
+  SEC_NULL,
+  SEC_TEXT,
+  SEC_RELA_TEXT,
+  SEC_SYMTAB,
+  SEC_STRTAB,
+  SEC_SHSTRTAB,
+  /// Empty section, that marks stack as not executable.
+  SEC_NOTE_GNU_STACK,
+  SEC_COUNT
+};
+
+} // namespace
+
+ObjectWriter::ObjectWriter(std::vector<uint8_t> Text)
+  : mText(std::move(Text)) {}
+
+void ObjectWriter::AddFunction(std::string Name, uint64_t Offset, uint64_t Size, bool IsHidden) {
+  mSymbols.push_back({std::move(Name), Offset, Size, /*IsDefined=*/true, IsHidden});
+}
+
+void ObjectWriter::AddCall(uint64_t Offset, const std::string &Symbol) {
+  mRelocations.push_back({Offset, FindOrAddUndefined(Symbol)});
+}
+
+uint32_t ObjectWriter::FindOrAddUndefined(const std::string &Name) {
+  for (uint32_t I = 0; I < mSymbols.size(); ++I)
+    if (mSymbols[I].Name == Name)
+      return I;
+  mSymbols.push_back({Name, 0U, 0U, /*IsDefined=*/false, /*IsHidden=*/false});
+  return mSymbols.size() - 1;
+}
+
+std::vector<char> ObjectWriter::Emit() const {
+  using namespace llvm::ELF;
+
+  FileBuffer File;
+  StringTable Strings;
+  StringTable SectionNames;
+  Elf64_Shdr Sections[SEC_COUNT];
+  std::memset(Sections, 0, sizeof(Sections));
+
+  uint64_t HeaderOffset = File.Append(Elf64_Ehdr{});
+
+  File.Align(16);
+  Elf64_Shdr &Text = Sections[SEC_TEXT];
+  Text.sh_name = SectionNames.Add(".text");
+  Text.sh_type = SHT_PROGBITS;
+  Text.sh_flags = SHF_ALLOC | SHF_EXECINSTR;
+  Text.sh_offset = File.Append(mText.data(), mText.size());
+  Text.sh_size = mText.size();
+  Text.sh_addralign = 16;
+
+  File.Align(8);
+  Elf64_Shdr &Rela = Sections[SEC_RELA_TEXT];
+  Rela.sh_name = SectionNames.Add(".rela.text");
+  Rela.sh_type = SHT_RELA;
+  Rela.sh_flags = SHF_INFO_LINK;
+  Rela.sh_offset = File.Data().size();
+  for (const Relocation &R : mRelocations) {
+    Elf64_Rela Entry{};
+    Entry.r_offset = R.Offset;
+    /// Symbol 0 is null one.
+    Entry.setSymbolAndType(R.Symbol + 1, R_X86_64_PLT32);
+    /// Displacement is counted from the end of instruction.
+    Entry.r_addend = -4;
+    File.Append(Entry);
+  }
+  Rela.sh_size = mRelocations.size() * sizeof(Elf64_Rela);
+  Rela.sh_link = SEC_SYMTAB;
+  Rela.sh_info = SEC_TEXT;
+  Rela.sh_addralign = 8;
+  Rela.sh_entsize = sizeof(Elf64_Rela);
+
+  Elf64_Shdr &Symtab = Sections[SEC_SYMTAB];
+  Symtab.sh_name = SectionNames.Add(".symtab");
+  Symtab.sh_type = SHT_SYMTAB;
+  Symtab.sh_offset = File.Append(Elf64_Sym{});
+  for (const Symbol &S : mSymbols) {
+    Elf64_Sym Entry{};
+    Entry.st_name = Strings.Add(S.Name);
+    Entry.setBindingAndType(STB_GLOBAL, S.IsDefined ? STT_FUNC : STT_NOTYPE);
+    Entry.st_other = S.IsHidden ? STV_HIDDEN : STV_DEFAULT;
+    Entry.st_shndx = S.IsDefined ? static_cast<uint16_t>(SEC_TEXT) : static_cast<uint16_t>(SHN_UNDEF);
+    Entry.st_value = S.Offset;
+    Entry.st_size = S.Size;
+    File.Append(Entry);
+  }
+  Symtab.sh_size = (mSymbols.size() + 1) * sizeof(Elf64_Sym);
+  Symtab.sh_link = SEC_STRTAB;
+  /// Index of the first global symbol, all of them are global.
+  Symtab.sh_info = 1;
+  Symtab.sh_addralign = 8;
+  Symtab.sh_entsize = sizeof(Elf64_Sym);
+
+  Elf64_Shdr &Strtab = Sections[SEC_STRTAB];
+  Strtab.sh_name = SectionNames.Add(".strtab");
+  Strtab.sh_type = SHT_STRTAB;
+  Strtab.sh_offset = File.Append(Strings.Data().data(), Strings.Data().size());
+  Strtab.sh_size = Strings.Data().size();
+  Strtab.sh_addralign = 1;
+
+  Elf64_Shdr &Note = Sections[SEC_NOTE_GNU_STACK];
+  Note.sh_name = SectionNames.Add(".note.GNU-stack");
+  Note.sh_type = SHT_PROGBITS;
+  Note.sh_offset = File.Data().size();
+  Note.sh_addralign = 1;
+
+  Elf64_Shdr &Shstrtab = Sections[SEC_SHSTRTAB];
+  Shstrtab.sh_name = SectionNames.Add(".shstrtab");
+  Shstrtab.sh_type = SHT_STRTAB;
+  Shstrtab.sh_offset = File.Append(SectionNames.Data().data(), SectionNames.Data().size());
+  Shstrtab.sh_size = SectionNames.Data().size();
+  Shstrtab.sh_addralign = 1;
+
+  File.Align(8);
+  uint64_t SectionsOffset = File.Append(Sections, sizeof(Sections));
+
+  auto *Header = File.At<Elf64_Ehdr>(HeaderOffset);
+  std::memcpy(Header->e_ident, ElfMagic, std::strlen(ElfMagic));
+  Header->e_ident[EI_CLASS] = ELFCLASS64;
+  Header->e_ident[EI_DATA] = ELFDATA2LSB;
+  Header->e_ident[EI_VERSION] = EV_CURRENT;
+  Header->e_ident[EI_OSABI] = ELFOSABI_NONE;
+  Header->e_type = ET_REL;
+  Header->e_machine = EM_X86_64;
+  Header->e_version = EV_CURRENT;
+  Header->e_shoff = SectionsOffset;
+  Header->e_ehsize = sizeof(Elf64_Ehdr);
+  Header->e_shentsize = sizeof(Elf64_Shdr);
+  Header->e_shnum = SEC_COUNT;
+  Header->e_shstrndx = SEC_SHSTRTAB;
+
+  return File.Data();
+}
+
+void ObjectWriter::Write(std::string_view Path) const {
+  std::vector<char> Data = Emit();
+  std::error_code Errc;
+  llvm::raw_fd_ostream OutStream(Path, Errc, llvm::sys::fs::OF_None);
+
+  if (Errc) {
+    llvm::errs() << "Could not open file: " << Errc.message();
+    exit(-1);
+  }
+
+  OutStream.write(Data.data(), Data.size());
+}
+
+} // namespace weak::elf
\ No newline at end of file
@@ -0,0 +1,271 @@
+/* Assembler.cpp - Encoder of x86-64 machine instructions.
+ * Copyright (C) 2022 epoll-reactor <glibcxx.chrono@gmail.com>
+ *
+ * This file is distributed under the MIT license.
+ */
+
+#include "BackEnd/X86/Assembler.h"
+#include <cassert>
+#include <limits>
+
+namespace weak::x86 {
+
+static constexpr uint32_t Unbound = std::numeric_limits<uint32_t>::max();
+
+void Assembler::Emit8(uint8_t Byte) {
+  mCode.push_back(Byte);
+}
+
+void Assembler::Emit32(uint32_t Word) {
+  for (unsigned I = 0; I < 4; ++I)
+    Emit8(Word >> (I * 8U));
+}
+
+void Assembler::EmitRex(bool W, unsigned Reg, unsigned Index, unsigned Base, bool ByteRegs) {
+  uint8_t Rex = (W << 3U) | ((Reg >> 3U) << 2U) | ((Index >> 3U) << 1U) | (Base >> 3U);
+  /// Without REX 8-bit registers 4-7 are AH, CH, DH and BH.
+  bool NeedRex = ByteRegs && ((Reg >= 4 && Reg < 8) || (Base >= 4 && Base < 8));
+  if (Rex || NeedRex)
+    Emit8(0x40 | Rex);
+}
+
+void Assembler::EmitRR(
+  uint8_t                        Prefix,
+  bool                           W,
+  std::initializer_list<uint8_t> Opcode,
+  unsigned                       Reg,
+  unsigned                       RM,
+  bool                           ByteRegs
+) {
+  if (Prefix)
+    Emit8(Prefix);
+  EmitRex(W, Reg, 0, RM, ByteRegs);
+  for (uint8_t Byte : Opcode)
+    Emit8(Byte);
+  Emit8(0xC0 | ((Reg & 7U) << 3U) | (RM & 7U));
+}
+
+void Assembler::EmitRM(
+  uint8_t                        Prefix,
+  bool                           W,
+  std::initializer_list<uint8_t> Opcode,
+  unsigned                       Reg,
+  Mem                            M,
+  bool                           ByteRegs
+) {
+  bool HasIndex = M.Index != NoReg;
+  assert(M.Index != RSP && "RSP cannot be index");
+
+  if (Prefix)
+    Emit8(Prefix);
+  EmitRex(W, Reg, HasIndex ? M.Index : 0, M.Base, ByteRegs);
+  for (uint8_t Byte : Opcode)
+    Emit8(Byte);
+
+  unsigned Base = M.Base & 7U;
+  bool NeedSIB = HasIndex || Base == (RSP & 7U);
+  bool IsDisp8 = M.Disp >= -128 && M.Disp <= 127;
+  /// RBP and R13 without displacement mean RIP-relative or no base.
+  unsigned Mod = M.Disp == 0 && Base != (RBP & 7U) ? 0U : IsDisp8 ? 1U : 2U;
+
+  Emit8((Mod << 6U) | ((Reg & 7U) << 3U) | (NeedSIB ? 4U : Base));
+  if (NeedSIB) {
+    unsigned Scale = M.Scale == 8 ? 3U : M.Scale == 4 ? 2U : M.Scale == 2 ? 1U : 0U;
+    Emit8((Scale << 6U) | ((HasIndex ? M.Index & 7U : 4U) << 3U) | Base);
+  }
+  if (Mod == 1)
+    Emit8(static_cast<uint8_t>(M.Disp));
+  else if (Mod == 2)
+    Emit32(M.Disp);
+}
+
+void Assembler::Mov(Reg Dst, Reg Src, bool Wide) {
+  EmitRR(0, Wide, {0x89}, Src, Dst);
+}
+
+void Assembler::MovImm(Reg Dst, int32_t Imm) {
+  EmitRex(false, 0, 0, Dst, false);
+  Emit8(0xB8 + (Dst & 7U));
+  Emit32(Imm);
+}
+
+void Assembler::Load(Reg Dst, Mem Src, Width W) {
+  switch (W) {
+  case Width::S8:  EmitRM(0, false, {0x0F, 0xBE}, Dst, Src); break;
+  case Width::U8:  EmitRM(0, false, {0x0F, 0xB6}, Dst, Src); break;
+  case Width::W32: EmitRM(0, false, {0x8B}, Dst, Src); break;
+  case Width::W64: EmitRM(0, true, {0x8B}, Dst, Src); break;
+  }
+}
+
+void Assembler::Store(Mem Dst, Reg Src, Width W) {
+  switch (W) {
+  case Width::S8:
+  case Width::U8:  EmitRM(0, false, {0x88}, Src, Dst, /*ByteRegs=*/true); break;
+  case Width::W32: EmitRM(0, false, {0x89}, Src, Dst); break;
+  case Width::W64: EmitRM(0, true, {0x89}, Src, Dst); break;
+  }
+}
+
+void Assembler::Lea(Reg Dst, Mem Src) {
+  EmitRM(0, true, {0x8D}, Dst, Src);
+}
+
+void Assembler::MovSX8(Reg Dst, Reg Src) {
+  EmitRR(0, false, {0x0F, 0xBE}, Dst, Src, /*ByteRegs=*/true);
+}
+
+void Assembler::MovZX8(Reg Dst, Reg Src) {
+  EmitRR(0, false, {0x0F, 0xB6}, Dst, Src, /*ByteRegs=*/true);
+}
+
+void Assembler::MovSXD(Reg Dst, Reg Src) {
+  EmitRR(0, true, {0x63}, Dst, Src);
+}
+
+void Assembler::Push(Reg R) {
+  EmitRex(false, 0, 0, R, false);
+  Emit8(0x50 + (R & 7U));
+}
+
+void Assembler::Pop(Reg R) {
+  EmitRex(false, 0, 0, R, false);
+  Emit8(0x58 + (R & 7U));
+}
+
+void Assembler::Alu(AluOp Op, Reg Dst, Reg Src, bool Wide) {
+  EmitRR(0, Wide, {Op}, Src, Dst);
+}
+
+void Assembler::AluImm(AluOp Op, Reg Dst, int32_t Imm, bool Wide) {
+  /// Opcode extension of immediate form is encoded in bits 3-5 of opcode.
+  EmitRR(0, Wide, {0x81}, Op >> 3U, Dst);
+  Emit32(Imm);
+}
+
+void Assembler::Test(Reg Dst, Reg Src) {
+  EmitRR(0, false, {0x85}, Src, Dst);
+}
+
+void Assembler::IMul(Reg Dst, Reg Src) {
+  EmitRR(0, false, {0x0F, 0xAF}, Dst, Src);
+}
+
+void Assembler::Neg(Reg R) {
+  EmitRR(0, false, {0xF7}, 3, R);
+}
+
+void Assembler::Shl(Reg R) {
+  EmitRR(0, false, {0xD3}, 4, R);
+}
+
+void Assembler::Sar(Reg R) {
+  EmitRR(0, false, {0xD3}, 7, R);
+}
+
+void Assembler::Cdq() {
+  Emit8(0x99);
+}
+
+void Assembler::IDiv(Reg R) {
+  EmitRR(0, false, {0xF7}, 7, R);
+}
+
+void Assembler::SetCC(Cond CC, Reg R) {
+  EmitRR(0, false, {0x0F, static_cast<uint8_t>(0x90 + CC)}, 0, R, /*ByteRegs=*/true);
+}
+
+void Assembler::SSE(SSEOp Op, XReg Dst, XReg Src) {
+  EmitRR(0xF3, false, {0x0F, Op}, Dst, Src);
+}
+
+void Assembler::MovssLoad(XReg Dst, Mem Src) {
+  EmitRM(0xF3, false, {0x0F, 0x10}, Dst, Src);
+}
+
+void Assembler::MovssStore(Mem Dst, XReg Src) {
+  EmitRM(0xF3, false, {0x0F, 0x11}, Src, Dst);
+}
+
+void Assembler::Ucomiss(XReg LHS, XReg RHS) {
+  EmitRR(0, false, {0x0F, 0x2E}, LHS, RHS);
+}
+
+void Assembler::MovdToXmm(XReg Dst, Reg Src) {
+  EmitRR(0x66, false, {0x0F, 0x6E}, Dst, Src);
+}
+
+void Assembler::MovdFromXmm(Reg Dst, XReg Src) {
+  EmitRR(0x66, false, {0x0F, 0x7E}, Src, Dst);
+}
+
+void Assembler::Cvtsi2ss(XReg Dst, Reg Src) {
+  EmitRR(0xF3, true, {0x0F, 0x2A}, Dst, Src);
+}
+
+Label Assembler::NewLabel() {
+  mLabels.push_back(Unbound);
+  return {static_cast<uint32_t>(mLabels.size() - 1)};
+}
+
+void Assembler::Bind(Label L) {
+  mLabels[L.ID] = mCode.size();
+}
+
+void Assembler::Jmp(Label L) {
+  Emit8(0xE9);
+  mJumps.emplace_back(mCode.size(), L.ID);
+  Emit32(0);
+}
+
+void Assembler::Jcc(Cond CC, Label L) {
+  Emit8(0x0F);
+  Emit8(0x80 + CC);
+  mJumps.emplace_back(mCode.size(), L.ID);
+  Emit32(0);
+}
+
+void Assembler::Call(std::string Symbol) {
+  Emit8(0xE8);
+  mCalls.push_back({static_cast<uint32_t>(mCode.size()), std::move(Symbol)});
+  Emit32(0);
+}
+
+void Assembler::Ret() {
+  Emit8(0xC3);
+}
+
+void Assembler::Ud2() {
+  Emit8(0x0F);
+  Emit8(0x0B);
+}
+
+void Assembler::Syscall() {
+  Emit8(0x0F);
+  Emit8(0x05);
+}
+
+void Assembler::Align(unsigned Alignment) {
+  while (mCode.size() % Alignment)
+    Emit8(0xCC);
+}
+
+void Assembler::Finish() {
+  for (auto [Offset, ID] : mJumps) {
+    assert(mLabels[ID] != Unbound && "Jump to unbound label");
+    uint32_t Disp = mLabels[ID] - (Offset + 4);
+    for (unsigned I = 0; I < 4; ++I)
+      mCode[Offset + I] = Disp >> (I * 8U);
+  }
+  mJumps.clear();
+}
+
+const std::vector<uint8_t> &Assembler::Code() const {
+  return mCode;
+}
+
+const std::vector<CallFixup> &Assembler::Calls() const {
+  return mCalls;
+}
+
+} // namespace weak::x86
\ No newline at end of file
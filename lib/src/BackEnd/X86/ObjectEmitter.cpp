@@ -0,0 +1,697 @@
+/* ObjectEmitter.cpp - Fast x86-64 code generator for Weak IR.
+ * Copyright (C) 2022 epoll-reactor <glibcxx.chrono@gmail.com>
+ *
+ * This file is distributed under the MIT license.
+ */
+
+#include "BackEnd/X86/ObjectEmitter.h"
+#include "BackEnd/ELF/ObjectWriter.h"
+#include "BackEnd/X86/Assembler.h"
+#include "BackEnd/X86/RegisterAllocator.h"
+#include "Utility/Unreachable.h"
+#include <algorithm>
+#include <unordered_map>
+
+namespace weak::x86 {
+namespace {
+
+using ir::BlockID;
+using ir::Opcode;
+using ir::Type;
+using ir::ValueID;
+
+constexpr Reg IntArgRegs[] = {RDI, RSI, RDX, RCX, R8, R9};
+constexpr XReg FloatArgRegs[] = {XMM0, XMM1, XMM2, XMM3, XMM4, XMM5, XMM6, XMM7};
+
+bool IsFloat(Type Ty) {
+  return Ty == Type::F32;
+}
+
+unsigned SizeOf(Type Ty) {
+  switch (Ty) {
+  case Type::I1:
+  case Type::I8:  return 1U;
+  case Type::I32:
+  case Type::F32: return 4U;
+  case Type::Ptr: return 8U;
+  default:        Unreachable("Expected sized type.");
+  }
+}
+
+/// Access of value in memory. I8 values are kept sign-extended and I1
+/// values are kept as 0 or 1 in registers.
+Width WidthOf(Type Ty) {
+  switch (Ty) {
+  case Type::I1:  return Width::U8;
+  case Type::I8:  return Width::S8;
+  case Type::Ptr: return Width::W64;
+  default:        return Width::W32;
+  }
+}
+
+Cond ICmpCond(Opcode Op) {
+  switch (Op) {
+  case Opcode::ICmpEQ:  return CC_E;
+  case Opcode::ICmpNE:  return CC_NE;
+  case Opcode::ICmpSLT: return CC_L;
+  case Opcode::ICmpSLE: return CC_LE;
+  case Opcode::ICmpSGT: return CC_G;
+  case Opcode::ICmpSGE: return CC_GE;
+  case Opcode::ICmpULT: return CC_B;
+  default:              Unreachable("Expected integer comparison.");
+  }
+}
+
+/// \brief Instruction selector for one function.
+///
+/// Frame layout below saved RBP:
+///   callee-saved registers
+///   spill slots
+///   arrays
+///   temporaries for parallel copies to φ-nodes
+class FunctionEmitter {
+public:
+  FunctionEmitter(const ir::Module &M, const ir::Function &F, Assembler &Asm)
+    : mModule(M)
+    , mFunc(F)
+    , mAsm(Asm)
+    , mAlloc(AllocateRegisters(F))
+    , mLabels(F.Blocks.size()) {}
+
+  void Emit() {
+    LayoutFrame();
+    EmitPrologue();
+
+    for (BlockID BB : mAlloc.Order)
+      mLabels[BB] = mAsm.NewLabel();
+
+    for (size_t I = 0; I < mAlloc.Order.size(); ++I) {
+      BlockID BB = mAlloc.Order[I];
+      mNext = I + 1 < mAlloc.Order.size() ? mAlloc.Order[I + 1] : ir::NoID;
+      mAsm.Bind(mLabels[BB]);
+      for (ValueID V : mFunc.Blocks[BB].Instrs)
+        EmitInstr(V);
+    }
+  }
+
+private:
+  void LayoutFrame() {
+    mSavedSize = 8 * mAlloc.UsedCalleeSaved.size();
+    int32_t Cursor = mSavedSize + 8 * mAlloc.SpillSlots;
+
+    size_t MaxPhis = 0;
+    for (BlockID BB : mAlloc.Order) {
+      size_t Phis = 0;
+      for (ValueID V : mFunc.Blocks[BB].Instrs) {
+        const ir::Instr &I = mFunc.Instrs[V];
+        Phis += I.Op == Opcode::Phi;
+        if (I.Op != Opcode::Alloca)
+          continue;
+        Cursor += (I.Imm * SizeOf(I.ElemTy) + 15) / 16 * 16;
+        mArrays[V] = -Cursor;
+      }
+      MaxPhis = std::max(MaxPhis, Phis);
+    }
+
+    Cursor += 8 * MaxPhis;
+    mTempOffset = -Cursor;
+    /// RSP is aligned by 16 at calls.
+    mFrameSize = (Cursor + 15) / 16 * 16 - mSavedSize;
+  }
+
+  void EmitPrologue() {
+    mAsm.Push(RBP);
+    mAsm.Mov(RBP, RSP, /*Wide=*/true);
+    for (Reg R : mAlloc.UsedCalleeSaved)
+      mAsm.Push(R);
+    if (mFrameSize)
+      mAsm.AluImm(ALU_SUB, RSP, mFrameSize, /*Wide=*/true);
+
+    unsigned IntArgs = 0;
+    unsigned FloatArgs = 0;
+    unsigned StackArgs = 0;
+    for (ValueID P : mFunc.Params()) {
+      Type Ty = mFunc.Instrs[P].Ty;
+      if (IsFloat(Ty)) {
+        if (FloatArgs < std::size(FloatArgRegs))
+          StoreXMM(P, FloatArgRegs[FloatArgs++]);
+        else {
+          mAsm.MovssLoad(XMM14, {RBP, static_cast<int32_t>(16 + 8 * StackArgs++)});
+          StoreXMM(P, XMM14);
+        }
+        continue;
+      }
+      Reg R = RAX;
+      if (IntArgs < std::size(IntArgRegs))
+        R = IntArgRegs[IntArgs++];
+      else
+        mAsm.Load(RAX, {RBP, static_cast<int32_t>(16 + 8 * StackArgs++)}, Width::W64);
+      /// Caller is not required to extend small integers.
+      Normalize(R, Ty);
+      StoreGPR(P, R);
+    }
+  }
+
+  void EmitEpilogue() {
+    if (mSavedSize) {
+      mAsm.Lea(RSP, {RBP, -mSavedSize});
+      for (auto It = mAlloc.UsedCalleeSaved.rbegin(); It != mAlloc.UsedCalleeSaved.rend(); ++It)
+        mAsm.Pop(*It);
+    } else
+      mAsm.Mov(RSP, RBP, /*Wide=*/true);
+    mAsm.Pop(RBP);
+    mAsm.Ret();
+  }
+
+  Mem SlotAddress(uint32_t Slot) const {
+    return {RBP, -static_cast<int32_t>(mSavedSize + 8 * (Slot + 1))};
+  }
+
+  /// Bring value to scratch register.
+  void LoadGPR(Reg R, ValueID V) {
+    const ir::Instr &I = mFunc.Instrs[V];
+    if (I.Op == Opcode::Const) {
+      mAsm.MovImm(R, static_cast<int32_t>(I.IntValue()));
+      return;
+    }
+    const Location &L = mAlloc.Locations[V];
+    bool Wide = I.Ty == Type::Ptr;
+    switch (L.Kind) {
+    case Location::GPR:
+      if (L.Reg != R)
+        mAsm.Mov(R, static_cast<Reg>(L.Reg), Wide);
+      break;
+    case Location::STACK:
+      mAsm.Load(R, SlotAddress(L.Slot), Wide ? Width::W64 : Width::W32);
+      break;
+    default:
+      /// Undefined value can be anything.
+      break;
+    }
+  }
+
+  void StoreGPR(ValueID V, Reg R) {
+    const Location &L = mAlloc.Locations[V];
+    bool Wide = mFunc.Instrs[V].Ty == Type::Ptr;
+    switch (L.Kind) {
+    case Location::GPR:
+      if (L.Reg != R)
+        mAsm.Mov(static_cast<Reg>(L.Reg), R, Wide);
+      break;
+    case Location::STACK:
+      mAsm.Store(SlotAddress(L.Slot), R, Wide ? Width::W64 : Width::W32);
+      break;
+    default:
+      break;
+    }
+  }
+
+  /// Bring float value to scratch register. Constants are materialized
+  /// through RAX.
+  void LoadXMM(XReg X, ValueID V) {
+    const ir::Instr &I = mFunc.Instrs[V];
+    if (I.Op == Opcode::Const) {
+      mAsm.MovImm(RAX, static_cast<int32_t>(I.Imm));
+      mAsm.MovdToXmm(X, RAX);
+      return;
+    }
+    const Location &L = mAlloc.Locations[V];
+    switch (L.Kind) {
+    case Location::XMM:
+      if (L.Reg != X)
+        mAsm.SSE(SSE_MOVSS, X, static_cast<XReg>(L.Reg));
+      break;
+    case Location::STACK:
+      mAsm.MovssLoad(X, SlotAddress(L.Slot));
+      break;
+    default:
+      break;
+    }
+  }
+
+  void StoreXMM(ValueID V, XReg X) {
+    const Location &L = mAlloc.Locations[V];
+    switch (L.Kind) {
+    case Location::XMM:
+      if (L.Reg != X)
+        mAsm.SSE(SSE_MOVSS, static_cast<XReg>(L.Reg), X);
+      break;
+    case Location::STACK:
+      mAsm.MovssStore(SlotAddress(L.Slot), X);
+      break;
+    default:
+      break;
+    }
+  }
+
+  /// Restore representation of small integer after operation on 32 bits.
+  void Normalize(Reg R, Type Ty) {
+    if (Ty == Type::I8)
+      mAsm.MovSX8(R, R);
+    else if (Ty == Type::I1)
+      mAsm.AluImm(ALU_AND, R, 1, /*Wide=*/false);
+  }
+
+  void EmitInstr(ValueID V) {
+    const ir::Instr &I = mFunc.Instrs[V];
+
+    switch (I.Op) {
+    case Opcode::Add: EmitBinary(V, ALU_ADD); break;
+    case Opcode::Sub: EmitBinary(V, ALU_SUB); break;
+    case Opcode::And: EmitBinary(V, ALU_AND); break;
+    case Opcode::Or:  EmitBinary(V, ALU_OR); break;
+    case Opcode::Xor: EmitBinary(V, ALU_XOR); break;
+    case Opcode::Mul:
+      LoadGPR(RAX, I.Ops[0]);
+      LoadGPR(RCX, I.Ops[1]);
+      mAsm.IMul(RAX, RCX);
+      Normalize(RAX, I.Ty);
+      StoreGPR(V, RAX);
+      break;
+    case Opcode::SDiv:
+      LoadGPR(RAX, I.Ops[0]);
+      LoadGPR(RCX, I.Ops[1]);
+      mAsm.Cdq();
+      mAsm.IDiv(RCX);
+      Normalize(RAX, I.Ty);
+      StoreGPR(V, RAX);
+      break;
+    case Opcode::Shl:
+    case Opcode::AShr:
+      LoadGPR(RAX, I.Ops[0]);
+      LoadGPR(RCX, I.Ops[1]);
+      if (I.Op == Opcode::Shl)
+        mAsm.Shl(RAX);
+      else
+        mAsm.Sar(RAX);
+      Normalize(RAX, I.Ty);
+      StoreGPR(V, RAX);
+      break;
+    case Opcode::FAdd: EmitFloatBinary(V, SSE_ADDSS); break;
+    case Opcode::FSub: EmitFloatBinary(V, SSE_SUBSS); break;
+    case Opcode::FMul: EmitFloatBinary(V, SSE_MULSS); break;
+    case Opcode::FDiv: EmitFloatBinary(V, SSE_DIVSS); break;
+    case Opcode::ICmpEQ:
+    case Opcode::ICmpNE:
+    case Opcode::ICmpSLT:
+    case Opcode::ICmpSLE:
+    case Opcode::ICmpSGT:
+    case Opcode::ICmpSGE:
+    case Opcode::ICmpULT:
+      EmitICmp(V);
+      break;
+    case Opcode::FCmpOEQ:
+    case Opcode::FCmpONE:
+    case Opcode::FCmpOLT:
+    case Opcode::FCmpOLE:
+    case Opcode::FCmpOGT:
+    case Opcode::FCmpOGE:
+    case Opcode::FCmpUNE:
+      EmitFCmp(V);
+      break;
+    case Opcode::ZExt:
+      LoadGPR(RAX, I.Ops[0]);
+      if (mFunc.Instrs[I.Ops[0]].Ty == Type::I8)
+        mAsm.MovZX8(RAX, RAX);
+      StoreGPR(V, RAX);
+      break;
+    case Opcode::SExt:
+      LoadGPR(RAX, I.Ops[0]);
+      /// True of I1 type is -1.
+      if (mFunc.Instrs[I.Ops[0]].Ty == Type::I1)
+        mAsm.Neg(RAX);
+      StoreGPR(V, RAX);
+      break;
+    case Opcode::UIToFP:
+      LoadGPR(RAX, I.Ops[0]);
+      if (mFunc.Instrs[I.Ops[0]].Ty == Type::I8)
+        mAsm.MovZX8(RAX, RAX);
+      /// Zero-extended 32-bit value is always positive 64-bit one.
+      mAsm.Cvtsi2ss(XMM14, RAX);
+      StoreXMM(V, XMM14);
+      break;
+    case Opcode::Alloca:
+      mAsm.Lea(RAX, {RBP, mArrays[V]});
+      StoreGPR(V, RAX);
+      break;
+    case Opcode::ElemAddr:
+      LoadGPR(RAX, I.Ops[0]);
+      LoadGPR(RCX, I.Ops[1]);
+      mAsm.MovSXD(RCX, RCX);
+      mAsm.Lea(RAX, {RAX, 0, RCX, static_cast<uint8_t>(SizeOf(I.ElemTy))});
+      StoreGPR(V, RAX);
+      break;
+    case Opcode::Load:
+      LoadGPR(RAX, I.Ops[0]);
+      if (IsFloat(I.Ty)) {
+        mAsm.MovssLoad(XMM14, {RAX});
+        StoreXMM(V, XMM14);
+      } else {
+        mAsm.Load(RAX, {RAX}, WidthOf(I.Ty));
+        StoreGPR(V, RAX);
+      }
+      break;
+    case Opcode::Store: {
+      Type Ty = mFunc.Instrs[I.Ops[0]].Ty;
+      LoadGPR(RCX, I.Ops[1]);
+      if (IsFloat(Ty)) {
+        LoadXMM(XMM14, I.Ops[0]);
+        mAsm.MovssStore({RCX}, XMM14);
+      } else {
+        LoadGPR(RAX, I.Ops[0]);
+        mAsm.Store({RCX}, RAX, WidthOf(Ty));
+      }
+      break;
+    }
+    case Opcode::Call:
+      EmitCall(V);
+      break;
+    case Opcode::Phi:
+      /// Defined by copies at the end of predecessors.
+      break;
+    case Opcode::Br:
+      EmitEdge(I.Block, mFunc.Blocks[I.Block].Succs[0]);
+      EmitJump(mFunc.Blocks[I.Block].Succs[0]);
+      break;
+    case Opcode::CondBr:
+      EmitCondBr(V);
+      break;
+    case Opcode::Ret:
+      if (!I.Ops.empty()) {
+        if (IsFloat(mFunc.Instrs[I.Ops[0]].Ty))
+          LoadXMM(XMM0, I.Ops[0]);
+        else
+          LoadGPR(RAX, I.Ops[0]);
+      }
+      EmitEpilogue();
+      break;
+    case Opcode::Trap:
+    case Opcode::Unreachable:
+      mAsm.Ud2();
+      break;
+    default:
+      Unreachable("Unexpected instruction in block.");
+    }
+  }
+
+  void EmitBinary(ValueID V, AluOp Op) {
+    const ir::Instr &I = mFunc.Instrs[V];
+    LoadGPR(RAX, I.Ops[0]);
+    LoadGPR(RCX, I.Ops[1]);
+    mAsm.Alu(Op, RAX, RCX, /*Wide=*/false);
+    Normalize(RAX, I.Ty);
+    StoreGPR(V, RAX);
+  }
+
+  void EmitFloatBinary(ValueID V, SSEOp Op) {
+    const ir::Instr &I = mFunc.Instrs[V];
+    LoadXMM(XMM14, I.Ops[0]);
+    LoadXMM(XMM15, I.Ops[1]);
+    mAsm.SSE(Op, XMM14, XMM15);
+    StoreXMM(V, XMM14);
+  }
+
+  void EmitICmp(ValueID V) {
+    const ir::Instr &I = mFunc.Instrs[V];
+    Type Ty = mFunc.Instrs[I.Ops[0]].Ty;
+    LoadGPR(RAX, I.Ops[0]);
+    LoadGPR(RCX, I.Ops[1]);
+
+    bool IsSigned = I.Op != Opcode::ICmpEQ && I.Op != Opcode::ICmpNE && I.Op != Opcode::ICmpULT;
+    if (Ty == Type::I1 && IsSigned) {
+      mAsm.Neg(RAX);
+      mAsm.Neg(RCX);
+    }
+    if (Ty == Type::I8 && I.Op == Opcode::ICmpULT) {
+      mAsm.MovZX8(RAX, RAX);
+      mAsm.MovZX8(RCX, RCX);
+    }
+
+    mAsm.Alu(ALU_CMP, RAX, RCX, /*Wide=*/Ty == Type::Ptr);
+    mAsm.SetCC(ICmpCond(I.Op), RAX);
+    mAsm.MovZX8(RAX, RAX);
+    StoreGPR(V, RAX);
+  }
+
+  void EmitFCmp(ValueID V) {
+    const ir::Instr &I = mFunc.Instrs[V];
+    LoadXMM(XMM14, I.Ops[0]);
+    LoadXMM(XMM15, I.Ops[1]);
+
+    /// Unordered result sets ZF, PF and CF, so "above" conditions are
+    /// false for NaN, and less-than is checked with swapped operands.
+    switch (I.Op) {
+    case Opcode::FCmpOLT:
+    case Opcode::FCmpOLE:
+      mAsm.Ucomiss(XMM15, XMM14);
+      mAsm.SetCC(I.Op == Opcode::FCmpOLT ? CC_A : CC_AE, RAX);
+      break;
+    case Opcode::FCmpOGT:
+    case Opcode::FCmpOGE:
+      mAsm.Ucomiss(XMM14, XMM15);
+      mAsm.SetCC(I.Op == Opcode::FCmpOGT ? CC_A : CC_AE, RAX);
+      break;
+    case Opcode::FCmpONE:
+      mAsm.Ucomiss(XMM14, XMM15);
+      mAsm.SetCC(CC_NE, RAX);
+      break;
+    case Opcode::FCmpOEQ:
+      mAsm.Ucomiss(XMM14, XMM15);
+      mAsm.SetCC(CC_E, RAX);
+      mAsm.SetCC(CC_NP, RCX);
+      mAsm.Alu(ALU_AND, RAX, RCX, /*Wide=*/false);
+      break;
+    case Opcode::FCmpUNE:
+      mAsm.Ucomiss(XMM14, XMM15);
+      mAsm.SetCC(CC_NE, RAX);
+      mAsm.SetCC(CC_P, RCX);
+      mAsm.Alu(ALU_OR, RAX, RCX, /*Wide=*/false);
+      break;
+    default:
+      Unreachable("Expected float comparison.");
+    }
+
+    mAsm.MovZX8(RAX, RAX);
+    StoreGPR(V, RAX);
+  }
+
+  void EmitCall(ValueID V) {
+    const ir::Instr &I = mFunc.Instrs[V];
+    std::vector<ValueID> IntArgs;
+    std::vector<ValueID> FloatArgs;
+    std::vector<ValueID> StackArgs;
+
+    for (ValueID Arg : I.Ops) {
+      if (IsFloat(mFunc.Instrs[Arg].Ty)) {
+        if (FloatArgs.size() < std::size(FloatArgRegs))
+          FloatArgs.push_back(Arg);
+        else
+          StackArgs.push_back(Arg);
+      } else {
+        if (IntArgs.size() < std::size(IntArgRegs))
+          IntArgs.push_back(Arg);
+        else
+          StackArgs.push_back(Arg);
+      }
+    }
+
+    /// Keep stack aligned by 16 after pushes.
+    int32_t StackSize = 8 * (StackArgs.size() + StackArgs.size() % 2);
+    if (StackArgs.size() % 2)
+      mAsm.AluImm(ALU_SUB, RSP, 8, /*Wide=*/true);
+    for (auto It = StackArgs.rbegin(); It != StackArgs.rend(); ++It) {
+      if (IsFloat(mFunc.Instrs[*It].Ty)) {
+        LoadXMM(XMM14, *It);
+        mAsm.MovdFromXmm(RAX, XMM14);
+      } else
+        LoadGPR(RAX, *It);
+      mAsm.Push(RAX);
+    }
+
+    /// Allocated registers never overlap with argument registers, so
+    /// arguments can be moved in any order.
+    for (size_t N = 0; N < FloatArgs.size(); ++N)
+      LoadXMM(FloatArgRegs[N], FloatArgs[N]);
+    for (size_t N = 0; N < IntArgs.size(); ++N)
+      LoadGPR(IntArgRegs[N], IntArgs[N]);
+
+    mAsm.Call(mModule.SymbolName(I.Imm));
+
+    if (StackSize)
+      mAsm.AluImm(ALU_ADD, RSP, StackSize, /*Wide=*/true);
+
+    if (I.Ty == Type::Void)
+      return;
+    if (IsFloat(I.Ty)) {
+      StoreXMM(V, XMM0);
+      return;
+    }
+    /// Callee is not required to extend small integers.
+    Normalize(RAX, I.Ty);
+    StoreGPR(V, RAX);
+  }
+
+  bool HasPhis(BlockID BB) const {
+    const auto &Instrs = mFunc.Blocks[BB].Instrs;
+    return !Instrs.empty() && mFunc.Instrs[Instrs.front()].Op == Opcode::Phi;
+  }
+
+  bool SameLocation(ValueID L, ValueID R) const {
+    const Location &A = mAlloc.Locations[L];
+    const Location &B = mAlloc.Locations[R];
+    if (A.Kind != B.Kind || A.Kind == Location::NONE)
+      return false;
+    return A.Kind == Location::STACK ? A.Slot == B.Slot : A.Reg == B.Reg;
+  }
+
+  /// Assign values, coming from predecessor, to φ-nodes of successor.
+  /// Copies are parallel, so all sources are saved to temporaries first.
+  void EmitEdge(BlockID Pred, BlockID Succ) {
+    const auto &Preds = mFunc.Blocks[Succ].Preds;
+    size_t Index = std::find(Preds.begin(), Preds.end(), Pred) - Preds.begin();
+
+    std::vector<std::pair<ValueID, ValueID>> Copies;
+    for (ValueID Phi : mFunc.Blocks[Succ].Instrs) {
+      const ir::Instr &I = mFunc.Instrs[Phi];
+      if (I.Op != Opcode::Phi)
+        break;
+      ValueID Src = I.Ops[Index];
+      if (mFunc.Instrs[Src].Op == Opcode::Undef || SameLocation(Phi, Src))
+        continue;
+      Copies.emplace_back(Phi, Src);
+    }
+
+    auto Temp = [&](size_t N) { return Mem{RBP, static_cast<int32_t>(mTempOffset + 8 * N)}; };
+
+    if (Copies.size() == 1) {
+      auto [Phi, Src] = Copies.front();
+      EmitCopy(Phi, Src);
+      return;
+    }
+
+    for (size_t N = 0; N < Copies.size(); ++N) {
+      ValueID Src = Copies[N].second;
+      if (IsFloat(mFunc.Instrs[Src].Ty)) {
+        LoadXMM(XMM14, Src);
+        mAsm.MovssStore(Temp(N), XMM14);
+      } else {
+        LoadGPR(RAX, Src);
+        mAsm.Store(Temp(N), RAX, Width::W64);
+      }
+    }
+    for (size_t N = 0; N < Copies.size(); ++N) {
+      ValueID Phi = Copies[N].first;
+      if (IsFloat(mFunc.Instrs[Phi].Ty)) {
+        mAsm.MovssLoad(XMM14, Temp(N));
+        StoreXMM(Phi, XMM14);
+      } else {
+        mAsm.Load(RAX, Temp(N), Width::W64);
+        StoreGPR(Phi, RAX);
+      }
+    }
+  }
+
+  void EmitCopy(ValueID Dst, ValueID Src) {
+    if (IsFloat(mFunc.Instrs[Src].Ty)) {
+      LoadXMM(XMM14, Src);
+      StoreXMM(Dst, XMM14);
+    } else {
+      LoadGPR(RAX, Src);
+      StoreGPR(Dst, RAX);
+    }
+  }
+
+  void EmitJump(BlockID Target) {
+    if (Target != mNext)
+      mAsm.Jmp(mLabels[Target]);
+  }
+
+  void EmitCondBr(ValueID V) {
+    const ir::Instr &I = mFunc.Instrs[V];
+    const auto &Succs = mFunc.Blocks[I.Block].Succs;
+    BlockID True = Succs[0];
+    BlockID False = Succs[1];
+
+    LoadGPR(RAX, I.Ops[0]);
+    mAsm.Test(RAX, RAX);
+
+    if (HasPhis(True) || HasPhis(False)) {
+      Label FalseEdge = mAsm.NewLabel();
+      mAsm.Jcc(CC_E, FalseEdge);
+      EmitEdge(I.Block, True);
+      mAsm.Jmp(mLabels[True]);
+      mAsm.Bind(FalseEdge);
+      EmitEdge(I.Block, False);
+      EmitJump(False);
+      return;
+    }
+
+    if (True == mNext) {
+      mAsm.Jcc(CC_E, mLabels[False]);
+      return;
+    }
+    mAsm.Jcc(CC_NE, mLabels[True]);
+    EmitJump(False);
+  }
+
+  const ir::Module &mModule;
+  const ir::Function &mFunc;
+  Assembler &mAsm;
+  Allocation mAlloc;
+  std::vector<Label> mLabels;
+  /// Offsets of arrays from RBP.
+  std::unordered_map<ValueID, int32_t> mArrays;
+  /// Block, emitted after current one.
+  BlockID mNext{ir::NoID};
+  int32_t mSavedSize{0};
+  int32_t mFrameSize{0};
+  int32_t mTempOffset{0};
+};
+
+elf::ObjectWriter CreateObject(const ir::Module &M) {
+  Assembler Asm;
+  std::unordered_map<std::string, uint32_t> Offsets;
+  std::vector<std::pair<uint32_t, uint32_t>> Ranges;
+
+  for (const ir::Function &F : M.Functions) {
+    Asm.Align(16);
+    uint32_t Start = Asm.Code().size();
+    FunctionEmitter(M, F, Asm).Emit();
+    Offsets[F.Name()] = Start;
+    Ranges.emplace_back(Start, Asm.Code().size() - Start);
+  }
+  Asm.Finish();
+
+  /// Calls between functions of object are resolved right here.
+  std::vector<uint8_t> Code = Asm.Code();
+  std::vector<const CallFixup *> External;
+  for (const CallFixup &Call : Asm.Calls()) {
+    auto It = Offsets.find(Call.Symbol);
+    if (It == Offsets.end()) {
+      External.push_back(&Call);
+      continue;
+    }
+    uint32_t Disp = It->second - (Call.Offset + 4);
+    for (unsigned I = 0; I < 4; ++I)
+      Code[Call.Offset + I] = Disp >> (I * 8U);
+  }
+
+  elf::ObjectWriter Writer(std::move(Code));
+  for (size_t I = 0; I < M.Functions.size(); ++I)
+    Writer.AddFunction(M.Functions[I].Name(), Ranges[I].first, Ranges[I].second, !M.Functions[I].Exported);
+  for (const CallFixup *Call : External)
+    Writer.AddCall(Call->Offset, Call->Symbol);
+  return Writer;
+}
+
+} // namespace
+
+void EmitObjectFile(const ir::Module &M, std::string_view Path) {
+  CreateObject(M).Write(Path);
+}
+
+std::vector<char> EmitObject(const ir::Module &M) {
+  return CreateObject(M).Emit();
+}
+
+} // namespace weak::x86
\ No newline at end of file
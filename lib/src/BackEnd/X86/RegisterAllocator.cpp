@@ -0,0 +1,284 @@
+/* RegisterAllocator.cpp - Linear scan register allocation for Weak IR.
+ * Copyright (C) 2022 epoll-reactor <glibcxx.chrono@gmail.com>
+ *
+ * This file is distributed under the MIT license.
+ */
+
+#include "BackEnd/X86/RegisterAllocator.h"
+#include "llvm/ADT/BitVector.h"
+#include <algorithm>
+
+namespace weak::x86 {
+namespace {
+
+using ir::BlockID;
+using ir::Opcode;
+using ir::ValueID;
+
+/// Caller-saved registers go first, so short intervals do not force
+/// prologue to save anything.
+constexpr Reg AllocatableGPRs[] = {R10, RBX, R12, R13, R14, R15};
+constexpr uint8_t AllocatableXMMs[] = {XMM8, XMM9, XMM10, XMM11, XMM12, XMM13};
+
+bool IsCalleeSaved(Reg R) {
+  return R == RBX || R == RBP || (R >= R12 && R <= R15);
+}
+
+struct Interval {
+  ValueID Value;
+  uint32_t Start;
+  uint32_t End;
+  bool IsFloat;
+  bool CrossesCall;
+};
+
+class LinearScan {
+public:
+  explicit LinearScan(const ir::Function &F)
+    : mFunc(F) {
+    mResult.Order = ir::ReversePostOrder(F);
+    mResult.Locations.resize(F.Instrs.size());
+  }
+
+  Allocation Run() {
+    Number();
+    ComputeLiveness();
+    BuildIntervals();
+    Scan();
+
+    for (const Location &L : mResult.Locations)
+      if (L.Kind == Location::GPR && IsCalleeSaved(static_cast<Reg>(L.Reg)) &&
+          std::find(mResult.UsedCalleeSaved.begin(), mResult.UsedCalleeSaved.end(), L.Reg) == mResult.UsedCalleeSaved.end())
+        mResult.UsedCalleeSaved.push_back(static_cast<Reg>(L.Reg));
+    std::sort(mResult.UsedCalleeSaved.begin(), mResult.UsedCalleeSaved.end());
+
+    return std::move(mResult);
+  }
+
+private:
+  bool NeedsLocation(ValueID V) const {
+    const ir::Instr &I = mFunc.Instrs[V];
+    if (I.Ty == ir::Type::Void)
+      return false;
+    return I.Op == Opcode::Param || (I.Block != ir::NoID && I.Op != Opcode::Nop);
+  }
+
+  /// Number instructions in order of emission. Even positions are taken
+  /// by instructions, odd position after the last one in block is used
+  /// for copies to φ-nodes of successors.
+  void Number() {
+    uint32_t Size = mFunc.Blocks.size();
+    mBlockStart.assign(Size, 0U);
+    mBlockEnd.assign(Size, 0U);
+    mPositions.assign(mFunc.Instrs.size(), 0U);
+    mHasPosition.assign(Size, false);
+
+    uint32_t Pos = 2;
+    for (BlockID BB : mResult.Order) {
+      mHasPosition[BB] = true;
+      mBlockStart[BB] = Pos;
+      for (ValueID V : mFunc.Blocks[BB].Instrs) {
+        mPositions[V] = Pos;
+        if (mFunc.Instrs[V].Op == Opcode::Call)
+          mCalls.push_back(Pos);
+        Pos += 2;
+      }
+      mBlockEnd[BB] = Pos - 1;
+    }
+  }
+
+  void ComputeLiveness() {
+    size_t Size = mFunc.Instrs.size();
+    std::vector<llvm::BitVector> Gen(mFunc.Blocks.size(), llvm::BitVector(Size));
+    std::vector<llvm::BitVector> Kill(mFunc.Blocks.size(), llvm::BitVector(Size));
+    mLiveIn.assign(mFunc.Blocks.size(), llvm::BitVector(Size));
+    mLiveOut.assign(mFunc.Blocks.size(), llvm::BitVector(Size));
+
+    for (BlockID BB : mResult.Order)
+      for (ValueID V : mFunc.Blocks[BB].Instrs) {
+        const ir::Instr &I = mFunc.Instrs[V];
+        if (I.Op != Opcode::Phi)
+          for (ValueID Op : I.Ops)
+            if (NeedsLocation(Op) && !Kill[BB].test(Op))
+              Gen[BB].set(Op);
+        if (NeedsLocation(V))
+          Kill[BB].set(V);
+      }
+
+    bool Changed = true;
+    while (Changed) {
+      Changed = false;
+      for (auto It = mResult.Order.rbegin(); It != mResult.Order.rend(); ++It) {
+        BlockID BB = *It;
+        llvm::BitVector Out(Size);
+        for (BlockID Succ : mFunc.Blocks[BB].Succs) {
+          Out |= mLiveIn[Succ];
+          ForEachPhiUse(BB, Succ, [&](ValueID, ValueID Op) {
+            if (NeedsLocation(Op))
+              Out.set(Op);
+          });
+        }
+        llvm::BitVector In = Out;
+        In.reset(Kill[BB]);
+        In |= Gen[BB];
+        if (In != mLiveIn[BB] || Out != mLiveOut[BB]) {
+          mLiveIn[BB] = std::move(In);
+          mLiveOut[BB] = std::move(Out);
+          Changed = true;
+        }
+      }
+    }
+  }
+
+  template <typename Callback>
+  void ForEachPhiUse(BlockID Pred, BlockID Succ, Callback C) const {
+    const auto &Preds = mFunc.Blocks[Succ].Preds;
+    size_t Index = std::find(Preds.begin(), Preds.end(), Pred) - Preds.begin();
+    for (ValueID Phi : mFunc.Blocks[Succ].Instrs) {
+      const ir::Instr &I = mFunc.Instrs[Phi];
+      if (I.Op != Opcode::Phi)
+        break;
+      C(Phi, I.Ops[Index]);
+    }
+  }
+
+  void BuildIntervals() {
+    std::vector<uint32_t> Start(mFunc.Instrs.size(), UINT32_MAX);
+    std::vector<uint32_t> End(mFunc.Instrs.size(), 0U);
+
+    auto Extend = [&](ValueID V, uint32_t Pos) {
+      Start[V] = std::min(Start[V], Pos);
+      End[V] = std::max(End[V], Pos);
+    };
+
+    for (ValueID P : mFunc.Params())
+      Extend(P, 0);
+
+    for (BlockID BB : mResult.Order) {
+      for (ValueID V : mFunc.Blocks[BB].Instrs) {
+        const ir::Instr &I = mFunc.Instrs[V];
+        if (NeedsLocation(V))
+          Extend(V, I.Op == Opcode::Phi ? mBlockStart[BB] : mPositions[V]);
+        if (I.Op == Opcode::Phi) {
+          const auto &Preds = mFunc.Blocks[BB].Preds;
+          for (size_t Op = 0; Op < I.Ops.size(); ++Op)
+            if (NeedsLocation(I.Ops[Op]) && mHasPosition[Preds[Op]])
+              Extend(I.Ops[Op], mBlockEnd[Preds[Op]]);
+          continue;
+        }
+        for (ValueID Op : I.Ops)
+          if (NeedsLocation(Op))
+            Extend(Op, mPositions[V]);
+      }
+      for (unsigned V : mLiveIn[BB].set_bits())
+        Extend(V, mBlockStart[BB]);
+      for (unsigned V : mLiveOut[BB].set_bits())
+        Extend(V, mBlockEnd[BB]);
+    }
+
+    for (ValueID V = 0; V < mFunc.Instrs.size(); ++V) {
+      if (Start[V] == UINT32_MAX)
+        continue;
+      auto Call = std::upper_bound(mCalls.begin(), mCalls.end(), Start[V]);
+      bool CrossesCall = Call != mCalls.end() && *Call < End[V];
+      mIntervals.push_back({V, Start[V], End[V], mFunc.Instrs[V].Ty == ir::Type::F32, CrossesCall});
+    }
+
+    std::sort(mIntervals.begin(), mIntervals.end(), [](const Interval &L, const Interval &R) {
+      return L.Start != R.Start ? L.Start < R.Start : L.Value < R.Value;
+    });
+  }
+
+  bool IsAllowed(const Interval &I, uint8_t R) const {
+    return !I.CrossesCall || (!I.IsFloat && IsCalleeSaved(static_cast<Reg>(R)));
+  }
+
+  void Spill(ValueID V) {
+    Location &L = mResult.Locations[V];
+    L.Kind = Location::STACK;
+    L.Slot = mResult.SpillSlots++;
+  }
+
+  void Scan() {
+    bool FreeGPR[16];
+    bool FreeXMM[16];
+    std::fill(std::begin(FreeGPR), std::end(FreeGPR), true);
+    std::fill(std::begin(FreeXMM), std::end(FreeXMM), true);
+    std::vector<const Interval *> Active;
+
+    for (const Interval &I : mIntervals) {
+      /// Expire intervals, ended before this one.
+      Active.erase(std::remove_if(Active.begin(), Active.end(), [&](const Interval *A) {
+        if (A->End >= I.Start)
+          return false;
+        const Location &L = mResult.Locations[A->Value];
+        (A->IsFloat ? FreeXMM : FreeGPR)[L.Reg] = true;
+        return true;
+      }), Active.end());
+
+      bool *Free = I.IsFloat ? FreeXMM : FreeGPR;
+      Location &L = mResult.Locations[I.Value];
+      L.Kind = I.IsFloat ? Location::XMM : Location::GPR;
+
+      auto TryAssign = [&](uint8_t R) {
+        if (!Free[R] || !IsAllowed(I, R))
+          return false;
+        Free[R] = false;
+        L.Reg = R;
+        Active.push_back(&I);
+        return true;
+      };
+
+      bool Assigned = false;
+      if (I.IsFloat) {
+        for (uint8_t R : AllocatableXMMs)
+          if ((Assigned = TryAssign(R)))
+            break;
+      } else {
+        for (Reg R : AllocatableGPRs)
+          if ((Assigned = TryAssign(R)))
+            break;
+      }
+      if (Assigned)
+        continue;
+
+      /// Spill interval, that ends last.
+      auto Victim = Active.end();
+      for (auto It = Active.begin(); It != Active.end(); ++It) {
+        if ((*It)->IsFloat != I.IsFloat)
+          continue;
+        if (!IsAllowed(I, mResult.Locations[(*It)->Value].Reg))
+          continue;
+        if (Victim == Active.end() || (*It)->End > (*Victim)->End)
+          Victim = It;
+      }
+
+      if (Victim != Active.end() && (*Victim)->End > I.End) {
+        L.Reg = mResult.Locations[(*Victim)->Value].Reg;
+        Spill((*Victim)->Value);
+        *Victim = &I;
+      } else
+        Spill(I.Value);
+    }
+  }
+
+  const ir::Function &mFunc;
+  Allocation mResult;
+  std::vector<uint32_t> mBlockStart;
+  std::vector<uint32_t> mBlockEnd;
+  std::vector<uint32_t> mPositions;
+  std::vector<bool> mHasPosition;
+  /// Positions of calls in ascending order.
+  std::vector<uint32_t> mCalls;
+  std::vector<llvm::BitVector> mLiveIn;
+  std::vector<llvm::BitVector> mLiveOut;
+  std::vector<Interval> mIntervals;
+};
+
+} // namespace
+
+Allocation AllocateRegisters(const ir::Function &F) {
+  return LinearScan(F).Run();
+}
+
+} // namespace weak::x86
\ No newline at end of file
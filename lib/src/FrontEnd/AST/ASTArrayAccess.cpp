@@ -16,7 +16,8 @@ ASTArrayAccess::ASTArrayAccess(
   unsigned               TheColumnNo
 ) : ASTNode(AST_ARRAY_ACCESS, TheLineNo, TheColumnNo)
   , mName(std::move(Name))
-  , mIndices(std::move(Indices)) {}
+  , mIndices(std::move(Indices))
+  , mInBounds(false) {}
 
 ASTArrayAccess::~ASTArrayAccess() {
   for (auto *I : mIndices)
@@ -35,4 +36,16 @@ const std::vector<ASTNode *> &ASTArrayAccess::Indices() const {
   return mIndices;
 }
 
+std::vector<ASTNode *> &ASTArrayAccess::Indices() {
+  return mIndices;
+}
+
+bool ASTArrayAccess::InBounds() const {
+  return mInBounds;
+}
+
+void ASTArrayAccess::SetInBounds(bool InBounds) {
+  mInBounds = InBounds;
+}
+
 } // namespace weak
\ No newline at end of file
@@ -18,7 +18,8 @@ ASTArrayDecl::ASTArrayDecl(
 ) : ASTNode(AST_ARRAY_DECL, LineNo, ColumnNo)
   , mDataType(DT)
   , mName(std::move(Name))
-  , mArityList(std::move(ArityList)) {}
+  , mArityList(std::move(ArityList))
+  , mMode(PARAM_DEFAULT) {}
 
 void ASTArrayDecl::Accept(ASTVisitor *Visitor) {
   Visitor->Visit(this);
@@ -36,4 +37,12 @@ const std::vector<unsigned> &ASTArrayDecl::ArityList() const {
   return mArityList;
 }
 
+ParamMode ASTArrayDecl::Mode() const {
+  return mMode;
+}
+
+void ASTArrayDecl::SetMode(ParamMode Mode) {
+  mMode = Mode;
+}
+
 } // namespace weak
\ No newline at end of file
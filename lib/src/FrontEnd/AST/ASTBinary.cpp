@@ -41,4 +41,12 @@ ASTNode *ASTBinary::RHS() const {
   return mRHS;
 }
 
+void ASTBinary::SetLHS(ASTNode *LHS) {
+  mLHS = LHS;
+}
+
+void ASTBinary::SetRHS(ASTNode *RHS) {
+  mRHS = RHS;
+}
+
 } // namespace weak
\ No newline at end of file
@@ -29,4 +29,8 @@ const std::vector<ASTNode *> &ASTCompound::Stmts() const {
   return mStmts;
 }
 
+std::vector<ASTNode *> &ASTCompound::Stmts() {
+  return mStmts;
+}
+
 } // namespace weak
\ No newline at end of file
@@ -35,4 +35,20 @@ ASTNode *ASTDoWhile::Condition() const {
   return mCondition;
 }
 
+void ASTDoWhile::SetBody(ASTCompound *Body) {
+  mBody = Body;
+}
+
+void ASTDoWhile::SetCondition(ASTNode *Condition) {
+  mCondition = Condition;
+}
+
+const LoopHints &ASTDoWhile::Hints() const {
+  return mHints;
+}
+
+void ASTDoWhile::SetHints(LoopHints Hints) {
+  mHints = Hints;
+}
+
 } // namespace weak
\ No newline at end of file
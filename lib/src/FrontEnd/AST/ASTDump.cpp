@@ -56,6 +56,7 @@ private:
 
   void Visit(ASTArrayDecl *Decl) override {
     ASTTypePrint("ArrayDecl", Decl);
+    PrintParamMode(Decl->Mode());
 
     const auto &ArityList = Decl->ArityList();
     mStream << Decl->DataType() << " "
@@ -115,6 +116,8 @@ private:
 
     mIndent += 2;
 
+    PrintLoopHints(Stmt->Hints());
+
     if (auto *Init = Stmt->Init()) {
       PrintIndent();
       ASTTypePrintLine("ForStmtInit", Init);
@@ -255,6 +258,7 @@ private:
 
   void Visit(ASTVarDecl *Decl) override {
     ASTTypePrint("VarDecl", Decl);
+    PrintParamMode(Decl->Mode());
     mStream << Decl->DataType() << ' ';
     mStream << (Decl->DataType() == DT_STRUCT ? Decl->TypeName() + ' ' : "");
     mStream << "`" << Decl->Name();
@@ -278,6 +282,7 @@ private:
 
     PrintIndent();
     ASTTypePrint("FunctionDeclName", Decl);
+    mStream << (Decl->IsExported() ? "export " : "");
     mStream << '`' << Decl->Name() << "`\n";
 
     PrintIndent();
@@ -372,6 +377,8 @@ private:
 
     mIndent += 2;
 
+    PrintLoopHints(Stmt->Hints());
+
     if (IsDoWhile) {
       PrintWhileBody();
       PrintWhileCondition();
@@ -396,6 +403,19 @@ private:
     PrintWithTextPos(Label, Node, true);
   }
 
+  void PrintLoopHints(const LoopHints &Hints) const {
+    if (Hints.Empty())
+      return;
+
+    PrintIndent();
+    mStream << "LoopHints " << Hints.ToString() << '\n';
+  }
+
+  void PrintParamMode(ParamMode Mode) const {
+    if (Mode != PARAM_DEFAULT)
+      mStream << ParamModeToString(Mode) << ' ';
+  }
+
   void PrintIndent() const { mStream << std::string(mIndent, ' '); }
 
   ASTNode *mRootNode;
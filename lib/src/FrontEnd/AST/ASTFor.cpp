@@ -49,4 +49,28 @@ ASTCompound *ASTFor::Body() const {
   return mBody;
 }
 
+void ASTFor::SetInit(ASTNode *Init) {
+  mInit = Init;
+}
+
+void ASTFor::SetCondition(ASTNode *Condition) {
+  mCondition = Condition;
+}
+
+void ASTFor::SetIncrement(ASTNode *Increment) {
+  mIncrement = Increment;
+}
+
+void ASTFor::SetBody(ASTCompound *Body) {
+  mBody = Body;
+}
+
+const LoopHints &ASTFor::Hints() const {
+  return mHints;
+}
+
+void ASTFor::SetHints(LoopHints Hints) {
+  mHints = Hints;
+}
+
 } // namespace weak
\ No newline at end of file
@@ -35,4 +35,8 @@ const std::vector<ASTNode *> &ASTFunctionCall::Args() const {
   return mArgs;
 }
 
+std::vector<ASTNode *> &ASTFunctionCall::Args() {
+  return mArgs;
+}
+
 } // namespace weak
\ No newline at end of file
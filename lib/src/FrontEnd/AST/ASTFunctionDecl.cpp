@@ -22,7 +22,8 @@ ASTFunctionDecl::ASTFunctionDecl(
   , mReturnType(ReturnType)
   , mName(std::move(Name))
   , mArgs(std::move(Args))
-  , mBody(Body) {}
+  , mBody(Body)
+  , mExported(false) {}
 
 ASTFunctionDecl::~ASTFunctionDecl() {
   for (ASTNode *Arg : mArgs)
@@ -50,4 +51,12 @@ ASTCompound *ASTFunctionDecl::Body() const {
   return mBody;
 }
 
+bool ASTFunctionDecl::IsExported() const {
+  return mExported;
+}
+
+void ASTFunctionDecl::SetExported(bool Exported) {
+  mExported = Exported;
+}
+
 } // namespace weak
\ No newline at end of file
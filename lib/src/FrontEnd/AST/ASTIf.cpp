@@ -43,4 +43,16 @@ ASTCompound *ASTIf::ElseBody() const {
   return mElseBody;
 }
 
+void ASTIf::SetCondition(ASTNode *Condition) {
+  mCondition = Condition;
+}
+
+void ASTIf::SetThenBody(ASTCompound *ThenBody) {
+  mThenBody = ThenBody;
+}
+
+void ASTIf::SetElseBody(ASTCompound *ElseBody) {
+  mElseBody = ElseBody;
+}
+
 } // namespace weak
\ No newline at end of file
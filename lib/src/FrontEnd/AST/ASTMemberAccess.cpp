@@ -17,7 +17,9 @@ ASTMemberAccess::ASTMemberAccess(
   unsigned   ColumnNo
 ) : ASTNode(AST_MEMBER_ACCESS, LineNo, ColumnNo)
   , mName(Name)
-  , mMemberDecl(MemberDecl) {}
+  , mMemberDecl(MemberDecl)
+  , mStructDecl(nullptr)
+  , mMemberIndex(0U) {}
 
 ASTMemberAccess::~ASTMemberAccess() {
   delete mName;
@@ -36,4 +38,24 @@ ASTNode *ASTMemberAccess::MemberDecl() const {
   return mMemberDecl;
 }
 
+void ASTMemberAccess::SetMemberDecl(ASTNode *MemberDecl) {
+  mMemberDecl = MemberDecl;
+}
+
+ASTStructDecl *ASTMemberAccess::StructDecl() const {
+  return mStructDecl;
+}
+
+void ASTMemberAccess::SetStructDecl(ASTStructDecl *Decl) {
+  mStructDecl = Decl;
+}
+
+unsigned ASTMemberAccess::MemberIndex() const {
+  return mMemberIndex;
+}
+
+void ASTMemberAccess::SetMemberIndex(unsigned Index) {
+  mMemberIndex = Index;
+}
+
 } // namespace weak
\ No newline at end of file
@@ -25,4 +25,8 @@ ASTNode *ASTReturn::Operand() const {
   return mOperand;
 }
 
+void ASTReturn::SetOperand(ASTNode *Operand) {
+  mOperand = Operand;
+}
+
 } // namespace weak
\ No newline at end of file
@@ -31,6 +31,10 @@ const std::vector<ASTNode *> &ASTStructDecl::Decls() const {
   return mDecls;
 }
 
+std::vector<ASTNode *> &ASTStructDecl::Decls() {
+  return mDecls;
+}
+
 const std::string &ASTStructDecl::Name() const {
   return mName;
 }
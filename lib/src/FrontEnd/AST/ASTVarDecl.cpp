@@ -19,7 +19,8 @@ ASTVarDecl::ASTVarDecl(
   , mDataType(DT)
   , mTypeName("")
   , mName(std::move(Name))
-  , mBody(Body) {}
+  , mBody(Body)
+  , mMode(PARAM_DEFAULT) {}
 
 ASTVarDecl::ASTVarDecl(
   weak::DataType  DT,
@@ -32,7 +33,8 @@ ASTVarDecl::ASTVarDecl(
   , mDataType(DT)
   , mTypeName(std::move(TypeName))
   , mName(std::move(Name))
-  , mBody(Body) {}
+  , mBody(Body)
+  , mMode(PARAM_DEFAULT) {}
 
 ASTVarDecl::~ASTVarDecl() {
   delete mBody;
@@ -58,4 +60,16 @@ ASTNode *ASTVarDecl::Body() const {
   return mBody;
 }
 
+void ASTVarDecl::SetBody(ASTNode *Body) {
+  mBody = Body;
+}
+
+ParamMode ASTVarDecl::Mode() const {
+  return mMode;
+}
+
+void ASTVarDecl::SetMode(ParamMode Mode) {
+  mMode = Mode;
+}
+
 } // namespace weak
\ No newline at end of file
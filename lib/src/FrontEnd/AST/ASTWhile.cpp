@@ -36,4 +36,20 @@ ASTCompound *ASTWhile::Body() const {
   return mBody;
 }
 
+void ASTWhile::SetCondition(ASTNode *Condition) {
+  mCondition = Condition;
+}
+
+void ASTWhile::SetBody(ASTCompound *Body) {
+  mBody = Body;
+}
+
+const LoopHints &ASTWhile::Hints() const {
+  return mHints;
+}
+
+void ASTWhile::SetHints(LoopHints Hints) {
+  mHints = Hints;
+}
+
 } // namespace weak
\ No newline at end of file
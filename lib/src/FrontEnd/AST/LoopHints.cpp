@@ -0,0 +1,60 @@
+/* LoopHints.cpp - Loop transformation hints, attached to loop statements.
+ * Copyright (C) 2022 epoll-reactor <glibcxx.chrono@gmail.com>
+ *
+ * This file is distributed under the MIT license.
+ */
+
+#include "FrontEnd/AST/LoopHints.h"
+
+namespace weak {
+
+bool LoopHints::Empty() const {
+  return Unroll == UNROLL_DEFAULT &&
+         Vectorize == VECTORIZE_DEFAULT &&
+         InterleaveCount == 0U;
+}
+
+std::string LoopHints::ToString() const {
+  std::string Result;
+
+  auto Append = [&](std::string Hint) {
+    if (!Result.empty())
+      Result += ' ';
+    Result += '#';
+    Result += Hint;
+  };
+
+  switch (Unroll) {
+  case UNROLL_ENABLE:
+    Append(UnrollCount ? "unroll(" + std::to_string(UnrollCount) + ")" : "unroll");
+    break;
+  case UNROLL_DISABLE:
+    Append("nounroll");
+    break;
+  case UNROLL_FULL:
+    Append("unroll(full)");
+    break;
+  default:
+    break;
+  }
+
+  switch (Vectorize) {
+  case VECTORIZE_ENABLE:
+    Append(VectorizeWidth
+      ? "vectorize(width=" + std::to_string(VectorizeWidth) + ")"
+      : "vectorize");
+    break;
+  case VECTORIZE_DISABLE:
+    Append("novectorize");
+    break;
+  default:
+    break;
+  }
+
+  if (InterleaveCount)
+    Append("interleave(" + std::to_string(InterleaveCount) + ")");
+
+  return Result;
+}
+
+} // namespace weak
\ No newline at end of file
@@ -0,0 +1,18 @@
+/* ParamMode.cpp - How function parameter is passed.
+ * Copyright (C) 2022 epoll-reactor <glibcxx.chrono@gmail.com>
+ *
+ * This file is distributed under the MIT license.
+ */
+
+#include "FrontEnd/AST/ParamMode.h"
+#include "Utility/Unreachable.h"
+
+const char *weak::ParamModeToString(ParamMode M) {
+  switch (M) {
+  case PARAM_DEFAULT:  return "";
+  case PARAM_IN:       return "in";
+  case PARAM_INOUT:    return "inout";
+  case PARAM_RESTRICT: return "restrict";
+  default:             Unreachable("Should not reach there.");
+  }
+}
\ No newline at end of file
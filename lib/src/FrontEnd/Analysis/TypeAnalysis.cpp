@@ -15,9 +15,11 @@
 #include "FrontEnd/AST/ASTFunctionCall.h"
 #include "FrontEnd/AST/ASTFunctionDecl.h"
 #include "FrontEnd/AST/ASTFunctionPrototype.h"
+#include "FrontEnd/AST/ASTMemberAccess.h"
 #include "FrontEnd/AST/ASTNumber.h"
 #include "FrontEnd/AST/ASTReturn.h"
 #include "FrontEnd/AST/ASTString.h"
+#include "FrontEnd/AST/ASTStructDecl.h"
 #include "FrontEnd/AST/ASTSymbol.h"
 #include "FrontEnd/AST/ASTUnary.h"
 #include "FrontEnd/AST/ASTVarDecl.h"
@@ -25,7 +27,9 @@
 #include "Utility/Diagnostic.h"
 #include "Utility/EnumOstreamOperators.h"
 #include "Utility/Unreachable.h"
+#include <algorithm>
 #include <cassert>
+#include <iterator>
 
 namespace weak {
 
@@ -103,7 +107,56 @@ bool TypeAnalysis::CorrectBinaryOpsAnalysis(TokenType Op, DataType T) {
   return CorrectOps;
 }
 
+static bool IsAssignment(TokenType Op) {
+  switch (Op) {
+  case TOK_ASSIGN:
+  case TOK_MUL_ASSIGN:
+  case TOK_DIV_ASSIGN:
+  case TOK_MOD_ASSIGN:
+  case TOK_PLUS_ASSIGN:
+  case TOK_MINUS_ASSIGN:
+  case TOK_SHL_ASSIGN:
+  case TOK_SHR_ASSIGN:
+  case TOK_BIT_AND_ASSIGN:
+  case TOK_BIT_OR_ASSIGN:
+  case TOK_XOR_ASSIGN: /// Fall through.
+    return true;
+  default:
+    return false;
+  }
+}
+
+static ParamMode GetParamMode(ASTNode *Decl) {
+  if (Decl->Is(AST_ARRAY_DECL))
+    return static_cast<ASTArrayDecl *>(Decl)->Mode();
+
+  if (Decl->Is(AST_VAR_DECL))
+    return static_cast<ASTVarDecl *>(Decl)->Mode();
+
+  return PARAM_DEFAULT;
+}
+
+void TypeAnalysis::ReadOnlyParamAnalysis(ASTNode *Stmt) {
+  const std::string *Name = nullptr;
+
+  if (Stmt->Is(AST_ARRAY_ACCESS))
+    Name = &static_cast<ASTArrayAccess *>(Stmt)->Name();
+
+  if (Stmt->Is(AST_MEMBER_ACCESS))
+    Name = &static_cast<ASTMemberAccess *>(Stmt)->Name()->Name();
+
+  if (!Name)
+    return;
+
+  if (auto *Record = mStorage.Lookup(*Name); Record && GetParamMode(Record->AST) == PARAM_IN)
+    weak::CompileError(Stmt)
+      << "Cannot modify read-only parameter `" << *Name << "`";
+}
+
 void TypeAnalysis::Visit(ASTBinary *Stmt) {
+  if (IsAssignment(Stmt->Operation()))
+    ReadOnlyParamAnalysis(Stmt->LHS());
+
   Stmt->LHS()->Accept(this);
   DataType LType = mLastDataType;
 
@@ -125,6 +178,7 @@ void TypeAnalysis::Visit(ASTBinary *Stmt) {
 }
 
 void TypeAnalysis::Visit(ASTUnary *Stmt) {
+  ReadOnlyParamAnalysis(Stmt->Operand());
   Stmt->Operand()->Accept(this);
   DataType T = mLastDataType;
 
@@ -149,10 +203,17 @@ void TypeAnalysis::Visit(ASTVarDecl *Decl) {
   mLastDataType = Decl->DataType();
 }
 
-static void OutOfRangeAnalysis(ASTArrayDecl *Array, ASTNode *Index) {
-  if (auto *I = Index; I->Is(AST_INTEGER_LITERAL)) {
+static void OutOfRangeAnalysis(ASTArrayDecl *Array, const std::vector<ASTNode *> &Indices) {
+  const auto &ArityList = Array->ArityList();
+  auto Dimensions = std::min(ArityList.size(), Indices.size());
+
+  for (size_t Dim = 0; Dim < Dimensions; ++Dim) {
+    auto *I = Indices[Dim];
+    if (!I->Is(AST_INTEGER_LITERAL))
+      continue;
+
     signed NumIndex = static_cast<ASTNumber *>(I)->Value();
-    signed ArraySize = Array->ArityList()[0];
+    signed ArraySize = ArityList[Dim];
 
     if (NumIndex < 0)
       weak::CompileError(I) << "Array index less than zero";
@@ -182,8 +243,14 @@ void TypeAnalysis::Visit(ASTArrayAccess *Stmt) {
         << "Expected integer as array index, got " << mLastDataType;
   }
 
+  if (!Record->Is(AST_ARRAY_DECL)) {
+    /// Element of string.
+    mLastDataType = DT_CHAR;
+    return;
+  }
+
   ASTArrayDecl *Array = static_cast<ASTArrayDecl *>(Record);
-//  OutOfRangeAnalysis(Array, Stmt->Index());
+  OutOfRangeAnalysis(Array, Stmt->Indices());
   mLastDataType = Array->DataType();
 }
 
@@ -191,6 +258,79 @@ void TypeAnalysis::Visit(ASTSymbol *Stmt) {
   mLastDataType = mStorage.Lookup(Stmt->Name())->Type;
 }
 
+void TypeAnalysis::Visit(ASTStructDecl *Decl) {
+  mStructs[Decl->Name()] = Decl;
+}
+
+static const std::string &GetMemberName(ASTNode *Stmt) {
+  if (Stmt->Is(AST_VAR_DECL))
+    return static_cast<ASTVarDecl *>(Stmt)->Name();
+
+  if (Stmt->Is(AST_ARRAY_DECL))
+    return static_cast<ASTArrayDecl *>(Stmt)->Name();
+
+  if (Stmt->Is(AST_STRUCT_DECL))
+    return static_cast<ASTStructDecl *>(Stmt)->Name();
+
+  Unreachable("Expected variable, array or structure.");
+}
+
+void TypeAnalysis::MemberAccessAnalysis(ASTStructDecl *Struct, ASTMemberAccess *Stmt) {
+  ASTNode *Member = Stmt->MemberDecl();
+  bool IsNested = Member->Is(AST_MEMBER_ACCESS);
+  const std::string &Name = IsNested
+    ? static_cast<ASTMemberAccess *>(Member)->Name()->Name()
+    : static_cast<ASTSymbol *>(Member)->Name();
+
+  const auto &Decls = Struct->Decls();
+  auto It = std::find_if(Decls.begin(), Decls.end(), [&](ASTNode *D) {
+    return GetMemberName(D) == Name;
+  });
+
+  if (It == Decls.end())
+    weak::CompileError(Member)
+      << "Structure `" << Struct->Name() << "` has no member `" << Name << "`";
+
+  Stmt->SetStructDecl(Struct);
+  Stmt->SetMemberIndex(std::distance(Decls.begin(), It));
+
+  if (IsNested) {
+    if (!(*It)->Is(AST_STRUCT_DECL))
+      weak::CompileError(Member)
+        << "Member `" << Name << "` of `" << Struct->Name()
+        << "` is not a structure";
+    MemberAccessAnalysis(
+      static_cast<ASTStructDecl *>(*It),
+      static_cast<ASTMemberAccess *>(Member)
+    );
+    return;
+  }
+
+  if ((*It)->Is(AST_VAR_DECL))
+    mLastDataType = static_cast<ASTVarDecl *>(*It)->DataType();
+  else if ((*It)->Is(AST_ARRAY_DECL))
+    mLastDataType = static_cast<ASTArrayDecl *>(*It)->DataType();
+  else
+    mLastDataType = DT_STRUCT;
+}
+
+void TypeAnalysis::Visit(ASTMemberAccess *Stmt) {
+  const std::string &Name = Stmt->Name()->Name();
+  auto *Record = mStorage.Lookup(Name)->AST;
+
+  if (!Record->Is(AST_VAR_DECL) ||
+      static_cast<ASTVarDecl *>(Record)->DataType() != DT_STRUCT)
+    weak::CompileError(Stmt)
+      << "Cannot access member of non-structure `" << Name << "`";
+
+  const std::string &TypeName = static_cast<ASTVarDecl *>(Record)->TypeName();
+  auto It = mStructs.find(TypeName);
+  if (It == mStructs.end())
+    weak::CompileError(Record) << "Structure `" << TypeName << "` not found";
+
+  MemberAccessAnalysis(It->second, Stmt);
+}
+
 void TypeAnalysis::Visit(ASTFunctionDecl *Decl) {
   mStorage.StartScope();
   /// This is to have function in recursive calls.
@@ -233,6 +373,83 @@ static const std::string &GetFunArgName(ASTNode *Stmt) {
   Unreachable("Expected variable or array.");
 }
 
+static unsigned ElementsCount(ASTArrayDecl *Array) {
+  unsigned Count = 1U;
+  for (unsigned Dimension : Array->ArityList())
+    Count *= Dimension;
+  return Count;
+}
+
+void TypeAnalysis::ReferenceArgumentAnalysis(
+  ASTNode                      *DeclArg,
+  ASTNode                      *CallArg,
+  const std::vector<ASTNode *> &CallArgs
+) {
+  ParamMode Mode = GetParamMode(DeclArg);
+  bool IsStruct =
+    DeclArg->Is(AST_VAR_DECL) &&
+    static_cast<ASTVarDecl *>(DeclArg)->DataType() == DT_STRUCT;
+
+  if (Mode == PARAM_DEFAULT && !IsStruct) {
+    /// Array without mode is a mutable pointer to caller's memory, so
+    /// read-only array cannot be passed there.
+    if (DeclArg->Is(AST_ARRAY_DECL) && CallArg->Is(AST_SYMBOL)) {
+      const std::string &Name = static_cast<ASTSymbol *>(CallArg)->Name();
+      if (auto *Record = mStorage.Lookup(Name); Record && GetParamMode(Record->AST) == PARAM_IN)
+        weak::CompileError(CallArg)
+          << "Read-only parameter `" << Name << "` passed as mutable";
+    }
+    return;
+  }
+
+  const std::string &ParamName = GetFunArgName(DeclArg);
+
+  if (!CallArg->Is(AST_SYMBOL))
+    weak::CompileError(CallArg)
+      << "For argument `" << ParamName << "` variable expected";
+
+  const std::string &Name = static_cast<ASTSymbol *>(CallArg)->Name();
+  ASTNode *Record = mStorage.Lookup(Name)->AST;
+
+  if (DeclArg->Is(AST_ARRAY_DECL)) {
+    if (!Record->Is(AST_ARRAY_DECL))
+      weak::CompileError(CallArg)
+        << "For argument `" << ParamName << "` array expected";
+
+    unsigned Expected = ElementsCount(static_cast<ASTArrayDecl *>(DeclArg));
+    unsigned Got = ElementsCount(static_cast<ASTArrayDecl *>(Record));
+    if (Got < Expected)
+      weak::CompileError(CallArg)
+        << "For argument `" << ParamName << "` got array of " << Got
+        << " elements, but expected at least " << Expected;
+  }
+
+  if (IsStruct) {
+    const std::string &Expected = static_cast<ASTVarDecl *>(DeclArg)->TypeName();
+    if (!Record->Is(AST_VAR_DECL) ||
+        static_cast<ASTVarDecl *>(Record)->TypeName() != Expected)
+      weak::CompileError(CallArg)
+        << "For argument `" << ParamName << "` structure `"
+        << Expected << "` expected";
+  }
+
+  /// Copy of structure can be freely modified.
+  bool IsCopy = IsStruct && Mode == PARAM_DEFAULT;
+  if (!IsCopy && Mode != PARAM_IN && GetParamMode(Record) == PARAM_IN)
+    weak::CompileError(CallArg)
+      << "Read-only parameter `" << Name << "` passed as mutable";
+
+  if (Mode != PARAM_RESTRICT)
+    return;
+
+  for (ASTNode *Other : CallArgs)
+    if (Other != CallArg && Other->Is(AST_SYMBOL) &&
+        static_cast<ASTSymbol *>(Other)->Name() == Name)
+      weak::CompileError(Other)
+        << "`" << Name << "` is passed to restrict parameter `"
+        << ParamName << "` and aliased by another argument";
+}
+
 template <typename ASTFun>
 void TypeAnalysis::CallArgumentsAnalysis(ASTNode *Decl, const std::vector<ASTNode *> &CallArgs) {
   auto *Fun = static_cast<ASTFun *>(Decl);
@@ -243,8 +460,10 @@ void TypeAnalysis::CallArgumentsAnalysis(ASTNode *Decl, const std::vector<ASTNod
   auto DeclArg = DeclArgs.begin();
 
   while (CallArg != CallArgs.end()) {
-    (*DeclArg)->Accept(this);
-    auto L = mLastDataType;
+    /// Not visited, since parameters should not be declared in caller scope.
+    auto L = (*DeclArg)->Is(AST_ARRAY_DECL)
+      ? static_cast<ASTArrayDecl *>(*DeclArg)->DataType()
+      : static_cast<ASTVarDecl *>(*DeclArg)->DataType();
 
     (*CallArg)->Accept(this);
     auto R = mLastDataType;
@@ -256,6 +475,8 @@ void TypeAnalysis::CallArgumentsAnalysis(ASTNode *Decl, const std::vector<ASTNod
           << "` got " << L
           << ", but expected " << R;
 
+    ReferenceArgumentAnalysis(*DeclArg, *CallArg, CallArgs);
+
     ++CallArg;
     ++DeclArg;
   }
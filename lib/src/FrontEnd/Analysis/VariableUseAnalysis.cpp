@@ -202,14 +202,14 @@ void VariableUseAnalysis::MakeUnusedVarAndFuncAnalysis() {
     bool IsFunction = false;
     IsFunction |= U->AST->Is(AST_FUNCTION_DECL);
     IsFunction |= U->AST->Is(AST_FUNCTION_PROTOTYPE);
-    bool IsMainFunction = false;
+    bool IsEntryPoint = false;
 
-    if (IsFunction) {
-      auto *Main = static_cast<ASTFunctionDecl *>(U->AST);
-      IsMainFunction = Main->Name() == "main";
+    if (U->AST->Is(AST_FUNCTION_DECL)) {
+      auto *F = static_cast<ASTFunctionDecl *>(U->AST);
+      IsEntryPoint = F->Name() == "main" || F->IsExported();
     }
 
-    if (U->Uses == 0U && !IsMainFunction)
+    if (U->Uses == 0U && !IsEntryPoint)
       weak::CompileWarning(U->AST)
         << (IsFunction ? "Function" : "Variable")
         << " `" << U->Name << "` is never used";
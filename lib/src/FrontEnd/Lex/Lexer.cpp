@@ -25,11 +25,15 @@ static const std::unordered_map<std::string_view, TokenType> LexKeywords = {
   {"continue", TOK_CONTINUE},
   {"do", TOK_DO},
   {"else", TOK_ELSE},
+  {"export", TOK_EXPORT},
   {"false", TOK_FALSE},
   {"float", TOK_FLOAT},
   {"for", TOK_FOR},
   {"if", TOK_IF},
+  {"in", TOK_IN},
+  {"inout", TOK_INOUT},
   {"int", TOK_INT},
+  {"restrict", TOK_RESTRICT},
   {"return", TOK_RETURN},
   {"string", TOK_STRING},
   {"struct", TOK_STRUCT},
@@ -74,6 +78,7 @@ static const std::unordered_map<std::string_view, TokenType> LexOperators = {
   {",", TOK_COMMA},
   {";", TOK_SEMICOLON},
   {"!", TOK_NOT},
+  {"#", TOK_HASH},
   {"[", TOK_OPEN_BOX_BRACKET},
   {"]", TOK_CLOSE_BOX_BRACKET},
   {"{", TOK_OPEN_CURLY_BRACKET},
@@ -98,11 +103,15 @@ static void NormalizeColumnPos(
     {TOK_CONTINUE, "continue"sv.length()},
     {TOK_DO, "do"sv.length()},
     {TOK_ELSE, "else"sv.length()},
+    {TOK_EXPORT, "export"sv.length()},
     {TOK_FALSE, "false"sv.length()},
     {TOK_FLOAT, "float"sv.length()},
     {TOK_FOR, "for"sv.length()},
     {TOK_IF, "if"sv.length()},
+    {TOK_IN, "in"sv.length()},
+    {TOK_INOUT, "inout"sv.length()},
     {TOK_INT, "int"sv.length()},
+    {TOK_RESTRICT, "restrict"sv.length()},
     {TOK_RETURN, "return"sv.length()},
     {TOK_STRING, "string"sv.length()},
     {TOK_TRUE, "true"sv.length()},
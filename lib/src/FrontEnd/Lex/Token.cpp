@@ -15,11 +15,15 @@ const char *weak::TokenToString(TokenType Type) {
   case TOK_CONTINUE:               return "<CONTINUE>";
   case TOK_DO:                     return "<DO>";
   case TOK_ELSE:                   return "<ELSE>";
+  case TOK_EXPORT:                 return "<EXPORT>";
   case TOK_FALSE:                  return "<FALSE>";
   case TOK_FLOAT:                  return "<FLOAT>";
   case TOK_FOR:                    return "<FOR>";
   case TOK_IF:                     return "<IF>";
+  case TOK_IN:                     return "<IN>";
+  case TOK_INOUT:                  return "<INOUT>";
   case TOK_INT:                    return "<INT>";
+  case TOK_RESTRICT:               return "<RESTRICT>";
   case TOK_RETURN:                 return "<RETURN>";
   case TOK_STRING:                 return "<STRING>";
   case TOK_TRUE:                   return "<TRUE>";
@@ -65,6 +69,7 @@ const char *weak::TokenToString(TokenType Type) {
   case TOK_COMMA:                  return ",";
   case TOK_SEMICOLON:              return ";";
   case TOK_NOT:                    return "!";
+  case TOK_HASH:                   return "#";
   case TOK_OPEN_BOX_BRACKET:       return "[";
   case TOK_CLOSE_BOX_BRACKET:      return "]";
   case TOK_OPEN_CURLY_BRACKET:     return "{";
@@ -92,6 +97,7 @@ weak::TokenType weak::CharToToken(char T) {
   case ',': return TOK_COMMA;
   case ';': return TOK_SEMICOLON;
   case '!': return TOK_NOT;
+  case '#': return TOK_HASH;
   case '[': return TOK_OPEN_BOX_BRACKET;
   case ']': return TOK_CLOSE_BOX_BRACKET;
   case '{': return TOK_OPEN_CURLY_BRACKET;
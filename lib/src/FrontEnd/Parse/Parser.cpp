@@ -43,6 +43,7 @@ std::unique_ptr<ASTCompound> Parser::Parse() {
     case TOK_STRUCT:
       Stmts.push_back(ParseStructDecl());
       break;
+    case TOK_EXPORT:
     case TOK_VOID:
     case TOK_INT:
     case TOK_CHAR:
@@ -67,6 +68,10 @@ std::unique_ptr<ASTCompound> Parser::Parse() {
 }
 
 ASTNode *Parser::ParseFunctionDecl() {
+  const Token *Export = nullptr;
+  if (PeekCurrent().Is(TOK_EXPORT))
+    Export = &PeekNext();
+
   /// Guaranteed data type, no checks needed.
   LocalizedDataType ReturnType = ParseReturnType();
   const Token &FunctionName = PeekNext();
@@ -82,7 +87,7 @@ ASTNode *Parser::ParseFunctionDecl() {
   if (PeekCurrent().Is('{')) {
     auto *Block = ParseBlock();
 
-    return new ASTFunctionDecl(
+    auto *Decl = new ASTFunctionDecl(
       ReturnType.DT,
       std::string(FunctionName.Data),
       std::move(ParameterList),
@@ -90,8 +95,14 @@ ASTNode *Parser::ParseFunctionDecl() {
       ReturnType.LineNo,
       ReturnType.ColumnNo
     );
+    Decl->SetExported(Export);
+    return Decl;
   }
 
+  if (Export)
+    weak::CompileError(Export->LineNo, Export->ColumnNo)
+      << "Only function definitions can be exported";
+
   Require(';');
   return new ASTFunctionPrototype(
     ReturnType.DT,
@@ -343,7 +354,7 @@ std::vector<ASTNode *> Parser::ParseParameterList() {
 
   --mTokenPtr;
   while (!PeekCurrent().Is(')')) {
-    List.push_back(ParseDeclWithoutInitializer());
+    List.push_back(ParseParameter());
     if (Require({')', ','}).Is(')')) {
       /// Move back to token before '('.
       --mTokenPtr;
@@ -353,6 +364,35 @@ std::vector<ASTNode *> Parser::ParseParameterList() {
   return List;
 }
 
+ASTNode *Parser::ParseParameter() {
+  ParamMode Mode = PARAM_DEFAULT;
+
+  switch (PeekCurrent().Type) {
+  case TOK_IN:       Mode = PARAM_IN;       break;
+  case TOK_INOUT:    Mode = PARAM_INOUT;    break;
+  case TOK_RESTRICT: Mode = PARAM_RESTRICT; break;
+  default:
+    return ParseDeclWithoutInitializer();
+  }
+
+  const Token &ModeToken = PeekNext();
+  ASTNode *Decl = ParseDeclWithoutInitializer();
+
+  if (Decl->Is(AST_ARRAY_DECL)) {
+    static_cast<ASTArrayDecl *>(Decl)->SetMode(Mode);
+    return Decl;
+  }
+
+  auto *Var = static_cast<ASTVarDecl *>(Decl);
+  if (Var->DataType() != DT_STRUCT)
+    weak::CompileError(ModeToken.LineNo, ModeToken.ColumnNo)
+      << "Parameter mode `" << ParamModeToString(Mode)
+      << "` is allowed only for arrays and structures";
+
+  Var->SetMode(Mode);
+  return Decl;
+}
+
 ASTCompound *Parser::ParseBlock() {
   if (mLoopsDepth > 0)
     return ParseIterationBlock();
@@ -401,6 +441,8 @@ ASTCompound *Parser::ParseIterationBlock() {
     case AST_CONTINUE_STMT:
     case AST_DO_WHILE_STMT:
     case AST_VAR_DECL:
+    case AST_ARRAY_DECL:
+    case AST_ARRAY_ACCESS:
     case AST_MEMBER_ACCESS:
     case AST_FUNCTION_CALL: // Fall through.
       Require(';');
@@ -424,6 +466,8 @@ ASTNode *Parser::ParseStmt() {
   case TOK_DO:
   case TOK_WHILE: // Fall through.
     return ParseIterationStmt();
+  case TOK_HASH:
+    return ParseHintedIterationStmt();
   case TOK_RETURN:
     return ParseJumpStmt();
   case TOK_INT:
@@ -478,6 +522,103 @@ ASTNode *Parser::ParseIterationStmt() {
   }
 }
 
+ASTNode *Parser::ParseHintedIterationStmt() {
+  LoopHints Hints = ParseLoopHints();
+
+  switch (const Token &T = PeekCurrent(); T.Type) {
+  case TOK_FOR: {
+    auto *Loop = static_cast<ASTFor *>(ParseFor());
+    Loop->SetHints(Hints);
+    return Loop;
+  }
+  case TOK_DO: {
+    auto *Loop = static_cast<ASTDoWhile *>(ParseDoWhile());
+    Loop->SetHints(Hints);
+    return Loop;
+  }
+  case TOK_WHILE: {
+    auto *Loop = static_cast<ASTWhile *>(ParseWhile());
+    Loop->SetHints(Hints);
+    return Loop;
+  }
+  default:
+    weak::CompileError(T.LineNo, T.ColumnNo) << "Loop expected after hints";
+    Unreachable("Should not reach there.");
+  }
+}
+
+LoopHints Parser::ParseLoopHints() {
+  LoopHints Hints;
+
+  while (Match(TOK_HASH)) {
+    const Token &T = Require(TOK_SYMBOL);
+    const std::string &Name = T.Data;
+
+    if (Name == "unroll" || Name == "nounroll") {
+      if (Hints.Unroll != LoopHints::UNROLL_DEFAULT)
+        weak::CompileError(T.LineNo, T.ColumnNo) << "Duplicated unroll hint";
+
+      if (Name == "nounroll")
+        Hints.Unroll = LoopHints::UNROLL_DISABLE;
+      else if (!Match('('))
+        Hints.Unroll = LoopHints::UNROLL_ENABLE;
+      else if (PeekCurrent().Is(TOK_SYMBOL) && PeekCurrent().Data == "full") {
+        PeekNext();
+        Require(')');
+        Hints.Unroll = LoopHints::UNROLL_FULL;
+      } else {
+        Hints.Unroll = LoopHints::UNROLL_ENABLE;
+        Hints.UnrollCount = ParseLoopHintCount();
+        Require(')');
+      }
+    } else if (Name == "vectorize" || Name == "novectorize") {
+      if (Hints.Vectorize != LoopHints::VECTORIZE_DEFAULT)
+        weak::CompileError(T.LineNo, T.ColumnNo) << "Duplicated vectorize hint";
+
+      if (Name == "novectorize")
+        Hints.Vectorize = LoopHints::VECTORIZE_DISABLE;
+      else {
+        Hints.Vectorize = LoopHints::VECTORIZE_ENABLE;
+        if (Match('(')) {
+          const Token &Option = Require(TOK_SYMBOL);
+          if (Option.Data != "width")
+            weak::CompileError(Option.LineNo, Option.ColumnNo)
+              << "Unknown vectorize option `" << Option.Data << "`";
+          Require('=');
+          Hints.VectorizeWidth = ParseLoopHintCount();
+          Require(')');
+
+          unsigned Width = Hints.VectorizeWidth;
+          if ((Width & (Width - 1)) != 0)
+            weak::CompileError(Option.LineNo, Option.ColumnNo)
+              << "Vector width should be a power of 2";
+        }
+      }
+    } else if (Name == "interleave") {
+      if (Hints.InterleaveCount)
+        weak::CompileError(T.LineNo, T.ColumnNo) << "Duplicated interleave hint";
+
+      Require('(');
+      Hints.InterleaveCount = ParseLoopHintCount();
+      Require(')');
+    } else
+      weak::CompileError(T.LineNo, T.ColumnNo)
+        << "Unknown loop hint `" << Name << "`";
+  }
+
+  return Hints;
+}
+
+unsigned Parser::ParseLoopHintCount() {
+  const Token &T = Require(TOK_INTEGRAL_LITERAL);
+  int Count = std::stoi(T.Data);
+
+  if (Count <= 0)
+    weak::CompileError(T.LineNo, T.ColumnNo) << "Expected positive number";
+
+  return static_cast<unsigned>(Count);
+}
+
 ASTNode *Parser::ParseFor() {
   const Token &Start = Require(TOK_FOR);
   Require('(');
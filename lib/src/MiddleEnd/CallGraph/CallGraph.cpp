@@ -0,0 +1,114 @@
+/* CallGraph.cpp - Graph of calls between functions.
+ * Copyright (C) 2022 epoll-reactor <glibcxx.chrono@gmail.com>
+ *
+ * This file is distributed under the MIT license.
+ */
+
+#include "MiddleEnd/CallGraph/CallGraph.h"
+#include "FrontEnd/AST/AST.h"
+#include "FrontEnd/AST/ASTVisitor.h"
+#include <algorithm>
+
+namespace weak {
+namespace {
+
+/// Collect names of all functions, called inside visited statement.
+class CallsCollector : public ASTVisitor {
+public:
+  std::vector<std::string> Collect(ASTNode *Body) {
+    Body->Accept(this);
+    return std::move(mCallees);
+  }
+
+private:
+  void Visit(ASTFunctionCall *Stmt) override {
+    ASTVisitor::Visit(Stmt);
+
+    const auto &Name = Stmt->Name();
+    if (std::find(mCallees.begin(), mCallees.end(), Name) == mCallees.end())
+      mCallees.push_back(Name);
+  }
+
+  std::vector<std::string> mCallees;
+};
+
+} // namespace
+} // namespace weak
+
+namespace weak {
+
+CallGraph::CallGraph(ASTNode *Root) {
+  for (ASTNode *Stmt : static_cast<ASTCompound *>(Root)->Stmts()) {
+    if (Stmt->Is(AST_FUNCTION_DECL)) {
+      auto *F = static_cast<ASTFunctionDecl *>(Stmt);
+      if (!mNodes.count(F->Name()))
+        mFunctions.push_back(F->Name());
+      /// Definition replaces forward declaration.
+      mNodes[F->Name()] = Node{F, CallsCollector().Collect(F->Body())};
+    }
+
+    if (Stmt->Is(AST_FUNCTION_PROTOTYPE)) {
+      auto *P = static_cast<ASTFunctionPrototype *>(Stmt);
+      if (mNodes.emplace(P->Name(), Node{P, {}}).second)
+        mFunctions.push_back(P->Name());
+    }
+  }
+}
+
+const std::vector<std::string> &CallGraph::Functions() const {
+  return mFunctions;
+}
+
+ASTNode *CallGraph::Decl(std::string_view Name) const {
+  auto It = mNodes.find(std::string(Name));
+  if (It == mNodes.end())
+    return nullptr;
+  return It->second.Decl;
+}
+
+const std::vector<std::string> &CallGraph::Callees(std::string_view Name) const {
+  static const std::vector<std::string> None;
+  auto It = mNodes.find(std::string(Name));
+  if (It == mNodes.end())
+    return None;
+  return It->second.Callees;
+}
+
+std::unordered_set<std::string>
+CallGraph::Reachable(const std::vector<std::string> &Roots) const {
+  std::unordered_set<std::string> Visited;
+  std::vector<std::string> Worklist;
+
+  for (const auto &R : Roots)
+    if (mNodes.count(R) && Visited.insert(R).second)
+      Worklist.push_back(R);
+
+  while (!Worklist.empty()) {
+    std::string Name = std::move(Worklist.back());
+    Worklist.pop_back();
+
+    for (const auto &Callee : Callees(Name))
+      if (Visited.insert(Callee).second)
+        Worklist.push_back(Callee);
+  }
+
+  return Visited;
+}
+
+std::vector<std::string> CallGraph::EntryPoints() const {
+  std::vector<std::string> Result;
+  for (const auto &Name : mFunctions)
+    if (IsEntryPoint(mNodes.at(Name).Decl))
+      Result.push_back(Name);
+  return Result;
+}
+
+bool CallGraph::IsEntryPoint(ASTNode *Decl) {
+  if (!Decl->Is(AST_FUNCTION_DECL))
+    return false;
+
+  auto *F = static_cast<ASTFunctionDecl *>(Decl);
+  return F->IsExported() || F->Name() == "main";
+}
+
+} // namespace weak
\ No newline at end of file
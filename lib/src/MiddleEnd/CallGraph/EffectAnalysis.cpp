@@ -0,0 +1,303 @@
+/* EffectAnalysis.cpp - Interprocedural analysis of function side effects.
+ * Copyright (C) 2022 epoll-reactor <glibcxx.chrono@gmail.com>
+ *
+ * This file is distributed under the MIT license.
+ */
+
+#include "MiddleEnd/CallGraph/EffectAnalysis.h"
+#include "MiddleEnd/CallGraph/CallGraph.h"
+#include "FrontEnd/AST/AST.h"
+#include "FrontEnd/AST/ASTVisitor.h"
+
+namespace weak {
+namespace {
+
+/// Argument of call, which memory effects are related to caller.
+struct CallArg {
+  /// Index of caller pointer parameter, passed as argument, or -1.
+  int CallerParam{-1};
+  /// String literal, placed in global memory.
+  bool GlobalMem{false};
+};
+
+struct CallSite {
+  std::string Callee;
+  std::vector<CallArg> Args;
+};
+
+/// Effects of function body itself, without callees.
+struct LocalEffects {
+  FunctionEffects Effects;
+  std::vector<CallSite> Calls;
+};
+
+bool IsPointerParam(ASTNode *Arg) {
+  if (Arg->Is(AST_ARRAY_DECL))
+    return true;
+  auto T = static_cast<ASTVarDecl *>(Arg)->DataType();
+  return T == DT_STRING || T == DT_STRUCT;
+}
+
+const std::string &ParamName(ASTNode *Arg) {
+  if (Arg->Is(AST_ARRAY_DECL))
+    return static_cast<ASTArrayDecl *>(Arg)->Name();
+  return static_cast<ASTVarDecl *>(Arg)->Name();
+}
+
+bool IsAssignment(TokenType T) {
+  switch (T) {
+  case TOK_ASSIGN:
+  case TOK_MUL_ASSIGN:
+  case TOK_DIV_ASSIGN:
+  case TOK_MOD_ASSIGN:
+  case TOK_PLUS_ASSIGN:
+  case TOK_MINUS_ASSIGN:
+  case TOK_SHL_ASSIGN:
+  case TOK_SHR_ASSIGN:
+  case TOK_BIT_AND_ASSIGN:
+  case TOK_BIT_OR_ASSIGN:
+  case TOK_XOR_ASSIGN:
+    return true;
+  default:
+    return false;
+  }
+}
+
+/// Collect effects of single function body.
+class LocalEffectsCollector : private ASTVisitor {
+public:
+  LocalEffectsCollector(bool TrapsOnOutOfRange)
+    : mTrapsOnOutOfRange(TrapsOnOutOfRange) {}
+
+  LocalEffects Collect(ASTFunctionDecl *Decl) {
+    mParams.clear();
+    mResult = LocalEffects();
+    mResult.Effects.Params.resize(Decl->Args().size());
+
+    for (unsigned I = 0; I < Decl->Args().size(); ++I)
+      if (ASTNode *Arg = Decl->Args()[I]; IsPointerParam(Arg))
+        mParams.emplace(ParamName(Arg), I);
+
+    Decl->Body()->Accept(this);
+    return std::move(mResult);
+  }
+
+private:
+  void Visit(ASTArrayAccess *Stmt) override {
+    ASTVisitor::Visit(Stmt);
+
+    if (mTrapsOnOutOfRange && !Stmt->InBounds())
+      mResult.Effects.MayNotReturn = true;
+
+    if (auto It = mParams.find(Stmt->Name()); It != mParams.end()) {
+      mResult.Effects.ReadsArgMem = true;
+      mResult.Effects.Params[It->second].Read = true;
+    }
+  }
+
+  void Visit(ASTBinary *Stmt) override {
+    ASTVisitor::Visit(Stmt);
+    if (IsAssignment(Stmt->Operation()))
+      MarkWritten(Stmt->LHS());
+  }
+
+  void Visit(ASTUnary *Stmt) override {
+    ASTVisitor::Visit(Stmt);
+    MarkWritten(Stmt->Operand());
+  }
+
+  void Visit(ASTString *) override {
+    mResult.Effects.ReadsOtherMem = true;
+  }
+
+  void Visit(ASTFunctionCall *Stmt) override {
+    ASTVisitor::Visit(Stmt);
+
+    CallSite Site{Stmt->Name(), {}};
+    for (ASTNode *Arg : Stmt->Args()) {
+      CallArg A;
+      if (Arg->Is(AST_SYMBOL))
+        if (auto It = mParams.find(static_cast<ASTSymbol *>(Arg)->Name()); It != mParams.end())
+          A.CallerParam = It->second;
+      A.GlobalMem = Arg->Is(AST_STRING_LITERAL);
+      Site.Args.push_back(A);
+    }
+
+    mResult.Calls.push_back(std::move(Site));
+  }
+
+  void Visit(ASTFor *Stmt) override {
+    mResult.Effects.MayNotReturn = true;
+    ASTVisitor::Visit(Stmt);
+  }
+
+  void Visit(ASTWhile *Stmt) override {
+    mResult.Effects.MayNotReturn = true;
+    ASTVisitor::Visit(Stmt);
+  }
+
+  void Visit(ASTDoWhile *Stmt) override {
+    mResult.Effects.MayNotReturn = true;
+    ASTVisitor::Visit(Stmt);
+  }
+
+  void Visit(ASTMemberAccess *Stmt) override {
+    if (auto It = mParams.find(Stmt->Name()->Name()); It != mParams.end()) {
+      mResult.Effects.ReadsArgMem = true;
+      mResult.Effects.Params[It->second].Read = true;
+    }
+  }
+
+  void MarkWritten(ASTNode *Target) {
+    const std::string *Name = nullptr;
+    if (Target->Is(AST_ARRAY_ACCESS))
+      Name = &static_cast<ASTArrayAccess *>(Target)->Name();
+    if (Target->Is(AST_MEMBER_ACCESS))
+      Name = &static_cast<ASTMemberAccess *>(Target)->Name()->Name();
+    if (!Name)
+      return;
+
+    auto It = mParams.find(*Name);
+    if (It == mParams.end())
+      return;
+
+    mResult.Effects.WritesArgMem = true;
+    mResult.Effects.Params[It->second].Written = true;
+  }
+
+  bool mTrapsOnOutOfRange;
+  /// Pointer parameter name -> its index.
+  std::unordered_map<std::string, unsigned> mParams;
+  LocalEffects mResult;
+};
+
+FunctionEffects UnknownEffects(ASTFunctionPrototype *Decl) {
+  FunctionEffects E;
+  E.ReadsArgMem = true;
+  E.WritesArgMem = true;
+  E.ReadsOtherMem = true;
+  E.WritesOtherMem = true;
+  E.MayUnwind = true;
+  E.MayNotReturn = true;
+  E.MayRecurse = true;
+  E.Params.resize(Decl->Args().size(), ParamEffects{true, true, true});
+  return E;
+}
+
+/// Set flag, if it is not set yet.
+/// \return true if flag was changed.
+bool Raise(bool &Flag, bool Value) {
+  if (Flag || !Value)
+    return false;
+  Flag = true;
+  return true;
+}
+
+/// Merge effects of call site into caller effects.
+/// \return true if caller effects changed.
+bool MergeCall(FunctionEffects &Caller, const FunctionEffects &Callee, const CallSite &Site) {
+  bool Changed = false;
+  Changed |= Raise(Caller.ReadsOtherMem, Callee.ReadsOtherMem);
+  Changed |= Raise(Caller.WritesOtherMem, Callee.WritesOtherMem);
+  Changed |= Raise(Caller.MayUnwind, Callee.MayUnwind);
+  Changed |= Raise(Caller.MayNotReturn, Callee.MayNotReturn);
+
+  for (unsigned I = 0; I < Site.Args.size() && I < Callee.Params.size(); ++I) {
+    const CallArg &A = Site.Args[I];
+    const ParamEffects &P = Callee.Params[I];
+
+    if (A.GlobalMem) {
+      Changed |= Raise(Caller.ReadsOtherMem, P.Read);
+      Changed |= Raise(Caller.WritesOtherMem, P.Written);
+    }
+
+    if (A.CallerParam < 0)
+      continue;
+
+    ParamEffects &CP = Caller.Params[A.CallerParam];
+    Changed |= Raise(CP.Read, P.Read);
+    Changed |= Raise(CP.Written, P.Written);
+    Changed |= Raise(CP.Captured, P.Captured);
+    Changed |= Raise(Caller.ReadsArgMem, P.Read);
+    Changed |= Raise(Caller.WritesArgMem, P.Written);
+  }
+
+  return Changed;
+}
+
+} // namespace
+} // namespace weak
+
+namespace weak {
+
+bool FunctionEffects::ReadNone() const {
+  return !ReadsArgMem && !WritesArgMem && !ReadsOtherMem && !WritesOtherMem;
+}
+
+bool FunctionEffects::ReadOnly() const {
+  return !WritesArgMem && !WritesOtherMem;
+}
+
+bool FunctionEffects::ArgMemOnly() const {
+  return !ReadsOtherMem && !WritesOtherMem;
+}
+
+EffectAnalysis::EffectAnalysis(ASTNode *Root, bool TrapsOnOutOfRange) {
+  CallGraph CG(Root);
+  std::unordered_map<std::string, LocalEffects> Locals;
+
+  for (const auto &Name : CG.Functions()) {
+    ASTNode *Decl = CG.Decl(Name);
+
+    if (Decl->Is(AST_FUNCTION_PROTOTYPE)) {
+      mEffects[Name] = UnknownEffects(static_cast<ASTFunctionPrototype *>(Decl));
+      continue;
+    }
+
+    auto Local = LocalEffectsCollector(TrapsOnOutOfRange).Collect(
+      static_cast<ASTFunctionDecl *>(Decl));
+    mEffects[Name] = Local.Effects;
+    Locals[Name] = std::move(Local);
+  }
+
+  std::vector<std::string> Exported;
+  for (const auto &Name : CG.Functions())
+    if (ASTNode *Decl = CG.Decl(Name); Decl->Is(AST_FUNCTION_DECL))
+      if (static_cast<ASTFunctionDecl *>(Decl)->IsExported())
+        Exported.push_back(Name);
+  auto Reentrant = CG.Reachable(Exported);
+
+  for (auto &[Name, Local] : Locals) {
+    FunctionEffects &E = mEffects[Name];
+    auto Reachable = CG.Reachable(CG.Callees(Name));
+    E.MayRecurse = Reachable.count(Name);
+
+    /// External code can call us back only through exported functions.
+    if (Reentrant.count(Name))
+      for (const auto &Callee : Reachable)
+        if (CG.Decl(Callee)->Is(AST_FUNCTION_PROTOTYPE))
+          E.MayRecurse = true;
+
+    /// Recursion depth is not limited.
+    E.MayNotReturn |= E.MayRecurse;
+  }
+
+  /// Effects only grow, so iteration stops, when nothing changes.
+  bool Changed = true;
+  while (Changed) {
+    Changed = false;
+    for (auto &[Name, Local] : Locals)
+      for (const auto &Site : Local.Calls)
+        if (auto It = mEffects.find(Site.Callee); It != mEffects.end())
+          Changed |= MergeCall(mEffects[Name], It->second, Site);
+  }
+}
+
+const FunctionEffects *EffectAnalysis::Effects(std::string_view Name) const {
+  auto It = mEffects.find(std::string(Name));
+  if (It == mEffects.end())
+    return nullptr;
+  return &It->second;
+}
+
+} // namespace weak
\ No newline at end of file
@@ -0,0 +1,125 @@
+/* StringMutationAnalysis.cpp - Detect string variables, that need own copy.
+ * Copyright (C) 2022 epoll-reactor <glibcxx.chrono@gmail.com>
+ *
+ * This file is distributed under the MIT license.
+ */
+
+#include "MiddleEnd/CallGraph/StringMutationAnalysis.h"
+#include "MiddleEnd/CallGraph/EffectAnalysis.h"
+#include "FrontEnd/AST/AST.h"
+#include "FrontEnd/AST/ASTVisitor.h"
+#include <unordered_map>
+
+namespace weak {
+namespace {
+
+bool IsAssignment(TokenType T) {
+  switch (T) {
+  case TOK_ASSIGN:
+  case TOK_MUL_ASSIGN:
+  case TOK_DIV_ASSIGN:
+  case TOK_MOD_ASSIGN:
+  case TOK_PLUS_ASSIGN:
+  case TOK_MINUS_ASSIGN:
+  case TOK_SHL_ASSIGN:
+  case TOK_SHR_ASSIGN:
+  case TOK_BIT_AND_ASSIGN:
+  case TOK_BIT_OR_ASSIGN:
+  case TOK_XOR_ASSIGN:
+    return true;
+  default:
+    return false;
+  }
+}
+
+class MutationCollector : private ASTVisitor {
+public:
+  MutationCollector(const EffectAnalysis &Effects,
+                    std::unordered_set<const ASTVarDecl *> &Mutated)
+    : mEffects(Effects)
+    , mMutated(Mutated) {}
+
+  void Collect(ASTNode *Root) { Root->Accept(this); }
+
+private:
+  void Visit(ASTFunctionDecl *Decl) override {
+    /// Variable names are unique within function at any point, since
+    /// redefinition is not allowed, so scopes are not tracked.
+    mStrings.clear();
+    ASTVisitor::Visit(Decl);
+  }
+
+  void Visit(ASTVarDecl *Decl) override {
+    ASTVisitor::Visit(Decl);
+
+    /// Only variables, initialized with literal, can share memory
+    /// with constant data.
+    if (Decl->DataType() == DT_STRING &&
+        Decl->Body() && Decl->Body()->Is(AST_STRING_LITERAL))
+      mStrings[Decl->Name()] = Decl;
+  }
+
+  void Visit(ASTBinary *Stmt) override {
+    ASTVisitor::Visit(Stmt);
+    if (IsAssignment(Stmt->Operation()))
+      MarkWritten(Stmt->LHS());
+  }
+
+  void Visit(ASTUnary *Stmt) override {
+    ASTVisitor::Visit(Stmt);
+    MarkWritten(Stmt->Operand());
+  }
+
+  void Visit(ASTSymbol *Stmt) override {
+    /// Any use of string without index, except arguments of known
+    /// functions, may give away pointer to it.
+    Mark(Stmt->Name());
+  }
+
+  void Visit(ASTFunctionCall *Stmt) override {
+    const FunctionEffects *Callee = mEffects.Effects(Stmt->Name());
+
+    for (unsigned I = 0; I < Stmt->Args().size(); ++I) {
+      ASTNode *Arg = Stmt->Args()[I];
+
+      if (Arg->Is(AST_SYMBOL) && Callee && I < Callee->Params.size()) {
+        const ParamEffects &P = Callee->Params[I];
+        if (!P.Written && !P.Captured)
+          continue;
+      }
+
+      Arg->Accept(this);
+    }
+  }
+
+  void MarkWritten(ASTNode *Target) {
+    if (Target->Is(AST_ARRAY_ACCESS))
+      Mark(static_cast<ASTArrayAccess *>(Target)->Name());
+  }
+
+  void Mark(const std::string &Name) {
+    if (auto It = mStrings.find(Name); It != mStrings.end())
+      mMutated.insert(It->second);
+  }
+
+  const EffectAnalysis &mEffects;
+  std::unordered_set<const ASTVarDecl *> &mMutated;
+  /// Name -> declaration of visible string variable, initialized with
+  /// literal.
+  std::unordered_map<std::string, ASTVarDecl *> mStrings;
+};
+
+} // namespace
+} // namespace weak
+
+namespace weak {
+
+StringMutationAnalysis::StringMutationAnalysis(ASTNode *Root, const EffectAnalysis &Effects) {
+  MutationCollector(Effects, mMutated).Collect(Root);
+}
+
+const std::unordered_set<const ASTVarDecl *> &StringMutationAnalysis::Mutated() const {
+  return mMutated;
+}
+
+} // namespace weak
\ No newline at end of file
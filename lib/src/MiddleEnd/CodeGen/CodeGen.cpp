@@ -7,14 +7,21 @@
 #include "MiddleEnd/CodeGen/CodeGen.h"
 
 #include "FrontEnd/AST/AST.h"
+#include "MiddleEnd/CallGraph/CallGraph.h"
+#include "MiddleEnd/CallGraph/EffectAnalysis.h"
+#include "MiddleEnd/CallGraph/StringMutationAnalysis.h"
 #include "MiddleEnd/CodeGen/ScalarExprEmitter.h"
 #include "MiddleEnd/CodeGen/TypeResolver.h"
+#include "MiddleEnd/IR/LLVMEmitter.h"
 #include "Utility/Unreachable.h"
 #include "llvm/ADT/APFloat.h"
 #include "llvm/IR/BasicBlock.h"
+#include "llvm/IR/CFG.h"
 #include "llvm/IR/Constants.h"
 #include "llvm/IR/DerivedTypes.h"
 #include "llvm/IR/Function.h"
+#include "llvm/IR/Intrinsics.h"
+#include "llvm/IR/MDBuilder.h"
 #include "llvm/IR/Type.h"
 #include "llvm/IR/Verifier.h"
 
@@ -35,14 +42,26 @@ public:
     , mResolver(mIRBuilder) {}
 
   llvm::Function *BuildSignature() {
-    /// \todo: Always external linkage? Come here after making multiple files
-    ///        compilation.
-    return llvm::Function::Create(
+    /// Functions, not visible outside of module, can use any calling
+    /// convention and be removed after inlining into all callers.
+    bool IsExternal = !mDecl->Is(AST_FUNCTION_DECL) || CallGraph::IsEntryPoint(mDecl);
+
+    llvm::Function *Func = llvm::Function::Create(
       CreateSignature(),
-      llvm::Function::ExternalLinkage,
+      IsExternal
+        ? llvm::Function::ExternalLinkage
+        : llvm::Function::InternalLinkage,
       mDecl->Name(),
       &mIRModule
     );
+
+    if (!IsExternal)
+      Func->setCallingConv(llvm::CallingConv::Fast);
+
+    for (auto &Arg : Func->args())
+      AddParamAttributes(Arg, mDecl->Args()[Arg.getArgNo()]);
+
+    return Func;
   }
 
 private:
@@ -60,10 +79,14 @@ private:
   }
 
   llvm::Type *ResolveParamType(ASTNode *AST) {
-    if (AST->Is(AST_VAR_DECL))
-      return mResolver.ResolveExceptVoid(
-        static_cast<ASTVarDecl *>(AST)->DataType()
-      );
+    if (AST->Is(AST_VAR_DECL)) {
+      auto *Decl = static_cast<ASTVarDecl *>(AST);
+      /// Structures are always passed by pointer.
+      if (Decl->DataType() == DT_STRUCT)
+        return ResolveStruct(Decl)->getPointerTo();
+
+      return mResolver.ResolveExceptVoid(Decl->DataType());
+    }
 
     return llvm::PointerType::get(
       mResolver.ResolveExceptVoid(
@@ -73,6 +96,56 @@ private:
     );
   }
 
+  llvm::StructType *ResolveStruct(ASTVarDecl *Decl) {
+    return llvm::StructType::getTypeByName(
+      mIRModule.getContext(),
+      Decl->TypeName()
+    );
+  }
+
+  /// Describe memory, referenced by array or structure parameter.
+  ///
+  /// Structure without mode is copied by callee (`byval`). Parameters
+  /// with mode are references to at least declared count of elements,
+  /// which never escape the call.
+  void AddParamAttributes(llvm::Argument &Arg, ASTNode *AST) {
+    llvm::LLVMContext &Ctx = mIRModule.getContext();
+    const llvm::DataLayout &DL = mIRModule.getDataLayout();
+    ParamMode Mode = PARAM_DEFAULT;
+    llvm::Type *MemTy = nullptr;
+
+    if (AST->Is(AST_ARRAY_DECL)) {
+      auto *Decl = static_cast<ASTArrayDecl *>(AST);
+      Mode = Decl->Mode();
+      MemTy = mResolver.Resolve(Decl);
+    } else if (auto *Decl = static_cast<ASTVarDecl *>(AST); Decl->DataType() == DT_STRUCT) {
+      Mode = Decl->Mode();
+      MemTy = ResolveStruct(Decl);
+      if (Mode == PARAM_DEFAULT)
+        Arg.addAttr(llvm::Attribute::getWithByValType(Ctx, MemTy));
+    }
+
+    if (!MemTy || (Mode == PARAM_DEFAULT && !Arg.hasByValAttr()))
+      return;
+
+    Arg.addAttr(llvm::Attribute::getWithAlignment(Ctx, DL.getABITypeAlign(MemTy)));
+
+    if (Mode == PARAM_DEFAULT)
+      return;
+
+    Arg.addAttr(llvm::Attribute::NoCapture);
+    Arg.addAttr(llvm::Attribute::getWithDereferenceableBytes(
+      Ctx,
+      DL.getTypeAllocSize(MemTy).getFixedSize()
+    ));
+
+    if (Mode == PARAM_IN)
+      Arg.addAttr(llvm::Attribute::ReadOnly);
+
+    if (Mode == PARAM_RESTRICT)
+      Arg.addAttr(llvm::Attribute::NoAlias);
+  }
+
   llvm::IRBuilder<> &mIRBuilder;
   llvm::Module &mIRModule;
   ASTFunctionDeclOrPrototype *mDecl;
@@ -84,14 +157,74 @@ private:
 
 namespace weak {
 
-CodeGen::CodeGen(ASTNode *Root)
+CodeGen::CodeGen(ASTNode *Root, CodeGenOptions Options)
   : mRoot(Root)
+  , mOptions(Options)
   , mLastInstr(nullptr)
   , mIRModule("LLVM Module", mIRCtx)
-  , mIRBuilder(mIRCtx) {}
+  , mIRBuilder(mIRCtx)
+  , mBoundsTrapBB(nullptr) {
+  /// Profiles name local functions by source file, so same local names
+  /// in different files do not clash.
+  if (!mOptions.SourcePath.empty())
+    mIRModule.setSourceFileName(mOptions.SourcePath);
+  if (mOptions.DebugInfo)
+    mDebugInfo = std::make_unique<DebugInfoBuilder>(mIRModule, mOptions.SourcePath);
+}
 
 void CodeGen::CreateCode() {
+  EffectAnalysis Analysis(mRoot, mOptions.BoundsCheck);
+  mMutatedStrings = StringMutationAnalysis(mRoot, Analysis).Mutated();
   mRoot->Accept(this);
+  if (mDebugInfo)
+    mDebugInfo->Finalize();
+  AddFunctionAttributes(Analysis);
+}
+
+void CodeGen::AddFunctionAttributes(const EffectAnalysis &Analysis) {
+  for (llvm::Function &F : mIRModule) {
+    if (F.isDeclaration())
+      continue;
+
+    const FunctionEffects *Effects = Analysis.Effects(F.getName());
+    if (!Effects)
+      continue;
+
+    if (!Effects->MayUnwind)
+      F.addFnAttr(llvm::Attribute::NoUnwind);
+
+    if (!Effects->MayRecurse)
+      F.addFnAttr(llvm::Attribute::NoRecurse);
+
+    if (!Effects->MayUnwind && !Effects->MayNotReturn)
+      F.addFnAttr(llvm::Attribute::WillReturn);
+
+    if (Effects->ReadNone())
+      F.addFnAttr(llvm::Attribute::ReadNone);
+    else {
+      if (Effects->ReadOnly())
+        F.addFnAttr(llvm::Attribute::ReadOnly);
+      if (Effects->ArgMemOnly())
+        F.addFnAttr(llvm::Attribute::ArgMemOnly);
+    }
+
+    for (llvm::Argument &Arg : F.args()) {
+      if (!Arg.getType()->isPointerTy())
+        continue;
+
+      const ParamEffects &P = Effects->Params[Arg.getArgNo()];
+      if (!P.Captured)
+        Arg.addAttr(llvm::Attribute::NoCapture);
+
+      if (!P.Read && !P.Written) {
+        /// Unused parameter can be declared read-only.
+        Arg.removeAttr(llvm::Attribute::ReadOnly);
+        Arg.addAttr(llvm::Attribute::ReadNone);
+      }
+      else if (!P.Written)
+        Arg.addAttr(llvm::Attribute::ReadOnly);
+    }
+  }
 }
 
 void CodeGen::Visit(ASTBool *Stmt) {
@@ -111,15 +244,22 @@ void CodeGen::Visit(ASTFloat *Stmt) {
   mLastInstr = llvm::ConstantFP::get(mIRCtx, Float);
 }
 
-void CodeGen::Visit(ASTString *Stmt) {
-  auto *Literal = mIRBuilder.CreateGlobalString(Stmt->Value());
-  Literal->setDSOLocal(false);
-  mLastInstr = llvm::ConstantExpr::getBitCast(
+llvm::Constant *CodeGen::EmitStringLiteral(const std::string &Value) {
+  auto &Literal = mStringPool[Value];
+  if (!Literal)
+    /// Created constant is already private and unnamed_addr, so LLVM
+    /// is also free to merge it with equal constants from other modules.
+    Literal = mIRBuilder.CreateGlobalString(Value, ".str", 0, &mIRModule);
+  return llvm::ConstantExpr::getBitCast(
     Literal,
     mIRBuilder.getInt8PtrTy()
   );
 }
 
+void CodeGen::Visit(ASTString *Stmt) {
+  mLastInstr = EmitStringLiteral(Stmt->Value());
+}
+
 static TokenType ResolveAssignmentOp(TokenType T) {
   switch (T) {
   case TOK_MUL_ASSIGN:     return TOK_STAR;
@@ -140,22 +280,34 @@ void CodeGen::Visit(ASTBinary *Stmt) {
   auto *LHS = Stmt->LHS();
   auto *RHS = Stmt->RHS();
 
-  LHS->Accept(this);
+  /// Old value of variable is not needed to overwrite it.
+  if (Stmt->Operation() == TOK_ASSIGN && LHS->Is(AST_SYMBOL)) {
+    mLastInstr = EmitValue(RHS);
+    if (mLastInstr)
+      WriteVariable(static_cast<ASTSymbol *>(LHS)->Name(), mLastInstr);
+    return;
+  }
+
+  if (Stmt->Operation() == TOK_AND || Stmt->Operation() == TOK_OR) {
+    mLastInstr = EmitLogicalValue(Stmt);
+    return;
+  }
+
+  if (LHS->Is(AST_MEMBER_ACCESS))
+    mLastInstr = EmitMemberPtr(static_cast<ASTMemberAccess *>(LHS));
+  else
+    LHS->Accept(this);
   llvm::Value *L = mLastInstr;
-  RHS->Accept(this);
-  llvm::Value *R = mLastInstr;
+  /// Load only value, since right hand side is never writeable.
+  llvm::Value *R = EmitValue(RHS);
 
   /// Load value and save pointer to it.
-  llvm::Value *ArrayPtr{nullptr};
-  if (LHS->Is(AST_ARRAY_ACCESS)) {
-    ArrayPtr = L;
+  llvm::Value *MemPtr{nullptr};
+  if (LHS->Is(AST_ARRAY_ACCESS) || LHS->Is(AST_MEMBER_ACCESS)) {
+    MemPtr = L;
     L = mIRBuilder.CreateLoad(L->getType()->getPointerElementType(), L);
   }
 
-  /// Load only value, since right hand side is never writeable.
-  if (RHS->Is(AST_ARRAY_ACCESS))
-    R = mIRBuilder.CreateLoad(R->getType()->getPointerElementType(), R);
-
   if (!L || !R)
     return;
 
@@ -163,22 +315,8 @@ void CodeGen::Visit(ASTBinary *Stmt) {
 
   switch (auto T = Stmt->Operation()) {
   case TOK_ASSIGN: {
-    if (LHS->Is(AST_ARRAY_ACCESS))
-      mIRBuilder.CreateStore(R, ArrayPtr);
-    else if (LHS->Is(AST_MEMBER_ACCESS)) {
-      auto *MA = static_cast<ASTMemberAccess *>(LHS);
-      const auto &Name = MA->Name()->Name();
-      auto *Type = llvm::StructType::getTypeByName(mIRCtx, mStructVarsStorage[Name]);
-
-      llvm::AllocaInst *Struct = mStorage.Lookup(Name);
-      /// \todo: Get AST for declaration and convert `.field` to index
-      mLastInstr = mIRBuilder.CreateStructGEP(Type, Struct, 1);
-      mIRBuilder.CreateStore(R, mLastInstr);
-    } else {
-      auto *Symbol = static_cast<ASTSymbol *>(LHS);
-      llvm::AllocaInst *Variable = mStorage.Lookup(Symbol->Name());
-      mIRBuilder.CreateStore(R, Variable);
-    }
+    if (MemPtr)
+      mIRBuilder.CreateStore(R, MemPtr);
     break;
   }
   case TOK_MUL_ASSIGN:
@@ -191,11 +329,12 @@ void CodeGen::Visit(ASTBinary *Stmt) {
   case TOK_BIT_AND_ASSIGN:
   case TOK_BIT_OR_ASSIGN:
   case TOK_XOR_ASSIGN: {
-    auto *Symbol = static_cast<ASTSymbol *>(LHS);
-    llvm::AllocaInst *Variable = mStorage.Lookup(Symbol->Name());
     TokenType Op = ResolveAssignmentOp(T);
     mLastInstr = ScalarEmitter.EmitBinOp(Op, L, R);
-    mIRBuilder.CreateStore(mLastInstr, Variable);
+    if (MemPtr)
+      mIRBuilder.CreateStore(mLastInstr, MemPtr);
+    else
+      WriteVariable(static_cast<ASTSymbol *>(LHS)->Name(), mLastInstr);
     break;
   }
   case TOK_PLUS:
@@ -208,8 +347,6 @@ void CodeGen::Visit(ASTBinary *Stmt) {
   case TOK_GT:
   case TOK_EQ:
   case TOK_NEQ:
-  case TOK_OR:
-  case TOK_AND:
   case TOK_BIT_OR:
   case TOK_BIT_AND:
   case TOK_XOR:
@@ -245,22 +382,20 @@ void CodeGen::Visit(ASTUnary *Stmt) {
   switch (auto T = Stmt->Operation()) {
   case TOK_INC:
   case TOK_DEC:
-    mLastInstr = ScalarEmitter.EmitBinOp(ResolveUnaryOp(T), Op, mIRBuilder.getInt32(1));
+    mLastInstr = ScalarEmitter.EmitBinOp(ResolveUnaryOp(T), Op, llvm::ConstantInt::get(Op->getType(), 1));
     break;
   default:
     Unreachable("Should not reach there.");
   }
 
-  auto *Symbol = static_cast<ASTSymbol *>(Stmt->Operand());
-
-  mIRBuilder.CreateStore(
-    mLastInstr,
-    ArrayPtr ? ArrayPtr : mStorage.Lookup(Symbol->Name())
-  );
+  if (ArrayPtr)
+    mIRBuilder.CreateStore(mLastInstr, ArrayPtr);
+  else
+    WriteVariable(static_cast<ASTSymbol *>(Stmt->Operand())->Name(), mLastInstr);
 }
 
 void CodeGen::Visit(ASTFor *Stmt) {
-  mStorage.StartScope();
+  StartScope();
 
   llvm::Function *Func = mIRBuilder.GetInsertBlock()->getParent();
 
@@ -268,29 +403,50 @@ void CodeGen::Visit(ASTFor *Stmt) {
     I->Accept(this);
 
   llvm::BasicBlock *CondBB{nullptr};
+  llvm::BasicBlock *IncBB{nullptr};
 
   auto *BodyBB = llvm::BasicBlock::Create(mIRCtx, "for.body", Func);
   auto *EndBB  = llvm::BasicBlock::Create(mIRCtx, "for.end", Func);
+  llvm::BasicBlock *PreheaderBB = mIRBuilder.GetInsertBlock();
 
   if (auto *C = Stmt->Condition()) {
     CondBB = llvm::BasicBlock::Create(mIRCtx, "for.cond", Func);
-    mIRBuilder.CreateBr(CondBB);
+    EmitBranch(CondBB);
     mIRBuilder.SetInsertPoint(CondBB);
-    C->Accept(this);
-    mIRBuilder.CreateCondBr(mLastInstr, BodyBB, EndBB);
+    EmitLocation(C);
+    EmitBranchOnCondition(C, BodyBB, EndBB);
+    mSSA.Seal(BodyBB);
   } else
-    mIRBuilder.CreateBr(BodyBB);
+    EmitBranch(BodyBB);
+
+  llvm::BasicBlock *HeaderBB = CondBB ? CondBB : BodyBB;
+
+  /// Increment is placed in its own block, since `continue` should
+  /// execute it.
+  if (Stmt->Increment())
+    IncBB = llvm::BasicBlock::Create(mIRCtx, "for.inc", Func, EndBB);
 
+  mLoops.push_back({IncBB ? IncBB : HeaderBB, EndBB, mStorage.Depth()});
   mIRBuilder.SetInsertPoint(BodyBB);
   Stmt->Body()->Accept(this);
+  mLoops.pop_back();
+
+  if (IncBB) {
+    EmitBranch(IncBB);
+    mSSA.Seal(IncBB);
+    mIRBuilder.SetInsertPoint(IncBB);
+    EmitLocation(Stmt->Increment());
+    Stmt->Increment()->Accept(this);
+  }
 
-  if (auto *I = Stmt->Increment())
-    I->Accept(this);
-
-  mIRBuilder.CreateBr(CondBB ? CondBB : BodyBB);
+  /// Back edge is the last predecessor of loop header.
+  EmitBranch(HeaderBB);
+  AttachLoopID(HeaderBB, PreheaderBB, CreateLoopID(Stmt->Hints()));
+  mSSA.Seal(HeaderBB);
+  mSSA.Seal(EndBB);
   mIRBuilder.SetInsertPoint(EndBB);
 
-  mStorage.EndScope();
+  EndScope();
 }
 
 void CodeGen::Visit(ASTWhile *Stmt) {
@@ -299,15 +455,22 @@ void CodeGen::Visit(ASTWhile *Stmt) {
   auto *CondBB = llvm::BasicBlock::Create(mIRCtx, "while.cond", Func);
   auto *BodyBB = llvm::BasicBlock::Create(mIRCtx, "while.body", Func);
   auto *EndBB  = llvm::BasicBlock::Create(mIRCtx, "while.end", Func);
+  llvm::BasicBlock *PreheaderBB = mIRBuilder.GetInsertBlock();
 
-  mIRBuilder.CreateBr(CondBB);
+  EmitBranch(CondBB);
   mIRBuilder.SetInsertPoint(CondBB);
+  EmitLocation(Stmt->Condition());
 
-  Stmt->Condition()->Accept(this);
-  mIRBuilder.CreateCondBr(mLastInstr, BodyBB, EndBB);
+  EmitBranchOnCondition(Stmt->Condition(), BodyBB, EndBB);
+  mSSA.Seal(BodyBB);
   mIRBuilder.SetInsertPoint(BodyBB);
+  mLoops.push_back({CondBB, EndBB, mStorage.Depth()});
   Stmt->Body()->Accept(this);
-  mIRBuilder.CreateBr(CondBB);
+  mLoops.pop_back();
+  EmitBranch(CondBB);
+  AttachLoopID(CondBB, PreheaderBB, CreateLoopID(Stmt->Hints()));
+  mSSA.Seal(CondBB);
+  mSSA.Seal(EndBB);
   mIRBuilder.SetInsertPoint(EndBB);
 }
 
@@ -315,49 +478,136 @@ void CodeGen::Visit(ASTDoWhile *Stmt) {
   llvm::Function *Func = mIRBuilder.GetInsertBlock()->getParent();
 
   auto *BodyBB = llvm::BasicBlock::Create(mIRCtx, "do.while.body", Func);
+  auto *CondBB = llvm::BasicBlock::Create(mIRCtx, "do.while.cond", Func);
   auto *EndBB  = llvm::BasicBlock::Create(mIRCtx, "do.while.end", Func);
+  llvm::BasicBlock *PreheaderBB = mIRBuilder.GetInsertBlock();
 
-  mIRBuilder.CreateBr(BodyBB);
+  EmitBranch(BodyBB);
   mIRBuilder.SetInsertPoint(BodyBB);
 
+  mLoops.push_back({CondBB, EndBB, mStorage.Depth()});
   Stmt->Body()->Accept(this);
-  Stmt->Condition()->Accept(this);
-  mIRBuilder.CreateCondBr(mLastInstr, BodyBB, EndBB);
+  mLoops.pop_back();
+  EmitBranch(CondBB);
+  mSSA.Seal(CondBB);
+  mIRBuilder.SetInsertPoint(CondBB);
+  EmitLocation(Stmt->Condition());
+  EmitBranchOnCondition(Stmt->Condition(), BodyBB, EndBB);
+  AttachLoopID(BodyBB, PreheaderBB, CreateLoopID(Stmt->Hints()));
+  mSSA.Seal(BodyBB);
+  mSSA.Seal(EndBB);
   mIRBuilder.SetInsertPoint(EndBB);
 }
 
-void CodeGen::Visit(ASTIf *Stmt) {
-  Stmt->Condition()->Accept(this);
-  llvm::Value *Cond = mLastInstr;
+void CodeGen::Visit(ASTBreak *) {
+  assert(!mLoops.empty() && "`break` outside of loop");
+  EmitLifetimeEnds(mLoops.back().Depth);
+  EmitBranch(mLoops.back().BreakBB);
+}
 
-  unsigned NumBits = Cond->getType()->getPrimitiveSizeInBits();
-  Cond = mIRBuilder.CreateICmpNE(Cond, mIRBuilder.getIntN(NumBits, 0));
+void CodeGen::Visit(ASTContinue *) {
+  assert(!mLoops.empty() && "`continue` outside of loop");
+  EmitLifetimeEnds(mLoops.back().Depth);
+  EmitBranch(mLoops.back().ContinueBB);
+}
 
+llvm::MDNode *CodeGen::CreateLoopID(const LoopHints &Hints) {
+  auto Temp = llvm::MDNode::getTemporary(mIRCtx, llvm::None);
+  llvm::SmallVector<llvm::Metadata *, 4> Operands{Temp.get()};
+
+  auto AddProperty = [&](llvm::StringRef Name, llvm::Metadata *Value = nullptr) {
+    llvm::SmallVector<llvm::Metadata *, 2> Property{llvm::MDString::get(mIRCtx, Name)};
+    if (Value)
+      Property.push_back(Value);
+    Operands.push_back(llvm::MDNode::get(mIRCtx, Property));
+  };
+
+  auto Int32 = [&](unsigned Value) {
+    return llvm::ConstantAsMetadata::get(mIRBuilder.getInt32(Value));
+  };
+
+  switch (Hints.Unroll) {
+  case LoopHints::UNROLL_ENABLE:
+    if (Hints.UnrollCount)
+      AddProperty("llvm.loop.unroll.count", Int32(Hints.UnrollCount));
+    else
+      AddProperty("llvm.loop.unroll.enable");
+    break;
+  case LoopHints::UNROLL_DISABLE:
+    AddProperty("llvm.loop.unroll.disable");
+    break;
+  case LoopHints::UNROLL_FULL:
+    AddProperty("llvm.loop.unroll.full");
+    break;
+  default:
+    break;
+  }
+
+  switch (Hints.Vectorize) {
+  case LoopHints::VECTORIZE_ENABLE:
+    AddProperty("llvm.loop.vectorize.enable", llvm::ConstantAsMetadata::get(mIRBuilder.getTrue()));
+    if (Hints.VectorizeWidth)
+      AddProperty("llvm.loop.vectorize.width", Int32(Hints.VectorizeWidth));
+    break;
+  case LoopHints::VECTORIZE_DISABLE:
+    /// Width 1 means scalar loop.
+    AddProperty("llvm.loop.vectorize.width", Int32(1U));
+    break;
+  default:
+    break;
+  }
+
+  if (Hints.InterleaveCount)
+    AddProperty("llvm.loop.interleave.count", Int32(Hints.InterleaveCount));
+
+  /// First operand of loop ID refers to node itself, which makes it
+  /// distinct from IDs of other loops.
+  llvm::MDNode *LoopID = llvm::MDNode::getDistinct(mIRCtx, Operands);
+  LoopID->replaceOperandWith(0, LoopID);
+  return LoopID;
+}
+
+void CodeGen::AttachLoopID(
+  llvm::BasicBlock *HeaderBB,
+  llvm::BasicBlock *PreheaderBB,
+  llvm::MDNode     *LoopID
+) {
+  /// Every branch to header, except entry to loop, is a back edge.
+  for (llvm::BasicBlock *Pred : llvm::predecessors(HeaderBB))
+    if (Pred != PreheaderBB)
+      Pred->getTerminator()->setMetadata(llvm::LLVMContext::MD_loop, LoopID);
+}
+
+void CodeGen::Visit(ASTIf *Stmt) {
   llvm::Function *Func = mIRBuilder.GetInsertBlock()->getParent();
 
   auto *ThenBB  = llvm::BasicBlock::Create(mIRCtx, "if.then", Func);
   auto *ElseBB  = llvm::BasicBlock::Create(mIRCtx, "if.else");
   auto *MergeBB = llvm::BasicBlock::Create(mIRCtx, "if.end");
 
-  mIRBuilder.CreateCondBr(Cond, ThenBB, Stmt->ElseBody() ? ElseBB : MergeBB);
+  EmitBranchOnCondition(Stmt->Condition(), ThenBB, Stmt->ElseBody() ? ElseBB : MergeBB);
+  mSSA.Seal(ThenBB);
   mIRBuilder.SetInsertPoint(ThenBB);
 
   Stmt->ThenBody()->Accept(this);
-  mIRBuilder.CreateBr(MergeBB);
+  EmitBranch(MergeBB);
 
   if (!Stmt->ElseBody()) {
     Func->getBasicBlockList().push_back(MergeBB);
+    mSSA.Seal(MergeBB);
     mIRBuilder.SetInsertPoint(MergeBB);
     return;
   }
 
   Func->getBasicBlockList().push_back(ElseBB);
+  mSSA.Seal(ElseBB);
   mIRBuilder.SetInsertPoint(ElseBB);
 
   Stmt->ElseBody()->Accept(this);
-  mIRBuilder.CreateBr(MergeBB);
+  EmitBranch(MergeBB);
 
   Func->getBasicBlockList().push_back(MergeBB);
+  mSSA.Seal(MergeBB);
   mIRBuilder.SetInsertPoint(MergeBB);
 }
 
@@ -375,25 +625,77 @@ void CodeGen::Visit(ASTFunctionDecl *Decl) {
   FunctionBuilder B(mIRBuilder, mIRModule, Decl);
   llvm::Function *Func = B.BuildSignature();
 
+  if (mOptions.WeakIRDeclarationsOnly) {
+    Func->setLinkage(llvm::Function::ExternalLinkage);
+    Func->setCallingConv(llvm::CallingConv::C);
+    /// Still not visible outside of translation unit.
+    if (!CallGraph::IsEntryPoint(Decl))
+      Func->setVisibility(llvm::GlobalValue::HiddenVisibility);
+  }
+
+  if (mOptions.WeakIR)
+    if (const ir::Function *F = mOptions.WeakIR->Find(Decl->Name())) {
+      if (mOptions.WeakIRDeclarationsOnly)
+        return;
+      for (auto &Arg : Func->args())
+        Arg.setName(ASTDeclName(Decl->Args()[Arg.getArgNo()]));
+      ir::EmitLLVMFunctionBody(*mOptions.WeakIR, *F, Func);
+      /// Broken function from Weak IR would be silently miscompiled by
+      /// both back ends, so stop here.
+      if (llvm::verifyFunction(*Func, &llvm::errs()))
+        Unreachable("Invalid LLVM IR is emitted from Weak IR.");
+      return;
+    }
+
   auto *EntryBB = llvm::BasicBlock::Create(mIRCtx, "entry", Func);
   mIRBuilder.SetInsertPoint(EntryBB);
+  mBoundsTrapBB = nullptr;
 
-  mStorage.StartScope();
+  mSSA.Reset();
+  mSSA.Seal(EntryBB);
+  StartScope();
+
+  if (mDebugInfo) {
+    mDebugInfo->StartFunction(Func, Decl);
+    EmitLocation(Decl);
+  }
 
+  /// Arguments are never spilled to stack: scalars are just initial
+  /// SSA values, arrays and structures are already pointers to memory.
   auto ASTArgIt = Decl->Args().begin();
   for (auto &Arg : Func->args()) {
-    auto *ArgAlloca = mIRBuilder.CreateAlloca(Arg.getType());
-    mIRBuilder.CreateStore(&Arg, ArgAlloca);
-    mStorage.Push(ASTDeclName(*ASTArgIt++), ArgAlloca);
+    const auto &Name = ASTDeclName(*ASTArgIt);
+    Arg.setName(Name);
+    if ((*ASTArgIt)->Is(AST_ARRAY_DECL)) {
+      auto *ArrayDecl = static_cast<ASTArrayDecl *>(*ASTArgIt);
+      mArraysStorage.back()[ArrayDecl->Name()] = ArrayDecl;
+      mStorage.Push(Name, &Arg);
+    } else if (static_cast<ASTVarDecl *>(*ASTArgIt)->DataType() == DT_STRUCT) {
+      mStorage.Push(Name, &Arg);
+    } else {
+      mSSA.Declare(Name, Arg.getType());
+      mSSA.Write(Name, EntryBB, &Arg);
+    }
+    if (mDebugInfo)
+      mDebugInfo->DeclareVariable(*ASTArgIt, &Arg, EntryBB, Arg.getArgNo() + 1);
+    ++ASTArgIt;
   }
 
   Decl->Body()->Accept(this);
-  mStorage.EndScope();
-  llvm::verifyFunction(*Func);
+  EndScope();
   mLastInstr = nullptr;
 
-  if (Decl->ReturnType() == DT_VOID)
-    mIRBuilder.CreateRetVoid();
+  if (!mIRBuilder.GetInsertBlock()->getTerminator()) {
+    if (Decl->ReturnType() == DT_VOID)
+      mIRBuilder.CreateRetVoid();
+    else
+      /// All paths with return were already terminated.
+      mIRBuilder.CreateUnreachable();
+  }
+
+  llvm::verifyFunction(*Func);
+  mIRBuilder.ClearInsertionPoint();
+  mIRBuilder.SetCurrentDebugLocation(llvm::DebugLoc());
 }
 
 void CodeGen::Visit(ASTFunctionCall *Stmt) {
@@ -402,11 +704,17 @@ void CodeGen::Visit(ASTFunctionCall *Stmt) {
 
   llvm::SmallVector<llvm::Value *, 16> Args;
   for (auto *Arg : FunArgs) {
-    Arg->Accept(this);
-    Args.push_back(mLastInstr);
+    llvm::Value *V = EmitValue(Arg);
+    /// Comparisons give i1, that is widened to integer parameter type.
+    llvm::Type *ParamTy = Callee->getFunctionType()->getParamType(Args.size());
+    if (ParamTy->isIntegerTy() && V->getType()->isIntegerTy())
+      V = mIRBuilder.CreateZExtOrTrunc(V, ParamTy);
+    Args.push_back(V);
   }
 
-  mLastInstr = mIRBuilder.CreateCall(Callee, Args);
+  llvm::CallInst *Call = mIRBuilder.CreateCall(Callee, Args);
+  Call->setCallingConv(Callee->getCallingConv());
+  mLastInstr = Call;
 }
 
 void CodeGen::Visit(ASTFunctionPrototype *Stmt) {
@@ -415,15 +723,31 @@ void CodeGen::Visit(ASTFunctionPrototype *Stmt) {
 }
 
 void CodeGen::Visit(ASTArrayAccess *Stmt) {
-  llvm::AllocaInst *Symbol = mStorage.Lookup(Stmt->Name());
-  llvm::Value *Array = mIRBuilder.CreateLoad(Symbol->getAllocatedType(), Symbol);
-  llvm::Type *ArrayTy = Array->getType();
+  /// Local arrays are addressed through their stack slot, array and
+  /// string parameters are pointers to first element.
+  llvm::Value *Array = mStorage.Lookup(Stmt->Name());
+  llvm::Type *ArrayTy = nullptr;
+  if (auto *Alloca = llvm::dyn_cast_or_null<llvm::AllocaInst>(Array))
+    ArrayTy = Alloca->getAllocatedType();
+  else {
+    if (!Array)
+      Array = mSSA.Read(Stmt->Name(), mIRBuilder.GetInsertBlock());
+    ArrayTy = Array->getType();
+  }
   llvm::Value *Zero = mIRBuilder.getInt32(0);
 
-  for (ASTNode *I : Stmt->Indices()) {
-    I->Accept(this);
+  const std::vector<unsigned> *ArityList = nullptr;
+  if (mOptions.BoundsCheck && !Stmt->InBounds())
+    if (ASTArrayDecl *Decl = LookupArrayDecl(Stmt->Name()))
+      ArityList = &Decl->ArityList();
+
+  for (size_t Dim = 0; Dim < Stmt->Indices().size(); ++Dim) {
+    Stmt->Indices()[Dim]->Accept(this);
     llvm::Value *Index = mLastInstr;
 
+    if (ArityList && Dim < ArityList->size())
+      EmitBoundsCheck(Index, (*ArityList)[Dim]);
+
     if (ArrayTy->isPointerTy()) {
       /// Pointer.
       mLastInstr = mIRBuilder.CreateInBoundsGEP(
@@ -434,11 +758,7 @@ void CodeGen::Visit(ASTArrayAccess *Stmt) {
       ArrayTy = ArrayTy->getPointerElementType();
     } else if (ArrayTy->isArrayTy()) {
       /// Array.
-      mLastInstr = mIRBuilder.CreateInBoundsGEP(
-        ArrayTy,
-        Array->getType()->isArrayTy() ? llvm::getPointerOperand(Array) : Array,
-        {Zero, Index}
-      );
+      mLastInstr = mIRBuilder.CreateInBoundsGEP(ArrayTy, Array, {Zero, Index});
       ArrayTy = llvm::dyn_cast<llvm::ArrayType>(ArrayTy)->getElementType();
     } else
       Unreachable("Expected array or pointer type.");
@@ -448,66 +768,298 @@ void CodeGen::Visit(ASTArrayAccess *Stmt) {
 }
 
 void CodeGen::Visit(ASTSymbol *Stmt) {
-  llvm::AllocaInst *Symbol = mStorage.Lookup(Stmt->Name());
-  llvm::Type *SymbolTy = Symbol->getAllocatedType();
+  mLastInstr = ReadVariable(Stmt->Name());
+}
 
+llvm::Value *CodeGen::ReadVariable(const std::string &Name) {
+  llvm::Value *Symbol = mStorage.Lookup(Name);
+
+  if (!Symbol)
+    return mSSA.Read(Name, mIRBuilder.GetInsertBlock());
+
+  auto *Alloca = llvm::dyn_cast<llvm::AllocaInst>(Symbol);
+  if (!Alloca)
+    /// Array or structure parameter.
+    return Symbol;
+
+  llvm::Type *SymbolTy = Alloca->getAllocatedType();
   if (SymbolTy->isArrayTy())
-    mLastInstr = mIRBuilder.CreateConstGEP2_32(SymbolTy, Symbol, 0, 0);
+    return mIRBuilder.CreateConstGEP2_32(SymbolTy, Alloca, 0, 0);
+
+  /// Structures are passed to functions by pointer.
+  if (SymbolTy->isStructTy())
+    return Alloca;
+
+  return mIRBuilder.CreateLoad(SymbolTy, Alloca);
+}
+
+void CodeGen::WriteVariable(const std::string &Name, llvm::Value *V) {
+  if (llvm::Value *Symbol = mStorage.Lookup(Name))
+    mIRBuilder.CreateStore(V, Symbol);
+  else {
+    mSSA.Write(Name, mIRBuilder.GetInsertBlock(), V);
+    if (mDebugInfo)
+      mDebugInfo->UpdateVariable(Name, V, mIRBuilder.GetInsertBlock());
+  }
+}
+
+llvm::Value *CodeGen::EmitValue(ASTNode *AST) {
+  AST->Accept(this);
+
+  if (AST->Is(AST_ARRAY_ACCESS))
+    mLastInstr = mIRBuilder.CreateLoad(
+      mLastInstr->getType()->getPointerElementType(),
+      mLastInstr
+    );
+
+  return mLastInstr;
+}
+
+llvm::AllocaInst *CodeGen::EmitStackSlot(llvm::Type *Ty) {
+  llvm::BasicBlock &EntryBB = mIRBuilder.GetInsertBlock()->getParent()->getEntryBlock();
+
+  /// Keep all allocas together at the beginning of entry block.
+  auto It = EntryBB.begin();
+  while (It != EntryBB.end() && llvm::isa<llvm::AllocaInst>(*It))
+    ++It;
+
+  llvm::IRBuilder<> AllocaBuilder(&EntryBB, It);
+  llvm::AllocaInst *Slot = AllocaBuilder.CreateAlloca(Ty);
+  mIRBuilder.CreateLifetimeStart(Slot);
+  return Slot;
+}
+
+ASTArrayDecl *CodeGen::LookupArrayDecl(const std::string &Name) const {
+  for (auto Scope = mArraysStorage.rbegin(); Scope != mArraysStorage.rend(); ++Scope)
+    if (auto It = Scope->find(Name); It != Scope->end())
+      return It->second;
+  return nullptr;
+}
+
+void CodeGen::StartScope() {
+  mStorage.StartScope();
+  mArraysStorage.emplace_back();
+}
+
+void CodeGen::EndScope() {
+  /// Scope, left by break, continue or return, already has its slots
+  /// ended on that exit.
+  llvm::BasicBlock *BB = mIRBuilder.GetInsertBlock();
+  if (BB && !BB->getTerminator())
+    EmitLifetimeEnds(mStorage.Depth() - 1);
+
+  mStorage.EndScope();
+  mArraysStorage.pop_back();
+}
+
+void CodeGen::EmitLifetimeEnds(unsigned Depth) {
+  for (llvm::Value *V : mStorage.ScopesDeeperThan(Depth))
+    if (llvm::isa<llvm::AllocaInst>(V))
+      mIRBuilder.CreateLifetimeEnd(V);
+}
+
+llvm::Value *CodeGen::EmitBoolCast(llvm::Value *V) {
+  llvm::Type *Ty = V->getType();
+
+  if (Ty->isIntegerTy(1))
+    return V;
+
+  if (Ty->isIntegerTy())
+    return mIRBuilder.CreateICmpNE(V, llvm::ConstantInt::get(Ty, 0));
+
+  if (Ty->isFloatingPointTy())
+    return mIRBuilder.CreateFCmpUNE(V, llvm::ConstantFP::get(Ty, 0.0));
+
+  if (Ty->isPointerTy())
+    return mIRBuilder.CreateIsNotNull(V);
+
+  Unreachable("Expected scalar condition.");
+}
+
+void CodeGen::EmitBranchOnCondition(
+  ASTNode           *Cond,
+  llvm::BasicBlock  *TrueBB,
+  llvm::BasicBlock  *FalseBB
+) {
+  if (Cond->Is(AST_BINARY)) {
+    auto *Binary = static_cast<ASTBinary *>(Cond);
+    TokenType Op = Binary->Operation();
+
+    if (Op == TOK_AND || Op == TOK_OR) {
+      llvm::Function *Func = mIRBuilder.GetInsertBlock()->getParent();
+      auto *RHSBB = llvm::BasicBlock::Create(
+        mIRCtx, Op == TOK_AND ? "land.rhs" : "lor.rhs", Func);
+
+      /// Right operand is evaluated only if left one does not decide result.
+      if (Op == TOK_AND)
+        EmitBranchOnCondition(Binary->LHS(), RHSBB, FalseBB);
+      else
+        EmitBranchOnCondition(Binary->LHS(), TrueBB, RHSBB);
+
+      mSSA.Seal(RHSBB);
+      mIRBuilder.SetInsertPoint(RHSBB);
+      EmitBranchOnCondition(Binary->RHS(), TrueBB, FalseBB);
+      return;
+    }
+  }
+
+  /// Comparisons already give i1, so branch on them directly.
+  llvm::Value *V = EmitBoolCast(EmitValue(Cond));
+  mIRBuilder.CreateCondBr(V, TrueBB, FalseBB);
+}
+
+llvm::Value *CodeGen::EmitLogicalValue(ASTBinary *Stmt) {
+  bool IsAnd = Stmt->Operation() == TOK_AND;
+  llvm::Function *Func = mIRBuilder.GetInsertBlock()->getParent();
+
+  llvm::Value *L = EmitValue(Stmt->LHS());
+  llvm::Type *ResultTy = L->getType();
+
+  auto *RHSBB = llvm::BasicBlock::Create(mIRCtx, IsAnd ? "land.rhs" : "lor.rhs", Func);
+  auto *EndBB = llvm::BasicBlock::Create(mIRCtx, IsAnd ? "land.end" : "lor.end", Func);
+
+  llvm::BasicBlock *LHSBB = mIRBuilder.GetInsertBlock();
+  llvm::Value *LBool = EmitBoolCast(L);
+  if (IsAnd)
+    mIRBuilder.CreateCondBr(LBool, RHSBB, EndBB);
   else
-    mLastInstr = mIRBuilder.CreateLoad(SymbolTy, Symbol);
+    mIRBuilder.CreateCondBr(LBool, EndBB, RHSBB);
+
+  mSSA.Seal(RHSBB);
+  mIRBuilder.SetInsertPoint(RHSBB);
+  llvm::Value *R = EmitBoolCast(EmitValue(Stmt->RHS()));
+  llvm::BasicBlock *RHSEndBB = mIRBuilder.GetInsertBlock();
+  mIRBuilder.CreateBr(EndBB);
+
+  mSSA.Seal(EndBB);
+  mIRBuilder.SetInsertPoint(EndBB);
+  llvm::PHINode *Phi = mIRBuilder.CreatePHI(mIRBuilder.getInt1Ty(), 2);
+  Phi->addIncoming(mIRBuilder.getInt1(!IsAnd), LHSBB);
+  Phi->addIncoming(R, RHSEndBB);
+
+  /// Result has the same type as operands.
+  if (ResultTy->isIntegerTy())
+    return mIRBuilder.CreateZExtOrTrunc(Phi, ResultTy);
+  if (ResultTy->isFloatingPointTy())
+    return mIRBuilder.CreateUIToFP(Phi, ResultTy);
+  return Phi;
+}
+
+void CodeGen::EmitLocation(ASTNode *AST) {
+  if (mDebugInfo)
+    mIRBuilder.SetCurrentDebugLocation(mDebugInfo->Location(AST));
+}
+
+void CodeGen::EmitBranch(llvm::BasicBlock *Target) {
+  if (!mIRBuilder.GetInsertBlock()->getTerminator())
+    mIRBuilder.CreateBr(Target);
 }
 
 void CodeGen::Visit(ASTCompound *Stmts) {
-  mStorage.StartScope();
-  for (ASTNode *Stmt : Stmts->Stmts())
+  StartScope();
+  for (ASTNode *Stmt : Stmts->Stmts()) {
+    EmitLocation(Stmt);
     Stmt->Accept(this);
-  mStorage.EndScope();
+    /// Statements after return, break or continue are unreachable.
+    llvm::BasicBlock *BB = mIRBuilder.GetInsertBlock();
+    if (BB && BB->getTerminator())
+      break;
+  }
+  EndScope();
 }
 
 void CodeGen::Visit(ASTReturn *Stmt) {
-  Stmt->Operand()->Accept(this);
-  mIRBuilder.CreateRet(mLastInstr);
+  llvm::Value *Value = EmitValue(Stmt->Operand());
+  /// Comparisons give i1, that is widened to integer return type.
+  llvm::Type *RetTy = mIRBuilder.GetInsertBlock()->getParent()->getReturnType();
+  if (RetTy->isIntegerTy() && Value->getType()->isIntegerTy())
+    Value = mIRBuilder.CreateZExtOrTrunc(Value, RetTy);
+  /// Returned value is already loaded, so all slots of function end here.
+  EmitLifetimeEnds(0U);
+  mIRBuilder.CreateRet(Value);
 }
 
-void CodeGen::Visit(ASTMemberAccess *Stmt) {
-  const auto &Name = Stmt->Name()->Name();
-  auto *Type = llvm::StructType::getTypeByName(mIRCtx, mStructVarsStorage[Name]);
+llvm::Value *CodeGen::EmitMemberPtr(ASTMemberAccess *Stmt) {
+  /// Either stack slot or structure parameter.
+  llvm::Value *Ptr = mStorage.Lookup(Stmt->Name()->Name());
+  auto *Type = llvm::cast<llvm::StructType>(Ptr->getType()->getPointerElementType());
+
+  while (true) {
+    unsigned Index = Stmt->MemberIndex();
+    Ptr = mIRBuilder.CreateStructGEP(Type, Ptr, Index);
 
-  llvm::AllocaInst *Struct = mStorage.Lookup(Name);
-  assert(Struct);
-  /// \todo: Get AST for declaration and convert `.field` to index
-  mLastInstr = mIRBuilder.CreateStructGEP(Type, Struct, 1);
-  mLastInstr = mIRBuilder.CreateLoad(Type->getTypeAtIndex(1U), mLastInstr);
-  /// \todo: Get type, with respect to nested member accesses.
+    if (!Stmt->MemberDecl()->Is(AST_MEMBER_ACCESS))
+      return Ptr;
+
+    Stmt = static_cast<ASTMemberAccess *>(Stmt->MemberDecl());
+    Type = llvm::cast<llvm::StructType>(Type->getElementType(Index));
+  }
+}
+
+void CodeGen::Visit(ASTMemberAccess *Stmt) {
+  llvm::Value *Ptr = EmitMemberPtr(Stmt);
+  mLastInstr = mIRBuilder.CreateLoad(Ptr->getType()->getPointerElementType(), Ptr);
 }
 
 void CodeGen::Visit(ASTArrayDecl *Stmt) {
   TypeResolver TR(mIRBuilder);
   llvm::Type *ArrayTy = TR.Resolve(Stmt);
-  llvm::AllocaInst *ArrayDecl = mIRBuilder.CreateAlloca(ArrayTy);
+  llvm::AllocaInst *ArrayDecl = EmitStackSlot(ArrayTy);
   mStorage.Push(Stmt->Name(), ArrayDecl);
+  mArraysStorage.back()[Stmt->Name()] = Stmt;
+  if (mDebugInfo)
+    mDebugInfo->DeclareVariable(Stmt, ArrayDecl, mIRBuilder.GetInsertBlock());
+}
+
+void CodeGen::EmitBoundsCheck(llvm::Value *Index, unsigned DimensionSize) {
+  llvm::Function *Func = mIRBuilder.GetInsertBlock()->getParent();
+
+  if (!mBoundsTrapBB) {
+    mBoundsTrapBB = llvm::BasicBlock::Create(mIRCtx, "bounds.trap", Func);
+    llvm::IRBuilder<> TrapBuilder(mBoundsTrapBB);
+    TrapBuilder.SetCurrentDebugLocation(mIRBuilder.getCurrentDebugLocation());
+    TrapBuilder.CreateIntrinsic(llvm::Intrinsic::trap, {}, {});
+    TrapBuilder.CreateUnreachable();
+  }
+
+  auto *OkBB = llvm::BasicBlock::Create(mIRCtx, "bounds.ok", Func);
+  auto *InBounds = mIRBuilder.CreateICmpULT(
+    Index,
+    llvm::ConstantInt::get(Index->getType(), DimensionSize)
+  );
+  /// Out of range is exceptional situation.
+  mIRBuilder.CreateCondBr(
+    InBounds,
+    OkBB,
+    mBoundsTrapBB,
+    llvm::MDBuilder(mIRCtx).createBranchWeights(1U << 20U, 1U)
+  );
+  mSSA.Seal(OkBB);
+  mIRBuilder.SetInsertPoint(OkBB);
 }
 
 void CodeGen::Visit(ASTVarDecl *Decl) {
   auto *Body = Decl->Body();
 
   if (!Body && Decl->DataType() == DT_STRUCT) {
-    mStructVarsStorage.emplace(Decl->Name(), Decl->TypeName());
-    auto *VarDecl = mIRBuilder.CreateAlloca(
+    auto *VarDecl = EmitStackSlot(
         llvm::StructType::getTypeByName(
           mIRCtx,
           Decl->TypeName()
         )
       );
     mStorage.Push(Decl->Name(), VarDecl);
+    if (mDebugInfo)
+      mDebugInfo->DeclareVariable(Decl, VarDecl, mIRBuilder.GetInsertBlock());
     return;
   }
 
-  Body->Accept(this);
+  EmitValue(Body);
 
   /// Special case, since we need to copy array from data section to another
-  /// array, placed on stack.
-  if (Decl->DataType() == DT_STRING) {
+  /// array, placed on stack. This is done only if contents of string are
+  /// modified, otherwise variable points to constant literal.
+  if (Decl->DataType() == DT_STRING && mMutatedStrings.count(Decl)) {
     llvm::Value *LiteralValue = mLastInstr;
     auto *Literal = static_cast<ASTString *>(Body);
     unsigned NullTerminator = 1;
@@ -515,7 +1067,7 @@ void CodeGen::Visit(ASTVarDecl *Decl) {
       mIRBuilder.getInt8Ty(),
       Literal->Value().size() + NullTerminator
     );
-    llvm::AllocaInst *Mem = mIRBuilder.CreateAlloca(ArrayType);
+    llvm::AllocaInst *Mem = EmitStackSlot(ArrayType);
     llvm::Value *CastedPtr = mIRBuilder.CreateBitCast(Mem, mIRBuilder.getInt8PtrTy());
     mIRBuilder.CreateMemCpy(
       /*Dst=*/CastedPtr,
@@ -526,28 +1078,44 @@ void CodeGen::Visit(ASTVarDecl *Decl) {
       /*isVolatile=*/false
     );
     mStorage.Push(Decl->Name(), Mem);
+    if (mDebugInfo)
+      mDebugInfo->DeclareVariable(Decl, Mem, mIRBuilder.GetInsertBlock());
     return;
   }
 
+  /// Scalars are never addressed, so memory is not needed for them.
   TypeResolver TR(mIRBuilder);
-  auto *VarDecl = mIRBuilder.CreateAlloca(TR.ResolveExceptVoid(Decl->DataType()));
-
-  mIRBuilder.CreateStore(mLastInstr, VarDecl);
-  mStorage.Push(Decl->Name(), VarDecl);
+  mSSA.Declare(Decl->Name(), TR.ResolveExceptVoid(Decl->DataType()));
+  mSSA.Write(Decl->Name(), mIRBuilder.GetInsertBlock(), mLastInstr);
+  if (mDebugInfo)
+    mDebugInfo->DeclareVariable(Decl, mLastInstr, mIRBuilder.GetInsertBlock());
 }
 
-void CodeGen::Visit(ASTStructDecl *Decl) {
+llvm::StructType *CodeGen::EmitStructType(ASTStructDecl *Decl, const std::string &Name) {
   auto *Struct = llvm::StructType::create(mIRCtx);
-  Struct->setName(Decl->Name());
+  Struct->setName(Name);
   llvm::SmallVector<llvm::Type *, 8> Members;
 
   TypeResolver TR(mIRBuilder);
 
-  for (auto *D : Decl->Decls())
+  for (auto *D : Decl->Decls()) {
+    if (D->Is(AST_STRUCT_DECL)) {
+      auto *Nested = static_cast<ASTStructDecl *>(D);
+      /// Qualify name, so it does not clash with global structure.
+      Members.push_back(EmitStructType(Nested, Name + "." + Nested->Name()));
+      continue;
+    }
     Members.push_back(TR.Resolve(D));
+  }
 
   Struct->setBody(std::move(Members));
+  return Struct;
+}
 
+void CodeGen::Visit(ASTStructDecl *Decl) {
+  llvm::StructType *Type = EmitStructType(Decl, Decl->Name());
+  if (mDebugInfo)
+    mDebugInfo->AddStruct(Decl, Type);
   mLastInstr = nullptr;
 }
 
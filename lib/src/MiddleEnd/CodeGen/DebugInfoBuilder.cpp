@@ -0,0 +1,254 @@
+/* DebugInfoBuilder.cpp - Helper class to emit DWARF metadata for LLVM IR.
+ * Copyright (C) 2022 epoll-reactor <glibcxx.chrono@gmail.com>
+ *
+ * This file is distributed under the MIT license.
+ */
+
+#include "MiddleEnd/CodeGen/DebugInfoBuilder.h"
+#include "FrontEnd/AST/AST.h"
+#include "Utility/Unreachable.h"
+#include "llvm/BinaryFormat/Dwarf.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/Module.h"
+#include <filesystem>
+
+namespace weak {
+
+static const std::string &DeclName(ASTNode *AST) {
+  if (AST->Is(AST_VAR_DECL))
+    return static_cast<ASTVarDecl *>(AST)->Name();
+
+  if (AST->Is(AST_ARRAY_DECL))
+    return static_cast<ASTArrayDecl *>(AST)->Name();
+
+  Unreachable("Expected variable or array declaration.");
+}
+
+DebugInfoBuilder::DebugInfoBuilder(llvm::Module &M, std::string_view SourcePath)
+  : mIRModule(M)
+  , mDIBuilder(M)
+  , mScope(nullptr) {
+  std::filesystem::path Path(SourcePath);
+  std::error_code _;
+  auto Absolute = std::filesystem::absolute(Path, _);
+
+  mFile = mDIBuilder.createFile(
+    Absolute.filename().string(),
+    Absolute.parent_path().string()
+  );
+  mCompileUnit = mDIBuilder.createCompileUnit(
+    llvm::dwarf::DW_LANG_C,
+    mFile,
+    /*Producer=*/"weak compiler",
+    /*isOptimized=*/false,
+    /*Flags=*/"",
+    /*RV=*/0
+  );
+
+  mIRModule.addModuleFlag(llvm::Module::Warning, "Dwarf Version", 4);
+  mIRModule.addModuleFlag(
+    llvm::Module::Warning,
+    "Debug Info Version",
+    llvm::DEBUG_METADATA_VERSION
+  );
+}
+
+void DebugInfoBuilder::StartFunction(llvm::Function *F, ASTFunctionDecl *Decl) {
+  llvm::SmallVector<llvm::Metadata *, 8> Types;
+  /// Void return type is encoded as null.
+  Types.push_back(Decl->ReturnType() == DT_VOID ? nullptr : ResolveType(Decl->ReturnType()));
+
+  for (ASTNode *Arg : Decl->Args())
+    Types.push_back(ResolveParamType(Arg));
+
+  mScope = mDIBuilder.createFunction(
+    mFile,
+    Decl->Name(),
+    /*LinkageName=*/llvm::StringRef(),
+    mFile,
+    Decl->LineNo(),
+    mDIBuilder.createSubroutineType(mDIBuilder.getOrCreateTypeArray(Types)),
+    /*ScopeLine=*/Decl->LineNo(),
+    llvm::DINode::FlagPrototyped,
+    F->hasLocalLinkage()
+      ? llvm::DISubprogram::SPFlagDefinition | llvm::DISubprogram::SPFlagLocalToUnit
+      : llvm::DISubprogram::SPFlagDefinition
+  );
+  F->setSubprogram(mScope);
+  mVariables.clear();
+}
+
+void DebugInfoBuilder::AddStruct(ASTStructDecl *Decl, llvm::StructType *Type) {
+  mStructs[Decl->Name()] = ResolveStruct(Decl, Type, Decl->Name());
+}
+
+llvm::DebugLoc DebugInfoBuilder::Location(ASTNode *AST) const {
+  return llvm::DILocation::get(
+    mIRModule.getContext(),
+    AST->LineNo(),
+    AST->ColumnNo(),
+    mScope
+  );
+}
+
+void DebugInfoBuilder::DeclareVariable(
+  ASTNode           *Decl,
+  llvm::Value       *Storage,
+  llvm::BasicBlock  *BB,
+  unsigned           ArgNo
+) {
+  const std::string &Name = DeclName(Decl);
+  auto *Slot = llvm::dyn_cast<llvm::AllocaInst>(Storage);
+  auto *Arg = llvm::dyn_cast<llvm::Argument>(Storage);
+  bool InMemory = Slot || (Arg && Arg->hasByValAttr());
+  llvm::DIType *Type = InMemory ? ResolveType(Decl) : ResolveParamType(Decl);
+
+  if (Slot && Decl->Is(AST_VAR_DECL) &&
+      static_cast<ASTVarDecl *>(Decl)->DataType() == DT_STRING) {
+    /// Modified string is a copy of literal on stack.
+    uint64_t Size = Slot->getAllocatedType()->getArrayNumElements();
+    Type = mDIBuilder.createArrayType(
+      Size * 8,
+      8,
+      ResolveType(DT_CHAR),
+      mDIBuilder.getOrCreateArray({mDIBuilder.getOrCreateSubrange(0, Size)})
+    );
+  }
+
+  llvm::DILocalVariable *Var = ArgNo
+    ? mDIBuilder.createParameterVariable(mScope, Name, ArgNo, mFile, Decl->LineNo(), Type)
+    : mDIBuilder.createAutoVariable(mScope, Name, mFile, Decl->LineNo(), Type);
+
+  if (InMemory) {
+    mDIBuilder.insertDeclare(
+      Storage, Var, mDIBuilder.createExpression(), Location(Decl), BB);
+    return;
+  }
+
+  mVariables[Name] = Var;
+  mDIBuilder.insertDbgValueIntrinsic(
+    Storage, Var, mDIBuilder.createExpression(), Location(Decl), BB);
+}
+
+void DebugInfoBuilder::UpdateVariable(const std::string &Name, llvm::Value *V, llvm::BasicBlock *BB) {
+  auto It = mVariables.find(Name);
+  if (It == mVariables.end())
+    return;
+
+  mDIBuilder.insertDbgValueIntrinsic(
+    V,
+    It->second,
+    mDIBuilder.createExpression(),
+    llvm::DILocation::get(mIRModule.getContext(), It->second->getLine(), 0, mScope),
+    BB
+  );
+}
+
+void DebugInfoBuilder::Finalize() {
+  mDIBuilder.finalize();
+}
+
+llvm::DIType *DebugInfoBuilder::ResolveType(DataType T) {
+  switch (T) {
+  case DT_CHAR:   return mDIBuilder.createBasicType("char", 8, llvm::dwarf::DW_ATE_signed_char);
+  case DT_INT:    return mDIBuilder.createBasicType("int", 32, llvm::dwarf::DW_ATE_signed);
+  case DT_BOOL:   return mDIBuilder.createBasicType("bool", 8, llvm::dwarf::DW_ATE_boolean);
+  case DT_FLOAT:  return mDIBuilder.createBasicType("float", 32, llvm::dwarf::DW_ATE_float);
+  case DT_STRING: return mDIBuilder.createPointerType(ResolveType(DT_CHAR), 64, 0, llvm::None, "string");
+  default:        Unreachable("Expected data type except void.");
+  }
+}
+
+llvm::DIType *DebugInfoBuilder::ResolveType(ASTNode *Decl) {
+  if (Decl->Is(AST_VAR_DECL)) {
+    auto *Var = static_cast<ASTVarDecl *>(Decl);
+    if (Var->DataType() == DT_STRUCT)
+      return mStructs.at(Var->TypeName());
+    return ResolveType(Var->DataType());
+  }
+
+  auto *Array = static_cast<ASTArrayDecl *>(Decl);
+  llvm::DIType *ElementType = ResolveType(Array->DataType());
+  uint64_t Size = ElementType->getSizeInBits();
+  llvm::SmallVector<llvm::Metadata *, 4> Subscripts;
+  for (unsigned Arity : Array->ArityList()) {
+    Subscripts.push_back(mDIBuilder.getOrCreateSubrange(0, Arity));
+    Size *= Arity;
+  }
+
+  return mDIBuilder.createArrayType(
+    Size,
+    ElementType->getSizeInBits(),
+    ElementType,
+    mDIBuilder.getOrCreateArray(Subscripts)
+  );
+}
+
+llvm::DIType *DebugInfoBuilder::ResolveParamType(ASTNode *Decl) {
+  /// Arrays and structures with mode are passed by pointer.
+  if (Decl->Is(AST_ARRAY_DECL))
+    return mDIBuilder.createPointerType(
+      ResolveType(static_cast<ASTArrayDecl *>(Decl)->DataType()), 64);
+
+  auto *Var = static_cast<ASTVarDecl *>(Decl);
+  if (Var->DataType() == DT_STRUCT && Var->Mode() != PARAM_DEFAULT)
+    return mDIBuilder.createPointerType(ResolveType(Decl), 64);
+
+  return ResolveType(Decl);
+}
+
+llvm::DICompositeType *DebugInfoBuilder::ResolveStruct(
+  ASTStructDecl     *Decl,
+  llvm::StructType  *Type,
+  const std::string &Name
+) {
+  const llvm::DataLayout &DL = mIRModule.getDataLayout();
+  const llvm::StructLayout *Layout = DL.getStructLayout(Type);
+  llvm::SmallVector<llvm::Metadata *, 8> Members;
+
+  for (unsigned I = 0; I < Decl->Decls().size(); ++I) {
+    ASTNode *D = Decl->Decls()[I];
+    llvm::DIType *MemberType = nullptr;
+    const std::string *MemberName = nullptr;
+
+    if (D->Is(AST_STRUCT_DECL)) {
+      auto *Nested = static_cast<ASTStructDecl *>(D);
+      MemberType = ResolveStruct(
+        Nested,
+        llvm::cast<llvm::StructType>(Type->getElementType(I)),
+        Name + "." + Nested->Name()
+      );
+      MemberName = &Nested->Name();
+    } else {
+      MemberType = ResolveType(D);
+      MemberName = &DeclName(D);
+    }
+
+    llvm::Type *MemberIRType = Type->getElementType(I);
+    Members.push_back(mDIBuilder.createMemberType(
+      mFile,
+      *MemberName,
+      mFile,
+      D->LineNo(),
+      MemberType->getSizeInBits(),
+      DL.getABITypeAlign(MemberIRType).value() * 8,
+      Layout->getElementOffsetInBits(I),
+      llvm::DINode::FlagZero,
+      MemberType
+    ));
+  }
+
+  return mDIBuilder.createStructType(
+    mFile,
+    Name,
+    mFile,
+    Decl->LineNo(),
+    Layout->getSizeInBits(),
+    Layout->getAlignment().value() * 8,
+    llvm::DINode::FlagZero,
+    /*DerivedFrom=*/nullptr,
+    mDIBuilder.getOrCreateArray(Members)
+  );
+}
+
+} // namespace weak
\ No newline at end of file
@@ -0,0 +1,135 @@
+/* SSABuilder.cpp - On-the-fly construction of SSA form.
+ * Copyright (C) 2022 epoll-reactor <glibcxx.chrono@gmail.com>
+ *
+ * This file is distributed under the MIT license.
+ */
+
+#include "MiddleEnd/CodeGen/SSABuilder.h"
+#include "llvm/IR/CFG.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/Instructions.h"
+#include <cassert>
+
+namespace weak {
+
+void SSABuilder::Reset() {
+  mCurrentDef.clear();
+  mTypes.clear();
+  mIncompletePhis.clear();
+  mSealedBlocks.clear();
+}
+
+void SSABuilder::Declare(std::string_view Name, llvm::Type *Ty) {
+  std::string Key(Name);
+  mTypes[Key] = Ty;
+  /// Variable with the same name from sibling scope is not visible anymore.
+  mCurrentDef[Key].clear();
+}
+
+bool SSABuilder::IsDeclared(std::string_view Name) const {
+  return mTypes.count(std::string(Name));
+}
+
+void SSABuilder::Write(std::string_view Name, llvm::BasicBlock *BB, llvm::Value *V) {
+  mCurrentDef[std::string(Name)][BB] = V;
+}
+
+llvm::Value *SSABuilder::Read(std::string_view Name, llvm::BasicBlock *BB) {
+  std::string Key(Name);
+  assert(mTypes.count(Key) && "Variable expected to be declared before");
+
+  auto &Defs = mCurrentDef[Key];
+  if (auto It = Defs.find(BB); It != Defs.end() && It->second)
+    return It->second;
+
+  return ReadRecursive(Key, BB);
+}
+
+void SSABuilder::Seal(llvm::BasicBlock *BB) {
+  /// Operands can create new incomplete φ-nodes in other blocks,
+  /// but not in this one, since it is already sealed.
+  mSealedBlocks.insert(BB);
+
+  auto Incomplete = std::move(mIncompletePhis[BB]);
+  mIncompletePhis.erase(BB);
+
+  for (auto &[Name, Phi] : Incomplete)
+    AddPhiOperands(Name, Phi);
+}
+
+llvm::Value *SSABuilder::ReadRecursive(const std::string &Name, llvm::BasicBlock *BB) {
+  llvm::Value *V = nullptr;
+
+  if (!mSealedBlocks.count(BB)) {
+    /// Not all predecessors are known.
+    llvm::PHINode *Phi = CreatePhi(Name, BB);
+    mIncompletePhis[BB].emplace_back(Name, Phi);
+    V = Phi;
+  } else if (auto *Pred = BB->getSinglePredecessor()) {
+    /// No φ-node needed.
+    V = Read(Name, Pred);
+  } else if (llvm::pred_empty(BB)) {
+    /// Unreachable block.
+    V = llvm::UndefValue::get(mTypes[Name]);
+  } else {
+    /// Break potential cycles with operandless φ-node.
+    llvm::PHINode *Phi = CreatePhi(Name, BB);
+    Write(Name, BB, Phi);
+    V = AddPhiOperands(Name, Phi);
+  }
+
+  Write(Name, BB, V);
+  return V;
+}
+
+llvm::Value *SSABuilder::AddPhiOperands(const std::string &Name, llvm::PHINode *Phi) {
+  for (llvm::BasicBlock *Pred : llvm::predecessors(Phi->getParent()))
+    Phi->addIncoming(Read(Name, Pred), Pred);
+
+  return TryRemoveTrivialPhi(Phi);
+}
+
+llvm::Value *SSABuilder::TryRemoveTrivialPhi(llvm::PHINode *Phi) {
+  llvm::Value *Same = nullptr;
+
+  for (llvm::Value *Op : Phi->incoming_values()) {
+    if (Op == Same || Op == Phi)
+      continue;
+    if (Same)
+      /// φ-node merges at least two values, so it is not trivial.
+      return Phi;
+    Same = Op;
+  }
+
+  if (!Same)
+    /// φ-node is unreachable or in start block.
+    Same = llvm::UndefValue::get(Phi->getType());
+
+  std::vector<llvm::WeakTrackingVH> PhiUsers;
+  for (llvm::User *U : Phi->users())
+    if (U != Phi && llvm::isa<llvm::PHINode>(U))
+      PhiUsers.emplace_back(U);
+
+  Phi->replaceAllUsesWith(Same);
+  Phi->eraseFromParent();
+
+  /// Users could become trivial after replacement. Same value itself
+  /// can be removed as such user, so track it.
+  llvm::WeakTrackingVH Result(Same);
+  for (auto &U : PhiUsers)
+    if (auto *UserPhi = llvm::dyn_cast_or_null<llvm::PHINode>(U))
+      TryRemoveTrivialPhi(UserPhi);
+
+  return Result;
+}
+
+llvm::PHINode *SSABuilder::CreatePhi(const std::string &Name, llvm::BasicBlock *BB) {
+  llvm::Type *Ty = mTypes[Name];
+
+  if (llvm::Instruction *First = BB->getFirstNonPHI())
+    return llvm::PHINode::Create(Ty, 0, Name, First);
+
+  return llvm::PHINode::Create(Ty, 0, Name, BB);
+}
+
+} // namespace weak
\ No newline at end of file
@@ -38,8 +38,6 @@ llvm::Value *ScalarExprEmitter::EmitIntegralBinOp(TokenType T, llvm::Value *L, l
   case TOK_GT:      return mIRBuilder.CreateICmpSGT(L, R);
   case TOK_EQ:      return mIRBuilder.CreateICmpEQ(L, R);
   case TOK_NEQ:     return mIRBuilder.CreateICmpNE(L, R);
-  case TOK_OR:      return mIRBuilder.CreateLogicalOr(L, R);
-  case TOK_AND:     return mIRBuilder.CreateLogicalAnd(L, R);
   case TOK_BIT_OR:  return mIRBuilder.CreateOr(L, R);
   case TOK_BIT_AND: return mIRBuilder.CreateAnd(L, R);
   case TOK_XOR:     return mIRBuilder.CreateXor(L, R);
@@ -61,8 +59,6 @@ llvm::Value *ScalarExprEmitter::EmitFloatBinOp(TokenType T, llvm::Value *L, llvm
   case TOK_GT:    return mIRBuilder.CreateFCmpOGT(L, R);
   case TOK_EQ:    return mIRBuilder.CreateFCmpOEQ(L, R);
   case TOK_NEQ:   return mIRBuilder.CreateFCmpONE(L, R);
-  case TOK_OR:    return mIRBuilder.CreateLogicalOr(L, R);
-  case TOK_AND:   return mIRBuilder.CreateLogicalAnd(L, R);
   default:        Unreachable("Unknown binary operator.");
   }
 }
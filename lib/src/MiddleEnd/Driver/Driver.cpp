@@ -5,40 +5,83 @@
  */
 
 #include "MiddleEnd/Driver/Driver.h"
+#include "BackEnd/ELF/Linker.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/Analysis/ModuleSummaryAnalysis.h"
+#include "llvm/Analysis/ProfileSummaryInfo.h"
+#include "llvm/Bitcode/BitcodeReader.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/CodeGen/ParallelCG.h"
+#include "llvm/ExecutionEngine/Orc/ExecutionUtils.h"
+#include "llvm/ExecutionEngine/Orc/LLJIT.h"
+#include "llvm/IR/DiagnosticPrinter.h"
 #include "llvm/IR/LegacyPassManager.h"
+#include "llvm/IR/Module.h"
+#include "llvm/LTO/LTO.h"
+#include "llvm/MC/MCSubtargetInfo.h"
+#include "llvm/MC/SubtargetFeature.h"
 #include "llvm/MC/TargetRegistry.h"
-#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Host.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/SmallVectorMemoryBuffer.h"
 #include "llvm/Support/TargetSelect.h"
 #include "llvm/Target/TargetMachine.h"
+#include <algorithm>
+#include <csetjmp>
+#include <csignal>
+#include <map>
+#include <set>
+#include <tuple>
 
 namespace {
 
 struct DriverImpl {
-  DriverImpl(llvm::Module &M)
-    : mIRModule(M) {
-    llvm::InitializeAllTargetInfos();
-    llvm::InitializeAllTargets();
-    llvm::InitializeAllTargetMCs();
-    llvm::InitializeAllAsmParsers();
-    llvm::InitializeAllAsmPrinters();
-  }
+  DriverImpl(
+    llvm::Module              &M,
+    llvm::TargetMachine       &TM,
+    const weak::DriverOptions &Options
+  ) : mIRModule(M)
+    , mTM(TM)
+    , mOptions(Options) {}
 
   void Build(std::string OutFile) {
-    auto *TM = CreateTM(llvm::sys::getDefaultTargetTriple());
-    mIRModule.setDataLayout(TM->createDataLayout());
+    weak::elf::Linker Linker;
+    for (const auto &Object : mOptions.ExtraObjects) {
+      auto Buffer = llvm::MemoryBuffer::getFile(Object);
+      if (!Buffer) {
+        llvm::errs() << "Could not open file: " << Buffer.getError().message();
+        exit(-1);
+      }
+      Linker.AddObject(std::move(*Buffer));
+    }
 
-    OutFile += ".o";
-    std::error_code Errc;
-    llvm::raw_fd_ostream OutStream(OutFile, Errc, llvm::sys::fs::OF_None);
+    for (auto &Object : EmitObjects())
+      Linker.AddObject(std::move(Object));
 
-    if (Errc) {
-      llvm::errs() << "Could not open file: " << Errc.message();
-      exit(-1);
-    }
+    Linker.Link(OutFile);
+  }
+
+  /// Emit object code to memory, it is passed to linker as is.
+  std::vector<std::unique_ptr<llvm::MemoryBuffer>> EmitObjects() {
+    unsigned Definitions = llvm::count_if(mIRModule, [](const llvm::Function &F) {
+      return !F.isDeclaration();
+    });
+    if (Definitions == 0U)
+      return {};
+
+    AddFramePointerAttributes();
+
+    unsigned Partitions = std::min(mOptions.CodeGenThreads, Definitions);
+    if (Partitions > 1U)
+      return EmitPartitions(Partitions);
+
+    std::vector<std::unique_ptr<llvm::MemoryBuffer>> Objects;
+
+    llvm::SmallVector<char, 0> Object;
+    llvm::raw_svector_ostream OutStream(Object);
 
     llvm::legacy::PassManager Pass;
-    TM->addPassesToEmitFile(
+    mTM.addPassesToEmitFile(
       Pass,
       OutStream,
       /*raw_pwrite_stream=*/nullptr,
@@ -46,45 +89,384 @@ struct DriverImpl {
     );
 
     Pass.run(mIRModule);
+    Objects.push_back(std::make_unique<llvm::SmallVectorMemoryBuffer>(
+      std::move(Object), mIRModule.getModuleIdentifier()));
+    return Objects;
+  }
+
+  /// \param Name is unique among all modules, optimized together.
+  std::unique_ptr<llvm::MemoryBuffer> EmitBitcode(std::string_view Name) {
+    AddFramePointerAttributes();
+
+    llvm::SmallVector<char, 0> Bitcode;
+    llvm::raw_svector_ostream OutStream(Bitcode);
+    if (mOptions.LTO == weak::LTOKind::Thin) {
+      llvm::ProfileSummaryInfo PSI(mIRModule);
+      llvm::ModuleSummaryIndex Index = llvm::buildModuleSummaryIndex(
+        mIRModule, /*GetBFICallback=*/nullptr, &PSI);
+      llvm::WriteBitcodeToFile(mIRModule, OutStream, /*ShouldPreserveUseListOrder=*/false, &Index);
+    } else
+      llvm::WriteBitcodeToFile(mIRModule, OutStream);
 
-    RunClangFrontEnd(OutFile);
+    return std::make_unique<llvm::SmallVectorMemoryBuffer>(
+      std::move(Bitcode), Name);
   }
 
 private:
-  void RunClangFrontEnd(std::string_view OutFile) {
-    std::string CompileCmd;
-    CompileCmd += "clang++ ";
-    CompileCmd += OutFile;
-    CompileCmd += " -o ";
-    CompileCmd += OutFile.substr(0, OutFile.size() - 2);
-    system(CompileCmd.c_str());
+  /// Split module to partitions, that are compiled on their own threads
+  /// with own contexts and target machines.
+  std::vector<std::unique_ptr<llvm::MemoryBuffer>> EmitPartitions(unsigned Count) {
+    /// Local functions may be called from other partition, so they are
+    /// turned to hidden ones, still local to translation unit. Local data
+    /// keeps functions, using it, in one partition.
+    for (llvm::Function &F : mIRModule)
+      if (F.hasLocalLinkage()) {
+        F.setLinkage(llvm::GlobalValue::ExternalLinkage);
+        F.setVisibility(llvm::GlobalValue::HiddenVisibility);
+      }
+
+    std::vector<llvm::SmallVector<char, 0>> Objects(Count);
+    std::vector<std::unique_ptr<llvm::raw_svector_ostream>> Streams;
+    std::vector<llvm::raw_pwrite_stream *> OutStreams;
+    for (auto &Object : Objects) {
+      Streams.push_back(std::make_unique<llvm::raw_svector_ostream>(Object));
+      OutStreams.push_back(Streams.back().get());
+    }
+
+    llvm::splitCodeGen(
+      mIRModule,
+      OutStreams,
+      /*BCOSs=*/{},
+      [&] {
+        return std::unique_ptr<llvm::TargetMachine>(mTM.getTarget().createTargetMachine(
+          mTM.getTargetTriple().str(),
+          mTM.getTargetCPU(),
+          mTM.getTargetFeatureString(),
+          mTM.Options,
+          llvm::Reloc::Model::Static,
+          /*CodeModel=*/llvm::None,
+          mTM.getOptLevel()
+        ));
+      },
+      llvm::CGFT_ObjectFile,
+      /*PreserveLocals=*/true
+    );
+
+    std::vector<std::unique_ptr<llvm::MemoryBuffer>> Result;
+    for (unsigned I = 0; I < Count; ++I)
+      Result.push_back(std::make_unique<llvm::SmallVectorMemoryBuffer>(
+        std::move(Objects[I]), mIRModule.getModuleIdentifier() + "." + std::to_string(I)));
+    return Result;
   }
 
-  llvm::TargetMachine *CreateTM(const std::string &Triple) {
-    std::string _;
-    return llvm::TargetRegistry::lookupTarget(Triple, _)
-      ->createTargetMachine(
-          Triple,
-          /*CPU=*/"generic",
-          /*Features=*/"",
-          /*Opts=*/{},
-          llvm::Reloc::Model::Static
-        );
+  void AddFramePointerAttributes() {
+    if (mOptions.KeepFramePointers)
+      for (llvm::Function &F : mIRModule)
+        if (!F.isDeclaration())
+          F.addFnAttr("frame-pointer", "all");
   }
 
   llvm::Module &mIRModule;
+  llvm::TargetMachine &mTM;
+  const weak::DriverOptions &mOptions;
 };
 
+template <typename T>
+T ExitOnJITError(llvm::Expected<T> Value) {
+  if (!Value) {
+    llvm::errs() << "JIT error: " << llvm::toString(Value.takeError());
+    exit(-1);
+  }
+  return std::move(*Value);
+}
+
+void ExitOnJITError(llvm::Error Err) {
+  if (Err) {
+    llvm::errs() << "JIT error: " << llvm::toString(std::move(Err));
+    exit(-1);
+  }
+}
+
+/// Where to return from program, that trapped.
+sigjmp_buf TrapJump;
+
+void OnTrap(int Signal) {
+  siglongjmp(TrapJump, Signal);
+}
+
+/// Call main, returning value of any integer type. Main, defined only in
+/// extra object, may be absent in module and is treated as returning int.
+int CallMain(const llvm::Function *Main, llvm::JITTargetAddress Address) {
+  if (!Main)
+    return reinterpret_cast<int32_t (*)()>(Address)();
+  llvm::Type *Ret = Main->getReturnType();
+  if (Ret->isVoidTy()) {
+    reinterpret_cast<void (*)()>(Address)();
+    return 0;
+  }
+  switch (Ret->getIntegerBitWidth()) {
+  case 1:
+  case 8:  return reinterpret_cast<int8_t (*)()>(Address)();
+  case 64: return reinterpret_cast<int64_t (*)()>(Address)();
+  default: return reinterpret_cast<int32_t (*)()>(Address)();
+  }
+}
+
+llvm::CodeGenOpt::Level ToCodeGenOptLevel(WeakOptimizationLevel OptLvl) {
+  switch (OptLvl) {
+  case O0: return llvm::CodeGenOpt::None;
+  case O1: return llvm::CodeGenOpt::Less;
+  case O3: return llvm::CodeGenOpt::Aggressive;
+  /// Size levels use default code generator, like clang does.
+  default: return llvm::CodeGenOpt::Default;
+  }
+}
+
+std::string ResolveCPU(const std::string &CPU) {
+  return CPU == "native" ? llvm::sys::getHostCPUName().str() : CPU;
+}
+
+/// Join features of host processor, if it is requested, with given ones.
+/// Later features override earlier.
+std::string ResolveFeatures(const weak::DriverOptions &Options) {
+  llvm::SubtargetFeatures Features;
+  llvm::StringMap<bool> HostFeatures;
+  if (Options.CPU == "native" && llvm::sys::getHostCPUFeatures(HostFeatures))
+    for (const auto &Feature : HostFeatures)
+      Features.AddFeature(Feature.first(), Feature.second);
+  llvm::SubtargetFeatures Requested(Options.Features);
+  for (const std::string &Feature : Requested.getFeatures())
+    Features.AddFeature(Feature);
+  return Features.getString();
+}
+
+/// Only host target is initialized, code is never cross-compiled.
+const llvm::Target &HostTarget() {
+  static const llvm::Target *Target = [] {
+    llvm::InitializeNativeTarget();
+    llvm::InitializeNativeTargetAsmPrinter();
+    std::string Error;
+    const llvm::Target *T = llvm::TargetRegistry::lookupTarget(llvm::sys::getDefaultTargetTriple(), Error);
+    if (!T) {
+      llvm::errs() << "Could not find target: " << Error;
+      exit(-1);
+    }
+    return T;
+  }();
+  return *Target;
+}
+
+void CheckCPU(const std::string &CPU) {
+  std::unique_ptr<llvm::MCSubtargetInfo> STI(
+    HostTarget().createMCSubtargetInfo(llvm::sys::getDefaultTargetTriple(), "", ""));
+  if (!STI->isCPUStringValid(CPU)) {
+    llvm::errs() << "Unknown processor: " << CPU;
+    exit(-1);
+  }
+}
+
+/// Get target machine for host. Target machines are created once per
+/// thread for each set of options and shared by all drivers of thread.
+/// Target machine caches subtargets without locking, so it must not be
+/// used by several threads at once.
+llvm::TargetMachine *GetTM(
+  const std::string     &CPU,
+  const std::string     &Features,
+  WeakOptimizationLevel  OptLvl
+) {
+  thread_local std::map<std::tuple<std::string, std::string, WeakOptimizationLevel>,
+                        std::unique_ptr<llvm::TargetMachine>> Cache;
+  auto &TM = Cache[{CPU, Features, OptLvl}];
+  if (TM)
+    return TM.get();
+
+  CheckCPU(CPU);
+  TM.reset(HostTarget().createTargetMachine(
+    llvm::sys::getDefaultTargetTriple(),
+    CPU,
+    Features,
+    /*Opts=*/{},
+    llvm::Reloc::Model::Static,
+    /*CodeModel=*/llvm::None,
+    ToCodeGenOptLevel(OptLvl)
+  ));
+  return TM.get();
+}
+
 } // namespace
 
 namespace weak {
 
-Driver::Driver(llvm::Module &M, std::string_view OutPath)
+Driver::Driver(llvm::Module &M, std::string_view OutPath, DriverOptions Options)
   : mIRModule(M)
-  , mOutPath(OutPath) {}
+  , mOutPath(OutPath)
+  , mOptions(Options) {
+  std::string CPU = ResolveCPU(mOptions.CPU);
+  std::string Features = ResolveFeatures(mOptions);
+  mTargetMachine = GetTM(CPU, Features, mOptions.OptLvl);
+  mIRModule.setTargetTriple(mTargetMachine->getTargetTriple().str());
+  mIRModule.setDataLayout(mTargetMachine->createDataLayout());
+
+  /// Cost models of vectorizers look at subtarget of each function.
+  std::string TuneCPU = ResolveCPU(mOptions.TuneCPU);
+  if (!TuneCPU.empty())
+    CheckCPU(TuneCPU);
+  for (llvm::Function &F : mIRModule) {
+    if (F.isDeclaration())
+      continue;
+    F.addFnAttr("target-cpu", CPU);
+    if (!Features.empty())
+      F.addFnAttr("target-features", Features);
+    if (!TuneCPU.empty())
+      F.addFnAttr("tune-cpu", TuneCPU);
+  }
+}
+
+Driver::~Driver() = default;
+
+llvm::TargetMachine &Driver::TargetMachine() {
+  return *mTargetMachine;
+}
 
 void Driver::Compile() {
-  DriverImpl{mIRModule}.Build(mOutPath);
+  DriverImpl{mIRModule, *mTargetMachine, mOptions}.Build(mOutPath);
+}
+
+std::vector<std::unique_ptr<llvm::MemoryBuffer>> Driver::EmitObjects() {
+  return DriverImpl{mIRModule, *mTargetMachine, mOptions}.EmitObjects();
+}
+
+std::unique_ptr<llvm::MemoryBuffer> Driver::EmitBitcode() {
+  return DriverImpl{mIRModule, *mTargetMachine, mOptions}.EmitBitcode(mOutPath);
+}
+
+int Driver::Run() {
+  /// JIT takes ownership of module and its context, so module is copied
+  /// through bitcode.
+  llvm::SmallVector<char, 0> Bitcode;
+  llvm::raw_svector_ostream BitcodeStream(Bitcode);
+  llvm::WriteBitcodeToFile(mIRModule, BitcodeStream);
+  auto Ctx = std::make_unique<llvm::LLVMContext>();
+  auto M = ExitOnJITError(llvm::parseBitcodeFile(
+    llvm::MemoryBufferRef(llvm::StringRef(Bitcode.data(), Bitcode.size()), mOutPath),
+    *Ctx
+  ));
+
+  auto JTMB = ExitOnJITError(llvm::orc::JITTargetMachineBuilder::detectHost());
+  JTMB.setCodeGenOptLevel(ToCodeGenOptLevel(mOptions.OptLvl));
+  auto JIT = ExitOnJITError(
+    llvm::orc::LLJITBuilder()
+      .setJITTargetMachineBuilder(std::move(JTMB))
+      .create()
+  );
+  /// Host process has its own main, that must not be found instead of
+  /// missing one.
+  JIT->getMainJITDylib().addGenerator(ExitOnJITError(
+    llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(
+      JIT->getDataLayout().getGlobalPrefix(),
+      [&](const llvm::orc::SymbolStringPtr &Name) {
+        return Name != JIT->mangleAndIntern("main");
+      })
+  ));
+
+  for (const auto &Object : mOptions.ExtraObjects)
+    ExitOnJITError(JIT->addObjectFile(ExitOnJITError(
+      llvm::errorOrToExpected(llvm::MemoryBuffer::getFile(Object))
+    )));
+
+  M->setDataLayout(JIT->getDataLayout());
+  ExitOnJITError(JIT->addIRModule(llvm::orc::ThreadSafeModule(std::move(M), std::move(Ctx))));
+  auto Address = ExitOnJITError(JIT->lookup("main")).getAddress();
+  const llvm::Function *Main = mIRModule.getFunction("main");
+
+  struct sigaction Action {};
+  struct sigaction OldIll {};
+  struct sigaction OldFpe {};
+  Action.sa_handler = OnTrap;
+  sigemptyset(&Action.sa_mask);
+  sigaction(SIGILL, &Action, &OldIll);
+  sigaction(SIGFPE, &Action, &OldFpe);
+
+  int ExitCode = 0;
+  /// Signal mask is saved, since signal is blocked inside handler.
+  if (int Signal = sigsetjmp(TrapJump, /*savemask=*/1))
+    ExitCode = 128 + Signal;
+  else
+    ExitCode = CallMain(Main, Address) & 0xFF;
+
+  sigaction(SIGILL, &OldIll, nullptr);
+  sigaction(SIGFPE, &OldFpe, nullptr);
+  return ExitCode;
+}
+
+std::string TargetDescription(const DriverOptions &Options) {
+  return llvm::sys::getDefaultTargetTriple() + ' ' + ResolveCPU(Options.CPU) + ' ' +
+    ResolveCPU(Options.TuneCPU) + ' ' + ResolveFeatures(Options);
+}
+
+std::vector<std::unique_ptr<llvm::MemoryBuffer>> LinkTimeOptimize(
+  const std::vector<std::unique_ptr<llvm::MemoryBuffer>> &Modules,
+  const DriverOptions                                    &Options
+) {
+  llvm::ExitOnError ExitOnLTOError("LTO error: ", /*DefaultErrorExitCode=*/-1);
+
+  llvm::lto::Config Conf;
+  Conf.CPU = ResolveCPU(Options.CPU);
+  llvm::SubtargetFeatures Features(ResolveFeatures(Options));
+  Conf.MAttrs = Features.getFeatures();
+  Conf.RelocModel = llvm::Reloc::Model::Static;
+  Conf.CGOptLevel = ToCodeGenOptLevel(Options.OptLvl);
+  /// Size levels are kept by function attributes, set before link.
+  Conf.OptLevel = Options.OptLvl == O0 ? 0 : Options.OptLvl == O1 ? 1 : Options.OptLvl == O3 ? 3 : 2;
+  /// Same tuning as per-module pipeline has.
+  Conf.PTO.LoopVectorization = Options.OptLvl >= O2 && Options.OptLvl != Oz;
+  Conf.PTO.SLPVectorization = Options.OptLvl >= O2 && Options.OptLvl != Oz;
+  Conf.PTO.LoopUnrolling = Options.OptLvl >= O2;
+  Conf.DiagHandler = [](const llvm::DiagnosticInfo &DI) {
+    llvm::DiagnosticPrinterRawOStream Printer(llvm::errs());
+    DI.print(Printer);
+    llvm::errs() << '\n';
+  };
+
+  llvm::lto::ThinBackend Backend;
+  if (Options.LTO == LTOKind::Thin)
+    Backend = llvm::lto::createInProcessThinBackend(llvm::heavyweight_hardware_concurrency());
+  llvm::lto::LTO LTO(std::move(Conf), std::move(Backend), std::max(Options.CodeGenThreads, 1U));
+
+  /// Program is linked statically, so the first definition is final and
+  /// only main is called from outside, by startup code.
+  std::set<std::string> Defined;
+  for (const auto &Module : Modules) {
+    auto Input = ExitOnLTOError(llvm::lto::InputFile::create(Module->getMemBufferRef()));
+    std::vector<llvm::lto::SymbolResolution> Resolutions;
+    for (const llvm::lto::InputFile::Symbol &Sym : Input->symbols()) {
+      llvm::lto::SymbolResolution &R = Resolutions.emplace_back();
+      R.VisibleToRegularObj = Sym.getName() == "main";
+      if (Sym.isUndefined())
+        continue;
+      R.Prevailing = Defined.insert(Sym.getName().str()).second;
+      R.FinalDefinitionInLinkageUnit = true;
+      if (!R.Prevailing && !Sym.isWeak()) {
+        llvm::errs() << "LTO error: duplicate symbol: " << Sym.getName();
+        exit(-1);
+      }
+    }
+    ExitOnLTOError(LTO.add(std::move(Input), Resolutions));
+  }
+
+  /// Each task writes its own buffer, so no locking is needed.
+  std::vector<llvm::SmallVector<char, 0>> Outputs(LTO.getMaxTasks());
+  ExitOnLTOError(LTO.run([&](unsigned Task) {
+    return std::make_unique<llvm::CachedFileStream>(
+      std::make_unique<llvm::raw_svector_ostream>(Outputs[Task]));
+  }));
+
+  std::vector<std::unique_ptr<llvm::MemoryBuffer>> Objects;
+  for (unsigned Task = 0; Task < Outputs.size(); ++Task)
+    if (!Outputs[Task].empty())
+      Objects.push_back(std::make_unique<llvm::SmallVectorMemoryBuffer>(
+        std::move(Outputs[Task]), "<lto " + std::to_string(Task) + ">"));
+  return Objects;
 }
 
 } // namespace weak
\ No newline at end of file
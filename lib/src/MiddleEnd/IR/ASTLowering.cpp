@@ -0,0 +1,840 @@
+/* ASTLowering.cpp - Translation of AST to Weak IR.
+ * Copyright (C) 2022 epoll-reactor <glibcxx.chrono@gmail.com>
+ *
+ * This file is distributed under the MIT license.
+ */
+
+#include "MiddleEnd/IR/ASTLowering.h"
+#include "FrontEnd/AST/AST.h"
+#include "FrontEnd/AST/ASTVisitor.h"
+#include "MiddleEnd/CallGraph/CallGraph.h"
+#include "Utility/Unreachable.h"
+#include "llvm/ADT/ArrayRef.h"
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace weak::ir {
+namespace {
+
+std::optional<Type> ResolveScalar(DataType DT) {
+  switch (DT) {
+  case DT_INT:   return Type::I32;
+  case DT_CHAR:  return Type::I8;
+  case DT_BOOL:  return Type::I1;
+  case DT_FLOAT: return Type::F32;
+  default:       return std::nullopt;
+  }
+}
+
+struct Signature {
+  Type RetTy{Type::Void};
+  std::vector<Type> Params;
+  /// Whether all types of signature are representable in Weak IR.
+  bool Supported{true};
+};
+
+using Signatures = std::unordered_map<std::string, Signature>;
+
+Signature ResolveSignature(DataType RetTy, const std::vector<ASTNode *> &Args) {
+  Signature Sig;
+
+  if (RetTy != DT_VOID) {
+    auto Ty = ResolveScalar(RetTy);
+    Sig.Supported = Ty.has_value();
+    Sig.RetTy = Ty.value_or(Type::Void);
+  }
+
+  for (ASTNode *Arg : Args) {
+    DataType DT = Arg->Is(AST_ARRAY_DECL)
+      ? static_cast<ASTArrayDecl *>(Arg)->DataType()
+      : static_cast<ASTVarDecl *>(Arg)->DataType();
+    auto Ty = ResolveScalar(DT);
+    Sig.Supported &= Ty.has_value();
+    Sig.Params.push_back(Arg->Is(AST_ARRAY_DECL) ? Type::Ptr : Ty.value_or(Type::Void));
+  }
+
+  return Sig;
+}
+
+/// Find out whether function body can be expressed in Weak IR.
+class SupportCheck : private ASTVisitor {
+public:
+  explicit SupportCheck(const Signatures &Sigs)
+    : mSigs(Sigs) {}
+
+  bool Check(ASTFunctionDecl *Decl) {
+    mSupported = mSigs.at(Decl->Name()).Supported;
+    mArrays.clear();
+    for (ASTNode *Arg : Decl->Args())
+      Arg->Accept(this);
+    Decl->Body()->Accept(this);
+    return mSupported;
+  }
+
+private:
+  void Visit(ASTString *) override { mSupported = false; }
+  void Visit(ASTMemberAccess *) override { mSupported = false; }
+  void Visit(ASTStructDecl *) override { mSupported = false; }
+
+  void Visit(ASTVarDecl *Decl) override {
+    mSupported &= ResolveScalar(Decl->DataType()).has_value();
+    ASTVisitor::Visit(Decl);
+  }
+
+  void Visit(ASTArrayDecl *Decl) override {
+    mSupported &= ResolveScalar(Decl->DataType()).has_value();
+    mArrays[Decl->Name()] = Decl->ArityList().size();
+  }
+
+  void Visit(ASTArrayAccess *Stmt) override {
+    /// Only elements are addressed, not whole rows.
+    auto It = mArrays.find(Stmt->Name());
+    mSupported &= It != mArrays.end() && It->second == Stmt->Indices().size();
+    ASTVisitor::Visit(Stmt);
+  }
+
+  void Visit(ASTFor *Stmt) override {
+    /// Hints are attached to LLVM loops only by CodeGen.
+    mSupported &= Stmt->Hints().Empty();
+    ASTVisitor::Visit(Stmt);
+  }
+
+  void Visit(ASTWhile *Stmt) override {
+    mSupported &= Stmt->Hints().Empty();
+    ASTVisitor::Visit(Stmt);
+  }
+
+  void Visit(ASTDoWhile *Stmt) override {
+    mSupported &= Stmt->Hints().Empty();
+    ASTVisitor::Visit(Stmt);
+  }
+
+  void Visit(ASTFunctionCall *Stmt) override {
+    auto It = mSigs.find(Stmt->Name());
+    mSupported &= It != mSigs.end() && It->second.Supported;
+    ASTVisitor::Visit(Stmt);
+  }
+
+  const Signatures &mSigs;
+  /// Array name -> count of dimensions.
+  std::unordered_map<std::string, size_t> mArrays;
+  bool mSupported{true};
+};
+
+bool IsCompoundAssignment(TokenType T) {
+  switch (T) {
+  case TOK_MUL_ASSIGN:
+  case TOK_DIV_ASSIGN:
+  case TOK_MOD_ASSIGN:
+  case TOK_PLUS_ASSIGN:
+  case TOK_MINUS_ASSIGN:
+  case TOK_SHL_ASSIGN:
+  case TOK_SHR_ASSIGN:
+  case TOK_BIT_AND_ASSIGN:
+  case TOK_BIT_OR_ASSIGN:
+  case TOK_XOR_ASSIGN:
+    return true;
+  default:
+    return false;
+  }
+}
+
+TokenType ResolveAssignmentOp(TokenType T) {
+  switch (T) {
+  case TOK_MUL_ASSIGN:     return TOK_STAR;
+  case TOK_DIV_ASSIGN:     return TOK_SLASH;
+  case TOK_MOD_ASSIGN:     return TOK_MOD;
+  case TOK_PLUS_ASSIGN:    return TOK_PLUS;
+  case TOK_MINUS_ASSIGN:   return TOK_MINUS;
+  case TOK_SHL_ASSIGN:     return TOK_SHL;
+  case TOK_SHR_ASSIGN:     return TOK_SHR;
+  case TOK_BIT_AND_ASSIGN: return TOK_BIT_AND;
+  case TOK_BIT_OR_ASSIGN:  return TOK_BIT_OR;
+  case TOK_XOR_ASSIGN:     return TOK_XOR;
+  default:                 Unreachable("Should not reach there.");
+  }
+}
+
+/// \brief Lowering of single function.
+///
+/// Scalar variables are turned into SSA values on the fly with the same
+/// algorithm, as used by SSABuilder for LLVM IR (Braun et al.). Trivial
+/// φ-nodes, found during construction, are forwarded to their single value
+/// and all uses are rewritten once function is complete.
+class FunctionLowering : private ASTVisitor {
+public:
+  FunctionLowering(
+    Module           &M,
+    const Signatures &Sigs,
+    bool              BoundsCheck,
+    ASTFunctionDecl  *Decl
+  ) : mModule(M)
+    , mSigs(Sigs)
+    , mBoundsCheck(BoundsCheck)
+    , mDecl(Decl)
+    , mFunc(
+        Decl->Name(),
+        Sigs.at(Decl->Name()).RetTy,
+        Sigs.at(Decl->Name()).Params
+      ) {}
+
+  Function Lower() {
+    mBB = 0;
+    Seal(0);
+
+    for (size_t I = 0; I < mDecl->Args().size(); ++I) {
+      ASTNode *Arg = mDecl->Args()[I];
+      ValueID Param = mFunc.Params()[I];
+      if (Arg->Is(AST_ARRAY_DECL)) {
+        auto *Array = static_cast<ASTArrayDecl *>(Arg);
+        mArrays[Array->Name()] = {Param, *ResolveScalar(Array->DataType()), &Array->ArityList()};
+        continue;
+      }
+      const auto &Name = static_cast<ASTVarDecl *>(Arg)->Name();
+      mScalars[Name] = mFunc.Instrs[Param].Ty;
+      WriteVariable(Name, mBB, Param);
+    }
+
+    mDecl->Body()->Accept(this);
+
+    if (!IsTerminated())
+      Emit(mFunc.ReturnType() == Type::Void ? Opcode::Ret : Opcode::Unreachable, Type::Void, {});
+
+    RemoveUnreachableBlocks();
+    RemoveTrivialPhis();
+    return std::move(mFunc);
+  }
+
+private:
+  // Literals.
+  void Visit(ASTBool *Stmt) override { mLast = mFunc.GetConst(Type::I1, Stmt->Value()); }
+  void Visit(ASTChar *Stmt) override { mLast = mFunc.GetConst(Type::I8, Stmt->Value()); }
+  void Visit(ASTNumber *Stmt) override { mLast = mFunc.GetConst(Type::I32, Stmt->Value()); }
+  void Visit(ASTFloat *Stmt) override { mLast = mFunc.GetFloatConst(Stmt->Value()); }
+
+  void Visit(ASTSymbol *Stmt) override {
+    if (auto It = mArrays.find(Stmt->Name()); It != mArrays.end())
+      mLast = It->second.Base;
+    else
+      mLast = ReadVariable(Stmt->Name(), mBB);
+  }
+
+  void Visit(ASTBinary *Stmt) override {
+    ASTNode *LHS = Stmt->LHS();
+    ASTNode *RHS = Stmt->RHS();
+    TokenType T = Stmt->Operation();
+
+    if (T == TOK_AND || T == TOK_OR) {
+      mLast = EmitLogicalValue(Stmt);
+      return;
+    }
+
+    if (T != TOK_ASSIGN && !IsCompoundAssignment(T)) {
+      ValueID L = EmitValue(LHS);
+      ValueID R = EmitValue(RHS);
+      mLast = EmitBinOp(T, L, R);
+      return;
+    }
+
+    if (LHS->Is(AST_SYMBOL)) {
+      const auto &Name = static_cast<ASTSymbol *>(LHS)->Name();
+      ValueID L = T == TOK_ASSIGN ? NoID : ReadVariable(Name, mBB);
+      ValueID R = EmitConversion(EmitValue(RHS), mScalars.at(Name));
+      mLast = T == TOK_ASSIGN ? R : EmitBinOp(ResolveAssignmentOp(T), L, R);
+      WriteVariable(Name, mBB, mLast);
+      return;
+    }
+
+    LHS->Accept(this);
+    ValueID Addr = mLast;
+    ValueID R = EmitConversion(EmitValue(RHS), mFunc.Instrs[Addr].ElemTy);
+    mLast = T == TOK_ASSIGN ? R : EmitBinOp(ResolveAssignmentOp(T), EmitLoad(Addr), R);
+    Emit(Opcode::Store, Type::Void, {mLast, Addr});
+  }
+
+  void Visit(ASTUnary *Stmt) override {
+    ASTNode *Operand = Stmt->Operand();
+    TokenType Op = Stmt->Operation() == TOK_INC ? TOK_PLUS : TOK_MINUS;
+
+    auto One = [&](ValueID V) {
+      Type Ty = mFunc.Instrs[V].Ty;
+      return Ty == Type::F32 ? mFunc.GetFloatConst(1.0F) : mFunc.GetConst(Ty, 1);
+    };
+
+    if (Operand->Is(AST_SYMBOL)) {
+      const auto &Name = static_cast<ASTSymbol *>(Operand)->Name();
+      ValueID Old = ReadVariable(Name, mBB);
+      mLast = EmitBinOp(Op, Old, One(Old));
+      WriteVariable(Name, mBB, mLast);
+      return;
+    }
+
+    Operand->Accept(this);
+    ValueID Addr = mLast;
+    ValueID Old = EmitLoad(Addr);
+    mLast = EmitBinOp(Op, Old, One(Old));
+    Emit(Opcode::Store, Type::Void, {mLast, Addr});
+  }
+
+  void Visit(ASTArrayAccess *Stmt) override {
+    const ArrayInfo &Array = mArrays.at(Stmt->Name());
+    const auto &Arity = *Array.Arity;
+    bool Check = mBoundsCheck && !Stmt->InBounds();
+    ValueID Flat = NoID;
+
+    for (size_t Dim = 0; Dim < Stmt->Indices().size(); ++Dim) {
+      ValueID Index = EmitValue(Stmt->Indices()[Dim]);
+
+      if (Check)
+        EmitBoundsCheck(Index, Arity[Dim]);
+
+      if (mFunc.Instrs[Index].Ty != Type::I32)
+        Index = Emit(Opcode::SExt, Type::I32, {Index});
+
+      /// Elements are stored in row-major order.
+      if (Flat == NoID)
+        Flat = Index;
+      else {
+        ValueID Scaled = Emit(Opcode::Mul, Type::I32, {Flat, mFunc.GetConst(Type::I32, Arity[Dim])});
+        Flat = Emit(Opcode::Add, Type::I32, {Scaled, Index});
+      }
+    }
+
+    mLast = Emit(Opcode::ElemAddr, Type::Ptr, {Array.Base, Flat}, 0, Array.ElemTy);
+  }
+
+  void Visit(ASTVarDecl *Decl) override {
+    Type Ty = *ResolveScalar(Decl->DataType());
+    ValueID V = Decl->Body() ? EmitConversion(EmitValue(Decl->Body()), Ty) : mFunc.GetUndef(Ty);
+    /// Variable with the same name from sibling scope is not visible anymore.
+    mScalars[Decl->Name()] = Ty;
+    mDefs[Decl->Name()].clear();
+    WriteVariable(Decl->Name(), mBB, V);
+  }
+
+  void Visit(ASTArrayDecl *Decl) override {
+    uint64_t Count = 1;
+    for (unsigned Dim : Decl->ArityList())
+      Count *= Dim;
+
+    Instr Alloca;
+    Alloca.Op = Opcode::Alloca;
+    Alloca.Ty = Type::Ptr;
+    Alloca.ElemTy = *ResolveScalar(Decl->DataType());
+    Alloca.Imm = Count;
+    Alloca.Block = 0;
+
+    /// Keep all allocas together at the beginning of entry block, so
+    /// memory is allocated once per call.
+    ValueID V = mFunc.Instrs.size();
+    mFunc.Instrs.push_back(std::move(Alloca));
+    auto &Entry = mFunc.Blocks[0].Instrs;
+    auto Pos = Entry.begin();
+    while (Pos != Entry.end() && mFunc.Instrs[*Pos].Op == Opcode::Alloca)
+      ++Pos;
+    Entry.insert(Pos, V);
+
+    mArrays[Decl->Name()] = {V, mFunc.Instrs[V].ElemTy, &Decl->ArityList()};
+  }
+
+  void Visit(ASTFunctionCall *Stmt) override {
+    const Signature &Sig = mSigs.at(Stmt->Name());
+    std::vector<ValueID> Args;
+    for (size_t I = 0; I < Stmt->Args().size(); ++I)
+      Args.push_back(EmitConversion(EmitValue(Stmt->Args()[I]), Sig.Params[I]));
+
+    mLast = Emit(
+      Opcode::Call,
+      Sig.RetTy,
+      Args,
+      mModule.Symbol(Stmt->Name())
+    );
+  }
+
+  void Visit(ASTReturn *Stmt) override {
+    if (ASTNode *Operand = Stmt->Operand())
+      Emit(Opcode::Ret, Type::Void, {EmitConversion(EmitValue(Operand), mFunc.ReturnType())});
+    else
+      Emit(Opcode::Ret, Type::Void, {});
+  }
+
+  void Visit(ASTCompound *Stmts) override {
+    for (ASTNode *Stmt : Stmts->Stmts()) {
+      Stmt->Accept(this);
+      /// Statements after return, break or continue are unreachable.
+      if (IsTerminated())
+        break;
+    }
+  }
+
+  void Visit(ASTIf *Stmt) override {
+    BlockID ThenBB = mFunc.CreateBlock();
+    BlockID ElseBB = Stmt->ElseBody() ? mFunc.CreateBlock() : NoID;
+    BlockID MergeBB = mFunc.CreateBlock();
+
+    EmitBranchOnCondition(Stmt->Condition(), ThenBB, Stmt->ElseBody() ? ElseBB : MergeBB);
+    Seal(ThenBB);
+    mBB = ThenBB;
+    Stmt->ThenBody()->Accept(this);
+    EmitBranch(MergeBB);
+
+    if (Stmt->ElseBody()) {
+      Seal(ElseBB);
+      mBB = ElseBB;
+      Stmt->ElseBody()->Accept(this);
+      EmitBranch(MergeBB);
+    }
+
+    Seal(MergeBB);
+    mBB = MergeBB;
+  }
+
+  void Visit(ASTFor *Stmt) override {
+    if (ASTNode *Init = Stmt->Init())
+      Init->Accept(this);
+
+    BlockID BodyBB = mFunc.CreateBlock();
+    BlockID EndBB = mFunc.CreateBlock();
+    BlockID CondBB = NoID;
+    BlockID IncBB = NoID;
+
+    if (ASTNode *Cond = Stmt->Condition()) {
+      CondBB = mFunc.CreateBlock();
+      EmitBranch(CondBB);
+      mBB = CondBB;
+      EmitBranchOnCondition(Cond, BodyBB, EndBB);
+      Seal(BodyBB);
+    } else
+      EmitBranch(BodyBB);
+
+    BlockID HeaderBB = CondBB != NoID ? CondBB : BodyBB;
+
+    /// Increment is placed in its own block, since `continue` should
+    /// execute it.
+    if (Stmt->Increment())
+      IncBB = mFunc.CreateBlock();
+
+    mLoops.push_back({IncBB != NoID ? IncBB : HeaderBB, EndBB});
+    mBB = BodyBB;
+    Stmt->Body()->Accept(this);
+    mLoops.pop_back();
+
+    if (IncBB != NoID) {
+      EmitBranch(IncBB);
+      Seal(IncBB);
+      mBB = IncBB;
+      Stmt->Increment()->Accept(this);
+    }
+
+    EmitBranch(HeaderBB);
+    Seal(HeaderBB);
+    Seal(EndBB);
+    mBB = EndBB;
+  }
+
+  void Visit(ASTWhile *Stmt) override {
+    BlockID CondBB = mFunc.CreateBlock();
+    BlockID BodyBB = mFunc.CreateBlock();
+    BlockID EndBB = mFunc.CreateBlock();
+
+    EmitBranch(CondBB);
+    mBB = CondBB;
+    EmitBranchOnCondition(Stmt->Condition(), BodyBB, EndBB);
+    Seal(BodyBB);
+    mBB = BodyBB;
+    mLoops.push_back({CondBB, EndBB});
+    Stmt->Body()->Accept(this);
+    mLoops.pop_back();
+    EmitBranch(CondBB);
+    Seal(CondBB);
+    Seal(EndBB);
+    mBB = EndBB;
+  }
+
+  void Visit(ASTDoWhile *Stmt) override {
+    BlockID BodyBB = mFunc.CreateBlock();
+    BlockID CondBB = mFunc.CreateBlock();
+    BlockID EndBB = mFunc.CreateBlock();
+
+    EmitBranch(BodyBB);
+    mBB = BodyBB;
+    mLoops.push_back({CondBB, EndBB});
+    Stmt->Body()->Accept(this);
+    mLoops.pop_back();
+    EmitBranch(CondBB);
+    Seal(CondBB);
+    mBB = CondBB;
+    EmitBranchOnCondition(Stmt->Condition(), BodyBB, EndBB);
+    Seal(BodyBB);
+    Seal(EndBB);
+    mBB = EndBB;
+  }
+
+  void Visit(ASTBreak *) override {
+    EmitBranch(mLoops.back().BreakBB);
+  }
+
+  void Visit(ASTContinue *) override {
+    EmitBranch(mLoops.back().ContinueBB);
+  }
+
+  ValueID Emit(
+    Opcode                     Op,
+    Type                       Ty,
+    llvm::ArrayRef<ValueID>    Ops,
+    uint64_t                   Imm = 0,
+    Type                       ElemTy = Type::Void
+  ) {
+    Instr I;
+    I.Op = Op;
+    I.Ty = Ty;
+    I.ElemTy = ElemTy;
+    I.Imm = Imm;
+    I.Ops.assign(Ops.begin(), Ops.end());
+    return mFunc.Append(mBB, std::move(I));
+  }
+
+  /// Evaluate expression and load array element if it designates one.
+  ValueID EmitValue(ASTNode *AST) {
+    AST->Accept(this);
+    if (AST->Is(AST_ARRAY_ACCESS))
+      mLast = EmitLoad(mLast);
+    return mLast;
+  }
+
+  ValueID EmitLoad(ValueID Addr) {
+    return Emit(Opcode::Load, mFunc.Instrs[Addr].ElemTy, {Addr});
+  }
+
+  ValueID EmitBinOp(TokenType T, ValueID L, ValueID R) {
+    Type Ty = mFunc.Instrs[L].Ty;
+    bool IsFloat = Ty == Type::F32;
+    Opcode Op;
+    Type ResultTy = Type::I1;
+
+    switch (T) {
+    case TOK_PLUS:    Op = IsFloat ? Opcode::FAdd : Opcode::Add;        ResultTy = Ty; break;
+    case TOK_MINUS:   Op = IsFloat ? Opcode::FSub : Opcode::Sub;        ResultTy = Ty; break;
+    case TOK_STAR:    Op = IsFloat ? Opcode::FMul : Opcode::Mul;        ResultTy = Ty; break;
+    case TOK_SLASH:   Op = IsFloat ? Opcode::FDiv : Opcode::SDiv;       ResultTy = Ty; break;
+    case TOK_LE:      Op = IsFloat ? Opcode::FCmpOLE : Opcode::ICmpSLE; break;
+    case TOK_LT:      Op = IsFloat ? Opcode::FCmpOLT : Opcode::ICmpSLT; break;
+    case TOK_GE:      Op = IsFloat ? Opcode::FCmpOGE : Opcode::ICmpSGE; break;
+    case TOK_GT:      Op = IsFloat ? Opcode::FCmpOGT : Opcode::ICmpSGT; break;
+    case TOK_EQ:      Op = IsFloat ? Opcode::FCmpOEQ : Opcode::ICmpEQ;  break;
+    case TOK_NEQ:     Op = IsFloat ? Opcode::FCmpONE : Opcode::ICmpNE;  break;
+    case TOK_BIT_OR:  Op = Opcode::Or;   ResultTy = Ty; break;
+    case TOK_BIT_AND: Op = Opcode::And;  ResultTy = Ty; break;
+    case TOK_XOR:     Op = Opcode::Xor;  ResultTy = Ty; break;
+    case TOK_SHL:     Op = Opcode::Shl;  ResultTy = Ty; break;
+    case TOK_SHR:     Op = Opcode::AShr; ResultTy = Ty; break;
+    default:          Unreachable("Unknown binary operator.");
+    }
+
+    return Emit(Op, ResultTy, {L, R});
+  }
+
+  /// Convert scalar to I1 by comparing it with zero.
+  ValueID EmitBoolCast(ValueID V) {
+    switch (Type Ty = mFunc.Instrs[V].Ty) {
+    case Type::I1:
+      return V;
+    case Type::F32:
+      return Emit(Opcode::FCmpUNE, Type::I1, {V, mFunc.GetFloatConst(0.0F)});
+    default:
+      return Emit(Opcode::ICmpNE, Type::I1, {V, mFunc.GetConst(Ty, 0)});
+    }
+  }
+
+  /// Widen I1, given by comparisons and `&&` or `||`, to declared type of
+  /// variable, return value or parameter. Other scalars already have it.
+  ValueID EmitConversion(ValueID V, Type Ty) {
+    if (mFunc.Instrs[V].Ty != Type::I1 || Ty == Type::I1 || Ty == Type::Ptr)
+      return V;
+    return Emit(Ty == Type::F32 ? Opcode::UIToFP : Opcode::ZExt, Ty, {V});
+  }
+
+  /// Emit short-circuit `&&` or `||`, which result is used as value.
+  ValueID EmitLogicalValue(ASTBinary *Stmt) {
+    bool IsAnd = Stmt->Operation() == TOK_AND;
+
+    ValueID L = EmitValue(Stmt->LHS());
+    Type ResultTy = mFunc.Instrs[L].Ty;
+    BlockID RHSBB = mFunc.CreateBlock();
+    BlockID EndBB = mFunc.CreateBlock();
+
+    BlockID LHSBB = mBB;
+    ValueID LBool = EmitBoolCast(L);
+    if (IsAnd)
+      EmitCondBr(LBool, RHSBB, EndBB);
+    else
+      EmitCondBr(LBool, EndBB, RHSBB);
+
+    Seal(RHSBB);
+    mBB = RHSBB;
+    ValueID R = EmitBoolCast(EmitValue(Stmt->RHS()));
+    EmitBranch(EndBB);
+
+    Seal(EndBB);
+    mBB = EndBB;
+    ValueID Phi = mFunc.InsertPhi(EndBB, Type::I1);
+    ValueID Short = mFunc.GetConst(Type::I1, !IsAnd);
+    for (BlockID Pred : mFunc.Blocks[EndBB].Preds)
+      mFunc.Instrs[Phi].Ops.push_back(Pred == LHSBB ? Short : R);
+
+    /// Result has the same type as operands.
+    switch (ResultTy) {
+    case Type::I1:  return Phi;
+    case Type::F32: return Emit(Opcode::UIToFP, ResultTy, {Phi});
+    default:        return Emit(Opcode::ZExt, ResultTy, {Phi});
+    }
+  }
+
+  /// Emit jump to one of targets, depending on condition. `&&` and `||` are
+  /// lowered to control flow, so right operand is evaluated only if needed.
+  void EmitBranchOnCondition(ASTNode *Cond, BlockID TrueBB, BlockID FalseBB) {
+    if (Cond->Is(AST_BINARY)) {
+      auto *Binary = static_cast<ASTBinary *>(Cond);
+      TokenType Op = Binary->Operation();
+
+      if (Op == TOK_AND || Op == TOK_OR) {
+        BlockID RHSBB = mFunc.CreateBlock();
+        if (Op == TOK_AND)
+          EmitBranchOnCondition(Binary->LHS(), RHSBB, FalseBB);
+        else
+          EmitBranchOnCondition(Binary->LHS(), TrueBB, RHSBB);
+        Seal(RHSBB);
+        mBB = RHSBB;
+        EmitBranchOnCondition(Binary->RHS(), TrueBB, FalseBB);
+        return;
+      }
+    }
+
+    EmitCondBr(EmitBoolCast(EmitValue(Cond)), TrueBB, FalseBB);
+  }
+
+  void EmitCondBr(ValueID Cond, BlockID TrueBB, BlockID FalseBB) {
+    BlockID From = mBB;
+    Emit(Opcode::CondBr, Type::Void, {Cond});
+    mFunc.AddEdge(From, TrueBB);
+    mFunc.AddEdge(From, FalseBB);
+  }
+
+  /// Emit branch unless current block is already terminated.
+  void EmitBranch(BlockID Target) {
+    if (IsTerminated())
+      return;
+    BlockID From = mBB;
+    Emit(Opcode::Br, Type::Void, {});
+    mFunc.AddEdge(From, Target);
+  }
+
+  /// Check if index is less than dimension size and jump to trap block
+  /// otherwise. Negative indices are treated as large unsigned numbers.
+  void EmitBoundsCheck(ValueID Index, unsigned DimensionSize) {
+    if (mTrapBB == NoID) {
+      mTrapBB = mFunc.CreateBlock();
+      Instr Trap;
+      Trap.Op = Opcode::Trap;
+      mFunc.Append(mTrapBB, std::move(Trap));
+    }
+
+    BlockID OkBB = mFunc.CreateBlock();
+    ValueID Size = mFunc.GetConst(mFunc.Instrs[Index].Ty, DimensionSize);
+    ValueID InBounds = Emit(Opcode::ICmpULT, Type::I1, {Index, Size});
+    EmitCondBr(InBounds, OkBB, mTrapBB);
+    Seal(OkBB);
+    mBB = OkBB;
+  }
+
+  bool IsTerminated() const {
+    return mFunc.Terminator(mBB) != NoID;
+  }
+
+  ValueID Resolve(ValueID V) const {
+    for (auto It = mForward.find(V); It != mForward.end(); It = mForward.find(V))
+      V = It->second;
+    return V;
+  }
+
+  void WriteVariable(const std::string &Name, BlockID BB, ValueID V) {
+    mDefs[Name][BB] = V;
+  }
+
+  ValueID ReadVariable(const std::string &Name, BlockID BB) {
+    auto &Defs = mDefs[Name];
+    if (auto It = Defs.find(BB); It != Defs.end())
+      return Resolve(It->second);
+    return ReadRecursive(Name, BB);
+  }
+
+  ValueID ReadRecursive(const std::string &Name, BlockID BB) {
+    ValueID V;
+    const auto &Preds = mFunc.Blocks[BB].Preds;
+
+    if (!mSealed.count(BB)) {
+      /// Not all predecessors are known.
+      V = mFunc.InsertPhi(BB, mScalars.at(Name));
+      mIncompletePhis[BB].emplace_back(Name, V);
+    } else if (Preds.size() == 1) {
+      /// No φ-node needed.
+      V = ReadVariable(Name, Preds[0]);
+    } else if (Preds.empty()) {
+      /// Unreachable block.
+      V = mFunc.GetUndef(mScalars.at(Name));
+    } else {
+      /// Break potential cycles with operandless φ-node.
+      V = mFunc.InsertPhi(BB, mScalars.at(Name));
+      WriteVariable(Name, BB, V);
+      V = AddPhiOperands(Name, V);
+    }
+
+    WriteVariable(Name, BB, V);
+    return V;
+  }
+
+  ValueID AddPhiOperands(const std::string &Name, ValueID Phi) {
+    /// Reads can create new instructions, so do not hold references.
+    std::vector<BlockID> Preds = mFunc.Blocks[mFunc.Instrs[Phi].Block].Preds;
+    llvm::SmallVector<ValueID, 2> Ops;
+    for (BlockID Pred : Preds)
+      Ops.push_back(ReadVariable(Name, Pred));
+    mFunc.Instrs[Phi].Ops = std::move(Ops);
+    return TryRemoveTrivialPhi(Phi);
+  }
+
+  ValueID TryRemoveTrivialPhi(ValueID Phi) {
+    ValueID Same = NoID;
+
+    for (ValueID Op : mFunc.Instrs[Phi].Ops) {
+      Op = Resolve(Op);
+      if (Op == Same || Op == Phi)
+        continue;
+      if (Same != NoID)
+        /// φ-node merges at least two values, so it is not trivial.
+        return Phi;
+      Same = Op;
+    }
+
+    if (Same == NoID)
+      /// φ-node is unreachable or in start block.
+      Same = mFunc.GetUndef(mFunc.Instrs[Phi].Ty);
+
+    mForward[Phi] = Same;
+    mFunc.Erase(Phi);
+    return Same;
+  }
+
+  /// Mark that all predecessors of block are known and complete
+  /// φ-nodes, created before.
+  void Seal(BlockID BB) {
+    mSealed.insert(BB);
+    auto Incomplete = std::move(mIncompletePhis[BB]);
+    mIncompletePhis.erase(BB);
+    for (auto &[Name, Phi] : Incomplete)
+      AddPhiOperands(Name, Phi);
+  }
+
+  void RemoveUnreachableBlocks() {
+    std::vector<bool> Reachable(mFunc.Blocks.size());
+    for (BlockID BB : ReversePostOrder(mFunc))
+      Reachable[BB] = true;
+    for (BlockID BB = 0; BB < mFunc.Blocks.size(); ++BB)
+      if (!Reachable[BB] && !mFunc.Blocks[BB].Removed)
+        mFunc.RemoveBlock(BB);
+  }
+
+  /// Users of removed φ-nodes, as well as φ-nodes, which lost operands from
+  /// unreachable blocks, can become trivial, so repeat until nothing changes.
+  void RemoveTrivialPhis() {
+    bool Changed = true;
+    while (Changed) {
+      Changed = false;
+      for (BlockID BB = 0; BB < mFunc.Blocks.size(); ++BB) {
+        std::vector<ValueID> Instrs = mFunc.Blocks[BB].Instrs;
+        for (ValueID V : Instrs)
+          if (mFunc.Instrs[V].Op == Opcode::Phi)
+            Changed |= TryRemoveTrivialPhi(V) != V;
+      }
+    }
+
+    std::vector<ValueID> Replacements(mFunc.Instrs.size(), NoID);
+    for (auto [From, To] : mForward)
+      Replacements[From] = To;
+    mFunc.ReplaceUses(Replacements);
+  }
+
+  struct ArrayInfo {
+    /// Alloca or pointer parameter.
+    ValueID Base;
+    Type ElemTy;
+    const std::vector<unsigned> *Arity;
+  };
+
+  struct LoopContext {
+    /// Where `continue` jumps to. Either header or increment block.
+    BlockID ContinueBB;
+    /// Where `break` jumps to.
+    BlockID BreakBB;
+  };
+
+  Module &mModule;
+  const Signatures &mSigs;
+  bool mBoundsCheck;
+  ASTFunctionDecl *mDecl;
+  Function mFunc;
+  /// Block, where instructions are appended.
+  BlockID mBB{0U};
+  /// Consequence of using visitor pattern, since we cannot return anything from
+  /// visit functions.
+  ValueID mLast{NoID};
+  /// Block with trap, shared between all bounds checks.
+  BlockID mTrapBB{NoID};
+  std::vector<LoopContext> mLoops;
+  std::unordered_map<std::string, ArrayInfo> mArrays;
+  std::unordered_map<std::string, Type> mScalars;
+  /// Variable -> its value at the end of each block.
+  std::unordered_map<std::string, std::unordered_map<BlockID, ValueID>> mDefs;
+  std::unordered_map<BlockID, std::vector<std::pair<std::string, ValueID>>> mIncompletePhis;
+  std::unordered_set<BlockID> mSealed;
+  /// Removed trivial φ-node -> value, that replaces it.
+  std::unordered_map<ValueID, ValueID> mForward;
+};
+
+} // namespace
+} // namespace weak::ir
+
+namespace weak {
+
+ir::Module LowerToWeakIR(ASTNode *Root, bool BoundsCheck) {
+  ir::Module M;
+  ir::Signatures Sigs;
+  const auto &Stmts = static_cast<ASTCompound *>(Root)->Stmts();
+
+  for (ASTNode *Stmt : Stmts) {
+    if (Stmt->Is(AST_FUNCTION_DECL)) {
+      auto *Decl = static_cast<ASTFunctionDecl *>(Stmt);
+      Sigs[Decl->Name()] = ir::ResolveSignature(Decl->ReturnType(), Decl->Args());
+    }
+    if (Stmt->Is(AST_FUNCTION_PROTOTYPE)) {
+      auto *Decl = static_cast<ASTFunctionPrototype *>(Stmt);
+      Sigs[Decl->Name()] = ir::ResolveSignature(Decl->ReturnType(), Decl->Args());
+    }
+  }
+
+  ir::SupportCheck Check(Sigs);
+  for (ASTNode *Stmt : Stmts) {
+    if (!Stmt->Is(AST_FUNCTION_DECL))
+      continue;
+    auto *Decl = static_cast<ASTFunctionDecl *>(Stmt);
+    if (!Check.Check(Decl))
+      continue;
+    M.Functions.push_back(ir::FunctionLowering(M, Sigs, BoundsCheck, Decl).Lower());
+    M.Functions.back().Exported = CallGraph::IsEntryPoint(Decl);
+  }
+
+  return M;
+}
+
+} // namespace weak
\ No newline at end of file
@@ -0,0 +1,72 @@
+/* DCE.cpp - Dead code elimination over Weak IR.
+ * Copyright (C) 2022 epoll-reactor <glibcxx.chrono@gmail.com>
+ *
+ * This file is distributed under the MIT license.
+ */
+
+#include "MiddleEnd/IR/Passes.h"
+
+namespace weak::ir {
+namespace {
+
+/// Whether instruction is needed regardless of its uses.
+bool IsRoot(const Instr &I) {
+  return I.Op == Opcode::Store || I.Op == Opcode::Call || IsTerminator(I.Op);
+}
+
+/// Mark instructions, that roots depend on, and remove the rest.
+/// Unlike removal of unused values, this also removes cycles of
+/// φ-nodes, that feed only each other.
+class DCE : public Pass {
+public:
+  const char *Name() const override { return "DCE"; }
+
+  unsigned Run(Function &F) override {
+    std::vector<bool> Live(F.Instrs.size());
+    std::vector<ValueID> Worklist;
+
+    for (const Block &BB : F.Blocks)
+      for (ValueID V : BB.Instrs)
+        if (IsRoot(F.Instrs[V])) {
+          Live[V] = true;
+          Worklist.push_back(V);
+        }
+
+    while (!Worklist.empty()) {
+      ValueID V = Worklist.back();
+      Worklist.pop_back();
+      for (ValueID Op : F.Instrs[V].Ops)
+        if (!Live[Op]) {
+          Live[Op] = true;
+          Worklist.push_back(Op);
+        }
+    }
+
+    unsigned Changes = 0;
+    for (Block &BB : F.Blocks) {
+      std::vector<ValueID> Kept;
+      for (ValueID V : BB.Instrs) {
+        if (Live[V]) {
+          Kept.push_back(V);
+          continue;
+        }
+        Instr &I = F.Instrs[V];
+        I.Op = Opcode::Nop;
+        I.Ops.clear();
+        I.Block = NoID;
+        ++Changes;
+      }
+      BB.Instrs = std::move(Kept);
+    }
+
+    return Changes;
+  }
+};
+
+} // namespace
+
+std::unique_ptr<Pass> CreateDCEPass() {
+  return std::make_unique<DCE>();
+}
+
+} // namespace weak::ir
\ No newline at end of file
@@ -0,0 +1,96 @@
+/* Dominators.cpp - Dominator tree of Weak IR function.
+ * Copyright (C) 2022 epoll-reactor <glibcxx.chrono@gmail.com>
+ *
+ * This file is distributed under the MIT license.
+ */
+
+#include "MiddleEnd/IR/Dominators.h"
+
+namespace weak::ir {
+
+DominatorTree::DominatorTree(const Function &F)
+  : mOrder(ReversePostOrder(F))
+  , mIDoms(F.Blocks.size(), NoID)
+  , mChildren(F.Blocks.size())
+  , mEnter(F.Blocks.size(), NoID)
+  , mLeave(F.Blocks.size(), NoID) {
+  std::vector<uint32_t> RPONumber(F.Blocks.size(), NoID);
+  for (size_t I = 0; I < mOrder.size(); ++I)
+    RPONumber[mOrder[I]] = I;
+
+  auto Intersect = [&](BlockID A, BlockID B) {
+    while (A != B) {
+      while (RPONumber[A] > RPONumber[B])
+        A = mIDoms[A];
+      while (RPONumber[B] > RPONumber[A])
+        B = mIDoms[B];
+    }
+    return A;
+  };
+
+  /// Entry temporarily dominates itself to stop intersection.
+  mIDoms[0] = 0;
+  bool Changed = true;
+  while (Changed) {
+    Changed = false;
+    for (BlockID BB : mOrder) {
+      if (BB == 0)
+        continue;
+      BlockID NewIDom = NoID;
+      for (BlockID Pred : F.Blocks[BB].Preds) {
+        if (mIDoms[Pred] == NoID)
+          /// Not processed yet or unreachable.
+          continue;
+        NewIDom = NewIDom == NoID ? Pred : Intersect(Pred, NewIDom);
+      }
+      if (NewIDom != mIDoms[BB]) {
+        mIDoms[BB] = NewIDom;
+        Changed = true;
+      }
+    }
+  }
+  mIDoms[0] = NoID;
+
+  for (BlockID BB : mOrder)
+    if (mIDoms[BB] != NoID)
+      mChildren[mIDoms[BB]].push_back(BB);
+
+  uint32_t Counter = 0;
+  std::vector<std::pair<BlockID, size_t>> Stack{{0, 0}};
+  mEnter[0] = Counter++;
+  while (!Stack.empty()) {
+    auto &[BB, Next] = Stack.back();
+    if (Next < mChildren[BB].size()) {
+      BlockID Child = mChildren[BB][Next++];
+      mEnter[Child] = Counter++;
+      Stack.push_back({Child, 0});
+      continue;
+    }
+    mLeave[BB] = Counter++;
+    Stack.pop_back();
+  }
+}
+
+BlockID DominatorTree::IDom(BlockID BB) const {
+  return mIDoms[BB];
+}
+
+const std::vector<BlockID> &DominatorTree::Children(BlockID BB) const {
+  return mChildren[BB];
+}
+
+bool DominatorTree::Dominates(BlockID A, BlockID B) const {
+  if (!IsReachable(A) || !IsReachable(B))
+    return false;
+  return mEnter[A] <= mEnter[B] && mLeave[B] <= mLeave[A];
+}
+
+bool DominatorTree::IsReachable(BlockID BB) const {
+  return mEnter[BB] != NoID;
+}
+
+const std::vector<BlockID> &DominatorTree::Order() const {
+  return mOrder;
+}
+
+} // namespace weak::ir
\ No newline at end of file
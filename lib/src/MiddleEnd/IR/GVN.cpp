@@ -0,0 +1,134 @@
+/* GVN.cpp - Dominator-based global value numbering over Weak IR.
+ * Copyright (C) 2022 epoll-reactor <glibcxx.chrono@gmail.com>
+ *
+ * This file is distributed under the MIT license.
+ */
+
+#include "MiddleEnd/IR/Dominators.h"
+#include "MiddleEnd/IR/Passes.h"
+#include <algorithm>
+#include <unordered_map>
+
+namespace weak::ir {
+namespace {
+
+/// Opcode, types and operands, that identify computed value.
+using Expression = std::vector<uint32_t>;
+
+struct ExpressionHash {
+  size_t operator()(const Expression &E) const {
+    size_t Hash = E.size();
+    for (uint32_t Word : E)
+      Hash = Hash * 31 + Word;
+    return Hash;
+  }
+};
+
+/// Walks dominator tree and keeps table of expressions, computed in
+/// dominating blocks. Each expression, found in table, is redundant and
+/// replaced with its first computation. Scoped table makes it enough to
+/// compare operands, since all of them are already numbered.
+///
+/// φ-nodes are numbered together with their block, so only identical
+/// φ-nodes of one block are merged.
+class GVN : public Pass {
+public:
+  const char *Name() const override { return "GVN"; }
+
+  unsigned Run(Function &F) override {
+    DominatorTree DT(F);
+    std::vector<ValueID> Replacements(F.Instrs.size(), NoID);
+    std::unordered_map<Expression, ValueID, ExpressionHash> Table;
+    unsigned Changes = 0;
+
+    auto Resolve = [&](ValueID V) {
+      while (Replacements[V] != NoID)
+        V = Replacements[V];
+      return V;
+    };
+
+    /// Blocks on current path in dominator tree and expressions, added to
+    /// table while visiting them.
+    std::vector<std::pair<BlockID, std::vector<Expression>>> Stack;
+    /// NoID marks leaving of block, which is on top of stack.
+    std::vector<BlockID> Worklist{0};
+
+    while (!Worklist.empty()) {
+      BlockID BB = Worklist.back();
+      Worklist.pop_back();
+
+      if (BB == NoID) {
+        for (const Expression &E : Stack.back().second)
+          Table.erase(E);
+        Stack.pop_back();
+        continue;
+      }
+
+      Stack.emplace_back(BB, std::vector<Expression>{});
+      Worklist.push_back(NoID);
+      for (BlockID Child : DT.Children(BB))
+        Worklist.push_back(Child);
+
+      std::vector<ValueID> Instrs = F.Blocks[BB].Instrs;
+      for (ValueID V : Instrs) {
+        Instr &I = F.Instrs[V];
+        for (ValueID &Op : I.Ops)
+          Op = Resolve(Op);
+
+        if (I.Op != Opcode::Phi && !IsPure(I))
+          continue;
+
+        if (I.Op == Opcode::Phi) {
+          /// φ-node, merging single value, is not needed.
+          ValueID Same = NoID;
+          bool Trivial = true;
+          for (ValueID Op : I.Ops) {
+            if (Op == V || Op == Same)
+              continue;
+            Trivial &= Same == NoID;
+            Same = Op;
+          }
+          if (Trivial && Same != NoID) {
+            Replacements[V] = Same;
+            F.Erase(V);
+            ++Changes;
+            continue;
+          }
+        }
+
+        Expression E{
+          static_cast<uint32_t>(I.Op),
+          static_cast<uint32_t>(I.Ty),
+          static_cast<uint32_t>(I.ElemTy),
+          I.Op == Opcode::Phi ? BB : NoID
+        };
+        std::vector<ValueID> Ops(I.Ops.begin(), I.Ops.end());
+        if (IsCommutative(I.Op))
+          std::sort(Ops.begin(), Ops.end());
+        E.insert(E.end(), Ops.begin(), Ops.end());
+
+        auto [It, Inserted] = Table.try_emplace(E, V);
+        if (Inserted) {
+          Stack.back().second.push_back(std::move(E));
+          continue;
+        }
+
+        Replacements[V] = It->second;
+        F.Erase(V);
+        ++Changes;
+      }
+    }
+
+    /// Operands of φ-nodes can come from blocks, visited later.
+    F.ReplaceUses(Replacements);
+    return Changes;
+  }
+};
+
+} // namespace
+
+std::unique_ptr<Pass> CreateGVNPass() {
+  return std::make_unique<GVN>();
+}
+
+} // namespace weak::ir
\ No newline at end of file
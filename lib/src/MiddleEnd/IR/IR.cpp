@@ -0,0 +1,558 @@
+/* IR.cpp - Weak IR, mid-level three-address intermediate representation.
+ * Copyright (C) 2022 epoll-reactor <glibcxx.chrono@gmail.com>
+ *
+ * This file is distributed under the MIT license.
+ */
+
+#include "MiddleEnd/IR/IR.h"
+#include "Utility/Unreachable.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace weak::ir {
+
+int64_t Instr::IntValue() const {
+  switch (Ty) {
+  case Type::I1:  return Imm & 1U;
+  case Type::I8:  return static_cast<int8_t>(Imm);
+  case Type::I32: return static_cast<int32_t>(Imm);
+  default:        Unreachable("Expected integer constant.");
+  }
+}
+
+float Instr::FloatValue() const {
+  assert(Ty == Type::F32 && "Expected float constant");
+  uint32_t Bits = static_cast<uint32_t>(Imm);
+  float Value;
+  std::memcpy(&Value, &Bits, sizeof(Value));
+  return Value;
+}
+
+Function::Function(std::string Name, Type RetTy, std::vector<Type> ParamTypes)
+  : mName(std::move(Name))
+  , mRetTy(RetTy) {
+  for (size_t I = 0; I < ParamTypes.size(); ++I) {
+    Instr Param;
+    Param.Op = Opcode::Param;
+    Param.Ty = ParamTypes[I];
+    Param.Imm = I;
+    mParams.push_back(Instrs.size());
+    Instrs.push_back(std::move(Param));
+  }
+  CreateBlock();
+}
+
+const std::string &Function::Name() const {
+  return mName;
+}
+
+Type Function::ReturnType() const {
+  return mRetTy;
+}
+
+const std::vector<ValueID> &Function::Params() const {
+  return mParams;
+}
+
+BlockID Function::CreateBlock() {
+  Blocks.emplace_back();
+  return Blocks.size() - 1;
+}
+
+ValueID Function::Append(BlockID BB, Instr I) {
+  ValueID V = Instrs.size();
+  I.Block = BB;
+  Instrs.push_back(std::move(I));
+  Blocks[BB].Instrs.push_back(V);
+  return V;
+}
+
+ValueID Function::InsertBeforeTerminator(BlockID BB, Instr I) {
+  ValueID V = Instrs.size();
+  I.Block = BB;
+  Instrs.push_back(std::move(I));
+  auto &List = Blocks[BB].Instrs;
+  auto Pos = List.end();
+  if (!List.empty() && IsTerminator(Instrs[List.back()].Op))
+    --Pos;
+  List.insert(Pos, V);
+  return V;
+}
+
+ValueID Function::InsertPhi(BlockID BB, Type Ty) {
+  ValueID V = Instrs.size();
+  Instr Phi;
+  Phi.Op = Opcode::Phi;
+  Phi.Ty = Ty;
+  Phi.Block = BB;
+  Instrs.push_back(std::move(Phi));
+  auto &List = Blocks[BB].Instrs;
+  auto Pos = std::find_if(List.begin(), List.end(), [&](ValueID I) {
+    return Instrs[I].Op != Opcode::Phi;
+  });
+  List.insert(Pos, V);
+  return V;
+}
+
+static uint64_t CanonicalBits(Type Ty, int64_t Value) {
+  switch (Ty) {
+  case Type::I1:  return Value & 1;
+  case Type::I8:  return static_cast<uint64_t>(static_cast<int64_t>(static_cast<int8_t>(Value)));
+  case Type::I32: return static_cast<uint64_t>(static_cast<int64_t>(static_cast<int32_t>(Value)));
+  default:        Unreachable("Expected integer type.");
+  }
+}
+
+static ValueID GetOrCreate(
+  std::vector<Instr>                           &Instrs,
+  std::map<std::pair<Type, uint64_t>, ValueID> &Consts,
+  Type                                          Ty,
+  uint64_t                                      Bits
+) {
+  auto [It, Inserted] = Consts.try_emplace({Ty, Bits}, Instrs.size());
+  if (Inserted) {
+    Instr Const;
+    Const.Op = Opcode::Const;
+    Const.Ty = Ty;
+    Const.Imm = Bits;
+    Instrs.push_back(std::move(Const));
+  }
+  return It->second;
+}
+
+ValueID Function::GetConst(Type Ty, int64_t Value) {
+  return GetOrCreate(Instrs, mConsts, Ty, CanonicalBits(Ty, Value));
+}
+
+ValueID Function::GetFloatConst(float Value) {
+  uint32_t Bits;
+  std::memcpy(&Bits, &Value, sizeof(Bits));
+  return GetOrCreate(Instrs, mConsts, Type::F32, Bits);
+}
+
+ValueID Function::GetUndef(Type Ty) {
+  auto [It, Inserted] = mUndefs.try_emplace(Ty, Instrs.size());
+  if (Inserted) {
+    Instr Undef;
+    Undef.Op = Opcode::Undef;
+    Undef.Ty = Ty;
+    Instrs.push_back(std::move(Undef));
+  }
+  return It->second;
+}
+
+void Function::AddEdge(BlockID From, BlockID To) {
+  Blocks[From].Succs.push_back(To);
+  Blocks[To].Preds.push_back(From);
+}
+
+void Function::RemoveEdge(BlockID From, BlockID To) {
+  auto &Succs = Blocks[From].Succs;
+  auto SuccIt = std::find(Succs.begin(), Succs.end(), To);
+  assert(SuccIt != Succs.end() && "Edge expected to exist");
+  Succs.erase(SuccIt);
+
+  auto &Preds = Blocks[To].Preds;
+  auto PredIt = std::find(Preds.begin(), Preds.end(), From);
+  size_t Index = PredIt - Preds.begin();
+  Preds.erase(PredIt);
+
+  for (ValueID V : Blocks[To].Instrs) {
+    Instr &Phi = Instrs[V];
+    if (Phi.Op != Opcode::Phi)
+      break;
+    if (Index < Phi.Ops.size())
+      Phi.Ops.erase(Phi.Ops.begin() + Index);
+  }
+}
+
+void Function::RemoveBlock(BlockID BB) {
+  while (!Blocks[BB].Succs.empty())
+    RemoveEdge(BB, Blocks[BB].Succs.back());
+  while (!Blocks[BB].Preds.empty())
+    RemoveEdge(Blocks[BB].Preds.back(), BB);
+
+  for (ValueID V : Blocks[BB].Instrs) {
+    Instrs[V].Op = Opcode::Nop;
+    Instrs[V].Ops.clear();
+  }
+  Blocks[BB].Instrs.clear();
+  Blocks[BB].Removed = true;
+}
+
+void Function::Erase(ValueID V) {
+  Instr &I = Instrs[V];
+  if (I.Block != NoID) {
+    auto &List = Blocks[I.Block].Instrs;
+    List.erase(std::find(List.begin(), List.end(), V));
+  }
+  I.Op = Opcode::Nop;
+  I.Ops.clear();
+  I.Block = NoID;
+}
+
+void Function::Move(ValueID V, BlockID BB) {
+  auto &List = Blocks[Instrs[V].Block].Instrs;
+  List.erase(std::find(List.begin(), List.end(), V));
+  Instrs[V].Block = BB;
+  auto &Target = Blocks[BB].Instrs;
+  auto Pos = Target.end();
+  if (!Target.empty() && IsTerminator(Instrs[Target.back()].Op))
+    --Pos;
+  Target.insert(Pos, V);
+}
+
+void Function::ReplaceUses(const std::vector<ValueID> &Replacements) {
+  auto Resolve = [&](ValueID V) {
+    while (V < Replacements.size() && Replacements[V] != NoID)
+      V = Replacements[V];
+    return V;
+  };
+
+  for (Instr &I : Instrs)
+    for (ValueID &Op : I.Ops)
+      Op = Resolve(Op);
+}
+
+ValueID Function::Terminator(BlockID BB) const {
+  const auto &List = Blocks[BB].Instrs;
+  if (List.empty() || !IsTerminator(Instrs[List.back()].Op))
+    return NoID;
+  return List.back();
+}
+
+uint32_t Module::Symbol(const std::string &Name) {
+  auto It = std::find(mSymbols.begin(), mSymbols.end(), Name);
+  if (It != mSymbols.end())
+    return It - mSymbols.begin();
+  mSymbols.push_back(Name);
+  return mSymbols.size() - 1;
+}
+
+const std::string &Module::SymbolName(uint32_t Index) const {
+  return mSymbols[Index];
+}
+
+const Function *Module::Find(const std::string &Name) const {
+  for (const Function &F : Functions)
+    if (F.Name() == Name)
+      return &F;
+  return nullptr;
+}
+
+std::vector<BlockID> ReversePostOrder(const Function &F) {
+  std::vector<BlockID> Order;
+  std::vector<bool> Visited(F.Blocks.size());
+  /// Block and index of next successor to visit.
+  std::vector<std::pair<BlockID, size_t>> Stack{{0, 0}};
+  Visited[0] = true;
+
+  while (!Stack.empty()) {
+    auto &[BB, Next] = Stack.back();
+    const auto &Succs = F.Blocks[BB].Succs;
+    if (Next < Succs.size()) {
+      BlockID Succ = Succs[Next++];
+      if (!Visited[Succ]) {
+        Visited[Succ] = true;
+        Stack.push_back({Succ, 0});
+      }
+      continue;
+    }
+    Order.push_back(BB);
+    Stack.pop_back();
+  }
+
+  std::reverse(Order.begin(), Order.end());
+  return Order;
+}
+
+bool IsTerminator(Opcode Op) {
+  switch (Op) {
+  case Opcode::Br:
+  case Opcode::CondBr:
+  case Opcode::Ret:
+  case Opcode::Trap:
+  case Opcode::Unreachable:
+    return true;
+  default:
+    return false;
+  }
+}
+
+bool IsPure(const Instr &I) {
+  switch (I.Op) {
+  case Opcode::Const:
+  case Opcode::Param:
+  case Opcode::Undef:
+  case Opcode::Alloca:
+  case Opcode::Load:
+  case Opcode::Store:
+  case Opcode::Phi:
+  case Opcode::Call:
+  case Opcode::Nop:
+    return false;
+  default:
+    return !IsTerminator(I.Op);
+  }
+}
+
+bool IsCommutative(Opcode Op) {
+  switch (Op) {
+  case Opcode::Add:
+  case Opcode::Mul:
+  case Opcode::And:
+  case Opcode::Or:
+  case Opcode::Xor:
+  case Opcode::FAdd:
+  case Opcode::FMul:
+  case Opcode::ICmpEQ:
+  case Opcode::ICmpNE:
+  case Opcode::FCmpOEQ:
+  case Opcode::FCmpONE:
+  case Opcode::FCmpUNE:
+    return true;
+  default:
+    return false;
+  }
+}
+
+const char *OpcodeToString(Opcode Op) {
+  switch (Op) {
+  case Opcode::Nop:         return "nop";
+  case Opcode::Const:       return "const";
+  case Opcode::Param:       return "param";
+  case Opcode::Undef:       return "undef";
+  case Opcode::Add:         return "add";
+  case Opcode::Sub:         return "sub";
+  case Opcode::Mul:         return "mul";
+  case Opcode::SDiv:        return "sdiv";
+  case Opcode::Shl:         return "shl";
+  case Opcode::AShr:        return "ashr";
+  case Opcode::And:         return "and";
+  case Opcode::Or:          return "or";
+  case Opcode::Xor:         return "xor";
+  case Opcode::FAdd:        return "fadd";
+  case Opcode::FSub:        return "fsub";
+  case Opcode::FMul:        return "fmul";
+  case Opcode::FDiv:        return "fdiv";
+  case Opcode::ICmpEQ:      return "icmp eq";
+  case Opcode::ICmpNE:      return "icmp ne";
+  case Opcode::ICmpSLT:     return "icmp slt";
+  case Opcode::ICmpSLE:     return "icmp sle";
+  case Opcode::ICmpSGT:     return "icmp sgt";
+  case Opcode::ICmpSGE:     return "icmp sge";
+  case Opcode::ICmpULT:     return "icmp ult";
+  case Opcode::FCmpOEQ:     return "fcmp oeq";
+  case Opcode::FCmpONE:     return "fcmp one";
+  case Opcode::FCmpOLT:     return "fcmp olt";
+  case Opcode::FCmpOLE:     return "fcmp ole";
+  case Opcode::FCmpOGT:     return "fcmp ogt";
+  case Opcode::FCmpOGE:     return "fcmp oge";
+  case Opcode::FCmpUNE:     return "fcmp une";
+  case Opcode::ZExt:        return "zext";
+  case Opcode::SExt:        return "sext";
+  case Opcode::UIToFP:      return "uitofp";
+  case Opcode::Alloca:      return "alloca";
+  case Opcode::ElemAddr:    return "elemaddr";
+  case Opcode::Load:        return "load";
+  case Opcode::Store:       return "store";
+  case Opcode::Phi:         return "phi";
+  case Opcode::Call:        return "call";
+  case Opcode::Br:          return "br";
+  case Opcode::CondBr:      return "condbr";
+  case Opcode::Ret:         return "ret";
+  case Opcode::Trap:        return "trap";
+  case Opcode::Unreachable: return "unreachable";
+  }
+  Unreachable("Unknown opcode.");
+}
+
+const char *TypeToString(Type Ty) {
+  switch (Ty) {
+  case Type::Void: return "void";
+  case Type::I1:   return "i1";
+  case Type::I8:   return "i8";
+  case Type::I32:  return "i32";
+  case Type::F32:  return "f32";
+  case Type::Ptr:  return "ptr";
+  }
+  Unreachable("Unknown type.");
+}
+
+namespace {
+
+class FunctionPrinter {
+public:
+  FunctionPrinter(const Module &M, const Function &F, std::ostream &Stream)
+    : mModule(M)
+    , mFunc(F)
+    , mStream(Stream)
+    , mValueNumbers(F.Instrs.size(), NoID)
+    , mBlockNumbers(F.Blocks.size(), NoID) {}
+
+  void Print() {
+    auto Order = ReversePostOrder(mFunc);
+    for (ValueID V : mFunc.Params())
+      mValueNumbers[V] = mNextValue++;
+    for (BlockID BB : Order) {
+      mBlockNumbers[BB] = mNextBlock++;
+      for (ValueID V : mFunc.Blocks[BB].Instrs)
+        if (mFunc.Instrs[V].Ty != Type::Void)
+          mValueNumbers[V] = mNextValue++;
+    }
+
+    mStream << "function " << mFunc.Name() << "(";
+    for (size_t I = 0; I < mFunc.Params().size(); ++I) {
+      ValueID V = mFunc.Params()[I];
+      mStream << (I ? ", " : "") << TypeToString(mFunc.Instrs[V].Ty) << ' ';
+      PrintValue(V);
+    }
+    mStream << ") -> " << TypeToString(mFunc.ReturnType()) << " {\n";
+
+    for (BlockID BB : Order) {
+      mStream << "bb" << mBlockNumbers[BB] << ':';
+      const auto &Preds = mFunc.Blocks[BB].Preds;
+      if (!Preds.empty()) {
+        mStream << " ; preds:";
+        for (BlockID P : Preds)
+          mStream << " bb" << mBlockNumbers[P];
+      }
+      mStream << '\n';
+      for (ValueID V : mFunc.Blocks[BB].Instrs)
+        PrintInstr(V);
+    }
+
+    mStream << "}\n";
+  }
+
+private:
+  void PrintValue(ValueID V) {
+    const Instr &I = mFunc.Instrs[V];
+    if (I.Op == Opcode::Const) {
+      switch (I.Ty) {
+      case Type::I1:  mStream << (I.IntValue() ? "true" : "false"); break;
+      case Type::F32: mStream << I.FloatValue(); break;
+      default:        mStream << I.IntValue(); break;
+      }
+      return;
+    }
+    if (I.Op == Opcode::Undef) {
+      mStream << "undef";
+      return;
+    }
+    mStream << '%' << mValueNumbers[V];
+  }
+
+  void PrintBlock(BlockID BB) {
+    mStream << "bb" << mBlockNumbers[BB];
+  }
+
+  void PrintOperands(const Instr &I) {
+    for (size_t Op = 0; Op < I.Ops.size(); ++Op) {
+      mStream << (Op ? ", " : "");
+      PrintValue(I.Ops[Op]);
+    }
+  }
+
+  void PrintInstr(ValueID V) {
+    const Instr &I = mFunc.Instrs[V];
+    const auto &Succs = mFunc.Blocks[I.Block].Succs;
+
+    mStream << "  ";
+    if (I.Ty != Type::Void) {
+      PrintValue(V);
+      mStream << " = ";
+    }
+    mStream << OpcodeToString(I.Op);
+
+    switch (I.Op) {
+    case Opcode::Alloca:
+      mStream << ' ' << TypeToString(I.ElemTy) << ", " << I.Imm;
+      break;
+    case Opcode::ElemAddr:
+      mStream << ' ' << TypeToString(I.ElemTy) << ' ';
+      PrintOperands(I);
+      break;
+    case Opcode::Load:
+      mStream << ' ' << TypeToString(I.Ty) << ' ';
+      PrintOperands(I);
+      break;
+    case Opcode::Store:
+      mStream << ' ' << TypeToString(mFunc.Instrs[I.Ops[0]].Ty) << ' ';
+      PrintOperands(I);
+      break;
+    case Opcode::ZExt:
+    case Opcode::SExt:
+    case Opcode::UIToFP:
+      mStream << ' ' << TypeToString(mFunc.Instrs[I.Ops[0]].Ty) << ' ';
+      PrintOperands(I);
+      mStream << " to " << TypeToString(I.Ty);
+      break;
+    case Opcode::Phi:
+      mStream << ' ' << TypeToString(I.Ty);
+      for (size_t Op = 0; Op < I.Ops.size(); ++Op) {
+        mStream << (Op ? ", " : " ") << "[ ";
+        PrintValue(I.Ops[Op]);
+        mStream << ", ";
+        PrintBlock(mFunc.Blocks[I.Block].Preds[Op]);
+        mStream << " ]";
+      }
+      break;
+    case Opcode::Call:
+      mStream << ' ' << TypeToString(I.Ty) << " @" << mModule.SymbolName(I.Imm) << '(';
+      PrintOperands(I);
+      mStream << ')';
+      break;
+    case Opcode::Br:
+      mStream << ' ';
+      PrintBlock(Succs[0]);
+      break;
+    case Opcode::CondBr:
+      mStream << ' ';
+      PrintOperands(I);
+      mStream << ", ";
+      PrintBlock(Succs[0]);
+      mStream << ", ";
+      PrintBlock(Succs[1]);
+      break;
+    case Opcode::Ret:
+      if (I.Ops.empty()) {
+        mStream << " void";
+        break;
+      }
+      mStream << ' ' << TypeToString(mFunc.Instrs[I.Ops[0]].Ty) << ' ';
+      PrintOperands(I);
+      break;
+    case Opcode::Trap:
+    case Opcode::Unreachable:
+      break;
+    default:
+      mStream << ' ' << TypeToString(mFunc.Instrs[I.Ops[0]].Ty) << ' ';
+      PrintOperands(I);
+      break;
+    }
+
+    mStream << '\n';
+  }
+
+  const Module &mModule;
+  const Function &mFunc;
+  std::ostream &mStream;
+  std::vector<uint32_t> mValueNumbers;
+  std::vector<uint32_t> mBlockNumbers;
+  uint32_t mNextValue{0U};
+  uint32_t mNextBlock{0U};
+};
+
+} // namespace
+
+void Dump(const Module &M, std::ostream &Stream) {
+  for (size_t I = 0; I < M.Functions.size(); ++I) {
+    if (I > 0)
+      Stream << '\n';
+    FunctionPrinter(M, M.Functions[I], Stream).Print();
+  }
+}
+
+} // namespace weak::ir
\ No newline at end of file
@@ -0,0 +1,128 @@
+/* LICM.cpp - Loop-invariant code motion over Weak IR.
+ * Copyright (C) 2022 epoll-reactor <glibcxx.chrono@gmail.com>
+ *
+ * This file is distributed under the MIT license.
+ */
+
+#include "MiddleEnd/IR/Dominators.h"
+#include "MiddleEnd/IR/Passes.h"
+#include <algorithm>
+#include <map>
+
+namespace weak::ir {
+namespace {
+
+struct Loop {
+  BlockID Header;
+  /// Membership of each block of function.
+  std::vector<bool> Blocks;
+  size_t Size{0U};
+};
+
+/// Find natural loops. Edge is a back edge, if its target dominates
+/// source. All back edges to one header form one loop.
+std::vector<Loop> FindLoops(const Function &F, const DominatorTree &DT) {
+  std::map<BlockID, std::vector<BlockID>> Latches;
+  for (BlockID BB : DT.Order())
+    for (BlockID Succ : F.Blocks[BB].Succs)
+      if (DT.Dominates(Succ, BB))
+        Latches[Succ].push_back(BB);
+
+  std::vector<Loop> Loops;
+  for (auto &[Header, Sources] : Latches) {
+    Loop L{Header, std::vector<bool>(F.Blocks.size()), 1U};
+    L.Blocks[Header] = true;
+    /// Loop body is everything, that reaches latch without passing header.
+    std::vector<BlockID> Worklist = Sources;
+    while (!Worklist.empty()) {
+      BlockID BB = Worklist.back();
+      Worklist.pop_back();
+      if (L.Blocks[BB] || !DT.IsReachable(BB))
+        continue;
+      L.Blocks[BB] = true;
+      ++L.Size;
+      for (BlockID Pred : F.Blocks[BB].Preds)
+        Worklist.push_back(Pred);
+    }
+    Loops.push_back(std::move(L));
+  }
+
+  /// Inner loops are smaller, so they go first, and code, hoisted from
+  /// them, can be hoisted further from outer loops.
+  std::stable_sort(Loops.begin(), Loops.end(), [](const Loop &L, const Loop &R) {
+    return L.Size < R.Size;
+  });
+  return Loops;
+}
+
+/// Get block, that is the only entry to loop and jumps only to header.
+BlockID FindPreheader(const Function &F, const Loop &L) {
+  BlockID Preheader = NoID;
+  for (BlockID Pred : F.Blocks[L.Header].Preds) {
+    if (L.Blocks[Pred])
+      continue;
+    if (Preheader != NoID && Preheader != Pred)
+      return NoID;
+    Preheader = Pred;
+  }
+  if (Preheader == NoID || F.Blocks[Preheader].Succs.size() != 1)
+    return NoID;
+  return Preheader;
+}
+
+/// Whether instruction can be executed even if loop body is never
+/// reached. Division traps on zero divisor and overflow.
+bool IsSafeToSpeculate(const Function &F, const Instr &I) {
+  if (!IsPure(I))
+    return false;
+  if (I.Op != Opcode::SDiv)
+    return true;
+  const Instr &Divisor = F.Instrs[I.Ops[1]];
+  return Divisor.Op == Opcode::Const && Divisor.IntValue() != 0 && Divisor.IntValue() != -1;
+}
+
+class LICM : public Pass {
+public:
+  const char *Name() const override { return "LICM"; }
+
+  unsigned Run(Function &F) override {
+    DominatorTree DT(F);
+    unsigned Changes = 0;
+
+    for (const Loop &L : FindLoops(F, DT)) {
+      BlockID Preheader = FindPreheader(F, L);
+      if (Preheader == NoID)
+        continue;
+
+      auto IsInvariant = [&](ValueID V) {
+        BlockID BB = F.Instrs[V].Block;
+        return BB == NoID || !L.Blocks[BB];
+      };
+
+      /// Blocks are visited after their dominators, so operands are
+      /// hoisted before users.
+      for (BlockID BB : DT.Order()) {
+        if (!L.Blocks[BB])
+          continue;
+        std::vector<ValueID> Instrs = F.Blocks[BB].Instrs;
+        for (ValueID V : Instrs) {
+          const Instr &I = F.Instrs[V];
+          if (!IsSafeToSpeculate(F, I) || !std::all_of(I.Ops.begin(), I.Ops.end(), IsInvariant))
+            continue;
+          F.Move(V, Preheader);
+          ++Changes;
+        }
+      }
+    }
+
+    return Changes;
+  }
+};
+
+} // namespace
+
+std::unique_ptr<Pass> CreateLICMPass() {
+  return std::make_unique<LICM>();
+}
+
+} // namespace weak::ir
\ No newline at end of file
@@ -0,0 +1,195 @@
+/* LLVMEmitter.cpp - Translation of Weak IR to LLVM IR.
+ * Copyright (C) 2022 epoll-reactor <glibcxx.chrono@gmail.com>
+ *
+ * This file is distributed under the MIT license.
+ */
+
+#include "MiddleEnd/IR/LLVMEmitter.h"
+#include "Utility/Unreachable.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/Intrinsics.h"
+#include "llvm/IR/MDBuilder.h"
+#include "llvm/IR/Module.h"
+
+namespace weak::ir {
+namespace {
+
+class LLVMEmitter {
+public:
+  LLVMEmitter(const Module &M, const Function &F, llvm::Function *Func)
+    : mModule(M)
+    , mFunc(F)
+    , mLLVMFunc(Func)
+    , mIRBuilder(Func->getContext())
+    , mValues(F.Instrs.size())
+    , mBlocks(F.Blocks.size()) {}
+
+  void Emit() {
+    llvm::LLVMContext &Ctx = mLLVMFunc->getContext();
+    auto Order = ReversePostOrder(mFunc);
+
+    for (BlockID BB : Order)
+      mBlocks[BB] = llvm::BasicBlock::Create(Ctx, BB == 0 ? "entry" : "bb", mLLVMFunc);
+
+    for (size_t I = 0; I < mFunc.Params().size(); ++I)
+      mValues[mFunc.Params()[I]] = mLLVMFunc->getArg(I);
+
+    /// φ-nodes can refer to values, defined later, so create them first.
+    for (BlockID BB : Order) {
+      mIRBuilder.SetInsertPoint(mBlocks[BB]);
+      for (ValueID V : mFunc.Blocks[BB].Instrs)
+        if (mFunc.Instrs[V].Op == Opcode::Phi)
+          mValues[V] = mIRBuilder.CreatePHI(ResolveType(mFunc.Instrs[V].Ty), mFunc.Blocks[BB].Preds.size());
+    }
+
+    for (BlockID BB : Order) {
+      mIRBuilder.SetInsertPoint(mBlocks[BB]);
+      for (ValueID V : mFunc.Blocks[BB].Instrs)
+        if (mFunc.Instrs[V].Op != Opcode::Phi)
+          mValues[V] = EmitInstr(mFunc.Instrs[V]);
+    }
+
+    for (BlockID BB : Order) {
+      const auto &Preds = mFunc.Blocks[BB].Preds;
+      for (ValueID V : mFunc.Blocks[BB].Instrs) {
+        const Instr &I = mFunc.Instrs[V];
+        if (I.Op != Opcode::Phi)
+          break;
+        auto *Phi = llvm::cast<llvm::PHINode>(mValues[V]);
+        for (size_t Op = 0; Op < I.Ops.size(); ++Op)
+          Phi->addIncoming(Get(I.Ops[Op]), mBlocks[Preds[Op]]);
+      }
+    }
+  }
+
+private:
+  llvm::Type *ResolveType(Type Ty) {
+    switch (Ty) {
+    case Type::Void: return mIRBuilder.getVoidTy();
+    case Type::I1:   return mIRBuilder.getInt1Ty();
+    case Type::I8:   return mIRBuilder.getInt8Ty();
+    case Type::I32:  return mIRBuilder.getInt32Ty();
+    case Type::F32:  return mIRBuilder.getFloatTy();
+    default:         Unreachable("Pointers are typed by their element.");
+    }
+  }
+
+  llvm::Value *Get(ValueID V) {
+    if (mValues[V])
+      return mValues[V];
+
+    const Instr &I = mFunc.Instrs[V];
+    switch (I.Op) {
+    case Opcode::Const:
+      if (I.Ty == Type::F32)
+        mValues[V] = llvm::ConstantFP::get(mIRBuilder.getFloatTy(), I.FloatValue());
+      else
+        mValues[V] = llvm::ConstantInt::get(ResolveType(I.Ty), I.IntValue(), /*isSigned=*/I.Ty != Type::I1);
+      break;
+    case Opcode::Undef:
+      mValues[V] = llvm::UndefValue::get(ResolveType(I.Ty));
+      break;
+    default:
+      Unreachable("Value used before definition.");
+    }
+    return mValues[V];
+  }
+
+  static bool IsTrapBlock(const Function &F, BlockID BB) {
+    const auto &Instrs = F.Blocks[BB].Instrs;
+    return Instrs.size() == 1 && F.Instrs[Instrs[0]].Op == Opcode::Trap;
+  }
+
+  llvm::Value *EmitInstr(const Instr &I) {
+    auto &B = mIRBuilder;
+    auto Op = [&](size_t N) { return Get(I.Ops[N]); };
+    const auto &Succs = mFunc.Blocks[I.Block].Succs;
+
+    switch (I.Op) {
+    case Opcode::Add:     return B.CreateAdd(Op(0), Op(1));
+    case Opcode::Sub:     return B.CreateSub(Op(0), Op(1));
+    case Opcode::Mul:     return B.CreateMul(Op(0), Op(1));
+    case Opcode::SDiv:    return B.CreateSDiv(Op(0), Op(1));
+    case Opcode::Shl:     return B.CreateShl(Op(0), Op(1));
+    case Opcode::AShr:    return B.CreateAShr(Op(0), Op(1));
+    case Opcode::And:     return B.CreateAnd(Op(0), Op(1));
+    case Opcode::Or:      return B.CreateOr(Op(0), Op(1));
+    case Opcode::Xor:     return B.CreateXor(Op(0), Op(1));
+    case Opcode::FAdd:    return B.CreateFAdd(Op(0), Op(1));
+    case Opcode::FSub:    return B.CreateFSub(Op(0), Op(1));
+    case Opcode::FMul:    return B.CreateFMul(Op(0), Op(1));
+    case Opcode::FDiv:    return B.CreateFDiv(Op(0), Op(1));
+    case Opcode::ICmpEQ:  return B.CreateICmpEQ(Op(0), Op(1));
+    case Opcode::ICmpNE:  return B.CreateICmpNE(Op(0), Op(1));
+    case Opcode::ICmpSLT: return B.CreateICmpSLT(Op(0), Op(1));
+    case Opcode::ICmpSLE: return B.CreateICmpSLE(Op(0), Op(1));
+    case Opcode::ICmpSGT: return B.CreateICmpSGT(Op(0), Op(1));
+    case Opcode::ICmpSGE: return B.CreateICmpSGE(Op(0), Op(1));
+    case Opcode::ICmpULT: return B.CreateICmpULT(Op(0), Op(1));
+    case Opcode::FCmpOEQ: return B.CreateFCmpOEQ(Op(0), Op(1));
+    case Opcode::FCmpONE: return B.CreateFCmpONE(Op(0), Op(1));
+    case Opcode::FCmpOLT: return B.CreateFCmpOLT(Op(0), Op(1));
+    case Opcode::FCmpOLE: return B.CreateFCmpOLE(Op(0), Op(1));
+    case Opcode::FCmpOGT: return B.CreateFCmpOGT(Op(0), Op(1));
+    case Opcode::FCmpOGE: return B.CreateFCmpOGE(Op(0), Op(1));
+    case Opcode::FCmpUNE: return B.CreateFCmpUNE(Op(0), Op(1));
+    case Opcode::ZExt:    return B.CreateZExt(Op(0), ResolveType(I.Ty));
+    case Opcode::SExt:    return B.CreateSExt(Op(0), ResolveType(I.Ty));
+    case Opcode::UIToFP:  return B.CreateUIToFP(Op(0), ResolveType(I.Ty));
+    case Opcode::Alloca:
+      return B.CreateAlloca(ResolveType(I.ElemTy), B.getInt32(I.Imm));
+    case Opcode::ElemAddr:
+      return B.CreateInBoundsGEP(ResolveType(I.ElemTy), Op(0), Op(1));
+    case Opcode::Load:
+      return B.CreateLoad(ResolveType(I.Ty), Op(0));
+    case Opcode::Store:
+      return B.CreateStore(Op(0), Op(1));
+    case Opcode::Call: {
+      llvm::Function *Callee = mLLVMFunc->getParent()->getFunction(mModule.SymbolName(I.Imm));
+      llvm::SmallVector<llvm::Value *, 8> Args;
+      for (size_t N = 0; N < I.Ops.size(); ++N)
+        Args.push_back(Op(N));
+      llvm::CallInst *Call = B.CreateCall(Callee, Args);
+      Call->setCallingConv(Callee->getCallingConv());
+      return Call;
+    }
+    case Opcode::Br:
+      return B.CreateBr(mBlocks[Succs[0]]);
+    case Opcode::CondBr:
+      /// Out of range index is exceptional situation.
+      if (IsTrapBlock(mFunc, Succs[1]))
+        return B.CreateCondBr(
+          Op(0),
+          mBlocks[Succs[0]],
+          mBlocks[Succs[1]],
+          llvm::MDBuilder(B.getContext()).createBranchWeights(1U << 20U, 1U)
+        );
+      return B.CreateCondBr(Op(0), mBlocks[Succs[0]], mBlocks[Succs[1]]);
+    case Opcode::Ret:
+      return I.Ops.empty() ? B.CreateRetVoid() : B.CreateRet(Op(0));
+    case Opcode::Trap:
+      B.CreateIntrinsic(llvm::Intrinsic::trap, {}, {});
+      return B.CreateUnreachable();
+    case Opcode::Unreachable:
+      return B.CreateUnreachable();
+    default:
+      Unreachable("Unexpected instruction in block.");
+    }
+  }
+
+  const Module &mModule;
+  const Function &mFunc;
+  llvm::Function *mLLVMFunc;
+  llvm::IRBuilder<> mIRBuilder;
+  std::vector<llvm::Value *> mValues;
+  std::vector<llvm::BasicBlock *> mBlocks;
+};
+
+} // namespace
+
+void EmitLLVMFunctionBody(const Module &M, const Function &F, llvm::Function *Func) {
+  LLVMEmitter(M, F, Func).Emit();
+}
+
+} // namespace weak::ir
\ No newline at end of file
@@ -0,0 +1,42 @@
+/* PassManager.cpp - Pipeline of Weak IR optimization passes.
+ * Copyright (C) 2022 epoll-reactor <glibcxx.chrono@gmail.com>
+ *
+ * This file is distributed under the MIT license.
+ */
+
+#include "MiddleEnd/IR/Passes.h"
+#include <iomanip>
+
+namespace weak::ir {
+
+void PassStats::Dump(std::ostream &Stream) const {
+  Stream << "Weak IR passes:\n";
+  for (const auto &[Name, Count] : Changes)
+    Stream << "  " << std::left << std::setw(22) << (std::string(Name) + ':') << Count << '\n';
+}
+
+void PassManager::Add(std::unique_ptr<Pass> P) {
+  mPasses.push_back(std::move(P));
+}
+
+PassStats PassManager::Run(Module &M) {
+  PassStats Stats;
+  for (const auto &P : mPasses) {
+    unsigned Changes = 0;
+    for (Function &F : M.Functions)
+      Changes += P->Run(F);
+    Stats.Changes.emplace_back(P->Name(), Changes);
+  }
+  return Stats;
+}
+
+PassStats RunDefaultPasses(Module &M) {
+  PassManager PM;
+  PM.Add(CreateSCCPPass());
+  PM.Add(CreateGVNPass());
+  PM.Add(CreateLICMPass());
+  PM.Add(CreateDCEPass());
+  return PM.Run(M);
+}
+
+} // namespace weak::ir
\ No newline at end of file
@@ -0,0 +1,329 @@
+/* SCCP.cpp - Sparse conditional constant propagation over Weak IR.
+ * Copyright (C) 2022 epoll-reactor <glibcxx.chrono@gmail.com>
+ *
+ * This file is distributed under the MIT license.
+ */
+
+#include "MiddleEnd/IR/Passes.h"
+#include <cmath>
+#include <set>
+
+namespace weak::ir {
+namespace {
+
+unsigned BitWidth(Type Ty) {
+  switch (Ty) {
+  case Type::I1: return 1U;
+  case Type::I8: return 8U;
+  default:       return 32U;
+  }
+}
+
+/// Value as signed integer of its width. Unlike Instr::IntValue(), true
+/// of I1 type is -1.
+int64_t SignedValue(const Instr &I) {
+  return I.Ty == Type::I1 ? -I.IntValue() : I.IntValue();
+}
+
+uint64_t UnsignedValue(const Instr &I) {
+  return static_cast<uint64_t>(I.IntValue()) & ((1ULL << BitWidth(I.Ty)) - 1);
+}
+
+/// Evaluate instruction with constant operands with the same semantics,
+/// as LLVM has. Operations with undefined or poison result are not folded.
+///
+/// \return Constant or NoID if result is not known.
+ValueID Fold(Function &F, const Instr &I) {
+  const Instr &A = F.Instrs[I.Ops[0]];
+
+  switch (I.Op) {
+  case Opcode::ZExt:
+    return F.GetConst(I.Ty, UnsignedValue(A));
+  case Opcode::SExt:
+    return F.GetConst(I.Ty, SignedValue(A));
+  case Opcode::UIToFP:
+    return F.GetFloatConst(static_cast<float>(UnsignedValue(A)));
+  default:
+    break;
+  }
+
+  const Instr &B = F.Instrs[I.Ops[1]];
+
+  if (A.Ty == Type::F32) {
+    float L = A.FloatValue();
+    float R = B.FloatValue();
+    bool Ordered = !std::isnan(L) && !std::isnan(R);
+
+    switch (I.Op) {
+    case Opcode::FAdd:    return F.GetFloatConst(L + R);
+    case Opcode::FSub:    return F.GetFloatConst(L - R);
+    case Opcode::FMul:    return F.GetFloatConst(L * R);
+    case Opcode::FDiv:    return F.GetFloatConst(L / R);
+    case Opcode::FCmpOEQ: return F.GetConst(Type::I1, L == R);
+    case Opcode::FCmpONE: return F.GetConst(Type::I1, Ordered && L != R);
+    case Opcode::FCmpOLT: return F.GetConst(Type::I1, L < R);
+    case Opcode::FCmpOLE: return F.GetConst(Type::I1, L <= R);
+    case Opcode::FCmpOGT: return F.GetConst(Type::I1, L > R);
+    case Opcode::FCmpOGE: return F.GetConst(Type::I1, L >= R);
+    case Opcode::FCmpUNE: return F.GetConst(Type::I1, L != R);
+    default:              return NoID;
+    }
+  }
+
+  int64_t L = SignedValue(A);
+  int64_t R = SignedValue(B);
+  int64_t Min = -(int64_t(1) << (BitWidth(A.Ty) - 1));
+
+  switch (I.Op) {
+  case Opcode::Add: return F.GetConst(I.Ty, L + R);
+  case Opcode::Sub: return F.GetConst(I.Ty, L - R);
+  case Opcode::Mul: return F.GetConst(I.Ty, L * R);
+  case Opcode::And: return F.GetConst(I.Ty, L & R);
+  case Opcode::Or:  return F.GetConst(I.Ty, L | R);
+  case Opcode::Xor: return F.GetConst(I.Ty, L ^ R);
+  case Opcode::SDiv:
+    if (R == 0 || (L == Min && R == -1))
+      return NoID;
+    return F.GetConst(I.Ty, L / R);
+  case Opcode::Shl:
+    if (UnsignedValue(B) >= BitWidth(A.Ty))
+      return NoID;
+    return F.GetConst(I.Ty, static_cast<int64_t>(UnsignedValue(A) << UnsignedValue(B)));
+  case Opcode::AShr:
+    if (UnsignedValue(B) >= BitWidth(A.Ty))
+      return NoID;
+    return F.GetConst(I.Ty, L >> UnsignedValue(B));
+  case Opcode::ICmpEQ:  return F.GetConst(Type::I1, L == R);
+  case Opcode::ICmpNE:  return F.GetConst(Type::I1, L != R);
+  case Opcode::ICmpSLT: return F.GetConst(Type::I1, L < R);
+  case Opcode::ICmpSLE: return F.GetConst(Type::I1, L <= R);
+  case Opcode::ICmpSGT: return F.GetConst(Type::I1, L > R);
+  case Opcode::ICmpSGE: return F.GetConst(Type::I1, L >= R);
+  case Opcode::ICmpULT: return F.GetConst(Type::I1, UnsignedValue(A) < UnsignedValue(B));
+  default:              return NoID;
+  }
+}
+
+class SCCPSolver {
+public:
+  explicit SCCPSolver(Function &F)
+    : mFunc(F)
+    , mStates(F.Instrs.size())
+    , mUsers(F.Instrs.size())
+    , mExecutable(F.Blocks.size()) {
+    for (const Block &BB : F.Blocks)
+      for (ValueID V : BB.Instrs)
+        for (ValueID Op : F.Instrs[V].Ops)
+          mUsers[Op].push_back(V);
+  }
+
+  unsigned Run() {
+    Solve();
+
+    unsigned Changes = 0;
+    std::vector<ValueID> Replacements(mFunc.Instrs.size(), NoID);
+    std::vector<ValueID> Replaced;
+
+    for (BlockID BB = 0; BB < mFunc.Blocks.size(); ++BB) {
+      if (!mExecutable[BB])
+        continue;
+      for (ValueID V : mFunc.Blocks[BB].Instrs) {
+        if (V >= mStates.size() || mStates[V].State != CONSTANT)
+          continue;
+        Replacements[V] = mStates[V].Const;
+        Replaced.push_back(V);
+      }
+    }
+
+    mFunc.ReplaceUses(Replacements);
+    for (ValueID V : Replaced)
+      mFunc.Erase(V);
+    Changes += Replaced.size();
+
+    for (BlockID BB = 0; BB < mFunc.Blocks.size(); ++BB) {
+      if (!mExecutable[BB])
+        continue;
+      ValueID Term = mFunc.Terminator(BB);
+      Instr &I = mFunc.Instrs[Term];
+      if (I.Op != Opcode::CondBr || mFunc.Instrs[I.Ops[0]].Op != Opcode::Const)
+        continue;
+      const auto &Succs = mFunc.Blocks[BB].Succs;
+      BlockID NotTaken = mFunc.Instrs[I.Ops[0]].IntValue() ? Succs[1] : Succs[0];
+      mFunc.RemoveEdge(BB, NotTaken);
+      I.Op = Opcode::Br;
+      I.Ops.clear();
+      ++Changes;
+    }
+
+    for (BlockID BB = 0; BB < mFunc.Blocks.size(); ++BB) {
+      if (mExecutable[BB] || mFunc.Blocks[BB].Removed)
+        continue;
+      mFunc.RemoveBlock(BB);
+      ++Changes;
+    }
+
+    return Changes;
+  }
+
+private:
+  enum StateKind {
+    /// Not reached yet, may become anything.
+    UNKNOWN,
+    CONSTANT,
+    OVERDEFINED
+  };
+
+  struct LatticeValue {
+    StateKind State{UNKNOWN};
+    ValueID Const{NoID};
+  };
+
+  LatticeValue Get(ValueID V) const {
+    switch (mFunc.Instrs[V].Op) {
+    case Opcode::Const:
+      return {CONSTANT, V};
+    case Opcode::Param:
+    case Opcode::Undef:
+      return {OVERDEFINED, NoID};
+    default:
+      return V < mStates.size() ? mStates[V] : LatticeValue{OVERDEFINED, NoID};
+    }
+  }
+
+  /// Lower value in lattice. Values can only go down, so each one is
+  /// changed at most twice.
+  void Set(ValueID V, LatticeValue New) {
+    LatticeValue &Old = mStates[V];
+    if (Old.State == New.State && Old.Const == New.Const)
+      return;
+    if (Old.State == OVERDEFINED)
+      return;
+    if (Old.State == CONSTANT && New.State != OVERDEFINED)
+      New = {OVERDEFINED, NoID};
+    Old = New;
+    mSSAWork.push_back(V);
+  }
+
+  void MarkEdge(BlockID From, BlockID To) {
+    if (mExecutableEdges.insert({From, To}).second)
+      mFlowWork.push_back(To);
+  }
+
+  void Solve() {
+    mExecutable[0] = true;
+    for (ValueID V : mFunc.Blocks[0].Instrs)
+      Visit(V);
+
+    while (!mFlowWork.empty() || !mSSAWork.empty()) {
+      while (!mFlowWork.empty()) {
+        BlockID BB = mFlowWork.back();
+        mFlowWork.pop_back();
+        /// New edge to already executable block can only change φ-nodes.
+        bool OnlyPhis = mExecutable[BB];
+        mExecutable[BB] = true;
+        for (ValueID V : mFunc.Blocks[BB].Instrs)
+          if (!OnlyPhis || mFunc.Instrs[V].Op == Opcode::Phi)
+            Visit(V);
+      }
+
+      while (!mSSAWork.empty()) {
+        ValueID V = mSSAWork.back();
+        mSSAWork.pop_back();
+        for (ValueID User : mUsers[V])
+          if (mExecutable[mFunc.Instrs[User].Block])
+            Visit(User);
+      }
+    }
+  }
+
+  void Visit(ValueID V) {
+    const Instr &I = mFunc.Instrs[V];
+    BlockID BB = I.Block;
+
+    switch (I.Op) {
+    case Opcode::Phi: {
+      LatticeValue Result;
+      const auto &Preds = mFunc.Blocks[BB].Preds;
+      for (size_t Op = 0; Op < I.Ops.size(); ++Op) {
+        if (!mExecutableEdges.count({Preds[Op], BB}))
+          continue;
+        LatticeValue In = Get(I.Ops[Op]);
+        if (In.State == UNKNOWN)
+          continue;
+        if (In.State == OVERDEFINED || (Result.State == CONSTANT && Result.Const != In.Const)) {
+          Result = {OVERDEFINED, NoID};
+          break;
+        }
+        Result = In;
+      }
+      if (Result.State != UNKNOWN)
+        Set(V, Result);
+      return;
+    }
+    case Opcode::Br:
+      MarkEdge(BB, mFunc.Blocks[BB].Succs[0]);
+      return;
+    case Opcode::CondBr: {
+      LatticeValue Cond = Get(I.Ops[0]);
+      const auto Succs = mFunc.Blocks[BB].Succs;
+      if (Cond.State == OVERDEFINED) {
+        MarkEdge(BB, Succs[0]);
+        MarkEdge(BB, Succs[1]);
+      } else if (Cond.State == CONSTANT)
+        MarkEdge(BB, mFunc.Instrs[Cond.Const].IntValue() ? Succs[0] : Succs[1]);
+      return;
+    }
+    default:
+      break;
+    }
+
+    if (I.Ty == Type::Void)
+      return;
+
+    if (!IsPure(I) || I.Op == Opcode::ElemAddr) {
+      Set(V, {OVERDEFINED, NoID});
+      return;
+    }
+
+    /// Folding may create new constant and reallocate instructions.
+    Instr Copy = I;
+    for (ValueID &Op : Copy.Ops) {
+      LatticeValue In = Get(Op);
+      if (In.State == OVERDEFINED) {
+        Set(V, In);
+        return;
+      }
+      if (In.State == UNKNOWN)
+        return;
+      Op = In.Const;
+    }
+
+    ValueID Const = Fold(mFunc, Copy);
+    Set(V, Const == NoID ? LatticeValue{OVERDEFINED, NoID} : LatticeValue{CONSTANT, Const});
+  }
+
+  Function &mFunc;
+  std::vector<LatticeValue> mStates;
+  std::vector<std::vector<ValueID>> mUsers;
+  std::vector<bool> mExecutable;
+  std::set<std::pair<BlockID, BlockID>> mExecutableEdges;
+  std::vector<ValueID> mSSAWork;
+  std::vector<BlockID> mFlowWork;
+};
+
+class SCCP : public Pass {
+public:
+  const char *Name() const override { return "SCCP"; }
+
+  unsigned Run(Function &F) override {
+    return SCCPSolver(F).Run();
+  }
+};
+
+} // namespace
+
+std::unique_ptr<Pass> CreateSCCPPass() {
+  return std::make_unique<SCCP>();
+}
+
+} // namespace weak::ir
\ No newline at end of file
@@ -0,0 +1,327 @@
+/* BoundsCheckElimination.cpp - Proving array accesses to be in bounds.
+ * Copyright (C) 2022 epoll-reactor <glibcxx.chrono@gmail.com>
+ *
+ * This file is distributed under the MIT license.
+ */
+
+#include "MiddleEnd/Optimizers/BoundsCheckElimination.h"
+#include "FrontEnd/AST/AST.h"
+#include "FrontEnd/AST/ASTVisitor.h"
+#include "FrontEnd/Analysis/ASTStorage.h"
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <unordered_map>
+
+namespace weak {
+namespace {
+
+/// Closed interval of values, that expression can take.
+struct Interval {
+  int64_t Lo;
+  int64_t Hi;
+};
+
+bool FitsInt(int64_t Value) {
+  return Value >= std::numeric_limits<int32_t>::min() &&
+         Value <= std::numeric_limits<int32_t>::max();
+}
+
+std::optional<Interval> MakeInterval(int64_t Lo, int64_t Hi) {
+  /// Out of 32-bit range operations wrap around, so nothing is known.
+  if (!FitsInt(Lo) || !FitsInt(Hi))
+    return std::nullopt;
+  return Interval{Lo, Hi};
+}
+
+/// Find any change of variable value inside statement.
+class AssignmentFinder : private ASTVisitor {
+public:
+  bool Find(ASTNode *Stmt, const std::string &Name) {
+    mName = &Name;
+    mFound = false;
+    Stmt->Accept(this);
+    return mFound;
+  }
+
+private:
+  void Visit(ASTBinary *Stmt) override {
+    ASTVisitor::Visit(Stmt);
+    switch (Stmt->Operation()) {
+    case TOK_ASSIGN:
+    case TOK_MUL_ASSIGN:
+    case TOK_DIV_ASSIGN:
+    case TOK_MOD_ASSIGN:
+    case TOK_PLUS_ASSIGN:
+    case TOK_MINUS_ASSIGN:
+    case TOK_SHL_ASSIGN:
+    case TOK_SHR_ASSIGN:
+    case TOK_BIT_AND_ASSIGN:
+    case TOK_BIT_OR_ASSIGN:
+    case TOK_XOR_ASSIGN:
+      Check(Stmt->LHS());
+      break;
+    default:
+      break;
+    }
+  }
+
+  void Visit(ASTUnary *Stmt) override {
+    ASTVisitor::Visit(Stmt);
+    Check(Stmt->Operand());
+  }
+
+  void Visit(ASTMemberAccess *) override {}
+
+  void Check(ASTNode *Target) {
+    if (Target->Is(AST_SYMBOL) && static_cast<ASTSymbol *>(Target)->Name() == *mName)
+      mFound = true;
+  }
+
+  const std::string *mName{nullptr};
+  bool mFound{false};
+};
+
+class RangeAnalyzer : private ASTVisitor {
+public:
+  RangeAnalyzer(BoundsCheckEliminationStats &Stats)
+    : mStats(Stats) {}
+
+  void Run(ASTNode *Root) {
+    Root->Accept(this);
+  }
+
+private:
+  void Visit(ASTCompound *Stmt) override {
+    mStorage.StartScope();
+    ASTVisitor::Visit(Stmt);
+    mStorage.EndScope();
+  }
+
+  void Visit(ASTFunctionDecl *Decl) override {
+    mStorage.StartScope();
+    ASTVisitor::Visit(Decl);
+    mStorage.EndScope();
+  }
+
+  void Visit(ASTArrayDecl *Decl) override {
+    mStorage.Push(Decl->Name(), Decl);
+  }
+
+  void Visit(ASTVarDecl *Decl) override {
+    ASTVisitor::Visit(Decl);
+    mStorage.Push(Decl->Name(), Decl);
+  }
+
+  void Visit(ASTFor *Stmt) override {
+    mStorage.StartScope();
+
+    if (auto *I = Stmt->Init())
+      I->Accept(this);
+    if (auto *C = Stmt->Condition())
+      C->Accept(this);
+    if (auto *I = Stmt->Increment())
+      I->Accept(this);
+
+    const std::string *Induction = InductionVariable(Stmt);
+    if (Induction)
+      mRanges[*Induction] = *InductionRange(Stmt);
+
+    Stmt->Body()->Accept(this);
+
+    if (Induction)
+      mRanges.erase(*Induction);
+
+    mStorage.EndScope();
+  }
+
+  void Visit(ASTArrayAccess *Stmt) override {
+    ASTVisitor::Visit(Stmt);
+
+    auto *Record = mStorage.Lookup(Stmt->Name());
+    if (!Record || !Record->AST->Is(AST_ARRAY_DECL))
+      return;
+
+    const auto &ArityList = static_cast<ASTArrayDecl *>(Record->AST)->ArityList();
+    const auto &Indices = Stmt->Indices();
+
+    bool InBounds = Indices.size() <= ArityList.size();
+    for (size_t Dim = 0; InBounds && Dim < Indices.size(); ++Dim) {
+      auto Range = RangeOf(Indices[Dim]);
+      InBounds = Range && Range->Lo >= 0 && Range->Hi < ArityList[Dim];
+    }
+
+    Stmt->SetInBounds(InBounds);
+
+    if (InBounds)
+      ++mStats.EliminatedChecks;
+    else
+      ++mStats.EmittedChecks;
+  }
+
+  // Nothing to analyze there.
+  void Visit(ASTFunctionPrototype *) override {}
+  void Visit(ASTStructDecl *) override {}
+  void Visit(ASTMemberAccess *) override {}
+
+  std::optional<Interval> RangeOf(ASTNode *Expr) {
+    if (Expr->Is(AST_INTEGER_LITERAL)) {
+      signed V = static_cast<ASTNumber *>(Expr)->Value();
+      return Interval{V, V};
+    }
+
+    if (Expr->Is(AST_SYMBOL)) {
+      auto It = mRanges.find(static_cast<ASTSymbol *>(Expr)->Name());
+      if (It == mRanges.end())
+        return std::nullopt;
+      return It->second;
+    }
+
+    if (!Expr->Is(AST_BINARY))
+      return std::nullopt;
+
+    auto *Binary = static_cast<ASTBinary *>(Expr);
+    auto L = RangeOf(Binary->LHS());
+    auto R = RangeOf(Binary->RHS());
+    if (!L || !R)
+      return std::nullopt;
+
+    switch (Binary->Operation()) {
+    case TOK_PLUS:
+      return MakeInterval(L->Lo + R->Lo, L->Hi + R->Hi);
+    case TOK_MINUS:
+      return MakeInterval(L->Lo - R->Hi, L->Hi - R->Lo);
+    case TOK_STAR: {
+      int64_t Products[] = {
+        L->Lo * R->Lo, L->Lo * R->Hi,
+        L->Hi * R->Lo, L->Hi * R->Hi
+      };
+      return MakeInterval(
+        *std::min_element(std::begin(Products), std::end(Products)),
+        *std::max_element(std::begin(Products), std::end(Products))
+      );
+    }
+    default:
+      return std::nullopt;
+    }
+  }
+
+  /// Get name of variable in loops like
+  /// for (int i = A; i < B; ++i), for (int i = A; i <= B; i += C),
+  /// where i is not changed in loop body, A and B has known ranges,
+  /// and C is positive literal. Induction variable is in [A, B) there.
+  const std::string *InductionVariable(ASTFor *Stmt) {
+    auto *Init = Stmt->Init();
+    if (!Init || !Init->Is(AST_VAR_DECL))
+      return nullptr;
+
+    auto *Decl = static_cast<ASTVarDecl *>(Init);
+    if (Decl->DataType() != DT_INT || !Decl->Body())
+      return nullptr;
+
+    const std::string &Name = Decl->Name();
+    if (!IsIncrementOf(Stmt->Increment(), Name))
+      return nullptr;
+
+    if (AssignmentFinder().Find(Stmt->Body(), Name))
+      return nullptr;
+
+    if (!InductionRange(Stmt))
+      return nullptr;
+
+    return &Name;
+  }
+
+  std::optional<Interval> InductionRange(ASTFor *Stmt) {
+    auto *Decl = static_cast<ASTVarDecl *>(Stmt->Init());
+    auto Start = RangeOf(Decl->Body());
+
+    auto *Cond = Stmt->Condition();
+    if (!Start || !Cond || !Cond->Is(AST_BINARY))
+      return std::nullopt;
+
+    auto *Cmp = static_cast<ASTBinary *>(Cond);
+    auto *LHS = Cmp->LHS();
+    if (!LHS->Is(AST_SYMBOL) || static_cast<ASTSymbol *>(LHS)->Name() != Decl->Name())
+      return std::nullopt;
+
+    auto Bound = RangeOf(Cmp->RHS());
+    if (!Bound)
+      return std::nullopt;
+
+    int64_t Hi = 0;
+    switch (Cmp->Operation()) {
+    case TOK_LT: Hi = Bound->Hi - 1; break;
+    case TOK_LE: Hi = Bound->Hi;     break;
+    default:     return std::nullopt;
+    }
+
+    /// Increment of the last value should not overflow, otherwise
+    /// variable wraps around and condition is still true.
+    if (!FitsInt(Hi + IncrementStep(Stmt->Increment())))
+      return std::nullopt;
+
+    return Interval{Start->Lo, Hi};
+  }
+
+  static bool IsIncrementOf(ASTNode *Incr, const std::string &Name) {
+    if (!Incr)
+      return false;
+
+    ASTNode *Target = nullptr;
+
+    if (Incr->Is(AST_PREFIX_UNARY) || Incr->Is(AST_POSTFIX_UNARY)) {
+      auto *U = static_cast<ASTUnary *>(Incr);
+      if (U->Operation() != TOK_INC)
+        return false;
+      Target = U->Operand();
+    }
+
+    if (Incr->Is(AST_BINARY)) {
+      auto *B = static_cast<ASTBinary *>(Incr);
+      if (B->Operation() != TOK_PLUS_ASSIGN || !B->RHS()->Is(AST_INTEGER_LITERAL))
+        return false;
+      if (static_cast<ASTNumber *>(B->RHS())->Value() <= 0)
+        return false;
+      Target = B->LHS();
+    }
+
+    return Target &&
+           Target->Is(AST_SYMBOL) &&
+           static_cast<ASTSymbol *>(Target)->Name() == Name;
+  }
+
+  static int64_t IncrementStep(ASTNode *Incr) {
+    if (Incr->Is(AST_BINARY))
+      return static_cast<ASTNumber *>(static_cast<ASTBinary *>(Incr)->RHS())->Value();
+    return 1;
+  }
+
+  BoundsCheckEliminationStats &mStats;
+
+  /// Array declarations.
+  ASTStorage mStorage;
+
+  /// Induction variables of loops we are currently inside.
+  std::unordered_map<std::string, Interval> mRanges;
+};
+
+} // namespace
+} // namespace weak
+
+namespace weak {
+
+void BoundsCheckEliminationStats::Dump(std::ostream &Stream) const {
+  Stream << "Bounds check elimination:\n"
+         << "  eliminated checks: " << EliminatedChecks << '\n'
+         << "  emitted checks:    " << EmittedChecks << '\n';
+}
+
+BoundsCheckEliminationStats RunBoundsCheckEliminationPass(ASTNode *Root) {
+  BoundsCheckEliminationStats Stats;
+  RangeAnalyzer(Stats).Run(Root);
+  return Stats;
+}
+
+} // namespace weak
\ No newline at end of file
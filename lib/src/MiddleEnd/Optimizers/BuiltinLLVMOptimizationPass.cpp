@@ -5,16 +5,99 @@
  */
 
 #include "MiddleEnd/Optimizers/Optimizers.h"
-#include "llvm/IR/LegacyPassManager.h"
+#include "Utility/Diagnostic.h"
+#include "Utility/Unreachable.h"
+#include "llvm/IR/DiagnosticHandler.h"
+#include "llvm/IR/DiagnosticInfo.h"
 #include "llvm/IR/Module.h"
-#include "llvm/Transforms/IPO/PassManagerBuilder.h"
+#include "llvm/Passes/PassBuilder.h"
 
-void weak::RunBuiltinLLVMOptimizationPass(llvm::Module &IRModule, WeakOptimizationLevel OptLvl) {
-  llvm::legacy::FunctionPassManager FPM(&IRModule);
-  llvm::PassManagerBuilder PassBuilder;
-  PassBuilder.OptLevel = static_cast<unsigned>(OptLvl);
-  PassBuilder.populateFunctionPassManager(FPM);
+namespace {
 
-  for (auto &Func : IRModule.getFunctionList())
-    FPM.run(Func);
+/// Turn LLVM warnings about loop hints, that optimizer was unable to
+/// honor, to compiler warnings. Everything else is reported by LLVM itself.
+struct MissedLoopHintsHandler : public llvm::DiagnosticHandler {
+  bool handleDiagnostics(const llvm::DiagnosticInfo &DI) override {
+    const auto *Failure = llvm::dyn_cast<llvm::DiagnosticInfoOptimizationFailure>(&DI);
+    if (!Failure)
+      return false;
+
+    weak::CompileWarning()
+      << "In function `" << Failure->getFunction().getName().str() << "`: "
+      << Failure->getMsg();
+    return true;
+  }
+};
+
+llvm::OptimizationLevel ToLLVMOptLevel(WeakOptimizationLevel OptLvl) {
+  switch (OptLvl) {
+  case O1: return llvm::OptimizationLevel::O1;
+  case O2: return llvm::OptimizationLevel::O2;
+  case O3: return llvm::OptimizationLevel::O3;
+  case Os: return llvm::OptimizationLevel::Os;
+  case Oz: return llvm::OptimizationLevel::Oz;
+  default: Unreachable("Unexpected optimization level.");
+  }
+}
+
+} // namespace
+
+void weak::RunBuiltinLLVMOptimizationPass(
+  llvm::Module          &IRModule,
+  WeakOptimizationLevel  OptLvl,
+  llvm::TargetMachine   *TM,
+  LTOKind                LTO
+) {
+  if (OptLvl == O0)
+    return;
+
+  /// Loop passes, that honor `llvm.loop` hints, are part of default
+  /// pipeline. Vectorization is forced by hints even if disabled here.
+  /// Same tuning as in clang: -Oz does not vectorize at all.
+  llvm::PipelineTuningOptions Tuning;
+  Tuning.LoopVectorization = OptLvl >= O2 && OptLvl != Oz;
+  Tuning.SLPVectorization = OptLvl >= O2 && OptLvl != Oz;
+  Tuning.LoopUnrolling = OptLvl >= O2;
+
+  /// Size levels affect passes mostly through function attributes.
+  for (llvm::Function &F : IRModule) {
+    if (F.isDeclaration())
+      continue;
+    if (OptLvl == Os || OptLvl == Oz)
+      F.addFnAttr(llvm::Attribute::OptimizeForSize);
+    if (OptLvl == Oz)
+      F.addFnAttr(llvm::Attribute::MinSize);
+  }
+
+  llvm::LoopAnalysisManager LAM;
+  llvm::FunctionAnalysisManager FAM;
+  llvm::CGSCCAnalysisManager CGAM;
+  llvm::ModuleAnalysisManager MAM;
+
+  llvm::PassBuilder PB(TM, Tuning);
+  PB.registerModuleAnalyses(MAM);
+  PB.registerCGSCCAnalyses(CGAM);
+  PB.registerFunctionAnalyses(FAM);
+  PB.registerLoopAnalyses(LAM);
+  PB.crossRegisterProxies(LAM, FAM, CGAM, MAM);
+
+  auto &Ctx = IRModule.getContext();
+  auto PrevHandler = Ctx.getDiagnosticHandler();
+  Ctx.setDiagnosticHandler(std::make_unique<MissedLoopHintsHandler>());
+
+  llvm::ModulePassManager MPM;
+  switch (LTO) {
+  case LTOKind::None:
+    MPM = PB.buildPerModuleDefaultPipeline(ToLLVMOptLevel(OptLvl));
+    break;
+  case LTOKind::Full:
+    MPM = PB.buildLTOPreLinkDefaultPipeline(ToLLVMOptLevel(OptLvl));
+    break;
+  case LTOKind::Thin:
+    MPM = PB.buildThinLTOPreLinkDefaultPipeline(ToLLVMOptLevel(OptLvl));
+    break;
+  }
+  MPM.run(IRModule, MAM);
+
+  Ctx.setDiagnosticHandler(std::move(PrevHandler));
 }
\ No newline at end of file
@@ -0,0 +1,537 @@
+/* ConstantFolding.cpp - AST-level constant folding and propagation.
+ * Copyright (C) 2022 epoll-reactor <glibcxx.chrono@gmail.com>
+ *
+ * This file is distributed under the MIT license.
+ */
+
+#include "MiddleEnd/Optimizers/ConstantFolding.h"
+#include "FrontEnd/AST/AST.h"
+#include "FrontEnd/AST/ASTVisitor.h"
+#include "FrontEnd/Analysis/ASTStorage.h"
+#include "Utility/Unreachable.h"
+#include "llvm/ADT/APFloat.h"
+#include "llvm/ADT/APInt.h"
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace weak {
+namespace {
+
+/// Literal value, represented with the same bit width as in LLVM IR.
+struct Constant {
+  DataType DT;
+  llvm::APInt Int;
+  llvm::APFloat Float{0.0F};
+};
+
+std::optional<Constant> AsConstant(ASTNode *Node) {
+  switch (Node->Type()) {
+  case AST_INTEGER_LITERAL: {
+    signed V = static_cast<ASTNumber *>(Node)->Value();
+    return Constant{DT_INT, llvm::APInt(32, V, /*isSigned=*/true)};
+  }
+  case AST_CHAR_LITERAL: {
+    char V = static_cast<ASTChar *>(Node)->Value();
+    return Constant{DT_CHAR, llvm::APInt(8, V, /*isSigned=*/true)};
+  }
+  case AST_BOOLEAN_LITERAL: {
+    bool V = static_cast<ASTBool *>(Node)->Value();
+    return Constant{DT_BOOL, llvm::APInt(1, V)};
+  }
+  case AST_FLOATING_POINT_LITERAL: {
+    float V = static_cast<ASTFloat *>(Node)->Value();
+    return Constant{DT_FLOAT, llvm::APInt(), llvm::APFloat(V)};
+  }
+  default:
+    return std::nullopt;
+  }
+}
+
+ASTNode *MakeLiteral(const Constant &C, unsigned LineNo, unsigned ColumnNo) {
+  switch (C.DT) {
+  case DT_INT:
+    return new ASTNumber(C.Int.getSExtValue(), LineNo, ColumnNo);
+  case DT_CHAR:
+    return new ASTChar(C.Int.getSExtValue(), LineNo, ColumnNo);
+  case DT_BOOL:
+    return new ASTBool(C.Int.getBoolValue(), LineNo, ColumnNo);
+  case DT_FLOAT:
+    return new ASTFloat(C.Float.convertToFloat(), LineNo, ColumnNo);
+  default:
+    Unreachable("Expected literal data type.");
+  }
+}
+
+Constant MakeBool(bool Value) {
+  return Constant{DT_BOOL, llvm::APInt(1, Value)};
+}
+
+/// Evaluate operation on integral values of the same width.
+///
+/// \return Result or nothing, if operation has no defined result.
+std::optional<Constant> EvaluateIntegral(TokenType T, const Constant &LC, const Constant &RC) {
+  const llvm::APInt &L = LC.Int;
+  const llvm::APInt &R = RC.Int;
+  auto Make = [&](llvm::APInt Result) {
+    return Constant{LC.DT, std::move(Result)};
+  };
+
+  switch (T) {
+  case TOK_PLUS:    return Make(L + R);
+  case TOK_MINUS:   return Make(L - R);
+  case TOK_STAR:    return Make(L * R);
+  case TOK_BIT_OR:  return Make(L | R);
+  case TOK_BIT_AND: return Make(L & R);
+  case TOK_XOR:     return Make(L ^ R);
+  case TOK_LE:      return MakeBool(L.sle(R));
+  case TOK_LT:      return MakeBool(L.slt(R));
+  case TOK_GE:      return MakeBool(L.sge(R));
+  case TOK_GT:      return MakeBool(L.sgt(R));
+  case TOK_EQ:      return MakeBool(L == R);
+  case TOK_NEQ:     return MakeBool(L != R);
+  case TOK_SLASH: {
+    if (R.isZero())
+      return std::nullopt;
+    bool Overflow = false;
+    llvm::APInt Result = L.sdiv_ov(R, Overflow);
+    if (Overflow)
+      return std::nullopt;
+    return Make(std::move(Result));
+  }
+  case TOK_SHL:
+  case TOK_SHR:
+    /// Shift by bit width or more produces poison value.
+    if (R.uge(L.getBitWidth()))
+      return std::nullopt;
+    return Make(T == TOK_SHL ? L.shl(R) : L.ashr(R));
+  case TOK_AND:
+  case TOK_OR:
+    /// Logical operators are emitted correctly only for booleans.
+    if (LC.DT != DT_BOOL)
+      return std::nullopt;
+    return MakeBool(T == TOK_AND ? (L.getBoolValue() && R.getBoolValue())
+                                 : (L.getBoolValue() || R.getBoolValue()));
+  default:
+    return std::nullopt;
+  }
+}
+
+/// Evaluate operation on floats with default rounding mode.
+std::optional<Constant> EvaluateFloat(TokenType T, const Constant &LC, const Constant &RC) {
+  llvm::APFloat L = LC.Float;
+  const llvm::APFloat &R = RC.Float;
+  constexpr auto Rounding = llvm::APFloat::rmNearestTiesToEven;
+  auto Cmp = L.compare(R);
+  auto Make = [&](llvm::APFloat Result) {
+    return Constant{DT_FLOAT, llvm::APInt(), std::move(Result)};
+  };
+
+  switch (T) {
+  case TOK_PLUS:  L.add(R, Rounding);      return Make(L);
+  case TOK_MINUS: L.subtract(R, Rounding); return Make(L);
+  case TOK_STAR:  L.multiply(R, Rounding); return Make(L);
+  case TOK_SLASH: L.divide(R, Rounding);   return Make(L);
+  case TOK_LE:    return MakeBool(Cmp == llvm::APFloat::cmpLessThan || Cmp == llvm::APFloat::cmpEqual);
+  case TOK_LT:    return MakeBool(Cmp == llvm::APFloat::cmpLessThan);
+  case TOK_GE:    return MakeBool(Cmp == llvm::APFloat::cmpGreaterThan || Cmp == llvm::APFloat::cmpEqual);
+  case TOK_GT:    return MakeBool(Cmp == llvm::APFloat::cmpGreaterThan);
+  case TOK_EQ:    return MakeBool(Cmp == llvm::APFloat::cmpEqual);
+  case TOK_NEQ:   return MakeBool(Cmp == llvm::APFloat::cmpLessThan || Cmp == llvm::APFloat::cmpGreaterThan);
+  default:        return std::nullopt;
+  }
+}
+
+std::optional<Constant> Evaluate(TokenType T, ASTNode *LHS, ASTNode *RHS) {
+  auto L = AsConstant(LHS);
+  auto R = AsConstant(RHS);
+
+  if (!L || !R || L->DT != R->DT)
+    return std::nullopt;
+
+  if (L->DT == DT_FLOAT)
+    return EvaluateFloat(T, *L, *R);
+
+  return EvaluateIntegral(T, *L, *R);
+}
+
+bool IsAssignment(TokenType T) {
+  switch (T) {
+  case TOK_ASSIGN:
+  case TOK_MUL_ASSIGN:
+  case TOK_DIV_ASSIGN:
+  case TOK_MOD_ASSIGN:
+  case TOK_PLUS_ASSIGN:
+  case TOK_MINUS_ASSIGN:
+  case TOK_SHL_ASSIGN:
+  case TOK_SHR_ASSIGN:
+  case TOK_BIT_AND_ASSIGN:
+  case TOK_BIT_OR_ASSIGN:
+  case TOK_XOR_ASSIGN:
+    return true;
+  default:
+    return false;
+  }
+}
+
+/// Collect declarations of variables, which are changed after initialization.
+class MutatedVarsCollector : private ASTVisitor {
+public:
+  std::unordered_set<ASTNode *> Collect(ASTNode *Root) {
+    Root->Accept(this);
+    return std::move(mMutated);
+  }
+
+private:
+  void Visit(ASTCompound *Stmt) override {
+    mStorage.StartScope();
+    ASTVisitor::Visit(Stmt);
+    mStorage.EndScope();
+  }
+
+  void Visit(ASTFor *Stmt) override {
+    mStorage.StartScope();
+    ASTVisitor::Visit(Stmt);
+    mStorage.EndScope();
+  }
+
+  void Visit(ASTFunctionDecl *Decl) override {
+    mStorage.StartScope();
+    ASTVisitor::Visit(Decl);
+    mStorage.EndScope();
+  }
+
+  void Visit(ASTVarDecl *Decl) override {
+    ASTVisitor::Visit(Decl);
+    mStorage.Push(Decl->Name(), Decl);
+  }
+
+  void Visit(ASTArrayDecl *Decl) override {
+    mStorage.Push(Decl->Name(), Decl);
+  }
+
+  void Visit(ASTBinary *Stmt) override {
+    ASTVisitor::Visit(Stmt);
+    if (IsAssignment(Stmt->Operation()))
+      MarkMutated(Stmt->LHS());
+  }
+
+  void Visit(ASTUnary *Stmt) override {
+    ASTVisitor::Visit(Stmt);
+    MarkMutated(Stmt->Operand());
+  }
+
+  // Names from there are not placed in function scope.
+  void Visit(ASTFunctionPrototype *) override {}
+  void Visit(ASTStructDecl *) override {}
+  void Visit(ASTMemberAccess *) override {}
+
+  void MarkMutated(ASTNode *Target) {
+    if (!Target->Is(AST_SYMBOL))
+      return;
+
+    if (auto *D = mStorage.Lookup(static_cast<ASTSymbol *>(Target)->Name()))
+      mMutated.insert(D->AST);
+  }
+
+  ASTStorage mStorage;
+  std::unordered_set<ASTNode *> mMutated;
+};
+
+/// Find break or continue, related to the loop with given body.
+class LoopJumpsFinder : private ASTVisitor {
+public:
+  bool Find(ASTCompound *LoopBody) {
+    mFound = false;
+    LoopBody->Accept(this);
+    return mFound;
+  }
+
+private:
+  void Visit(ASTBreak *) override { mFound = true; }
+  void Visit(ASTContinue *) override { mFound = true; }
+
+  // Jumps inside nested loops are not related to our loop.
+  void Visit(ASTFor *) override {}
+  void Visit(ASTWhile *) override {}
+  void Visit(ASTDoWhile *) override {}
+
+  bool mFound{false};
+};
+
+class ConstantFolder : private ASTVisitor {
+public:
+  ConstantFolder(
+    ConstantFoldingStats          &Stats,
+    std::unordered_set<ASTNode *>  Mutated
+  ) : mStats(Stats)
+    , mMutated(std::move(Mutated))
+    , mReplacement(nullptr) {}
+
+  ~ConstantFolder() {
+    for (auto &[Decl, Literal] : mConstants)
+      delete Literal;
+  }
+
+  void Run(ASTNode *Root) {
+    Root->Accept(this);
+  }
+
+private:
+  /// Visit node and get what should be placed instead of it: the node itself,
+  /// new node or null, if statement should be removed. Replaced node is deleted.
+  ASTNode *Fold(ASTNode *Node) {
+    if (!Node)
+      return nullptr;
+
+    ASTNode *Outer = mReplacement;
+    mReplacement = Node;
+    Node->Accept(this);
+    ASTNode *Result = mReplacement;
+    mReplacement = Outer;
+
+    if (Result != Node)
+      delete Node;
+
+    return Result;
+  }
+
+  /// Set replacement for currently folded node.
+  void Replace(ASTNode *With) {
+    mReplacement = With;
+  }
+
+  void Visit(ASTCompound *Stmt) override {
+    mStorage.StartScope();
+
+    std::vector<ASTNode *> Folded;
+    for (ASTNode *S : Stmt->Stmts())
+      if (ASTNode *F = Fold(S))
+        Folded.push_back(F);
+
+    Stmt->Stmts() = std::move(Folded);
+
+    mStorage.EndScope();
+  }
+
+  void Visit(ASTBinary *Stmt) override {
+    Stmt->SetLHS(Fold(Stmt->LHS()));
+    Stmt->SetRHS(Fold(Stmt->RHS()));
+
+    if (IsAssignment(Stmt->Operation()))
+      return;
+
+    if (auto C = Evaluate(Stmt->Operation(), Stmt->LHS(), Stmt->RHS())) {
+      Replace(MakeLiteral(*C, Stmt->LineNo(), Stmt->ColumnNo()));
+      ++mStats.FoldedExprs;
+    }
+  }
+
+  void Visit(ASTUnary *Stmt) override {
+    /// Operand is always variable, but indices of array can be folded.
+    if (auto *Op = Stmt->Operand(); Op->Is(AST_ARRAY_ACCESS))
+      Op->Accept(this);
+  }
+
+  void Visit(ASTArrayAccess *Stmt) override {
+    for (ASTNode *&I : Stmt->Indices())
+      I = Fold(I);
+  }
+
+  void Visit(ASTFunctionCall *Stmt) override {
+    for (ASTNode *&A : Stmt->Args())
+      A = Fold(A);
+  }
+
+  void Visit(ASTReturn *Stmt) override {
+    Stmt->SetOperand(Fold(Stmt->Operand()));
+  }
+
+  void Visit(ASTSymbol *Stmt) override {
+    auto *D = mStorage.Lookup(Stmt->Name());
+    if (!D)
+      return;
+
+    auto It = mConstants.find(D->AST);
+    if (It == mConstants.end())
+      return;
+
+    Replace(MakeLiteral(*AsConstant(It->second), Stmt->LineNo(), Stmt->ColumnNo()));
+    ++mStats.PropagatedUses;
+  }
+
+  void Visit(ASTVarDecl *Decl) override {
+    Decl->SetBody(Fold(Decl->Body()));
+    mStorage.Push(Decl->Name(), Decl);
+
+    ASTNode *Body = Decl->Body();
+    if (!Body || mMutated.count(Decl))
+      return;
+
+    auto C = AsConstant(Body);
+    if (!C || C->DT != Decl->DataType())
+      return;
+
+    /// All uses will be replaced with literal, so declaration is not
+    /// needed anymore.
+    Decl->SetBody(nullptr);
+    mConstants.emplace(Decl, Body);
+    Replace(nullptr);
+    ++mStats.RemovedDecls;
+  }
+
+  void Visit(ASTArrayDecl *Decl) override {
+    mStorage.Push(Decl->Name(), Decl);
+  }
+
+  void Visit(ASTFunctionDecl *Decl) override {
+    mStorage.StartScope();
+
+    for (ASTNode *A : Decl->Args()) {
+      if (A->Is(AST_VAR_DECL))
+        mStorage.Push(static_cast<ASTVarDecl *>(A)->Name(), A);
+      if (A->Is(AST_ARRAY_DECL))
+        mStorage.Push(static_cast<ASTArrayDecl *>(A)->Name(), A);
+    }
+
+    Decl->Body()->Accept(this);
+
+    mStorage.EndScope();
+  }
+
+  void Visit(ASTIf *Stmt) override {
+    Stmt->SetCondition(Fold(Stmt->Condition()));
+
+    auto C = AsConstant(Stmt->Condition());
+    if (!C || C->DT == DT_FLOAT) {
+      Stmt->ThenBody()->Accept(this);
+      if (auto *E = Stmt->ElseBody())
+        E->Accept(this);
+      return;
+    }
+
+    ++mStats.SimplifiedBranches;
+
+    ASTCompound *Taken = C->Int.getBoolValue()
+      ? Stmt->ThenBody()
+      : Stmt->ElseBody();
+
+    if (!Taken) {
+      Replace(nullptr);
+      return;
+    }
+
+    /// Detach body to keep it alive after if statement removal.
+    if (Taken == Stmt->ThenBody())
+      Stmt->SetThenBody(nullptr);
+    else
+      Stmt->SetElseBody(nullptr);
+
+    Taken->Accept(this);
+    Replace(Taken);
+  }
+
+  void Visit(ASTFor *Stmt) override {
+    mStorage.StartScope();
+
+    Stmt->SetInit(Fold(Stmt->Init()));
+    Stmt->SetCondition(Fold(Stmt->Condition()));
+    Stmt->SetIncrement(Fold(Stmt->Increment()));
+    Stmt->Body()->Accept(this);
+
+    mStorage.EndScope();
+
+    if (!IsFalse(Stmt->Condition()))
+      return;
+
+    ++mStats.SimplifiedLoops;
+
+    ASTNode *Init = Stmt->Init();
+    if (!Init) {
+      Replace(nullptr);
+      return;
+    }
+
+    /// Init part is executed anyway. Wrap it into block to keep the scope.
+    Stmt->SetInit(nullptr);
+    Replace(new ASTCompound({Init}, Stmt->LineNo(), Stmt->ColumnNo()));
+  }
+
+  void Visit(ASTWhile *Stmt) override {
+    Stmt->SetCondition(Fold(Stmt->Condition()));
+    Stmt->Body()->Accept(this);
+
+    if (IsFalse(Stmt->Condition())) {
+      Replace(nullptr);
+      ++mStats.SimplifiedLoops;
+    }
+  }
+
+  void Visit(ASTDoWhile *Stmt) override {
+    Stmt->Body()->Accept(this);
+    Stmt->SetCondition(Fold(Stmt->Condition()));
+
+    if (!IsFalse(Stmt->Condition()))
+      return;
+
+    /// Body without loop is executed exactly once, but only if there are
+    /// no jumps, that need enclosing loop.
+    if (LoopJumpsFinder().Find(Stmt->Body()))
+      return;
+
+    ASTCompound *Body = Stmt->Body();
+    Stmt->SetBody(nullptr);
+    Replace(Body);
+    ++mStats.SimplifiedLoops;
+  }
+
+  // Nothing to fold there.
+  void Visit(ASTFunctionPrototype *) override {}
+  void Visit(ASTStructDecl *) override {}
+  void Visit(ASTMemberAccess *) override {}
+
+  /// Loop conditions are always booleans.
+  static bool IsFalse(ASTNode *Condition) {
+    if (!Condition || !Condition->Is(AST_BOOLEAN_LITERAL))
+      return false;
+
+    return !static_cast<ASTBool *>(Condition)->Value();
+  }
+
+  ConstantFoldingStats &mStats;
+
+  /// Declarations that cannot be propagated.
+  std::unordered_set<ASTNode *> mMutated;
+
+  /// Removed declaration -> literal, that was used to initialize it.
+  std::unordered_map<ASTNode *, ASTNode *> mConstants;
+
+  /// Name resolution.
+  ASTStorage mStorage;
+
+  /// What should be placed instead of currently folded node.
+  ASTNode *mReplacement;
+};
+
+} // namespace
+} // namespace weak
+
+namespace weak {
+
+void ConstantFoldingStats::Dump(std::ostream &Stream) const {
+  Stream << "Constant folding:\n"
+         << "  folded expressions:   " << FoldedExprs << '\n'
+         << "  propagated uses:      " << PropagatedUses << '\n'
+         << "  removed declarations: " << RemovedDecls << '\n'
+         << "  simplified branches:  " << SimplifiedBranches << '\n'
+         << "  simplified loops:     " << SimplifiedLoops << '\n';
+}
+
+ConstantFoldingStats RunConstantFoldingPass(ASTNode *Root) {
+  ConstantFoldingStats Stats;
+  auto Mutated = MutatedVarsCollector().Collect(Root);
+  ConstantFolder(Stats, std::move(Mutated)).Run(Root);
+  return Stats;
+}
+
+} // namespace weak
\ No newline at end of file
@@ -0,0 +1,62 @@
+/* DeadFunctionElimination.cpp - Removal of functions unreachable from main.
+ * Copyright (C) 2022 epoll-reactor <glibcxx.chrono@gmail.com>
+ *
+ * This file is distributed under the MIT license.
+ */
+
+#include "MiddleEnd/Optimizers/DeadFunctionElimination.h"
+#include "MiddleEnd/CallGraph/CallGraph.h"
+#include "FrontEnd/AST/AST.h"
+
+namespace weak {
+namespace {
+
+const std::string *FunctionName(ASTNode *Stmt) {
+  if (Stmt->Is(AST_FUNCTION_DECL))
+    return &static_cast<ASTFunctionDecl *>(Stmt)->Name();
+
+  if (Stmt->Is(AST_FUNCTION_PROTOTYPE))
+    return &static_cast<ASTFunctionPrototype *>(Stmt)->Name();
+
+  return nullptr;
+}
+
+} // namespace
+} // namespace weak
+
+namespace weak {
+
+void DeadFunctionEliminationStats::Dump(std::ostream &Stream) const {
+  Stream << "Dead function elimination:\n"
+         << "  reachable functions: " << ReachableFunctions << '\n'
+         << "  removed functions:   " << RemovedFunctions << '\n';
+}
+
+DeadFunctionEliminationStats RunDeadFunctionEliminationPass(ASTNode *Root) {
+  DeadFunctionEliminationStats Stats;
+  CallGraph CG(Root);
+
+  if (!CG.Decl("main"))
+    return Stats;
+
+  auto Reachable = CG.Reachable(CG.EntryPoints());
+  Stats.ReachableFunctions = Reachable.size();
+
+  std::vector<ASTNode *> Kept;
+  for (ASTNode *Stmt : static_cast<ASTCompound *>(Root)->Stmts()) {
+    const std::string *Name = FunctionName(Stmt);
+    if (!Name || Reachable.count(*Name)) {
+      Kept.push_back(Stmt);
+      continue;
+    }
+
+    delete Stmt;
+    ++Stats.RemovedFunctions;
+  }
+
+  static_cast<ASTCompound *>(Root)->Stmts() = std::move(Kept);
+
+  return Stats;
+}
+
+} // namespace weak
\ No newline at end of file
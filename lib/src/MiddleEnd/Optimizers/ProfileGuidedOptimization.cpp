@@ -0,0 +1,304 @@
+/* ProfileGuidedOptimization.cpp - Instrumentation and use of execution profiles.
+ * Copyright (C) 2022 epoll-reactor <glibcxx.chrono@gmail.com>
+ *
+ * This file is distributed under the MIT license.
+ */
+
+#include "MiddleEnd/Optimizers/ProfileGuidedOptimization.h"
+#include "llvm/ADT/MapVector.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/InstIterator.h"
+#include "llvm/IR/IntrinsicInst.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Passes/PassBuilder.h"
+#include "llvm/ProfileData/InstrProf.h"
+#include "llvm/ProfileData/InstrProfReader.h"
+#include "llvm/ProfileData/InstrProfWriter.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Signals.h"
+#include "llvm/Transforms/Instrumentation/PGOInstrumentation.h"
+
+namespace {
+
+/// Counters of one instrumented function.
+struct ProfiledFunction {
+  /// Name, function is found by in profile. Names of local functions
+  /// are qualified by source file.
+  std::string Name;
+  /// Hash of control flow graph, profile is checked against.
+  uint64_t Hash{0U};
+  llvm::GlobalVariable *Counters{nullptr};
+  /// Value profiling sites by value kind. Values are not collected, but
+  /// sites are written empty, so their count matches the function.
+  unsigned ValueSites[llvm::IPVK_Last + 1]{};
+};
+
+using ProfiledFunctions = llvm::MapVector<llvm::GlobalVariable *, ProfiledFunction>;
+
+template <typename Pass>
+void RunModulePass(llvm::Module &M, Pass &&P) {
+  llvm::LoopAnalysisManager LAM;
+  llvm::FunctionAnalysisManager FAM;
+  llvm::CGSCCAnalysisManager CGAM;
+  llvm::ModuleAnalysisManager MAM;
+
+  llvm::PassBuilder PB;
+  PB.registerModuleAnalyses(MAM);
+  PB.registerCGSCCAnalyses(CGAM);
+  PB.registerFunctionAnalyses(FAM);
+  PB.registerLoopAnalyses(LAM);
+  PB.crossRegisterProxies(LAM, FAM, CGAM, MAM);
+
+  llvm::ModulePassManager MPM;
+  MPM.addPass(std::forward<Pass>(P));
+  MPM.run(M, MAM);
+}
+
+/// Replace instrumentation intrinsics by increments of private global
+/// arrays, one per function. This is what LLVM InstrProfiling pass does,
+/// but without sections and registration, that require compiler-rt.
+ProfiledFunctions LowerIntrinsics(llvm::Module &M) {
+  ProfiledFunctions Functions;
+  auto Get = [&](llvm::InstrProfInstBase *I) -> ProfiledFunction & {
+    auto [It, Inserted] = Functions.insert({I->getName(), ProfiledFunction{}});
+    if (Inserted) {
+      It->second.Name = llvm::getPGOFuncNameVarInitializer(I->getName()).str();
+      It->second.Hash = I->getHash()->getZExtValue();
+    }
+    return It->second;
+  };
+
+  llvm::Type *I64 = llvm::Type::getInt64Ty(M.getContext());
+  for (llvm::Function &F : M)
+    for (llvm::Instruction &I : llvm::make_early_inc_range(llvm::instructions(F))) {
+      if (auto *VP = llvm::dyn_cast<llvm::InstrProfValueProfileInst>(&I)) {
+        unsigned &Sites = Get(VP).ValueSites[VP->getValueKind()->getZExtValue()];
+        Sites = std::max<unsigned>(Sites, VP->getIndex()->getZExtValue() + 1);
+        VP->eraseFromParent();
+        continue;
+      }
+      auto *Inc = llvm::dyn_cast<llvm::InstrProfIncrementInst>(&I);
+      if (!Inc)
+        continue;
+      ProfiledFunction &PF = Get(Inc);
+      if (!PF.Counters) {
+        auto *Ty = llvm::ArrayType::get(I64, Inc->getNumCounters()->getZExtValue());
+        PF.Counters = new llvm::GlobalVariable(
+          M, Ty, /*isConstant=*/false, llvm::GlobalValue::PrivateLinkage,
+          llvm::ConstantAggregateZero::get(Ty), llvm::getInstrProfCountersVarPrefix() + PF.Name);
+      }
+      llvm::IRBuilder<> Builder(Inc);
+      llvm::Value *Counter = Builder.CreateConstInBoundsGEP2_64(
+        PF.Counters->getValueType(), PF.Counters, 0, Inc->getIndex()->getZExtValue());
+      llvm::Value *Count = Builder.CreateLoad(I64, Counter);
+      Builder.CreateStore(Builder.CreateAdd(Count, Inc->getStep()), Counter);
+      Inc->eraseFromParent();
+    }
+
+  /// Names are kept by LLVM only for its profile runtime.
+  for (auto &[NameVar, PF] : Functions)
+    if (NameVar->use_empty())
+      NameVar->eraseFromParent();
+  if (auto *Version = M.getNamedGlobal(INSTR_PROF_QUOTE(INSTR_PROF_RAW_VERSION_VAR)))
+    if (Version->use_empty())
+      Version->eraseFromParent();
+  return Functions;
+}
+
+/// Text, that follows counters of function in LLVM text profile format:
+/// empty value profiling sites and record separator.
+std::string RecordTrailer(const ProfiledFunction &PF) {
+  std::string Trailer;
+  unsigned Kinds = 0U;
+  for (unsigned Kind = llvm::IPVK_First; Kind <= llvm::IPVK_Last; ++Kind) {
+    if (PF.ValueSites[Kind] == 0U)
+      continue;
+    ++Kinds;
+    Trailer += "# ValueKind:\n" + std::to_string(Kind) + "\n";
+    Trailer += "# NumValueSites:\n" + std::to_string(PF.ValueSites[Kind]) + "\n";
+    for (unsigned Site = 0U; Site < PF.ValueSites[Kind]; ++Site)
+      Trailer += "0\n";
+  }
+  if (Kinds != 0U)
+    Trailer = "# Num Value Kinds:\n" + std::to_string(Kinds) + "\n" + Trailer;
+  return Trailer + "\n";
+}
+
+/// Create function void(i8 *File, i64 *Counters, i64 Count), that prints
+/// counters one per line.
+llvm::Function *CreateCountersPrinter(llvm::Module &M, llvm::FunctionCallee FPrintf) {
+  llvm::LLVMContext &Ctx = M.getContext();
+  llvm::Type *I64 = llvm::Type::getInt64Ty(Ctx);
+  auto *Printer = llvm::Function::Create(
+    llvm::FunctionType::get(
+      llvm::Type::getVoidTy(Ctx), {llvm::Type::getInt8PtrTy(Ctx), I64->getPointerTo(), I64}, false),
+    llvm::GlobalValue::InternalLinkage, "__weak_profile_counters", M);
+
+  auto *Entry = llvm::BasicBlock::Create(Ctx, "entry", Printer);
+  auto *Loop = llvm::BasicBlock::Create(Ctx, "loop", Printer);
+  auto *Exit = llvm::BasicBlock::Create(Ctx, "exit", Printer);
+  llvm::IRBuilder<> Builder(Entry);
+  llvm::Value *Format = Builder.CreateGlobalStringPtr("%llu\n");
+  Builder.CreateBr(Loop);
+
+  /// Every instrumented function has at least one counter.
+  Builder.SetInsertPoint(Loop);
+  llvm::PHINode *Index = Builder.CreatePHI(I64, 2);
+  Index->addIncoming(Builder.getInt64(0), Entry);
+  llvm::Value *Count = Builder.CreateLoad(I64, Builder.CreateInBoundsGEP(I64, Printer->getArg(1), Index));
+  Builder.CreateCall(FPrintf, {Printer->getArg(0), Format, Count});
+  llvm::Value *Next = Builder.CreateAdd(Index, Builder.getInt64(1));
+  Index->addIncoming(Next, Loop);
+  Builder.CreateCondBr(Builder.CreateICmpEQ(Next, Printer->getArg(2)), Exit, Loop);
+
+  Builder.SetInsertPoint(Exit);
+  Builder.CreateRetVoid();
+  return Printer;
+}
+
+std::string DumpFunctionName(unsigned Unit) {
+  return "__weak_profile_dump." + std::to_string(Unit);
+}
+
+/// Create function void(i8 *File), that prints records of all functions
+/// of translation unit. It is called from other unit, if main is there.
+void CreateDumpFunction(llvm::Module &M, const ProfiledFunctions &Functions, unsigned Unit) {
+  llvm::LLVMContext &Ctx = M.getContext();
+  llvm::Type *I8Ptr = llvm::Type::getInt8PtrTy(Ctx);
+  llvm::Type *I32 = llvm::Type::getInt32Ty(Ctx);
+  llvm::FunctionCallee FPuts = M.getOrInsertFunction("fputs", I32, I8Ptr, I8Ptr);
+  llvm::FunctionCallee FPrintf = M.getOrInsertFunction(
+    "fprintf", llvm::FunctionType::get(I32, {I8Ptr, I8Ptr}, /*isVarArg=*/true));
+  llvm::Function *Printer = CreateCountersPrinter(M, FPrintf);
+
+  auto *Dump = llvm::Function::Create(
+    llvm::FunctionType::get(llvm::Type::getVoidTy(Ctx), {I8Ptr}, false),
+    llvm::GlobalValue::ExternalLinkage, DumpFunctionName(Unit), M);
+  llvm::IRBuilder<> Builder(llvm::BasicBlock::Create(Ctx, "entry", Dump));
+  llvm::Value *File = Dump->getArg(0);
+  for (const auto &[NameVar, PF] : Functions) {
+    if (!PF.Counters)
+      continue;
+    uint64_t Count = PF.Counters->getValueType()->getArrayNumElements();
+    std::string Header =
+      PF.Name + "\n# Func Hash:\n" + std::to_string(PF.Hash) +
+      "\n# Num Counters:\n" + std::to_string(Count) + "\n# Counter Values:\n";
+    Builder.CreateCall(FPuts, {Builder.CreateGlobalStringPtr(Header), File});
+    Builder.CreateCall(Printer, {
+      File,
+      Builder.CreateConstInBoundsGEP2_64(PF.Counters->getValueType(), PF.Counters, 0, 0),
+      Builder.getInt64(Count)});
+    Builder.CreateCall(FPuts, {Builder.CreateGlobalStringPtr(RecordTrailer(PF)), File});
+  }
+  Builder.CreateRetVoid();
+}
+
+/// Write profile of all units, when main returns. Program, that traps,
+/// leaves no profile.
+void CreateProfileWriter(llvm::Module &M, std::string_view ProfilePath, unsigned Units) {
+  llvm::Function *Main = M.getFunction("main");
+  if (!Main || Main->isDeclaration())
+    return;
+
+  llvm::LLVMContext &Ctx = M.getContext();
+  llvm::Type *I8Ptr = llvm::Type::getInt8PtrTy(Ctx);
+  llvm::Type *I32 = llvm::Type::getInt32Ty(Ctx);
+  llvm::Type *Void = llvm::Type::getVoidTy(Ctx);
+  llvm::FunctionCallee FOpen = M.getOrInsertFunction("fopen", I8Ptr, I8Ptr, I8Ptr);
+  llvm::FunctionCallee FPuts = M.getOrInsertFunction("fputs", I32, I8Ptr, I8Ptr);
+  llvm::FunctionCallee FClose = M.getOrInsertFunction("fclose", I32, I8Ptr);
+
+  auto *Writer = llvm::Function::Create(
+    llvm::FunctionType::get(Void, false), llvm::GlobalValue::InternalLinkage, "__weak_profile_write", M);
+  auto *Entry = llvm::BasicBlock::Create(Ctx, "entry", Writer);
+  auto *Write = llvm::BasicBlock::Create(Ctx, "write", Writer);
+  auto *Exit = llvm::BasicBlock::Create(Ctx, "exit", Writer);
+
+  llvm::IRBuilder<> Builder(Entry);
+  llvm::Value *File = Builder.CreateCall(FOpen, {
+    Builder.CreateGlobalStringPtr(llvm::StringRef(ProfilePath.data(), ProfilePath.size())),
+    Builder.CreateGlobalStringPtr("w")});
+  Builder.CreateCondBr(Builder.CreateIsNull(File), Exit, Write);
+
+  Builder.SetInsertPoint(Write);
+  Builder.CreateCall(FPuts, {Builder.CreateGlobalStringPtr("# IR level Instrumentation Flag\n:ir\n"), File});
+  for (unsigned Unit = 0U; Unit < Units; ++Unit)
+    Builder.CreateCall(M.getOrInsertFunction(DumpFunctionName(Unit), Void, I8Ptr), {File});
+  Builder.CreateCall(FClose, {File});
+  Builder.CreateBr(Exit);
+
+  Builder.SetInsertPoint(Exit);
+  Builder.CreateRetVoid();
+
+  for (llvm::Instruction &I : llvm::make_early_inc_range(llvm::instructions(Main)))
+    if (llvm::isa<llvm::ReturnInst>(I))
+      llvm::CallInst::Create(Writer, "", &I);
+}
+
+} // namespace
+
+void weak::RunProfileInstrumentationPass(
+  llvm::Module     &M,
+  std::string_view  ProfilePath,
+  unsigned          Unit,
+  unsigned          Units
+) {
+  RunModulePass(M, llvm::PGOInstrumentationGen());
+  CreateDumpFunction(M, LowerIntrinsics(M), Unit);
+  CreateProfileWriter(M, ProfilePath, Units);
+}
+
+void weak::RunProfileUsePass(llvm::Module &M, const std::string &IndexedProfilePath) {
+  RunModulePass(M, llvm::PGOInstrumentationUse(IndexedProfilePath));
+}
+
+namespace weak {
+
+IndexedProfile::IndexedProfile(const std::string &Path) {
+  auto ExitOnProfileError = [&](llvm::Error Err) {
+    if (Err) {
+      llvm::errs() << "Cannot read profile " << Path << ": " << llvm::toString(std::move(Err));
+      exit(-1);
+    }
+  };
+
+  auto Reader = llvm::InstrProfReader::create(Path);
+  if (!Reader)
+    ExitOnProfileError(Reader.takeError());
+  if (!(*Reader)->isIRLevelProfile()) {
+    llvm::errs() << "Cannot read profile " << Path << ": not an IR level instrumentation profile";
+    exit(-1);
+  }
+
+  llvm::InstrProfWriter Writer;
+  ExitOnProfileError(Writer.mergeProfileKind((*Reader)->getProfileKind()));
+  for (llvm::NamedInstrProfRecord &Record : **Reader)
+    Writer.addRecord(std::move(Record), ExitOnProfileError);
+  if ((*Reader)->hasError())
+    ExitOnProfileError((*Reader)->getError());
+
+  int FD = -1;
+  llvm::SmallString<128> TempPath;
+  if (std::error_code EC = llvm::sys::fs::createTemporaryFile("weak-profile", "profdata", FD, TempPath)) {
+    llvm::errs() << "Cannot create temporary file: " << EC.message();
+    exit(-1);
+  }
+  mPath = TempPath.str().str();
+  llvm::sys::RemoveFileOnSignal(mPath);
+  llvm::raw_fd_ostream Stream(FD, /*shouldClose=*/true);
+  if (llvm::Error Err = Writer.write(Stream)) {
+    llvm::sys::fs::remove(mPath);
+    ExitOnProfileError(std::move(Err));
+  }
+}
+
+IndexedProfile::~IndexedProfile() {
+  llvm::sys::fs::remove(mPath);
+  llvm::sys::DontRemoveFileOnSignal(mPath);
+}
+
+const std::string &IndexedProfile::Path() const {
+  return mPath;
+}
+
+} // namespace weak
\ No newline at end of file
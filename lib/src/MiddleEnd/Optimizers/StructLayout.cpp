@@ -0,0 +1,312 @@
+/* StructLayout.cpp - Reordering and splitting of structure members.
+ * Copyright (C) 2022 epoll-reactor <glibcxx.chrono@gmail.com>
+ *
+ * This file is distributed under the MIT license.
+ */
+
+#include "MiddleEnd/Optimizers/StructLayout.h"
+#include "FrontEnd/AST/AST.h"
+#include "FrontEnd/AST/ASTVisitor.h"
+#include "Utility/Unreachable.h"
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace weak {
+namespace {
+
+/// Name of side structure with cold members. `$` is not allowed in
+/// identifiers, so it never clashes with members, written by user.
+const char *const ColdStructName = "cold$";
+
+/// Member is cold if it is used this times less than the hottest one.
+constexpr uint64_t ColdRatio = 8U;
+
+struct TypeLayout {
+  unsigned Size;
+  unsigned Align;
+};
+
+unsigned AlignTo(unsigned Offset, unsigned Align) {
+  return (Offset + Align - 1) / Align * Align;
+}
+
+TypeLayout ScalarLayout(DataType T) {
+  switch (T) {
+  case DT_BOOL:
+  case DT_CHAR:   return {1U, 1U};
+  case DT_INT:
+  case DT_FLOAT:  return {4U, 4U};
+  case DT_STRING: return {8U, 8U};
+  default:        Unreachable("Expected data type.");
+  }
+}
+
+TypeLayout MemberLayout(ASTNode *Member);
+
+/// End of last member, not including trailing padding.
+unsigned MembersEnd(const std::vector<ASTNode *> &Members, unsigned &Align) {
+  unsigned Offset = 0U;
+  Align = 1U;
+
+  for (ASTNode *M : Members) {
+    TypeLayout L = MemberLayout(M);
+    Offset = AlignTo(Offset, L.Align) + L.Size;
+    Align = std::max(Align, L.Align);
+  }
+
+  return Offset;
+}
+
+TypeLayout StructLayout(ASTStructDecl *Decl) {
+  unsigned Align = 1U;
+  unsigned End = MembersEnd(Decl->Decls(), Align);
+  return {AlignTo(End, Align), Align};
+}
+
+TypeLayout MemberLayout(ASTNode *Member) {
+  if (Member->Is(AST_VAR_DECL))
+    return ScalarLayout(static_cast<ASTVarDecl *>(Member)->DataType());
+
+  if (Member->Is(AST_ARRAY_DECL)) {
+    auto *Array = static_cast<ASTArrayDecl *>(Member);
+    TypeLayout L = ScalarLayout(Array->DataType());
+    for (unsigned Dimension : Array->ArityList())
+      L.Size *= Dimension;
+    return L;
+  }
+
+  if (Member->Is(AST_STRUCT_DECL))
+    return StructLayout(static_cast<ASTStructDecl *>(Member));
+
+  Unreachable("Expected variable, array or structure.");
+}
+
+/// Gather resolved member accesses and estimate, how often each member
+/// is used.
+class MemberAccessCollector : private ASTVisitor {
+public:
+  void Collect(ASTNode *Root) {
+    Root->Accept(this);
+  }
+
+  /// Access nodes, which index members of given structure.
+  std::unordered_map<ASTStructDecl *, std::vector<ASTMemberAccess *>> Accesses;
+  /// Sum of access weights for member declaration.
+  std::unordered_map<ASTNode *, uint64_t> Weights;
+
+private:
+  void Visit(ASTFor *Stmt) override {
+    ++mLoopDepth;
+    ASTVisitor::Visit(Stmt);
+    --mLoopDepth;
+  }
+
+  void Visit(ASTWhile *Stmt) override {
+    ++mLoopDepth;
+    ASTVisitor::Visit(Stmt);
+    --mLoopDepth;
+  }
+
+  void Visit(ASTDoWhile *Stmt) override {
+    ++mLoopDepth;
+    ASTVisitor::Visit(Stmt);
+    --mLoopDepth;
+  }
+
+  void Visit(ASTMemberAccess *Stmt) override {
+    /// Each loop level is assumed to execute 8 times.
+    uint64_t Weight = uint64_t{1U} << (3U * std::min(mLoopDepth, 20U));
+
+    while (auto *Struct = Stmt->StructDecl()) {
+      Accesses[Struct].push_back(Stmt);
+      Weights[Struct->Decls()[Stmt->MemberIndex()]] += Weight;
+
+      if (!Stmt->MemberDecl()->Is(AST_MEMBER_ACCESS))
+        break;
+      Stmt = static_cast<ASTMemberAccess *>(Stmt->MemberDecl());
+    }
+  }
+
+  unsigned mLoopDepth{0U};
+};
+
+class StructLayoutPass {
+public:
+  StructLayoutPass(const StructLayoutOptions &Opts, StructLayoutStats &Stats)
+    : mOpts(Opts)
+    , mStats(Stats) {}
+
+  void Run(ASTNode *Root) {
+    mUses.Collect(Root);
+
+    std::vector<ASTStructDecl *> Structs;
+    for (ASTNode *Stmt : static_cast<ASTCompound *>(Root)->Stmts())
+      if (Stmt->Is(AST_STRUCT_DECL)) {
+        auto *Decl = static_cast<ASTStructDecl *>(Stmt);
+        Structs.push_back(Decl);
+        RecordSizeBefore(Decl, Decl->Name());
+      }
+
+    for (ASTStructDecl *Decl : Structs)
+      Transform(Decl);
+
+    for (size_t I = 0; I < mRecords.size(); ++I) {
+      ASTStructDecl *Decl = mRecords[I];
+      auto &Layout = mStats.Structs[I];
+      Layout.SizeAfter = StructLayout(Decl).Size;
+      Layout.HotSize = Layout.SizeAfter;
+
+      const auto &Members = Decl->Decls();
+      if (!Members.empty() && mColdStructs.count(Members.back())) {
+        std::vector<ASTNode *> Hot(Members.begin(), Members.end() - 1);
+        unsigned Align = 1U;
+        Layout.HotSize = MembersEnd(Hot, Align);
+      }
+    }
+  }
+
+private:
+  void RecordSizeBefore(ASTStructDecl *Decl, const std::string &Name) {
+    StructLayoutStats::Layout Layout;
+    Layout.Name = Name;
+    Layout.SizeBefore = StructLayout(Decl).Size;
+    mStats.Structs.push_back(std::move(Layout));
+    mRecords.push_back(Decl);
+
+    for (ASTNode *M : Decl->Decls())
+      if (M->Is(AST_STRUCT_DECL)) {
+        auto *Nested = static_cast<ASTStructDecl *>(M);
+        RecordSizeBefore(Nested, Name + "." + Nested->Name());
+      }
+  }
+
+  uint64_t Weight(ASTNode *Member) {
+    auto It = mUses.Weights.find(Member);
+    return It != mUses.Weights.end() ? It->second : 0U;
+  }
+
+  void SortByAlignment(std::vector<ASTNode *> &Members) {
+    std::stable_sort(Members.begin(), Members.end(), [](ASTNode *L, ASTNode *R) {
+      return MemberLayout(L).Align > MemberLayout(R).Align;
+    });
+  }
+
+  void Transform(ASTStructDecl *Decl) {
+    const std::vector<ASTNode *> Original = Decl->Decls();
+
+    for (ASTNode *M : Original)
+      if (M->Is(AST_STRUCT_DECL))
+        Transform(static_cast<ASTStructDecl *>(M));
+
+    std::vector<ASTNode *> Hot;
+    std::vector<ASTNode *> Cold;
+
+    uint64_t MaxWeight = 0U;
+    if (mOpts.SplitColdFields)
+      for (ASTNode *M : Original)
+        MaxWeight = std::max(MaxWeight, Weight(M));
+
+    for (ASTNode *M : Original) {
+      bool IsCold = MaxWeight > 0U && Weight(M) * ColdRatio < MaxWeight;
+      (IsCold ? Cold : Hot).push_back(M);
+    }
+
+    if (mOpts.ReorderFields) {
+      SortByAlignment(Hot);
+      SortByAlignment(Cold);
+    }
+
+    ASTStructDecl *ColdDecl{nullptr};
+    if (!Cold.empty()) {
+      ColdDecl = new ASTStructDecl(
+        ColdStructName,
+        Cold,
+        Decl->LineNo(),
+        Decl->ColumnNo()
+      );
+      mColdStructs.insert(ColdDecl);
+      mStats.ColdFields += Cold.size();
+      Hot.push_back(ColdDecl);
+    }
+
+    if (Hot == Original)
+      return;
+
+    ++mStats.ChangedStructs;
+    Decl->Decls() = Hot;
+    RemapAccesses(Decl, Original, ColdDecl);
+  }
+
+  void RemapAccesses(
+    ASTStructDecl                *Decl,
+    const std::vector<ASTNode *> &Original,
+    ASTStructDecl                *ColdDecl
+  ) {
+    std::unordered_map<ASTNode *, unsigned> Indices;
+    for (unsigned I = 0; I < Decl->Decls().size(); ++I)
+      Indices[Decl->Decls()[I]] = I;
+
+    std::unordered_map<ASTNode *, unsigned> ColdIndices;
+    if (ColdDecl)
+      for (unsigned I = 0; I < ColdDecl->Decls().size(); ++I)
+        ColdIndices[ColdDecl->Decls()[I]] = I;
+
+    for (ASTMemberAccess *Access : mUses.Accesses[Decl]) {
+      ASTNode *Member = Original[Access->MemberIndex()];
+
+      if (auto It = Indices.find(Member); It != Indices.end()) {
+        Access->SetMemberIndex(It->second);
+        continue;
+      }
+
+      ASTNode *Tail = Access->MemberDecl();
+      auto *ColdAccess = new ASTMemberAccess(
+        new ASTSymbol(ColdDecl->Name(), Tail->LineNo(), Tail->ColumnNo()),
+        Tail,
+        Tail->LineNo(),
+        Tail->ColumnNo()
+      );
+      ColdAccess->SetStructDecl(ColdDecl);
+      ColdAccess->SetMemberIndex(ColdIndices[Member]);
+
+      Access->SetMemberDecl(ColdAccess);
+      Access->SetMemberIndex(Indices[ColdDecl]);
+    }
+  }
+
+  const StructLayoutOptions &mOpts;
+  StructLayoutStats &mStats;
+  MemberAccessCollector mUses;
+  /// Structures in order of StructLayoutStats::Structs.
+  std::vector<ASTStructDecl *> mRecords;
+  std::unordered_set<ASTNode *> mColdStructs;
+};
+
+} // namespace
+} // namespace weak
+
+namespace weak {
+
+void StructLayoutStats::Dump(std::ostream &Stream) const {
+  Stream << "Struct layout:\n"
+         << "  changed structures: " << ChangedStructs << '\n'
+         << "  cold members:       " << ColdFields << '\n';
+
+  for (const auto &S : Structs) {
+    Stream << "  " << S.Name << ": "
+           << S.SizeBefore << " -> " << S.SizeAfter << " bytes";
+    if (S.HotSize != S.SizeAfter)
+      Stream << " (hot " << S.HotSize << " bytes)";
+    Stream << '\n';
+  }
+}
+
+StructLayoutStats RunStructLayoutPass(ASTNode *Root, const StructLayoutOptions &Opts) {
+  StructLayoutStats Stats;
+  StructLayoutPass(Opts, Stats).Run(Root);
+  return Stats;
+}
+
+} // namespace weak
\ No newline at end of file
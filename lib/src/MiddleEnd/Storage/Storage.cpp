@@ -12,11 +12,11 @@ hash() -> hash<std::string_view>;
 
 namespace weak {
 
-void Storage::Push(std::string_view Name, llvm::AllocaInst *Value) {
+void Storage::Push(std::string_view Name, llvm::Value *Value) {
   mScopes.emplace(std::hash{}(Name), DeclRecord{mDepth, Value});
 }
 
-llvm::AllocaInst *Storage::Lookup(std::string_view Name) const {
+llvm::Value *Storage::Lookup(std::string_view Name) const {
   auto It = mScopes.find(std::hash{}(Name));
 
   if (It == mScopes.end())
@@ -29,6 +29,20 @@ llvm::AllocaInst *Storage::Lookup(std::string_view Name) const {
   return Decl.Value;
 }
 
+std::vector<llvm::Value *> Storage::ScopesDeeperThan(unsigned Depth) const {
+  std::vector<llvm::Value *> Values;
+
+  for (const auto &[Hash, Decl] : mScopes)
+    if (Decl.Depth > Depth)
+      Values.push_back(Decl.Value);
+
+  return Values;
+}
+
+unsigned Storage::Depth() const {
+  return mDepth;
+}
+
 void Storage::StartScope() {
   ++mDepth;
 }
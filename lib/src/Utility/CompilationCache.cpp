@@ -0,0 +1,169 @@
+/* CompilationCache.cpp - On-disk cache of compilation results.
+ * Copyright (C) 2022 epoll-reactor <glibcxx.chrono@gmail.com>
+ *
+ * This file is distributed under the MIT license.
+ */
+
+#include "Utility/CompilationCache.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/Support/CachePruning.h"
+#include "llvm/Support/EndianStream.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Process.h"
+#include "llvm/Support/SHA1.h"
+#include "llvm/Support/raw_ostream.h"
+#include <chrono>
+#include <dlfcn.h>
+
+namespace weak {
+namespace {
+
+/// Entries should start with this prefix, otherwise llvm::pruneCache
+/// does not touch them.
+constexpr std::string_view EntryPrefix = "llvmcache-";
+constexpr std::string_view EntryMagic = "WEAKOBJ1";
+
+/// Size and modification time of file, so rebuilt compiler does not
+/// take results of old one.
+std::string FileIdentity(const std::string &Path) {
+  llvm::sys::fs::file_status Status;
+  if (llvm::sys::fs::status(Path, Status))
+    return Path;
+  return Path + ':' + std::to_string(Status.getSize()) + ':' +
+    std::to_string(Status.getLastModificationTime().time_since_epoch().count());
+}
+
+/// Identity of compiler executable and of library, that contains this
+/// code, if it is shared.
+std::string CompilerIdentity() {
+  std::string Identity = LLVM_VERSION_STRING;
+  Identity += FileIdentity(llvm::sys::fs::getMainExecutable(nullptr, nullptr));
+  Dl_info Info;
+  if (dladdr(reinterpret_cast<void *>(&CompilerIdentity), &Info) && Info.dli_fname)
+    Identity += FileIdentity(Info.dli_fname);
+  return Identity;
+}
+
+void HashPart(llvm::SHA1 &Hasher, std::string_view Part) {
+  uint8_t Size[8];
+  llvm::support::endian::write64le(Size, Part.size());
+  Hasher.update(Size);
+  Hasher.update(llvm::StringRef(Part.data(), Part.size()));
+}
+
+/// Entry is magic, number of blobs and blobs with their sizes.
+std::optional<std::vector<std::string>> ParseEntry(llvm::StringRef Data) {
+  using namespace llvm::support::endian;
+  if (!Data.consume_front(llvm::StringRef(EntryMagic.data(), EntryMagic.size())) || Data.size() < 4)
+    return std::nullopt;
+  uint32_t Count = read32le(Data.data());
+  Data = Data.drop_front(4);
+
+  std::vector<std::string> Blobs;
+  for (uint32_t I = 0; I < Count; ++I) {
+    if (Data.size() < 8)
+      return std::nullopt;
+    uint64_t Size = read64le(Data.data());
+    Data = Data.drop_front(8);
+    if (Data.size() < Size)
+      return std::nullopt;
+    Blobs.push_back(Data.take_front(Size).str());
+    Data = Data.drop_front(Size);
+  }
+  if (!Data.empty())
+    return std::nullopt;
+  return Blobs;
+}
+
+} // namespace
+
+void CompilationCacheStats::Dump(std::ostream &Stream) const {
+  Stream << "Compilation cache:\n"
+         << "  hits:   " << Hits << '\n'
+         << "  misses: " << Misses << '\n';
+}
+
+CompilationCache::CompilationCache(std::string_view Dir, uint64_t MaxSize)
+  : mDir(Dir)
+  , mMaxSize(MaxSize) {
+  if (std::error_code EC = llvm::sys::fs::create_directories(mDir)) {
+    llvm::errs() << "Cannot create cache directory " << mDir << ": " << EC.message();
+    exit(-1);
+  }
+}
+
+std::string CompilationCache::ComputeKey(const std::vector<std::string_view> &Parts) {
+  static const std::string Identity = CompilerIdentity();
+  llvm::SHA1 Hasher;
+  HashPart(Hasher, Identity);
+  for (std::string_view Part : Parts)
+    HashPart(Hasher, Part);
+  return llvm::toHex(Hasher.final(), /*LowerCase=*/true);
+}
+
+std::optional<std::vector<std::string>> CompilationCache::Lookup(const std::string &Key) {
+  std::string Path = EntryPath(Key);
+  int FD = -1;
+  if (llvm::sys::fs::openFileForRead(Path, FD)) {
+    ++mMisses;
+    return std::nullopt;
+  }
+  auto Buffer = llvm::MemoryBuffer::getOpenFile(FD, Path, /*FileSize=*/-1, /*RequiresNullTerminator=*/false);
+  /// Access time is what eviction looks at, and file systems, mounted
+  /// with noatime or relatime, do not update it on read.
+  llvm::sys::fs::setLastAccessAndModificationTime(FD, std::chrono::system_clock::now());
+  llvm::sys::Process::SafelyCloseFileDescriptor(FD);
+
+  std::optional<std::vector<std::string>> Blobs;
+  if (Buffer)
+    Blobs = ParseEntry((*Buffer)->getBuffer());
+  ++(Blobs ? mHits : mMisses);
+  return Blobs;
+}
+
+void CompilationCache::Store(const std::string &Key, const std::vector<std::string_view> &Blobs) {
+  auto Temp = llvm::sys::fs::TempFile::create(mDir + "/weak-%%%%%%%%.tmp");
+  if (!Temp) {
+    llvm::consumeError(Temp.takeError());
+    return;
+  }
+
+  llvm::raw_fd_ostream Stream(Temp->FD, /*shouldClose=*/false);
+  Stream << EntryMagic;
+  llvm::support::endian::write<uint32_t>(Stream, Blobs.size(), llvm::support::little);
+  for (std::string_view Blob : Blobs) {
+    llvm::support::endian::write<uint64_t>(Stream, Blob.size(), llvm::support::little);
+    Stream << Blob;
+  }
+  Stream.flush();
+
+  if (Stream.has_error()) {
+    Stream.clear_error();
+    llvm::consumeError(Temp->discard());
+    return;
+  }
+  /// Rename is atomic, so reader gets either old or new entry, equal
+  /// to each other anyway.
+  llvm::consumeError(Temp->keep(EntryPath(Key)));
+}
+
+void CompilationCache::Prune() {
+  llvm::CachePruningPolicy Policy;
+  /// Scan on every build, so limit is never exceeded for long.
+  Policy.Interval = std::chrono::seconds(0);
+  Policy.Expiration = std::chrono::seconds(0);
+  Policy.MaxSizeBytes = mMaxSize;
+  llvm::pruneCache(mDir, Policy);
+}
+
+CompilationCacheStats CompilationCache::Stats() const {
+  return {mHits, mMisses};
+}
+
+std::string CompilationCache::EntryPath(const std::string &Key) const {
+  return mDir + '/' + std::string(EntryPrefix) + Key;
+}
+
+} // namespace weak
\ No newline at end of file
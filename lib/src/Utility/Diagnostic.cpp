@@ -10,6 +10,9 @@
 #include <sstream>
 
 /// Forward declaration is in Diagnostic.h, so there is no unnamed namespace.
+///
+/// State is thread-local, so translation units, compiled in parallel,
+/// do not mix their messages.
 struct Diagnostic {
   enum DiagLevel { WARN, ERROR } Level;
 
@@ -31,15 +34,13 @@ struct Diagnostic {
     ErrorStream << ": ";
   }
 
-  static inline std::ostringstream ErrorStream, WarnStream;
+  static inline thread_local std::ostringstream ErrorStream, WarnStream;
 };
 
 void weak::PrintGeneratedWarns(std::ostream &Stream) {
   Diagnostic::WarnStream.flush();
   std::string Data = Diagnostic::WarnStream.str();
   if (!Data.empty()) {
-    if (Data.back() == '\n')
-      Data.pop_back();
     Stream << Data << std::flush;
     std::ostringstream().swap(Diagnostic::WarnStream);
   }
@@ -61,7 +62,7 @@ std::ostream &weak::OstreamRAII::operator<<(const char *String) {
 
 static weak::OstreamRAII MakeMessage(Diagnostic::DiagLevel Level) {
   Diagnostic::ClearBuf();
-  static Diagnostic Diag;
+  thread_local Diagnostic Diag;
   Diag.SetLvl(Level);
   Diag.EmitEmptyLabel();
   return weak::OstreamRAII{&Diag};
@@ -73,7 +74,7 @@ static weak::OstreamRAII MakeMessage(
   unsigned              ColumnNo
 ) {
   Diagnostic::ClearBuf();
-  static Diagnostic Diag;
+  thread_local Diagnostic Diag;
   Diag.SetLvl(Level);
   Diag.EmitLabel(LineNo, ColumnNo);
   return weak::OstreamRAII{&Diag};
@@ -44,6 +44,9 @@ void AnalyzeWarns(std::string_view Program, std::ostringstream &WarnStream, weak
 
   std::string GeneratedWarns = WarnStream.str();
   std::string ExpectedWarns = ExtractExpectedMsg(Program);
+  /// Every printed warning is terminated with newline.
+  if (!ExpectedWarns.empty())
+    ExpectedWarns += '\n';
 
   if (GeneratedWarns == ExpectedWarns) {
     std::cout << "Success!" << std::endl;
@@ -0,0 +1,30 @@
+//CompoundStmt <line:0, col:0>
+//  FunctionDecl <line:24, col:1>
+//    FunctionDeclRetType <line:24, col:1> <INT>
+//    FunctionDeclName <line:24, col:1> `twice`
+//    FunctionDeclArgs <line:24, col:1>
+//      VarDecl <line:24, col:11> <INT> `x`
+//    FunctionDeclBody <line:24, col:1>
+//      CompoundStmt <line:24, col:18>
+//        ReturnStmt <line:25, col:5>
+//          BinaryOperator <line:25, col:14> *
+//            Symbol <line:25, col:12> `x`
+//            Number <line:25, col:16> 2
+//    FunctionDecl <line:28, col:8>
+//      FunctionDeclRetType <line:28, col:8> <INT>
+//      FunctionDeclName <line:28, col:8> export `api`
+//      FunctionDeclArgs <line:28, col:8>
+//        VarDecl <line:28, col:16> <INT> `x`
+//      FunctionDeclBody <line:28, col:8>
+//        CompoundStmt <line:28, col:23>
+//          ReturnStmt <line:29, col:5>
+//            FunctionCall <line:29, col:12> `twice`
+//              FunctionCallArgs <line:29, col:12>
+//                Symbol <line:29, col:18> `x`
+int twice(int x) {
+    return x * 2;
+}
+
+export int api(int x) {
+    return twice(x);
+}
\ No newline at end of file
@@ -0,0 +1,64 @@
+//CompoundStmt <line:0, col:0>
+//  FunctionDecl <line:51, col:1>
+//    FunctionDeclRetType <line:51, col:1> <VOID>
+//    FunctionDeclName <line:51, col:1> `f`
+//    FunctionDeclArgs <line:51, col:1>
+//      ArrayDecl <line:51, col:8> <INT> [16] `a`
+//    FunctionDeclBody <line:51, col:1>
+//      CompoundStmt <line:51, col:19>
+//        ForStmt <line:53, col:3>
+//          LoopHints #unroll(4) #vectorize(width=8) #interleave(2)
+//          ForStmtInit <line:53, col:8>
+//            VarDecl <line:53, col:8> <INT> `i`
+//              Number <line:53, col:16> 0
+//          ForStmtCondition <line:53, col:21>
+//            BinaryOperator <line:53, col:21> <
+//              Symbol <line:53, col:19> `i`
+//              Number <line:53, col:23> 16
+//          ForStmtIncrement <line:53, col:27>
+//            Prefix UnaryOperator <line:53, col:27> ++
+//              Symbol <line:53, col:29> `i`
+//          ForStmtBody <line:53, col:32>
+//            CompoundStmt <line:53, col:32>
+//              BinaryOperator <line:54, col:10> =
+//                ArrayAccess <line:54, col:5> a
+//                  Symbol <line:54, col:7> `i`
+//                Symbol <line:54, col:12> `i`
+//        WhileStmt <line:57, col:3>
+//          LoopHints #nounroll #novectorize
+//          WhileStmtCond <line:57, col:15>
+//            BinaryOperator <line:57, col:15> <
+//              ArrayAccess <line:57, col:10> a
+//                Number <line:57, col:12> 0
+//              Number <line:57, col:17> 10
+//          WhileStmtBody <line:57, col:21>
+//            CompoundStmt <line:57, col:21>
+//              Prefix UnaryOperator <line:58, col:5> ++
+//                ArrayAccess <line:58, col:7> a
+//                  Number <line:58, col:9> 0
+//        DoWhileStmt <line:61, col:3>
+//          LoopHints #unroll(full)
+//          DoWhileStmtBody <line:61, col:6>
+//            CompoundStmt <line:61, col:6>
+//              Prefix UnaryOperator <line:62, col:5> --
+//                ArrayAccess <line:62, col:7> a
+//                  Number <line:62, col:9> 0
+//          DoWhileStmtCond <line:63, col:17>
+//            BinaryOperator <line:63, col:17> >
+//              ArrayAccess <line:63, col:12> a
+//                Number <line:63, col:14> 0
+//              Number <line:63, col:19> 0
+void f(int a[16]) {
+  #unroll(4) #vectorize(width=8) #interleave(2)
+  for (int i = 0; i < 16; ++i) {
+    a[i] = i;
+  }
+  #nounroll #novectorize
+  while (a[0] < 10) {
+    ++a[0];
+  }
+  #unroll(full)
+  do {
+    --a[0];
+  } while (a[0] > 0);
+}
\ No newline at end of file
@@ -0,0 +1,20 @@
+//CompoundStmt <line:0, col:0>
+//  FunctionDecl <line:18, col:1>
+//    FunctionDeclRetType <line:18, col:1> <VOID>
+//    FunctionDeclName <line:18, col:1> `f`
+//    FunctionDeclArgs <line:18, col:1>
+//      ArrayDecl <line:18, col:11> in <INT> [4] `a`
+//      ArrayDecl <line:18, col:27> inout <INT> [4] `b`
+//      ArrayDecl <line:18, col:46> restrict <FLOAT> [2][2] `c`
+//      VarDecl <line:18, col:64> in <STRUCT> point `p`
+//      VarDecl <line:18, col:73> <STRUCT> point `q`
+//    FunctionDeclBody <line:18, col:1>
+//      CompoundStmt <line:18, col:82>
+//        BinaryOperator <line:19, col:8> =
+//          ArrayAccess <line:19, col:3> b
+//            Number <line:19, col:5> 0
+//          ArrayAccess <line:19, col:10> a
+//            Number <line:19, col:12> 0
+void f(in int a[4], inout int b[4], restrict float c[2][2], in point p, point q) {
+  b[0] = a[0];
+}
\ No newline at end of file
@@ -0,0 +1,8 @@
+// Error at line 7, column 7: Read-only parameter `mem` passed as mutable
+void g(int mem[10]) {
+    mem[0] = 1;
+}
+
+void f(in int mem[10]) {
+    g(mem);
+}
\ No newline at end of file
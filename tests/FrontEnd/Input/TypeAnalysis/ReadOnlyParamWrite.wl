@@ -0,0 +1,4 @@
+// Error at line 3, column 5: Cannot modify read-only parameter `mem`
+void f(in int mem[10]) {
+    mem[0] = 1;
+}
\ No newline at end of file
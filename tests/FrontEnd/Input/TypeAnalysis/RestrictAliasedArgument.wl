@@ -0,0 +1,8 @@
+// Error at line 7, column 15: `mem` is passed to restrict parameter `to` and aliased by another argument
+void copy(restrict int to[10], in int from[10]) {
+    to[0] = from[0];
+}
+
+void f(int mem[10]) {
+    copy(mem, mem);
+}
\ No newline at end of file
@@ -0,0 +1,9 @@
+// Error at line 8, column 18: For argument `mem` got array of 5 elements, but expected at least 10
+int first(in int mem[10]) {
+    return mem[0];
+}
+
+int main() {
+    int small[5];
+    return first(small);
+}
\ No newline at end of file
@@ -0,0 +1,13 @@
+// Error at line 11, column 7: Structure `point` has no member `z`
+struct point {
+    int x;
+    int y;
+}
+
+int main() {
+    point p;
+    p.x = 1;
+    p.y = 2;
+    p.z = 3;
+    return p.x;
+}
\ No newline at end of file
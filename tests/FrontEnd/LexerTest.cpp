@@ -111,8 +111,12 @@ int main() {
   SECTION(LexingKeywords) {
     std::vector<Token> Assertion = {MakeToken("", TOK_BOOL),
                                     MakeToken("", TOK_CHAR),
-                                    MakeToken("", TOK_WHILE)};
-    RunLexerTest("bool\nchar\nwhile", Assertion);
+                                    MakeToken("", TOK_WHILE),
+                                    MakeToken("", TOK_IN),
+                                    MakeToken("", TOK_INOUT),
+                                    MakeToken("", TOK_RESTRICT),
+                                    MakeToken("", TOK_EXPORT)};
+    RunLexerTest("bool\nchar\nwhile\nin\ninout\nrestrict\nexport", Assertion);
   }
   SECTION(LexingOperators) {
     std::vector<Token> Assertion_1 = {MakeToken("", TOK_PLUS),
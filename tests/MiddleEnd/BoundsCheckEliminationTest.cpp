@@ -0,0 +1,64 @@
+#include "MiddleEnd/Optimizers/BoundsCheckElimination.h"
+#include "MiddleEnd/Optimizers/ConstantFolding.h"
+#include "FrontEnd/Lex/Lexer.h"
+#include "FrontEnd/Parse/Parser.h"
+#include "FrontEnd/Analysis/VariableUseAnalysis.h"
+#include "FrontEnd/Analysis/FunctionAnalysis.h"
+#include "FrontEnd/Analysis/TypeAnalysis.h"
+#include "Utility/Files.h"
+#include <filesystem>
+#include <iostream>
+
+using namespace std::string_view_literals;
+
+/// First line of program should contain count of eliminated
+/// and emitted checks, f.e.
+/// // 3 1
+void TestBoundsCheckElimination(std::string_view Path) {
+  std::cout << "Testing file " << Path << "...\n";
+  std::string Program = weak::FileAsString(Path);
+
+  if (Program.substr(0, 3) != "// ") {
+    std::cerr << "Expected count of eliminated and emitted checks.";
+    exit(-1);
+  }
+
+  std::string ExpectedCounts = Program.substr(
+    "// "sv.length(),
+    Program.find_first_of('\n') - "// "sv.length()
+  );
+
+  weak::Lexer Lex(&Program.front(), &Program.back());
+  auto Tokens = Lex.Analyze();
+  weak::Parser Parser(&Tokens.front(), &Tokens.back());
+  auto AST = Parser.Parse();
+
+  weak::VariableUseAnalysis(AST.get()).Analyze();
+  weak::FunctionAnalysis(AST.get()).Analyze();
+  weak::TypeAnalysis(AST.get()).Analyze();
+  weak::RunConstantFoldingPass(AST.get());
+  auto Stats = weak::RunBoundsCheckEliminationPass(AST.get());
+
+  std::string GeneratedCounts =
+    std::to_string(Stats.EliminatedChecks) + " " +
+    std::to_string(Stats.EmittedChecks);
+
+  if (GeneratedCounts == ExpectedCounts)
+    return;
+
+  std::cerr
+    << "Checks count mismatch:\n\t" << GeneratedCounts
+    << "\ngot, but\n\t" << ExpectedCounts << "\nexpected.";
+  exit(-1);
+}
+
+int main() {
+  auto Dir = std::filesystem::directory_iterator(
+    std::filesystem::current_path().concat("/BoundsCheckElimination")
+  );
+  for (const auto &File : Dir) {
+    const auto &Path = File.path();
+    if (Path.extension() == ".wl")
+      TestBoundsCheckElimination(Path.native());
+  }
+}
\ No newline at end of file
@@ -1,3 +1,4 @@
+#include "BackEnd/X86/ObjectEmitter.h"
 #include "MiddleEnd/CodeGen/CodeGen.h"
 #include "FrontEnd/Lex/Lexer.h"
 #include "FrontEnd/Parse/Parser.h"
@@ -5,6 +6,11 @@
 #include "FrontEnd/Analysis/FunctionAnalysis.h"
 #include "FrontEnd/Analysis/TypeAnalysis.h"
 #include "MiddleEnd/Driver/Driver.h"
+#include "MiddleEnd/IR/ASTLowering.h"
+#include "MiddleEnd/IR/Passes.h"
+#include "MiddleEnd/Optimizers/BoundsCheckElimination.h"
+#include "MiddleEnd/Optimizers/ConstantFolding.h"
+#include "MiddleEnd/Optimizers/DeadFunctionElimination.h"
 #include "Utility/Diagnostic.h"
 #include "Utility/Files.h"
 #include <filesystem>
@@ -20,9 +26,19 @@ int RunAndGetExitCode(const std::string &TargetPath) {
   return WEXITSTATUS(code);
 }
 
+void CheckExitCode(const std::string &PathToBin, int ExitCode, int ExpectedExitCode) {
+  if (ExitCode != ExpectedExitCode) {
+    llvm::errs()
+      << PathToBin << ": process exited with wrong exit code: " << ExitCode
+      << " got, but " << ExpectedExitCode << " expected.";
+    exit(-1);
+  }
+}
+
 /// There semantic analysis expect to be correct.
 void RunTestOnValidCode(
   std::vector<weak::Analysis *> &Analyzers,
+  weak::ASTNode                 *AST,
   weak::CodeGen                 &CG,
   const std::string             &Program,
   const std::string             &PathToBin
@@ -48,13 +64,15 @@ void RunTest(std::string_view Path, bool IsValid) {
   Analyzers.push_back(new weak::FunctionAnalysis(AST.get()));
   Analyzers.push_back(new weak::TypeAnalysis(AST.get()));
 
-  weak::CodeGen CG(AST.get());
+  weak::CodeGenOptions Options;
+  Options.BoundsCheck = true;
+  weak::CodeGen CG(AST.get(), Options);
 
   std::string PathToBin(Path.substr(Path.find_last_of('/') + 1));
   PathToBin = PathToBin.substr(0, PathToBin.find_first_of('.'));
 
   if (IsValid)
-    RunTestOnValidCode(Analyzers, CG, Program, PathToBin);
+    RunTestOnValidCode(Analyzers, AST.get(), CG, Program, PathToBin);
   else
     RunTestOnInvalidCode(Analyzers, CG, Program);
 
@@ -66,6 +84,7 @@ void RunTest(std::string_view Path, bool IsValid) {
 
 void RunTestOnValidCode(
   std::vector<weak::Analysis *> &Analyzers,
+  weak::ASTNode                 *AST,
   weak::CodeGen                 &CG,
   const std::string             &Program,
   const std::string             &PathToBin
@@ -73,6 +92,10 @@ void RunTestOnValidCode(
   for (auto *A : Analyzers)
     A->Analyze();
 
+  weak::RunConstantFoldingPass(AST);
+  weak::RunDeadFunctionEliminationPass(AST);
+  weak::RunBoundsCheckEliminationPass(AST);
+
   if (Program.substr(0, 3) != "// ") {
     llvm::errs() << "Expected planned exit code.";
     exit(-1);
@@ -84,18 +107,33 @@ void RunTestOnValidCode(
     )
   );
 
+  /// Program compiled by LLVM is run in memory, saving link and process
+  /// creation.
   CG.CreateCode();
   weak::Driver Driver(CG.Module(), PathToBin);
-  Driver.Compile();
-
-  int ExitCode = RunAndGetExitCode(PathToBin);
-  if (ExitCode != ExpectedExitCode) {
-    llvm::errs()
-      << "Process exited with wrong exit code: " << ExitCode
-      << " got, but " << ExpectedExitCode << " expected.";
-    exit(-1);
-  } else
-    llvm::outs() << "Success!\n";
+  CheckExitCode(PathToBin, Driver.Run(), ExpectedExitCode);
+
+  /// Same program, but functions lowered to Weak IR are compiled by
+  /// native back end. Executable is written by built-in linker and run
+  /// as separate process to check both emitted ELF files.
+  auto WeakIR = weak::LowerToWeakIR(AST, /*BoundsCheck=*/true);
+  weak::ir::RunDefaultPasses(WeakIR);
+  std::string FastBin = PathToBin + "_fast";
+  weak::x86::EmitObjectFile(WeakIR, FastBin + ".weak.o");
+
+  weak::CodeGenOptions FastOptions;
+  FastOptions.BoundsCheck = true;
+  FastOptions.WeakIR = &WeakIR;
+  FastOptions.WeakIRDeclarationsOnly = true;
+  weak::CodeGen FastCG(AST, FastOptions);
+  FastCG.CreateCode();
+  weak::DriverOptions DriverOpts;
+  DriverOpts.ExtraObjects.push_back(FastBin + ".weak.o");
+  weak::Driver FastDriver(FastCG.Module(), FastBin, DriverOpts);
+  FastDriver.Compile();
+  CheckExitCode(FastBin, RunAndGetExitCode(FastBin), ExpectedExitCode);
+
+  llvm::outs() << "Success!\n";
 }
 
 void RunTestOnInvalidCode(
@@ -0,0 +1,75 @@
+#include "MiddleEnd/Optimizers/ConstantFolding.h"
+#include "FrontEnd/AST/ASTDump.h"
+#include "FrontEnd/Lex/Lexer.h"
+#include "FrontEnd/Parse/Parser.h"
+#include "FrontEnd/Analysis/VariableUseAnalysis.h"
+#include "FrontEnd/Analysis/FunctionAnalysis.h"
+#include "FrontEnd/Analysis/TypeAnalysis.h"
+#include "Utility/Diagnostic.h"
+#include "Utility/Files.h"
+#include <filesystem>
+#include <iostream>
+
+/// This gets all contents of first comment placed
+/// at the very beginning of input program.
+std::string ExtractAST(std::string Program) {
+  std::string ExpectedAST;
+
+  using namespace std::string_view_literals;
+  while (Program.size() > 2 && Program.substr(0, 2) == "//") {
+    const auto EOL = Program.find_first_of('\n');
+    std::string Line = Program.substr(2, EOL - "//"sv.length());
+    Program = Program.substr(EOL + 1);
+    ExpectedAST += Line;
+    ExpectedAST += '\n';
+  }
+
+  return ExpectedAST;
+}
+
+void TestConstantFolding(std::string_view Path) {
+  std::cout << "Testing file " << Path << "...\n";
+  std::string Program = weak::FileAsString(Path);
+
+  weak::Lexer Lex(&Program.front(), &Program.back());
+  auto Tokens = Lex.Analyze();
+  weak::Parser Parser(&Tokens.front(), &Tokens.back());
+  auto AST = Parser.Parse();
+
+  weak::VariableUseAnalysis(AST.get()).Analyze();
+  weak::FunctionAnalysis(AST.get()).Analyze();
+  weak::TypeAnalysis(AST.get()).Analyze();
+  weak::RunConstantFoldingPass(AST.get());
+
+  weak::PrintGeneratedWarns(std::cout);
+
+  std::ostringstream ASTStream;
+  weak::ASTDump(AST.get(), ASTStream);
+
+  std::string GeneratedAST = ASTStream.str();
+  std::string ExpectedAST = ExtractAST(Program);
+
+  if (ExpectedAST == GeneratedAST)
+    return;
+
+  std::cout
+    << "Error while folding program:\n"
+    << Program << '\n'
+    << "Expected AST:\n"
+    << ExpectedAST
+    << "\nGenerated AST:\n"
+    << GeneratedAST
+    << "\n";
+  exit(-1);
+}
+
+int main() {
+  auto Dir = std::filesystem::directory_iterator(
+    std::filesystem::current_path().concat("/ConstantFolding")
+  );
+  for (const auto &File : Dir) {
+    const auto &Path = File.path();
+    if (Path.extension() == ".wl")
+      TestConstantFolding(Path.native());
+  }
+}
\ No newline at end of file
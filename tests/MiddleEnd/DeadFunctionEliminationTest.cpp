@@ -0,0 +1,71 @@
+#include "MiddleEnd/Optimizers/DeadFunctionElimination.h"
+#include "MiddleEnd/Optimizers/ConstantFolding.h"
+#include "MiddleEnd/CodeGen/CodeGen.h"
+#include "FrontEnd/Lex/Lexer.h"
+#include "FrontEnd/Parse/Parser.h"
+#include "FrontEnd/Analysis/VariableUseAnalysis.h"
+#include "FrontEnd/Analysis/FunctionAnalysis.h"
+#include "FrontEnd/Analysis/TypeAnalysis.h"
+#include "Utility/Files.h"
+#include <filesystem>
+#include <iostream>
+
+using namespace std::string_view_literals;
+
+/// First line of program should contain names of functions, that
+/// should be left in LLVM module, f.e.
+/// // main f g
+void TestDeadFunctionElimination(std::string_view Path) {
+  std::cout << "Testing file " << Path << "...\n";
+  std::string Program = weak::FileAsString(Path);
+
+  if (Program.substr(0, 3) != "// ") {
+    std::cerr << "Expected list of generated functions.";
+    exit(-1);
+  }
+
+  std::string ExpectedFunctions = Program.substr(
+    "// "sv.length(),
+    Program.find_first_of('\n') - "// "sv.length()
+  );
+
+  weak::Lexer Lex(&Program.front(), &Program.back());
+  auto Tokens = Lex.Analyze();
+  weak::Parser Parser(&Tokens.front(), &Tokens.back());
+  auto AST = Parser.Parse();
+
+  weak::VariableUseAnalysis(AST.get()).Analyze();
+  weak::FunctionAnalysis(AST.get()).Analyze();
+  weak::TypeAnalysis(AST.get()).Analyze();
+  weak::RunConstantFoldingPass(AST.get());
+  weak::RunDeadFunctionEliminationPass(AST.get());
+
+  weak::CodeGen CG(AST.get());
+  CG.CreateCode();
+
+  std::string GeneratedFunctions;
+  for (const auto &F : CG.GlobalFunctions()) {
+    if (!GeneratedFunctions.empty())
+      GeneratedFunctions += ' ';
+    GeneratedFunctions += F.getName().str();
+  }
+
+  if (GeneratedFunctions == ExpectedFunctions)
+    return;
+
+  std::cerr
+    << "Functions mismatch:\n\t" << GeneratedFunctions
+    << "\ngot, but\n\t" << ExpectedFunctions << "\nexpected.";
+  exit(-1);
+}
+
+int main() {
+  auto Dir = std::filesystem::directory_iterator(
+    std::filesystem::current_path().concat("/DeadFunctionElimination")
+  );
+  for (const auto &File : Dir) {
+    const auto &Path = File.path();
+    if (Path.extension() == ".wl")
+      TestDeadFunctionElimination(Path.native());
+  }
+}
\ No newline at end of file
@@ -0,0 +1,120 @@
+#include "MiddleEnd/CodeGen/CodeGen.h"
+#include "FrontEnd/Lex/Lexer.h"
+#include "FrontEnd/Parse/Parser.h"
+#include "FrontEnd/Analysis/VariableUseAnalysis.h"
+#include "FrontEnd/Analysis/FunctionAnalysis.h"
+#include "FrontEnd/Analysis/TypeAnalysis.h"
+#include "Utility/Files.h"
+#include "llvm/IR/DebugInfoMetadata.h"
+#include "llvm/IR/InstIterator.h"
+#include "llvm/IR/IntrinsicInst.h"
+#include "llvm/IR/Verifier.h"
+#include <filesystem>
+#include <iostream>
+
+/// This gets all contents of first comment placed
+/// at the very beginning of input program.
+std::string ExtractDescription(std::string Program) {
+  std::string Expected;
+
+  using namespace std::string_view_literals;
+  while (Program.size() > 3 && Program.substr(0, 3) == "// ") {
+    const auto EOL = Program.find_first_of('\n');
+    Expected += Program.substr(3, EOL - "// "sv.length());
+    Expected += '\n';
+    Program = Program.substr(EOL + 1);
+  }
+
+  return Expected;
+}
+
+/// Print subprogram and described variables of function in form
+/// name:line [var:line] [var:line]
+///
+/// Also checks, that every instruction except stack slots and phi nodes
+/// has source location.
+std::string PrintDebugInfo(const llvm::Function &F) {
+  const llvm::DISubprogram *SP = F.getSubprogram();
+  if (!SP) {
+    std::cerr << "Function " << F.getName().str() << " has no subprogram.";
+    exit(-1);
+  }
+
+  std::string Result = SP->getName().str() + ":" + std::to_string(SP->getLine());
+  std::vector<const llvm::DILocalVariable *> Vars;
+
+  for (const auto &I : llvm::instructions(F)) {
+    if (auto *Dbg = llvm::dyn_cast<llvm::DbgVariableIntrinsic>(&I)) {
+      if (std::find(Vars.begin(), Vars.end(), Dbg->getVariable()) == Vars.end())
+        Vars.push_back(Dbg->getVariable());
+      continue;
+    }
+
+    if (llvm::isa<llvm::AllocaInst>(I) || llvm::isa<llvm::PHINode>(I))
+      continue;
+
+    if (!I.getDebugLoc()) {
+      std::cerr << "Instruction without location in " << F.getName().str() << ":\n";
+      I.print(llvm::errs());
+      exit(-1);
+    }
+  }
+
+  for (const auto *V : Vars)
+    Result += " [" + V->getName().str() + ":" + std::to_string(V->getLine()) + "]";
+
+  return Result;
+}
+
+void TestDebugInfo(std::string_view Path) {
+  std::cout << "Testing file " << Path << "...\n";
+  std::string Program = weak::FileAsString(Path);
+
+  weak::Lexer Lex(&Program.front(), &Program.back());
+  auto Tokens = Lex.Analyze();
+  weak::Parser Parser(&Tokens.front(), &Tokens.back());
+  auto AST = Parser.Parse();
+
+  weak::VariableUseAnalysis(AST.get()).Analyze();
+  weak::FunctionAnalysis(AST.get()).Analyze();
+  weak::TypeAnalysis(AST.get()).Analyze();
+
+  weak::CodeGenOptions Options;
+  Options.BoundsCheck = true;
+  Options.DebugInfo = true;
+  Options.SourcePath = Path;
+  weak::CodeGen CG(AST.get(), Options);
+  CG.CreateCode();
+
+  bool BrokenDebugInfo = false;
+  if (llvm::verifyModule(CG.Module(), &llvm::errs(), &BrokenDebugInfo) || BrokenDebugInfo) {
+    std::cerr << "Invalid module generated.";
+    exit(-1);
+  }
+
+  std::string Generated;
+  for (const auto &F : CG.GlobalFunctions())
+    if (!F.isDeclaration())
+      Generated += PrintDebugInfo(F) + '\n';
+
+  std::string Expected = ExtractDescription(Program);
+
+  if (Generated == Expected)
+    return;
+
+  std::cerr
+    << "Debug info mismatch:\n" << Generated
+    << "got, but\n" << Expected << "expected.";
+  exit(-1);
+}
+
+int main() {
+  auto Dir = std::filesystem::directory_iterator(
+    std::filesystem::current_path().concat("/DebugInfo")
+  );
+  for (const auto &File : Dir) {
+    const auto &Path = File.path();
+    if (Path.extension() == ".wl")
+      TestDebugInfo(Path.native());
+  }
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+#include "MiddleEnd/CodeGen/CodeGen.h"
+#include "FrontEnd/Lex/Lexer.h"
+#include "FrontEnd/Parse/Parser.h"
+#include "FrontEnd/Analysis/VariableUseAnalysis.h"
+#include "FrontEnd/Analysis/FunctionAnalysis.h"
+#include "FrontEnd/Analysis/TypeAnalysis.h"
+#include "Utility/Files.h"
+#include <filesystem>
+#include <iostream>
+
+/// This gets all contents of first comment placed
+/// at the very beginning of input program.
+std::string ExtractAttributes(std::string Program) {
+  std::string Expected;
+
+  using namespace std::string_view_literals;
+  while (Program.size() > 3 && Program.substr(0, 3) == "// ") {
+    const auto EOL = Program.find_first_of('\n');
+    Expected += Program.substr(3, EOL - "// "sv.length());
+    Expected += '\n';
+    Program = Program.substr(EOL + 1);
+  }
+
+  return Expected;
+}
+
+/// Print function attributes and attributes of each parameter
+/// in form
+/// name: fn-attrs [param-attrs] [param-attrs]
+std::string PrintAttributes(const llvm::Function &F) {
+  std::string Result = F.getName().str() + ":";
+
+  if (auto Attrs = F.getAttributes().getFnAttrs().getAsString(); !Attrs.empty())
+    Result += " " + Attrs;
+
+  for (const auto &Arg : F.args())
+    Result += " [" + F.getAttributes().getParamAttrs(Arg.getArgNo()).getAsString() + "]";
+
+  return Result;
+}
+
+void TestFunctionAttributes(std::string_view Path) {
+  std::cout << "Testing file " << Path << "...\n";
+  std::string Program = weak::FileAsString(Path);
+
+  weak::Lexer Lex(&Program.front(), &Program.back());
+  auto Tokens = Lex.Analyze();
+  weak::Parser Parser(&Tokens.front(), &Tokens.back());
+  auto AST = Parser.Parse();
+
+  weak::VariableUseAnalysis(AST.get()).Analyze();
+  weak::FunctionAnalysis(AST.get()).Analyze();
+  weak::TypeAnalysis(AST.get()).Analyze();
+
+  weak::CodeGen CG(AST.get());
+  CG.CreateCode();
+
+  std::string Generated;
+  for (const auto &F : CG.GlobalFunctions())
+    if (!F.isDeclaration())
+      Generated += PrintAttributes(F) + '\n';
+
+  std::string Expected = ExtractAttributes(Program);
+
+  if (Generated == Expected)
+    return;
+
+  std::cerr
+    << "Attributes mismatch:\n" << Generated
+    << "got, but\n" << Expected << "expected.";
+  exit(-1);
+}
+
+int main() {
+  auto Dir = std::filesystem::directory_iterator(
+    std::filesystem::current_path().concat("/FunctionAttributes")
+  );
+  for (const auto &File : Dir) {
+    const auto &Path = File.path();
+    if (Path.extension() == ".wl")
+      TestFunctionAttributes(Path.native());
+  }
+}
\ No newline at end of file
@@ -0,0 +1,15 @@
+// 4 0
+int main() {
+    int mem[10][20];
+    for (int i = 0; i < 10; ++i) {
+        for (int j = 0; j <= 19; j += 2) {
+            mem[i][j] = i * j;
+        }
+    }
+    int n = 9;
+    for (int i = 0; i < n; ++i) {
+        mem[i + 1][19 - i] = 0;
+    }
+    mem[9][19] = 1;
+    return mem[0][0];
+}
\ No newline at end of file
@@ -0,0 +1,20 @@
+// 0 4
+int get(int mem[10], int i) {
+    int r = 0;
+    r = mem[i];
+    return r;
+}
+
+int main() {
+    int mem[10];
+    int k = 0;
+    for (int i = 0; i < 10; ++i) {
+        mem[i + 1] = i;
+        k = mem[i * 2];
+    }
+    for (int i = 0; i < 10; ++i) {
+        ++i;
+        mem[i] = 0;
+    }
+    return get(mem, 0);
+}
\ No newline at end of file
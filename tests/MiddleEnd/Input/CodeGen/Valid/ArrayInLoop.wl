@@ -0,0 +1,12 @@
+// 159
+int main() {
+    int s = 0;
+    int i = 0;
+    while (i < 100000) {
+        int a[64];
+        a[0] = i;
+        s = a[0];
+        ++i;
+    }
+    return s;
+}
\ No newline at end of file
@@ -0,0 +1,31 @@
+// 42
+int find(int n) {
+    int i = 0;
+    while (i < 100) {
+        int a[16];
+        a[0] = i;
+        if (a[0] == n) {
+            int b[4];
+            b[1] = a[0];
+            return b[1];
+        }
+        ++i;
+    }
+    return 0;
+}
+
+int main() {
+    int s = 0;
+    for (int i = 0; i < 1000; ++i) {
+        int a[32];
+        a[1] = i;
+        if (a[1] < 10) {
+            continue;
+        }
+        if (a[1] > 20) {
+            break;
+        }
+        s = s + 1;
+    }
+    return s + find(31);
+}
\ No newline at end of file
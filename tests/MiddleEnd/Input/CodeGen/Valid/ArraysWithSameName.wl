@@ -0,0 +1,29 @@
+// 118
+// Arrays of different functions have the same name, but different sizes.
+// Indices are checked against array, visible at the point of access.
+int small() {
+    int buf[2];
+    buf[0] = 1;
+    buf[1] = 2;
+    return buf[0] + buf[1];
+}
+
+int large(int n) {
+    int buf[8];
+    for (int i = 0; i < n; ++i) {
+        buf[i] = i;
+    }
+    return buf[n - 1];
+}
+
+int text(int n) {
+    string buf = "weak compiler";
+    if (buf[n] == 'l') {
+        return 108;
+    }
+    return 0;
+}
+
+int main() {
+    return small() + large(8) + text(10);
+}
\ No newline at end of file
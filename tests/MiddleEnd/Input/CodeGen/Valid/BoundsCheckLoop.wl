@@ -0,0 +1,16 @@
+// 45
+int sum(int mem[10], int n) {
+    int result = 0;
+    for (int i = 0; i < n; ++i) {
+        result += mem[i];
+    }
+    return result;
+}
+
+int main() {
+    int mem[10];
+    for (int i = 0; i < 10; ++i) {
+        mem[i] = i;
+    }
+    return sum(mem, 10);
+}
\ No newline at end of file
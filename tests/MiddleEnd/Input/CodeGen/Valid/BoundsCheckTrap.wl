@@ -0,0 +1,12 @@
+// 132
+int get(int mem[10], int i) {
+    int r = 0;
+    r = mem[i];
+    return r;
+}
+
+int main() {
+    int mem[10];
+    mem[0] = 1;
+    return get(mem, 10);
+}
\ No newline at end of file
@@ -0,0 +1,38 @@
+// 220
+int find(int a[10], int key) {
+    int pos = 0 - 1;
+    for (int i = 0; i < 10; ++i) {
+        if (a[i] == key) {
+            pos = i;
+            break;
+        }
+    }
+    return pos;
+}
+
+int main() {
+    int a[10];
+    for (int i = 0; i < 10; ++i) {
+        a[i] = i * 3;
+    }
+    int skipped = 0;
+    int i = 0;
+    while (i < 10) {
+        ++i;
+        if (i < 5) {
+            continue;
+        }
+        ++skipped;
+    }
+    int n = 0;
+    do {
+        ++n;
+        if (n == 2) {
+            continue;
+        }
+        if (n == 4) {
+            break;
+        }
+    } while (n < 100);
+    return find(a, 21) * 10 + skipped + n * 100;
+}
\ No newline at end of file
@@ -0,0 +1,15 @@
+// 120
+int factorial(int n) {
+    if (n <= 1) {
+        return 1;
+    }
+    return n * factorial(n - 1);
+}
+
+export int api(int n) {
+    return factorial(n);
+}
+
+int main() {
+    return factorial(5);
+}
\ No newline at end of file
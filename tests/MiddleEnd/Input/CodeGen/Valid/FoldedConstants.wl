@@ -0,0 +1,23 @@
+// 41
+int main() {
+  int a = 2 + 3 * 4;
+  int b = (64 >> 2) - a;
+  bool c = 1 < 2;
+  int r = 0;
+  if (c) {
+    r = a + b;
+  } else {
+    r = 100;
+  }
+  for (int i = 0; false; ++i) {
+    r = 200;
+  }
+  do {
+    r += 24;
+  } while (false);
+  int d = 1;
+  if (false) {
+    d = 0;
+  }
+  return r + d;
+}
\ No newline at end of file
@@ -0,0 +1,19 @@
+// 28
+int logic(int a, int b) {
+    return a > 0 && b > 0 || a == b;
+}
+
+int id(int x) {
+    return x;
+}
+
+int main() {
+    int m = 0 - 1;
+    int s = logic(1, 2) + logic(m, m) + logic(m, 2) + logic(3, 0);
+    s = s + id(1 > 0 && 2 < 0) + id(1 > 0 || 2 < 0);
+    int k = id(5 == 5) + 10;
+    if (logic(7, 7) == 1) {
+        s = s + k;
+    }
+    return s * 2;
+}
\ No newline at end of file
@@ -0,0 +1,26 @@
+// 224
+int sum(int a[64]) {
+    int s = 0;
+    #unroll(4) #vectorize(width=8) #interleave(2)
+    for (int i = 0; i < 64; ++i) {
+        s += a[i];
+    }
+    int k = 0;
+    #nounroll
+    while (k < 10) {
+        ++k;
+    }
+    #unroll(full)
+    do {
+        --k;
+    } while (k > 0);
+    return s + k;
+}
+
+int main() {
+    int a[64];
+    for (int i = 0; i < 64; ++i) {
+        a[i] = i;
+    }
+    return sum(a);
+}
\ No newline at end of file
@@ -0,0 +1,56 @@
+// 84
+struct point {
+    int x;
+    int y;
+}
+
+int sum(in int mem[100]) {
+    int s = 0;
+    for (int i = 0; i < 100; ++i) {
+        s += mem[i];
+    }
+    return s;
+}
+
+void add(restrict int to[100], in int from[100]) {
+    for (int i = 0; i < 100; ++i) {
+        to[i] += from[i];
+    }
+}
+
+void fill(inout int mem[100], int value) {
+    for (int i = 0; i < 100; ++i) {
+        mem[i] = value;
+    }
+}
+
+void move(inout point p, int dx) {
+    p.x += dx;
+}
+
+int length(point p) {
+    p.x *= 2;
+    return p.x + p.y;
+}
+
+int dot(in point a, in point b) {
+    return a.x * b.x + a.y * b.y;
+}
+
+int main() {
+    int a[100];
+    int b[100];
+    fill(a, 1);
+    fill(b, 2);
+    add(a, b);
+    point p;
+    p.x = 1;
+    p.y = 2;
+    move(p, 3);
+    int l = length(p);
+    int r = sum(a) - 250;
+    r += p.x;
+    r += l;
+    r += dot(p, p);
+    return r;
+}
\ No newline at end of file
@@ -0,0 +1,23 @@
+// 5
+int merge(int n) {
+    int s = 0;
+    for (int i = 0; i < n; ++i) {
+        if (i < 5) {
+            s += i;
+        } else {
+            s -= 1;
+        }
+    }
+    int k = 0;
+    while (k < 10) {
+        k += 3;
+    }
+    do {
+        k -= 1;
+    } while (k > 0);
+    return s + k;
+}
+
+int main() {
+    return merge(10);
+}
\ No newline at end of file
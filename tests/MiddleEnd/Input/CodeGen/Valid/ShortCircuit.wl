@@ -0,0 +1,25 @@
+// 110
+int touch(int a[1]) {
+    a[0] += 1;
+    return 1;
+}
+
+int main() {
+    int c[1];
+    c[0] = 0;
+    int x = 0;
+    if ((x == 1) && (touch(c) == 1)) {
+        x = 5;
+    }
+    if ((x == 0) || (touch(c) == 1)) {
+        x = x + 1;
+    }
+    bool b = (x == 1) && (touch(c) == 1);
+    if (b) {
+        ++x;
+    }
+    while ((x < 10) && (x > 0)) {
+        ++x;
+    }
+    return c[0] * 100 + x;
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+// 142
+int strcmp(string l, string r);
+string strcpy(string dst, string src);
+
+int count(string s, int n, char c) {
+    int result = 0;
+    for (int i = 0; i < n; ++i) {
+        if (s[i] == c) {
+            ++result;
+        }
+    }
+    return result;
+}
+
+void upper(string s) {
+    s[0] = 'H';
+}
+
+int main() {
+    string a = "hello";
+    string b = "hello";
+    string c = "hello";
+    string d = "hello";
+    strcpy(b, "HELLO");
+    upper(c);
+    ++d[1];
+    int result = 0;
+    if (a[4] == 'o') {
+        result = result + 100;
+    }
+    if (strcmp(b, "HELLO") == 0) {
+        result = result + 20;
+    }
+    if (strcmp(c, "Hello") == 0) {
+        result = result + 10;
+    }
+    if (d[1] == 'f') {
+        result = result + 10;
+    }
+    return result + count(a, 5, 'l');
+}
\ No newline at end of file
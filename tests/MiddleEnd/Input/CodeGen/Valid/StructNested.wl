@@ -0,0 +1,37 @@
+// 154
+struct nested {
+    int z;
+}
+
+struct outer {
+    char tag;
+    int a;
+    struct nested {
+        char d;
+        int e;
+        struct deep {
+            int f;
+            int g;
+        };
+    };
+    int b;
+}
+
+int main() {
+    outer o;
+    nested n;
+    n.z = 7;
+    o.tag = 'x';
+    o.a = 1;
+    o.b = 2;
+    o.nested.d = 'y';
+    o.nested.e = 10;
+    o.nested.deep.f = 100;
+    o.nested.deep.g = 20;
+    o.b += 3;
+    o.a += 1;
+    for (int i = 0; i < 5; ++i) {
+        o.nested.deep.g += i;
+    }
+    return o.a + o.b + o.nested.e + o.nested.deep.f + o.nested.deep.g + n.z;
+}
\ No newline at end of file
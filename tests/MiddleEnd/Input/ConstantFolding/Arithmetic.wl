@@ -0,0 +1,40 @@
+//CompoundStmt <line:0, col:0>
+//  FunctionDecl <line:29, col:1>
+//    FunctionDeclRetType <line:29, col:1> <INT>
+//    FunctionDeclName <line:29, col:1> `main`
+//    FunctionDeclArgs <line:29, col:1>
+//    FunctionDeclBody <line:29, col:1>
+//      CompoundStmt <line:29, col:12>
+//        VarDecl <line:34, col:3> <INT> `e`
+//          BinaryOperator <line:34, col:13> /
+//            Number <line:34, col:11> 1
+//            Number <line:34, col:15> 0
+//        VarDecl <line:35, col:3> <INT> `f`
+//          BinaryOperator <line:35, col:13> <<
+//            Number <line:35, col:11> 1
+//            Number <line:35, col:16> 32
+//        VarDecl <line:37, col:3> <INT> `r`
+//          Number <line:37, col:11> 0
+//        BinaryOperator <line:38, col:5> =
+//          Symbol <line:38, col:3> `r`
+//          BinaryOperator <line:38, col:9> +
+//            Number <line:38, col:7> 14
+//            BinaryOperator <line:38, col:13> +
+//              Symbol <line:38, col:11> `e`
+//              BinaryOperator <line:38, col:17> +
+//                Symbol <line:38, col:15> `f`
+//                Number <line:38, col:19> -1
+//        ReturnStmt <line:39, col:3>
+//          Symbol <line:39, col:10> `r`
+int main() {
+  int a = 2 + 3 * 4;
+  float b = 1.5 * 2.0;
+  bool c = 1 < 2;
+  char d = 'a' + 'b';
+  int e = 1 / 0;
+  int f = 1 << 32;
+  int g = (5 - 7) >> 1;
+  int r = 0;
+  r = a + e + f + g;
+  return r;
+}
\ No newline at end of file
@@ -0,0 +1,59 @@
+//CompoundStmt <line:0, col:0>
+//  FunctionDecl <line:33, col:1>
+//    FunctionDeclRetType <line:33, col:1> <INT>
+//    FunctionDeclName <line:33, col:1> `main`
+//    FunctionDeclArgs <line:33, col:1>
+//    FunctionDeclBody <line:33, col:1>
+//      CompoundStmt <line:33, col:12>
+//        VarDecl <line:34, col:3> <INT> `r`
+//          Number <line:34, col:11> 0
+//        CompoundStmt <line:37, col:10>
+//          BinaryOperator <line:38, col:7> =
+//            Symbol <line:38, col:5> `r`
+//            Number <line:38, col:9> 2
+//        CompoundStmt <line:40, col:13>
+//          BinaryOperator <line:41, col:7> +=
+//            Symbol <line:41, col:5> `r`
+//            Number <line:41, col:10> 3
+//        CompoundStmt <line:49, col:3>
+//          VarDecl <line:49, col:8> <INT> `i`
+//            Number <line:49, col:16> 0
+//        CompoundStmt <line:52, col:6>
+//          BinaryOperator <line:53, col:7> +=
+//            Symbol <line:53, col:5> `r`
+//            Number <line:53, col:10> 7
+//        DoWhileStmt <line:55, col:3>
+//          DoWhileStmtBody <line:55, col:6>
+//            CompoundStmt <line:55, col:6>
+//              BreakStmt <line:56, col:5>
+//          DoWhileStmtCond <line:57, col:12>
+//            BooleanLiteral <line:57, col:12> false
+//        ReturnStmt <line:58, col:3>
+//          Symbol <line:58, col:10> `r`
+int main() {
+  int r = 0;
+  if (1 == 2) {
+    r = 1;
+  } else {
+    r = 2;
+  }
+  if (true) {
+    r += 3;
+  }
+  if (false) {
+    r += 4;
+  }
+  while (1 > 2) {
+    r += 5;
+  }
+  for (int i = 0; 1 > 2; ++i) {
+    r += 6;
+  }
+  do {
+    r += 7;
+  } while (false);
+  do {
+    break;
+  } while (false);
+  return r;
+}
\ No newline at end of file
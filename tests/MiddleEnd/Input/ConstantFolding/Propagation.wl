@@ -0,0 +1,60 @@
+//CompoundStmt <line:0, col:0>
+//  FunctionDecl <line:46, col:1>
+//    FunctionDeclRetType <line:46, col:1> <INT>
+//    FunctionDeclName <line:46, col:1> `f`
+//    FunctionDeclArgs <line:46, col:1>
+//      VarDecl <line:46, col:7> <INT> `x`
+//    FunctionDeclBody <line:46, col:1>
+//      CompoundStmt <line:46, col:14>
+//        VarDecl <line:48, col:3> <INT> `z`
+//          Number <line:48, col:11> 20
+//        BinaryOperator <line:49, col:5> +=
+//          Symbol <line:49, col:3> `z`
+//          Symbol <line:49, col:8> `x`
+//        ReturnStmt <line:50, col:3>
+//          BinaryOperator <line:50, col:16> +
+//            Number <line:50, col:12> 20
+//            Symbol <line:50, col:18> `z`
+//    FunctionDecl <line:53, col:1>
+//      FunctionDeclRetType <line:53, col:1> <INT>
+//      FunctionDeclName <line:53, col:1> `main`
+//      FunctionDeclArgs <line:53, col:1>
+//      FunctionDeclBody <line:53, col:1>
+//        CompoundStmt <line:53, col:12>
+//          VarDecl <line:55, col:3> <INT> `sum`
+//            Number <line:55, col:13> 0
+//          ForStmt <line:56, col:3>
+//            ForStmtInit <line:56, col:8>
+//              VarDecl <line:56, col:8> <INT> `i`
+//                Number <line:56, col:16> 0
+//            ForStmtCondition <line:56, col:21>
+//              BinaryOperator <line:56, col:21> <
+//                Symbol <line:56, col:19> `i`
+//                Number <line:56, col:23> 3
+//            ForStmtIncrement <line:56, col:26>
+//              Prefix UnaryOperator <line:56, col:26> ++
+//                Symbol <line:56, col:28> `i`
+//            ForStmtBody <line:56, col:31>
+//              CompoundStmt <line:56, col:31>
+//                BinaryOperator <line:57, col:9> +=
+//                  Symbol <line:57, col:5> `sum`
+//                  Number <line:57, col:12> 3
+//          ReturnStmt <line:59, col:3>
+//            FunctionCall <line:59, col:10> `f`
+//              FunctionCallArgs <line:59, col:10>
+//                Number <line:59, col:12> 3
+int f(int x) {
+  int y = 10;
+  int z = 20;
+  z += x;
+  return y * 2 + z;
+}
+
+int main() {
+  int n = 3;
+  int sum = 0;
+  for (int i = 0; i < n; ++i) {
+    sum += n;
+  }
+  return f(n);
+}
\ No newline at end of file
@@ -0,0 +1,12 @@
+// main
+int debug(int x) {
+  return x;
+}
+
+int main() {
+  int r = 0;
+  if (false) {
+    r = debug(1);
+  }
+  return r;
+}
\ No newline at end of file
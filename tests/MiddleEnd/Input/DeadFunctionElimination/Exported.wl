@@ -0,0 +1,16 @@
+// helper api main
+int helper(int x) {
+  return x * 2;
+}
+
+int unused(int x) {
+  return x;
+}
+
+export int api(int x) {
+  return helper(x);
+}
+
+int main() {
+  return 0;
+}
\ No newline at end of file
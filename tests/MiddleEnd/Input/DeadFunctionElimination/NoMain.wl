@@ -0,0 +1,8 @@
+// first second
+int first(int x) {
+  return x;
+}
+
+int second(int x) {
+  return x;
+}
\ No newline at end of file
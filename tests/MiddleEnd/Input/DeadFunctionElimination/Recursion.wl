@@ -0,0 +1,15 @@
+// fact main
+int fact(int x) {
+  if (x == 0) {
+    return 1;
+  }
+  return x * fact(x - 1);
+}
+
+int dead_recursion(int x) {
+  return dead_recursion(x);
+}
+
+int main() {
+  return fact(5);
+}
\ No newline at end of file
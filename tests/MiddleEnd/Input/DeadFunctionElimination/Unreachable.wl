@@ -0,0 +1,20 @@
+// used helper main
+int unused(int x) {
+  return x + 1;
+}
+
+int used(int x) {
+  return x * 2;
+}
+
+int helper(int x) {
+  return used(x);
+}
+
+int unused_caller() {
+  return unused(1);
+}
+
+int main() {
+  return helper(2);
+}
\ No newline at end of file
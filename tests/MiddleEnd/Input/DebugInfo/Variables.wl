@@ -0,0 +1,38 @@
+// sum:11 [mem:11] [n:11] [s:12] [i:13]
+// dot:19 [a:19] [b:19]
+// main:23 [mem:24] [i:25] [p:28] [text:31] [result:33]
+struct point {
+    int x;
+    int y;
+}
+
+int puts(string s);
+
+int sum(in int mem[10], int n) {
+    int s = 0;
+    for (int i = 0; i < n; ++i) {
+        s += mem[i];
+    }
+    return s;
+}
+
+int dot(point a, in point b) {
+    return a.x * b.x + a.y * b.y;
+}
+
+int main() {
+    int mem[10];
+    for (int i = 0; i < 10; ++i) {
+        mem[i] = i;
+    }
+    point p;
+    p.x = 2;
+    p.y = 3;
+    string text = "Hello";
+    puts(text);
+    int result = sum(mem, 10);
+    while (result > 100) {
+        result -= 100;
+    }
+    return result + dot(p, p);
+}
\ No newline at end of file
@@ -0,0 +1,18 @@
+// compare: []
+// ignore: norecurse nounwind readonly willreturn [nocapture readnone]
+// main: norecurse
+int strcmp(string l, string r);
+
+export int compare(string l) {
+    return strcmp(l, "abc");
+}
+
+int ignore(string s) {
+    string copy = "abc";
+    return 0;
+}
+
+int main() {
+    string s = "abc";
+    return compare(s) + ignore(s);
+}
\ No newline at end of file
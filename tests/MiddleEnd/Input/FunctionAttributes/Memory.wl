@@ -0,0 +1,40 @@
+// square: norecurse nounwind readnone willreturn []
+// first: argmemonly norecurse nounwind readonly willreturn [nocapture readonly]
+// set_first: argmemonly norecurse nounwind willreturn [nocapture] []
+// copy_first: argmemonly norecurse nounwind willreturn [nocapture] [nocapture readonly]
+// sum: argmemonly norecurse nounwind readonly [nocapture readonly]
+// main: norecurse nounwind readnone
+int square(int x) {
+    return x * x;
+}
+
+int first(int mem[10]) {
+    int r = 0;
+    r = mem[0];
+    return r;
+}
+
+int set_first(int mem[10], int value) {
+    mem[0] = value;
+    return 0;
+}
+
+int copy_first(int to[10], int from[10]) {
+    return set_first(to, first(from));
+}
+
+int sum(int mem[10]) {
+    int result = 0;
+    for (int i = 0; i < 10; ++i) {
+        result += mem[i];
+    }
+    return result;
+}
+
+int main() {
+    int a[10];
+    int b[10];
+    set_first(a, square(3));
+    copy_first(b, a);
+    return sum(b);
+}
\ No newline at end of file
@@ -0,0 +1,42 @@
+// sum: argmemonly norecurse nounwind readonly [nocapture readonly align 4 dereferenceable(64)]
+// scale: argmemonly norecurse nounwind [noalias nocapture align 4 dereferenceable(64)] [nocapture readonly align 4 dereferenceable(64)]
+// swap: argmemonly norecurse nounwind willreturn [nocapture align 4 dereferenceable(8)]
+// first: argmemonly norecurse nounwind readonly willreturn [nocapture readonly byval(%pair) align 4]
+// main: norecurse nounwind readnone
+struct pair {
+    int a;
+    int b;
+}
+
+int sum(in int mem[16]) {
+    int s = 0;
+    for (int i = 0; i < 16; ++i) {
+        s += mem[i];
+    }
+    return s;
+}
+
+void scale(restrict int to[16], in int from[16]) {
+    for (int i = 0; i < 16; ++i) {
+        to[i] = from[i] * 2;
+    }
+}
+
+void swap(inout pair p) {
+    int t = p.a;
+    p.a = p.b;
+    p.b = t;
+}
+
+int first(pair p) {
+    return p.a;
+}
+
+int main() {
+    int a[16];
+    int b[16];
+    scale(b, a);
+    pair p;
+    swap(p);
+    return sum(b) + first(p);
+}
\ No newline at end of file
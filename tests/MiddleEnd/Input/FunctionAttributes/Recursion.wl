@@ -0,0 +1,12 @@
+// fact: nounwind readnone []
+// main: norecurse nounwind readnone
+int fact(int x) {
+    if (x == 0) {
+        return 1;
+    }
+    return x * fact(x - 1);
+}
+
+int main() {
+    return fact(5);
+}
\ No newline at end of file
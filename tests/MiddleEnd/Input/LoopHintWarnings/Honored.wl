@@ -0,0 +1,12 @@
+export int sum(int a[64]) {
+    int s = 0;
+    #vectorize(width=8)
+    for (int i = 0; i < 64; ++i) {
+        s += a[i];
+    }
+    #unroll(4)
+    for (int i = 0; i < 64; ++i) {
+        a[i] = s;
+    }
+    return s;
+}
\ No newline at end of file
@@ -0,0 +1,11 @@
+// Warning: In function `recurrence`: loop not vectorized: the optimizer was unable to perform the requested transformation; the transformation might be disabled or specified as part of an unsupported transformation ordering
+export int recurrence(int n) {
+    int s = 0;
+    int p = 1;
+    #vectorize(width=8)
+    for (int i = 0; i < n; ++i) {
+        s = s + p;
+        p = p * 3 + s;
+    }
+    return s;
+}
\ No newline at end of file
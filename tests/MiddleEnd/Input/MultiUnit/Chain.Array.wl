@@ -0,0 +1,11 @@
+// Calls back to third unit.
+int fillone(int i);
+
+export int fill(int array[16], int n) {
+    int sum = 0;
+    for (int i = 0; i < n; ++i) {
+        array[i] = fillone(i);
+        sum = sum + array[i];
+    }
+    return sum;
+}
\ No newline at end of file
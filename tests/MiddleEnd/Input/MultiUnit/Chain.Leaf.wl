@@ -0,0 +1,8 @@
+// Leaf functions.
+export int fillone(int i) {
+    return i;
+}
+
+export float scale(float x) {
+    return x / 2.0;
+}
\ No newline at end of file
@@ -0,0 +1,13 @@
+// 42
+float scale(float x);
+int fill(int array[16], int n);
+
+int main() {
+    int array[16];
+    int sum = fill(array, 16);
+    float half = scale(10.0);
+    if (half > 4.9) {
+        return sum - 78;
+    }
+    return 0;
+}
\ No newline at end of file
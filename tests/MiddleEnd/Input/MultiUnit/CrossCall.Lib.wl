@@ -0,0 +1,16 @@
+// Same helper is defined in other unit, but is not exported.
+int helper() {
+    return 1;
+}
+
+export int square(int x) {
+    return x * x + helper() - 1;
+}
+
+export int sum(int n) {
+    int s = 0;
+    for (int i = 1; i <= n; ++i) {
+        s = s + i;
+    }
+    return s - 45 + 10;
+}
\ No newline at end of file
@@ -0,0 +1,11 @@
+// 73
+int square(int x);
+int sum(int n);
+
+int helper() {
+    return 3;
+}
+
+int main() {
+    return square(helper()) + sum(10) + 64;
+}
\ No newline at end of file
@@ -0,0 +1,8 @@
+// Not exported, so not visible from other units.
+int helper() {
+    return 1;
+}
+
+export int unused() {
+    return helper();
+}
\ No newline at end of file
@@ -0,0 +1,6 @@
+// Link error: undefined symbol: helper
+int helper();
+
+int main() {
+    return helper();
+}
\ No newline at end of file
@@ -0,0 +1,6 @@
+// Link error: undefined symbol: helper
+int helper(int x);
+
+int main() {
+    return helper(1);
+}
\ No newline at end of file
@@ -0,0 +1,30 @@
+// 188
+// Error path is defined first, but is never executed, so with profile
+// it is placed after main, that runs the hot loop.
+export int recover(int x) {
+    int r = 0;
+    for (int i = 0; i < x; ++i) {
+        r = r + (i * 7) / 13;
+    }
+    return r;
+}
+
+export int step(int x) {
+    if (x - (x / 3) * 3 == 0) {
+        return x / 3;
+    }
+    return x + 1;
+}
+
+int main() {
+    int s = 0;
+    for (int i = 0; i < 100000; ++i) {
+        int v = step(i);
+        if (v < 0) {
+            s = s + recover(v);
+        }
+        s = s + v;
+        s = s - (s / 1000) * 1000;
+    }
+    return s - (s / 256) * 256;
+}
\ No newline at end of file
@@ -0,0 +1,24 @@
+// 48
+// item 24 16 12
+struct item {
+    char tag;
+    int count;
+    char flag;
+    float weight;
+    bool dirty;
+    int id;
+}
+
+int main() {
+    item it;
+    it.tag = 'a';
+    it.flag = 'b';
+    it.dirty = true;
+    it.id = 3;
+    it.count = 0;
+    for (int i = 0; i < 10; ++i) {
+        it.count += i;
+        it.weight = 1.5;
+    }
+    return it.count + it.id;
+}
\ No newline at end of file
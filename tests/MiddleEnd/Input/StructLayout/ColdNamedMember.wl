@@ -0,0 +1,24 @@
+// 55
+// item 16 12 9
+struct item {
+    int hits;
+    char cold;
+    int total;
+    char flag;
+}
+
+int main() {
+    item it;
+    it.cold = 'c';
+    it.flag = 'f';
+    it.hits = 0;
+    it.total = 0;
+    for (int i = 0; i < 10; ++i) {
+        it.hits += 1;
+        it.total += i;
+    }
+    if (it.cold == 'c') {
+        return it.hits + it.total;
+    }
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,25 @@
+//function f(i32 %0) -> i32 {
+//bb0:
+//  %1 = alloca i32, 10
+//  %2 = icmp ult i32 %0, 10
+//  condbr %2, bb1, bb2
+//bb1: ; preds: bb0
+//  %3 = elemaddr i32 %1, %0
+//  store i32 1, %3
+//  condbr %2, bb3, bb2
+//bb2: ; preds: bb0 bb1
+//  trap
+//bb3: ; preds: bb1
+//  %4 = load i32 %3
+//  br bb4
+//bb4: ; preds: bb3
+//  %5 = elemaddr i32 %1, 2
+//  %6 = load i32 %5
+//  %7 = add i32 %4, %6
+//  ret i32 %7
+//}
+int f(int a) {
+  int arr[10];
+  arr[a] = 1;
+  return arr[a] + arr[2];
+}
\ No newline at end of file
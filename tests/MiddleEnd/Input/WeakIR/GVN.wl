@@ -0,0 +1,20 @@
+//function f(i32 %0, i32 %1) -> i32 {
+//bb0:
+//  %2 = add i32 %0, %1
+//  %3 = icmp sgt i32 %0, %1
+//  condbr %3, bb2, bb1
+//bb1: ; preds: bb0
+//  ret i32 %2
+//bb2: ; preds: bb0
+//  %4 = mul i32 %2, %2
+//  %5 = add i32 %4, %2
+//  ret i32 %5
+//}
+int f(int a, int b) {
+  int x = a + b;
+  int y = b + a;
+  if (a > b) {
+    return x * y + (a + b);
+  }
+  return a + b;
+}
\ No newline at end of file
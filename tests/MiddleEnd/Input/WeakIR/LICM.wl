@@ -0,0 +1,25 @@
+//function f(i32 %0, i32 %1, i32 %2) -> i32 {
+//bb0:
+//  %3 = mul i32 %0, %1
+//  br bb1
+//bb1: ; preds: bb0 bb4
+//  %4 = phi i32 [ 0, bb0 ], [ %8, bb4 ]
+//  %5 = phi i32 [ 0, bb0 ], [ %7, bb4 ]
+//  %6 = icmp slt i32 %4, %2
+//  condbr %6, bb3, bb2
+//bb2: ; preds: bb1
+//  ret i32 %5
+//bb3: ; preds: bb1
+//  %7 = add i32 %5, %3
+//  br bb4
+//bb4: ; preds: bb3
+//  %8 = add i32 %4, 1
+//  br bb1
+//}
+int f(int a, int b, int n) {
+  int s = 0;
+  for (int i = 0; i < n; ++i) {
+    s = s + a * b;
+  }
+  return s;
+}
\ No newline at end of file
@@ -0,0 +1,22 @@
+//function f(i32 %0, i32 %1) -> i32 {
+//bb0:
+//  br bb1
+//bb1: ; preds: bb0 bb3
+//  %2 = phi i32 [ 0, bb0 ], [ %4, bb3 ]
+//  %3 = icmp slt i32 %2, %1
+//  condbr %3, bb3, bb2
+//bb2: ; preds: bb1
+//  ret i32 %0
+//bb3: ; preds: bb1
+//  %4 = add i32 %2, 1
+//  br bb1
+//}
+int f(int a, int n) {
+  int x = a;
+  int i = 0;
+  while (i < n) {
+    x = x;
+    ++i;
+  }
+  return x;
+}
\ No newline at end of file
@@ -0,0 +1,26 @@
+//function f(i32 %0, i32 %1) -> i32 {
+//bb0:
+//  br bb1
+//bb1: ; preds: bb0 bb4
+//  %2 = phi i32 [ 0, bb0 ], [ %4, bb4 ]
+//  %3 = icmp slt i32 %2, %1
+//  condbr %3, bb3, bb2
+//bb2: ; preds: bb1
+//  ret i32 6
+//bb3: ; preds: bb1
+//  br bb4
+//bb4: ; preds: bb3
+//  %4 = add i32 %2, 1
+//  br bb1
+//}
+int f(int a, int n) {
+  int x = 3;
+  int i = 0;
+  while (i < n) {
+    if (x != 3) {
+      x = a;
+    }
+    ++i;
+  }
+  return x * 2;
+}
\ No newline at end of file
@@ -0,0 +1,76 @@
+#include "MiddleEnd/CodeGen/CodeGen.h"
+#include "FrontEnd/Lex/Lexer.h"
+#include "FrontEnd/Parse/Parser.h"
+#include "FrontEnd/Analysis/VariableUseAnalysis.h"
+#include "FrontEnd/Analysis/FunctionAnalysis.h"
+#include "FrontEnd/Analysis/TypeAnalysis.h"
+#include "MiddleEnd/Driver/Driver.h"
+#include "MiddleEnd/Optimizers/Optimizers.h"
+#include "Utility/Diagnostic.h"
+#include "Utility/Files.h"
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+
+/// Program is optimized at -O2. Comments at the very beginning of it
+/// are warnings about loop hints, that optimizer is expected to miss.
+
+std::string ExtractExpectedWarns(std::string_view Program) {
+  std::string Expected;
+
+  using namespace std::string_view_literals;
+  while (Program.size() > 3 && Program.substr(0, 3) == "// ") {
+    const auto EOL = Program.find_first_of('\n');
+    Expected += Program.substr(3, EOL - "// "sv.length());
+    Expected += '\n';
+    Program = Program.substr(EOL + 1);
+  }
+
+  return Expected;
+}
+
+void TestLoopHintWarnings(std::string_view Path) {
+  std::cout << "Testing file " << Path << "... ";
+  std::string Program = weak::FileAsString(Path);
+
+  weak::Lexer Lex(&Program.front(), &Program.back());
+  auto Tokens = Lex.Analyze();
+  weak::Parser Parser(&Tokens.front(), &Tokens.back());
+  auto AST = Parser.Parse();
+
+  weak::VariableUseAnalysis(AST.get()).Analyze();
+  weak::FunctionAnalysis(AST.get()).Analyze();
+  weak::TypeAnalysis(AST.get()).Analyze();
+
+  weak::CodeGen CG(AST.get());
+  CG.CreateCode();
+  weak::DriverOptions DriverOpts;
+  DriverOpts.OptLvl = O2;
+  weak::Driver Driver(CG.Module(), "LoopHintWarnings", DriverOpts);
+  weak::RunBuiltinLLVMOptimizationPass(CG.Module(), O2, &Driver.TargetMachine());
+
+  std::ostringstream Generated;
+  weak::PrintGeneratedWarns(Generated);
+  std::string Expected = ExtractExpectedWarns(Program);
+
+  if (Generated.str() == Expected) {
+    std::cout << "Success!" << std::endl;
+    return;
+  }
+
+  std::cerr
+    << "Warnings mismatch:\n" << Generated.str()
+    << "got, but\n" << Expected << "expected.";
+  exit(-1);
+}
+
+int main() {
+  auto Dir = std::filesystem::directory_iterator(
+    std::filesystem::current_path().concat("/LoopHintWarnings")
+  );
+  for (const auto &File : Dir) {
+    const auto &Path = File.path();
+    if (Path.extension() == ".wl")
+      TestLoopHintWarnings(Path.native());
+  }
+}
@@ -0,0 +1,150 @@
+#include "BackEnd/ELF/Linker.h"
+#include "BackEnd/X86/ObjectEmitter.h"
+#include "MiddleEnd/CodeGen/CodeGen.h"
+#include "FrontEnd/Lex/Lexer.h"
+#include "FrontEnd/Parse/Parser.h"
+#include "FrontEnd/Analysis/VariableUseAnalysis.h"
+#include "FrontEnd/Analysis/FunctionAnalysis.h"
+#include "FrontEnd/Analysis/TypeAnalysis.h"
+#include "MiddleEnd/Driver/Driver.h"
+#include "MiddleEnd/IR/ASTLowering.h"
+#include "MiddleEnd/IR/Passes.h"
+#include "MiddleEnd/Optimizers/ConstantFolding.h"
+#include "MiddleEnd/Optimizers/DeadFunctionElimination.h"
+#include "MiddleEnd/Optimizers/Optimizers.h"
+#include "Utility/Files.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <thread>
+
+/// Input files of one program are named <Program>.<Unit>.wl, main is
+/// defined in <Program>.Main.wl, which starts with expected exit code
+/// or link error.
+
+using Objects = std::vector<std::unique_ptr<llvm::MemoryBuffer>>;
+
+/// Compile input file to objects, or to bitcode with LTO. Called from
+/// many threads at once.
+Objects CompileUnit(const std::string &Path, bool Fast, weak::LTOKind LTO, unsigned CodeGenThreads) {
+  std::string Program = weak::FileAsString(Path);
+  weak::Lexer Lex(&Program.front(), &Program.back());
+  auto Tokens = Lex.Analyze();
+  weak::Parser Parser(&Tokens.front(), &Tokens.back());
+  auto AST = Parser.Parse();
+
+  weak::VariableUseAnalysis(AST.get()).Analyze();
+  weak::FunctionAnalysis(AST.get()).Analyze();
+  weak::TypeAnalysis(AST.get()).Analyze();
+  weak::RunConstantFoldingPass(AST.get());
+  weak::RunDeadFunctionEliminationPass(AST.get());
+
+  Objects Result;
+  weak::ir::Module WeakIR;
+  weak::CodeGenOptions Options;
+  if (Fast) {
+    WeakIR = weak::LowerToWeakIR(AST.get(), /*BoundsCheck=*/false);
+    weak::ir::RunDefaultPasses(WeakIR);
+    std::vector<char> Object = weak::x86::EmitObject(WeakIR);
+    Result.push_back(llvm::MemoryBuffer::getMemBufferCopy(
+      llvm::StringRef(Object.data(), Object.size()), Path + ".weak.o"));
+    Options.WeakIR = &WeakIR;
+    Options.WeakIRDeclarationsOnly = true;
+  }
+
+  weak::CodeGen CG(AST.get(), Options);
+  CG.CreateCode();
+  weak::DriverOptions DriverOpts;
+  DriverOpts.LTO = LTO;
+  DriverOpts.CodeGenThreads = CodeGenThreads;
+  weak::Driver Driver(CG.Module(), Path, DriverOpts);
+  if (LTO != weak::LTOKind::None) {
+    weak::RunBuiltinLLVMOptimizationPass(CG.Module(), O2, &Driver.TargetMachine(), LTO);
+    Result.push_back(Driver.EmitBitcode());
+  } else
+    for (auto &Object : Driver.EmitObjects())
+      Result.push_back(std::move(Object));
+  return Result;
+}
+
+void RunTest(const std::string &Name, const std::vector<std::string> &Paths, bool Fast,
+             weak::LTOKind LTO = weak::LTOKind::None, unsigned CodeGenThreads = 1U) {
+  std::string Suffix = Fast ? "_fast" : LTO == weak::LTOKind::Full ? "_lto" : LTO == weak::LTOKind::Thin ? "_thinlto" : "";
+  if (CodeGenThreads > 1U)
+    Suffix += "_split";
+  std::cout << "Testing program " << Name << Suffix << "... ";
+
+  std::vector<Objects> Units(Paths.size());
+  std::vector<std::thread> Threads;
+  for (size_t I = 0; I < Paths.size(); ++I)
+    Threads.emplace_back([&, I] { Units[I] = CompileUnit(Paths[I], Fast, LTO, CodeGenThreads); });
+  for (std::thread &T : Threads)
+    T.join();
+
+  if (LTO != weak::LTOKind::None) {
+    Objects Bitcode;
+    for (auto &Unit : Units)
+      for (auto &Module : Unit)
+        Bitcode.push_back(std::move(Module));
+    weak::DriverOptions DriverOpts;
+    DriverOpts.LTO = LTO;
+    DriverOpts.OptLvl = O2;
+    Units.clear();
+    Units.push_back(weak::LinkTimeOptimize(Bitcode, DriverOpts));
+  }
+
+  weak::elf::Linker Linker;
+  for (size_t I = 0; I < Units.size(); ++I)
+    for (auto &Object : Units[I])
+      Linker.AddObject(std::move(Object), I);
+  std::string PathToBin = Name + Suffix;
+
+  std::string Main = weak::FileAsString("MultiUnit/" + Name + ".Main.wl");
+  std::string Expected = Main.substr(3, Main.find_first_of('\n') - 3);
+  try {
+    Linker.Link(PathToBin);
+  } catch (const std::exception &E) {
+    if (E.what() != Expected) {
+      std::cerr << PathToBin << ": " << E.what() << " got, but " << Expected << " expected.";
+      exit(-1);
+    }
+    std::cout << "Success!\n";
+    return;
+  }
+
+  int ExpectedExitCode = std::stoi(Expected);
+  int ExitCode = WEXITSTATUS(system(("./" + PathToBin).c_str()));
+  if (ExitCode != ExpectedExitCode) {
+    std::cerr
+      << PathToBin << ": process exited with wrong exit code: " << ExitCode
+      << " got, but " << ExpectedExitCode << " expected.";
+    exit(-1);
+  }
+
+  std::cout << "Success!\n";
+}
+
+int main() {
+  auto Dir = std::filesystem::directory_iterator(
+    std::filesystem::current_path().concat("/MultiUnit")
+  );
+  std::map<std::string, std::vector<std::string>> Programs;
+  for (const auto &File : Dir) {
+    const auto &Path = File.path();
+    if (Path.extension() != ".wl")
+      continue;
+    std::string FileName = Path.filename().native();
+    Programs[FileName.substr(0, FileName.find('.'))].push_back(Path.native());
+  }
+
+  for (const auto &[Name, Paths] : Programs) {
+    RunTest(Name, Paths, /*Fast=*/false);
+    RunTest(Name, Paths, /*Fast=*/true);
+    RunTest(Name, Paths, /*Fast=*/false, weak::LTOKind::Full);
+    RunTest(Name, Paths, /*Fast=*/false, weak::LTOKind::Thin);
+    RunTest(Name, Paths, /*Fast=*/false, weak::LTOKind::None, /*CodeGenThreads=*/4U);
+  }
+
+  std::cout << "All tests passed!";
+}
\ No newline at end of file
@@ -0,0 +1,141 @@
+#include "MiddleEnd/CodeGen/CodeGen.h"
+#include "FrontEnd/Lex/Lexer.h"
+#include "FrontEnd/Parse/Parser.h"
+#include "FrontEnd/Analysis/VariableUseAnalysis.h"
+#include "FrontEnd/Analysis/FunctionAnalysis.h"
+#include "FrontEnd/Analysis/TypeAnalysis.h"
+#include "MiddleEnd/Driver/Driver.h"
+#include "MiddleEnd/Optimizers/Optimizers.h"
+#include "MiddleEnd/Optimizers/ProfileGuidedOptimization.h"
+#include "Utility/Files.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Object/ObjectFile.h"
+#include <filesystem>
+#include <iostream>
+#include <map>
+
+/// Program is compiled with instrumentation and run, then compiled
+/// again with profile it wrote. Hot main should go before cold error
+/// path, defined first.
+
+enum class BuildKind { Plain, Instrumented, ProfileUse };
+
+void Fail(const std::string &Message) {
+  std::cerr << Message;
+  exit(-1);
+}
+
+/// Execution counts, attached by profile, and sections, code generator
+/// put hot and cold functions to.
+void CheckProfileUse(llvm::Module &M) {
+  auto EntryCount = [&](const char *Name) -> uint64_t {
+    auto Count = M.getFunction(Name)->getEntryCount();
+    if (!Count)
+      Fail(std::string("No entry count of ") + Name + ".");
+    return Count->getCount();
+  };
+  if (!M.getProfileSummary(/*IsCS=*/false))
+    Fail("No profile summary.");
+  if (EntryCount("main") != 1U || EntryCount("step") != 100000U || EntryCount("recover") != 0U)
+    Fail("Wrong entry counts.");
+}
+
+void CheckSections(llvm::Module &M) {
+  auto Prefix = [&](const char *Name) {
+    return M.getFunction(Name)->getSectionPrefix().getValueOr("").str();
+  };
+  if (Prefix("main") != "hot")
+    Fail("main is not placed to hot section.");
+  if (Prefix("recover") != "unlikely")
+    Fail("recover is not placed to cold section.");
+}
+
+/// \return Addresses of functions in executable.
+std::map<std::string, uint64_t> ReadSymbols(const std::string &Path) {
+  auto Object = llvm::object::ObjectFile::createObjectFile(Path);
+  if (!Object)
+    Fail(Path + ": " + llvm::toString(Object.takeError()));
+  std::map<std::string, uint64_t> Symbols;
+  for (const auto &Symbol : Object->getBinary()->symbols())
+    Symbols[llvm::cantFail(Symbol.getName()).str()] = llvm::cantFail(Symbol.getAddress());
+  return Symbols;
+}
+
+/// Compile program at -O2 and link it.
+///
+/// \return Addresses of functions in executable.
+std::map<std::string, uint64_t> Build(
+  const std::string &Path,
+  const std::string &PathToBin,
+  BuildKind          Kind,
+  const std::string &ProfilePath
+) {
+  std::string Program = weak::FileAsString(Path);
+  weak::Lexer Lex(&Program.front(), &Program.back());
+  auto Tokens = Lex.Analyze();
+  weak::Parser Parser(&Tokens.front(), &Tokens.back());
+  auto AST = Parser.Parse();
+
+  weak::VariableUseAnalysis(AST.get()).Analyze();
+  weak::FunctionAnalysis(AST.get()).Analyze();
+  weak::TypeAnalysis(AST.get()).Analyze();
+
+  weak::CodeGenOptions Options;
+  Options.SourcePath = Path;
+  weak::CodeGen CG(AST.get(), Options);
+  CG.CreateCode();
+  weak::DriverOptions DriverOpts;
+  DriverOpts.OptLvl = O2;
+  weak::Driver Driver(CG.Module(), PathToBin, DriverOpts);
+  if (Kind == BuildKind::Instrumented)
+    weak::RunProfileInstrumentationPass(CG.Module(), ProfilePath);
+  if (Kind == BuildKind::ProfileUse) {
+    weak::RunProfileUsePass(CG.Module(), ProfilePath);
+    CheckProfileUse(CG.Module());
+  }
+  weak::RunBuiltinLLVMOptimizationPass(CG.Module(), O2, &Driver.TargetMachine());
+  Driver.Compile();
+  if (Kind == BuildKind::ProfileUse)
+    CheckSections(CG.Module());
+  return ReadSymbols(PathToBin);
+}
+
+void Run(const std::string &PathToBin, int ExpectedExitCode) {
+  int ExitCode = WEXITSTATUS(system(("./" + PathToBin).c_str()));
+  if (ExitCode != ExpectedExitCode)
+    Fail(PathToBin + ": process exited with wrong exit code: " + std::to_string(ExitCode) +
+         " got, but " + std::to_string(ExpectedExitCode) + " expected.");
+}
+
+int main() {
+  std::string Path = "Profile/HotCold.wl";
+  std::string Program = weak::FileAsString(Path);
+  int ExpectedExitCode = std::stoi(Program.substr(3, Program.find_first_of('\n') - 3));
+  std::string ProfilePath = "HotCold.proftext";
+  std::filesystem::remove(ProfilePath);
+
+  std::cout << "Testing plain build... ";
+  auto Plain = Build(Path, "HotCold_plain", BuildKind::Plain, "");
+  Run("HotCold_plain", ExpectedExitCode);
+  /// Source order.
+  if (Plain["recover"] > Plain["main"])
+    Fail("Functions are reordered without profile.");
+  std::cout << "Success!\n";
+
+  std::cout << "Testing instrumented build... ";
+  Build(Path, "HotCold_gen", BuildKind::Instrumented, ProfilePath);
+  Run("HotCold_gen", ExpectedExitCode);
+  if (!std::filesystem::exists(ProfilePath))
+    Fail("Profile is not written.");
+  std::cout << "Success!\n";
+
+  std::cout << "Testing build with profile... ";
+  weak::IndexedProfile Profile(ProfilePath);
+  auto Optimized = Build(Path, "HotCold_use", BuildKind::ProfileUse, Profile.Path());
+  Run("HotCold_use", ExpectedExitCode);
+  if (Optimized["main"] > Optimized["recover"])
+    Fail("Hot main is placed after cold function.");
+  std::cout << "Success!\n";
+
+  std::cout << "All tests passed!";
+}
\ No newline at end of file
@@ -0,0 +1,94 @@
+#include "MiddleEnd/Optimizers/StructLayout.h"
+#include "MiddleEnd/CodeGen/CodeGen.h"
+#include "MiddleEnd/Driver/Driver.h"
+#include "FrontEnd/Lex/Lexer.h"
+#include "FrontEnd/Parse/Parser.h"
+#include "FrontEnd/Analysis/VariableUseAnalysis.h"
+#include "FrontEnd/Analysis/FunctionAnalysis.h"
+#include "FrontEnd/Analysis/TypeAnalysis.h"
+#include "Utility/Files.h"
+#include <filesystem>
+#include <iostream>
+
+using namespace std::string_view_literals;
+
+/// Leading comment contains expected exit code of program with changed
+/// layout and sizes of each structure, f.e.
+/// // 48
+/// // item 24 16 12
+/// where numbers are size before, size after and size of hot members.
+void TestStructLayout(std::string_view Path) {
+  std::cout << "Testing file " << Path << "...\n";
+  std::string Program = weak::FileAsString(Path);
+
+  std::vector<std::string> Expected;
+  std::string_view Rest = Program;
+  while (Rest.substr(0, 3) == "// ") {
+    auto EOL = Rest.find_first_of('\n');
+    Expected.emplace_back(Rest.substr("// "sv.length(), EOL - "// "sv.length()));
+    Rest = Rest.substr(EOL + 1);
+  }
+
+  if (Expected.empty()) {
+    std::cerr << "Expected exit code and structure sizes.";
+    exit(-1);
+  }
+
+  weak::Lexer Lex(&Program.front(), &Program.back());
+  auto Tokens = Lex.Analyze();
+  weak::Parser Parser(&Tokens.front(), &Tokens.back());
+  auto AST = Parser.Parse();
+
+  weak::VariableUseAnalysis(AST.get()).Analyze();
+  weak::FunctionAnalysis(AST.get()).Analyze();
+  weak::TypeAnalysis(AST.get()).Analyze();
+
+  weak::StructLayoutOptions Opts;
+  Opts.ReorderFields = true;
+  Opts.SplitColdFields = true;
+  auto Stats = weak::RunStructLayoutPass(AST.get(), Opts);
+
+  std::vector<std::string> Generated;
+  for (const auto &S : Stats.Structs)
+    Generated.push_back(
+      S.Name + " " +
+      std::to_string(S.SizeBefore) + " " +
+      std::to_string(S.SizeAfter) + " " +
+      std::to_string(S.HotSize)
+    );
+
+  if (!std::equal(Expected.begin() + 1, Expected.end(), Generated.begin(), Generated.end())) {
+    std::cerr << "Structure sizes mismatch:\n";
+    for (const auto &Line : Generated)
+      std::cerr << '\t' << Line << '\n';
+    std::cerr << "got.";
+    exit(-1);
+  }
+
+  weak::CodeGen CG(AST.get());
+  CG.CreateCode();
+
+  std::string PathToBin(Path.substr(Path.find_last_of('/') + 1));
+  PathToBin = PathToBin.substr(0, PathToBin.find_first_of('.'));
+  weak::Driver(CG.Module(), PathToBin).Compile();
+
+  int ExitCode = WEXITSTATUS(system(("./" + PathToBin).c_str()));
+  if (std::to_string(ExitCode) == Expected.front())
+    return;
+
+  std::cerr
+    << "Process exited with wrong exit code: " << ExitCode
+    << " got, but " << Expected.front() << " expected.";
+  exit(-1);
+}
+
+int main() {
+  auto Dir = std::filesystem::directory_iterator(
+    std::filesystem::current_path().concat("/StructLayout")
+  );
+  for (const auto &File : Dir) {
+    const auto &Path = File.path();
+    if (Path.extension() == ".wl")
+      TestStructLayout(Path.native());
+  }
+}
\ No newline at end of file
@@ -0,0 +1,75 @@
+#include "MiddleEnd/IR/ASTLowering.h"
+#include "MiddleEnd/IR/Passes.h"
+#include "FrontEnd/Lex/Lexer.h"
+#include "FrontEnd/Parse/Parser.h"
+#include "FrontEnd/Analysis/VariableUseAnalysis.h"
+#include "FrontEnd/Analysis/FunctionAnalysis.h"
+#include "FrontEnd/Analysis/TypeAnalysis.h"
+#include "Utility/Files.h"
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+
+/// This gets all contents of first comment placed
+/// at the very beginning of input program.
+std::string ExtractIR(std::string Program) {
+  std::string ExpectedIR;
+
+  using namespace std::string_view_literals;
+  while (Program.size() > 2 && Program.substr(0, 2) == "//") {
+    const auto EOL = Program.find_first_of('\n');
+    std::string Line = Program.substr(2, EOL - "//"sv.length());
+    Program = Program.substr(EOL + 1);
+    ExpectedIR += Line;
+    ExpectedIR += '\n';
+  }
+
+  return ExpectedIR;
+}
+
+void TestWeakIR(std::string_view Path) {
+  std::cout << "Testing file " << Path << "...\n";
+  std::string Program = weak::FileAsString(Path);
+
+  weak::Lexer Lex(&Program.front(), &Program.back());
+  auto Tokens = Lex.Analyze();
+  weak::Parser Parser(&Tokens.front(), &Tokens.back());
+  auto AST = Parser.Parse();
+
+  weak::VariableUseAnalysis(AST.get()).Analyze();
+  weak::FunctionAnalysis(AST.get()).Analyze();
+  weak::TypeAnalysis(AST.get()).Analyze();
+
+  auto Module = weak::LowerToWeakIR(AST.get(), /*BoundsCheck=*/true);
+  weak::ir::RunDefaultPasses(Module);
+
+  std::ostringstream IRStream;
+  weak::ir::Dump(Module, IRStream);
+
+  std::string GeneratedIR = IRStream.str();
+  std::string ExpectedIR = ExtractIR(Program);
+
+  if (ExpectedIR == GeneratedIR)
+    return;
+
+  std::cout
+    << "Error while optimizing program:\n"
+    << Program << '\n'
+    << "Expected IR:\n"
+    << ExpectedIR
+    << "\nGenerated IR:\n"
+    << GeneratedIR
+    << "\n";
+  exit(-1);
+}
+
+int main() {
+  auto Dir = std::filesystem::directory_iterator(
+    std::filesystem::current_path().concat("/WeakIR")
+  );
+  for (const auto &File : Dir) {
+    const auto &Path = File.path();
+    if (Path.extension() == ".wl")
+      TestWeakIR(Path.native());
+  }
+}
\ No newline at end of file
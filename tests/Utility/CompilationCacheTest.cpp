@@ -0,0 +1,91 @@
+#include "Utility/CompilationCache.h"
+#include "TestHelpers.h"
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+std::string ObjectOfSize(size_t Size, char Fill) {
+  return std::string(Size, Fill);
+}
+
+int main() {
+  using weak::CompilationCache;
+  fs::path Dir = fs::current_path() / "CompilationCache";
+  fs::remove_all(Dir);
+
+  SECTION(KeysDependOnAllParts) {
+    std::string Key = CompilationCache::ComputeKey({"a.wl", "int main() {}", "-O2"});
+    TEST_CASE(Key.size() == 40U);
+    TEST_CASE(Key == CompilationCache::ComputeKey({"a.wl", "int main() {}", "-O2"}));
+    TEST_CASE(Key != CompilationCache::ComputeKey({"a.wl", "int main() {}", "-O3"}));
+    TEST_CASE(Key != CompilationCache::ComputeKey({"b.wl", "int main() {}", "-O2"}));
+    /// Parts are not just concatenated.
+    TEST_CASE(CompilationCache::ComputeKey({"ab", "c"}) != CompilationCache::ComputeKey({"a", "bc"}));
+  }
+  SECTION(StoreAndLookup) {
+    CompilationCache Cache(Dir.native(), /*MaxSize=*/0U);
+    std::string Key = CompilationCache::ComputeKey({"StoreAndLookup"});
+    TEST_CASE(!Cache.Lookup(Key));
+
+    std::string Object = ObjectOfSize(100, '\0');
+    Cache.Store(Key, {"warning", "", Object});
+    auto Blobs = Cache.Lookup(Key);
+    TEST_CASE(Blobs);
+    TEST_CASE(Blobs->size() == 3U);
+    TEST_CASE((*Blobs)[0] == "warning");
+    TEST_CASE((*Blobs)[1].empty());
+    TEST_CASE((*Blobs)[2] == Object);
+
+    TEST_CASE(Cache.Stats().Hits == 1U);
+    TEST_CASE(Cache.Stats().Misses == 1U);
+  }
+  SECTION(DamagedEntryIsMiss) {
+    CompilationCache Cache(Dir.native(), /*MaxSize=*/0U);
+    std::string Key = CompilationCache::ComputeKey({"DamagedEntryIsMiss"});
+    Cache.Store(Key, {"blob"});
+    fs::path Entry = Dir / ("llvmcache-" + Key);
+    fs::resize_file(Entry, fs::file_size(Entry) - 1);
+    TEST_CASE(!Cache.Lookup(Key));
+    TEST_CASE(Cache.Stats().Misses == 1U);
+  }
+  SECTION(ConcurrentStores) {
+    CompilationCache Cache(Dir.native(), /*MaxSize=*/0U);
+    std::string Key = CompilationCache::ComputeKey({"ConcurrentStores"});
+    std::string Object = ObjectOfSize(1 << 16, 'x');
+    std::vector<std::thread> Threads;
+    for (int I = 0; I < 8; ++I)
+      Threads.emplace_back([&] {
+        Cache.Store(Key, {Object});
+        auto Blobs = Cache.Lookup(Key);
+        TEST_CASE(Blobs && (*Blobs)[0] == Object);
+      });
+    for (std::thread &T : Threads)
+      T.join();
+    /// No temporary files are left.
+    for (const auto &File : fs::directory_iterator(Dir))
+      TEST_CASE(File.path().extension() != ".tmp");
+  }
+  SECTION(LeastRecentlyUsedAreEvicted) {
+    fs::remove_all(Dir);
+    CompilationCache Cache(Dir.native(), /*MaxSize=*/2500U);
+    std::string Object = ObjectOfSize(1000, 'o');
+    std::string Old = CompilationCache::ComputeKey({"Old"});
+    std::string Used = CompilationCache::ComputeKey({"Used"});
+    std::string New = CompilationCache::ComputeKey({"New"});
+
+    Cache.Store(Used, {Object});
+    Cache.Store(Old, {Object});
+    /// Access times have one second resolution on some file systems.
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+    TEST_CASE(Cache.Lookup(Used));
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+    Cache.Store(New, {Object});
+
+    Cache.Prune();
+    TEST_CASE(!Cache.Lookup(Old));
+    TEST_CASE(Cache.Lookup(Used));
+    TEST_CASE(Cache.Lookup(New));
+  }
+}
\ No newline at end of file